@@ -0,0 +1,33 @@
+#!/bin/sh
+# Runs luna_bench and the example loops, writing JSON results per commit:
+#   benchmarks/run.sh [build dir] [results dir]
+# Results land in <results dir>/<commit>/: luna_bench.json from Google Benchmark
+# and one PerfSummary per example, run headless for 600 frames.
+set -e
+
+build=$(cd "${1:-build}" && pwd)
+results="${2:-bench-results}/$(git rev-parse --short HEAD)"
+mkdir -p "$results"
+results=$(cd "$results" && pwd)
+
+# the window benchmarks need an X server, Xvfb stands in on CI
+display=""
+if [ -z "$DISPLAY" ] && command -v xvfb-run > /dev/null; then
+    display="xvfb-run -a"
+fi
+
+if [ -x "$build/benchmarks/luna_bench" ]; then
+    $display "$build/benchmarks/luna_bench" \
+        --benchmark_out="$results/luna_bench.json" \
+        --benchmark_out_format=json
+fi
+
+# the examples load their resources from the working directory
+for example in simplewindow/linux/simplewindow hellotriangle/vulkan/linux/triangle; do
+    program="$build/examples/$example"
+    if [ -x "$program" ]; then
+        (cd "$(dirname "$program")" && "./$(basename "$program")" --headless "$results/$(basename "$program").json")
+    fi
+done
+
+echo "results in $results"
@@ -0,0 +1,104 @@
+#include "AssetPack.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace Luna;
+namespace fs = std::filesystem;
+
+namespace
+{
+    // shader and material sized files, the case where per file overhead dominates
+    const fs::path & Assets(const uint32 count)
+    {
+        static fs::path root;
+        static uint32 written = 0;
+
+        if (written != count)
+        {
+            root = fs::temp_directory_path() / "luna_bench_assets";
+            fs::remove_all(root);
+
+            for (uint32 i = 0; i < count; ++i)
+            {
+                const fs::path path = root / std::to_string(i % 32) / (std::to_string(i) + ".spv");
+                fs::create_directories(path.parent_path());
+
+                std::ofstream file(path, std::ios::binary);
+                const string data(512 + (i * 97) % 3584, char('a' + i % 26));
+                file.write(data.data(), std::streamsize(data.size()));
+            }
+
+            AssetPack::Build(root.string(), (root.parent_path() / "luna_bench_assets.pak").string());
+            written = count;
+        }
+
+        return root;
+    }
+}
+
+// every asset opened, sized and read into its own buffer, the way the loaders do it
+static void BM_LooseFiles(benchmark::State & state)
+{
+    const fs::path & root = Assets(uint32(state.range(0)));
+
+    std::vector<fs::path> paths;
+    for (const fs::directory_entry & item : fs::recursive_directory_iterator(root))
+    {
+        if (item.is_regular_file())
+            paths.push_back(item.path());
+    }
+
+    std::vector<char> buffer;
+    for (auto _ : state)
+    {
+        uint64 bytes = 0;
+        for (const fs::path & path : paths)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            buffer.resize(size_t(file.tellg()));
+            file.seekg(0);
+            file.read(buffer.data(), std::streamsize(buffer.size()));
+            bytes += buffer.size();
+        }
+
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    state.SetItemsProcessed(state.iterations() * int64_t(paths.size()));
+}
+BENCHMARK(BM_LooseFiles)->Arg(5'000)->Unit(benchmark::kMillisecond);
+
+// one mapping for the pack, then a hash lookup and a span per asset
+static void BM_AssetPack(benchmark::State & state)
+{
+    const fs::path pack = Assets(uint32(state.range(0))).parent_path() / "luna_bench_assets.pak";
+
+    std::vector<string> names;
+    for (uint32 i = 0; i < uint32(state.range(0)); ++i)
+        names.push_back(std::to_string(i % 32) + "/" + std::to_string(i) + ".spv");
+
+    for (auto _ : state)
+    {
+        AssetPack assets;
+        if (!assets.Open(pack.string()))
+        {
+            state.SkipWithError("the pack could not be opened");
+            break;
+        }
+
+        // touching the first byte faults the page in, as a loader would
+        uint64 bytes = 0;
+        for (const string & name : names)
+        {
+            const std::span<const uint8> view = assets.View(name);
+            bytes += view.size() + view[0];
+        }
+
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AssetPack)->Arg(5'000)->Unit(benchmark::kMillisecond);
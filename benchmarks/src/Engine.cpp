@@ -0,0 +1,152 @@
+#include "Engine.h"
+#include "KeyCodes.h"
+#include <benchmark/benchmark.h>
+#include <iterator>
+#include <vector>
+
+using namespace Luna;
+
+namespace
+{
+    // null when there is no X server, run under xvfb-run on CI
+    Luna::Window * BenchWindow()
+    {
+        static Luna::Window * window = []
+        {
+            Luna::Window * w = new Luna::Window();
+            w->Mode(WINDOWED);
+            w->Size(640, 480);
+            if (!w->Create())
+            {
+                delete w;
+                return static_cast<Luna::Window*>(nullptr);
+            }
+            return w;
+        }();
+
+        return window;
+    }
+
+    Input * BenchInput(Luna::Window * window)
+    {
+        static XEvent event{};
+        static Input * input = [window]
+        {
+            Input * i = new Input();
+            i->Initialize(window->XDisplay(), window->Id(), &event);
+            return i;
+        }();
+
+        return input;
+    }
+
+    constexpr uint32 BENCH_KEYS[] { VK_ESCAPE, VK_SPACE, VK_RETURN, VK_LEFT, VK_RIGHT, VK_UP, VK_DOWN, 'W', 'A', 'S', 'D', VK_F3 };
+}
+
+// the engine reads the clock once per frame, games often a few more times
+static void BM_TimerStamp(benchmark::State & state)
+{
+    Timer timer;
+    timer.Start();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(timer.Stamp());
+}
+BENCHMARK(BM_TimerStamp);
+
+static void BM_TimerElapsed(benchmark::State & state)
+{
+    Timer timer;
+    timer.Start();
+    const int64 stamp = timer.Stamp();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(timer.Elapsed(stamp));
+}
+BENCHMARK(BM_TimerElapsed);
+
+// KeyDown maps the key symbol to a keycode through Xlib on every call
+static void BM_KeyDown(benchmark::State & state)
+{
+    Luna::Window * window = BenchWindow();
+    if (!window)
+    {
+        state.SkipWithError("no X display");
+        return;
+    }
+
+    const Input * input = BenchInput(window);
+
+    uint32 i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(input->KeyDown(BENCH_KEYS[i++ % std::size(BENCH_KEYS)]));
+}
+BENCHMARK(BM_KeyDown);
+
+// key presses, releases and pointer motion through the handler the loop calls per event
+static void BM_EngineProc(benchmark::State & state)
+{
+    std::vector<XEvent> events(64);
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        XEvent & event = events[i];
+        switch (i % 4)
+        {
+        case 0: event.type = KeyPress; event.xkey.keycode = 9 + uint32(i % 48); break;
+        case 1: event.type = KeyRelease; event.xkey.keycode = 9 + uint32(i % 48); break;
+        default: event.type = MotionNotify; event.xmotion.x = int32(i); event.xmotion.y = int32(i * 2); break;
+        }
+    }
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        Engine::EngineProc(&events[i++ % events.size()]);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EngineProc);
+
+// the PNG decode and the swizzle to _NET_WM_ICON that Create does for the window icon
+static void BM_DecodeIcon(benchmark::State & state)
+{
+    std::vector<unsigned long> icon;
+    if (!DecodeIcon(LUNA_BENCH_ICON, icon))
+    {
+        state.SkipWithError("icon not found");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        DecodeIcon(LUNA_BENCH_ICON, icon);
+        benchmark::DoNotOptimize(icon.data());
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(icon.size() - 2) * 4);
+}
+BENCHMARK(BM_DecodeIcon);
+
+// the FPS title debug builds set once a second, flushed like the loop does
+static void BM_Caption(benchmark::State & state)
+{
+    Luna::Window * window = BenchWindow();
+    if (!window)
+    {
+        state.SkipWithError("no X display");
+        return;
+    }
+
+    const string title = "Window Game    FPS: 60    Frame Time: 16.667 (ms)";
+
+    for (auto _ : state)
+    {
+        window->Caption(title);
+        XFlush(window->XDisplay());
+    }
+
+    XSync(window->XDisplay(), false);
+}
+BENCHMARK(BM_Caption);
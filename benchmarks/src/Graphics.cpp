@@ -0,0 +1,334 @@
+#include "Graphics.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+
+using namespace Luna;
+
+namespace
+{
+    // stands in for the culling and draw recording a game does between Clear and Present
+    void Spin(const std::chrono::microseconds duration)
+    {
+        const auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end)
+            benchmark::ClobberMemory();
+    }
+
+    Window & BenchWindow()
+    {
+        static Window * window = []
+        {
+            Window * w = new Window();
+            w->Mode(WINDOWED);
+            w->Size(1280, 720);
+            w->Create();
+            return w;
+        }();
+
+        return *window;
+    }
+}
+
+// CPU-heavy frames: with a single frame in flight the CPU waits for the GPU
+// to finish the previous frame before recording, with two or more they overlap.
+// Runs on lavapipe under Xvfb when there is no GPU. gpu_ms is the mean GPU
+// time of a frame from the timestamp queries, read back frames later, and
+// wait_ms the time Clear blocks on the fence of the frame it reuses.
+static void BM_FramesInFlight(benchmark::State & state)
+{
+    Graphics graphics;
+    graphics.FramesInFlight(uint32(state.range(0)));
+    graphics.Initialize(&BenchWindow());
+
+    Profiler profiler;
+    graphics.Profile(&profiler);
+
+    // full screen clears keep the GPU busy for a while
+    const uint32 clears = uint32(state.range(1));
+    VkClearAttachment attachment { VK_IMAGE_ASPECT_COLOR_BIT, 0, {} };
+    const VkClearRect rect { graphics.scissorRect, 0, 1 };
+
+    double gpu = 0.0;
+    double wait = 0.0;
+    uint64 resolved = 0;
+    uint64 reported = 0;
+
+    for (auto _ : state)
+    {
+        profiler.BeginFrame();
+        const auto start = std::chrono::steady_clock::now();
+        if (!graphics.Clear())
+        {
+            state.SkipWithError("the window has no area to render to");
+            break;
+        }
+        wait += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        {
+            GpuScope scope(&graphics, "Clears");
+            for (uint32 i = 0; i < clears; ++i)
+            {
+                attachment.clearValue.color.float32[0] = float(i) / clears;
+                vkCmdClearAttachments(graphics.CommandBuffer(), 1, &attachment, 1, &rect);
+            }
+        }
+
+        Spin(std::chrono::microseconds(2000));
+        graphics.Present();
+        profiler.EndFrame();
+
+        const FrameReport & report = profiler.Report();
+        if (report.frame != reported)
+        {
+            reported = report.frame;
+            gpu += report.gpu;
+            ++resolved;
+        }
+    }
+
+    graphics.Profile(nullptr);
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["gpu_ms"] = resolved ? gpu / resolved : 0.0;
+    state.counters["wait_ms"] = state.iterations() ? wait / double(state.iterations()) : 0.0;
+}
+BENCHMARK(BM_FramesInFlight)->ArgsProduct({ { 1, 2, 3 }, { 64, 512 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// CPU cost of GPU timestamp scopes (0, 8 and the 64 a frame can hold) with the
+// profiler attached or not, and proof the results come back: resolved is the
+// share of frames whose GPU times arrived, lag_frames how many frames after
+// their own, which stays at the frames in flight when read back without a stall.
+// Fails when profiling never resolves a frame, as on a device without timestamps.
+static void BM_GpuScopes(benchmark::State & state)
+{
+    Graphics graphics;
+    graphics.Initialize(&BenchWindow());
+
+    const uint32 scopes = uint32(state.range(0));
+    const bool profiling = state.range(1) == 1;
+
+    Profiler profiler;
+    graphics.Profile(profiling ? &profiler : nullptr);
+
+    VkClearAttachment attachment { VK_IMAGE_ASPECT_COLOR_BIT, 0, {} };
+    const VkClearRect rect { { { 0, 0 }, { 1, 1 } }, 0, 1 };
+
+    uint64 resolved = 0;
+    uint64 reported = 0;
+    uint64 lag = 0;
+
+    for (auto _ : state)
+    {
+        profiler.BeginFrame();
+        if (!graphics.Clear())
+        {
+            state.SkipWithError("the window has no area to render to");
+            break;
+        }
+
+        for (uint32 i = 0; i < scopes; ++i)
+        {
+            GpuScope scope(&graphics, "Scope");
+            vkCmdClearAttachments(graphics.CommandBuffer(), 1, &attachment, 1, &rect);
+        }
+
+        graphics.Present();
+        profiler.EndFrame();
+
+        const FrameReport & report = profiler.Report();
+        // without queries the report is published at EndFrame with no GPU time
+        if (profiling && report.frame != reported && report.gpu > 0.0)
+        {
+            reported = report.frame;
+            lag += profiler.Frame() - report.frame;
+            ++resolved;
+        }
+    }
+
+    graphics.Profile(nullptr);
+
+    if (profiling && state.iterations() > 16 && resolved == 0)
+        state.SkipWithError("no GPU timestamps were read back");
+
+    state.SetItemsProcessed(state.iterations() * scopes);
+    state.counters["resolved"] = state.iterations() ? double(resolved) / double(state.iterations()) : 0.0;
+    state.counters["lag_frames"] = resolved ? double(lag) / double(resolved) : 0.0;
+}
+BENCHMARK(BM_GpuScopes)->ArgsProduct({ { 0, 8, 64 }, { 0, 1 } })->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Draw recording spread over worker threads, each chunk into a secondary
+// command buffer from the thread's own pool. A 1x1 clear stands in for a
+// draw call; threads 0 records everything on the calling thread.
+static void BM_ParallelRecording(benchmark::State & state)
+{
+    Graphics graphics;
+    graphics.Initialize(&BenchWindow());
+
+    const uint32 draws = uint32(state.range(0));
+    ThreadPool threadPool(uint32(state.range(1)));
+
+    VkClearAttachment attachment { VK_IMAGE_ASPECT_COLOR_BIT, 0, {} };
+    const VkClearRect rect { { { 0, 0 }, { 1, 1 } }, 0, 1 };
+
+    for (auto _ : state)
+    {
+        if (!graphics.Clear())
+        {
+            state.SkipWithError("the window has no area to render to");
+            break;
+        }
+
+        graphics.Record(&threadPool, draws, 512, [&](VkCommandBuffer commandBuffer, uint32 begin, uint32 end)
+        {
+            for (uint32 i = begin; i < end; ++i)
+                vkCmdClearAttachments(commandBuffer, 1, &attachment, 1, &rect);
+        });
+
+        graphics.Present();
+    }
+
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+BENCHMARK(BM_ParallelRecording)->ArgsProduct({ { 10000, 50000 }, { 0, 2, 4, 8 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// The baseline for BM_ParallelRecording: the same draws recorded straight into
+// the frame's primary command buffer, as before Graphics::Record existed
+static void BM_SerialRecording(benchmark::State & state)
+{
+    Graphics graphics;
+    graphics.Initialize(&BenchWindow());
+
+    const uint32 draws = uint32(state.range(0));
+
+    VkClearAttachment attachment { VK_IMAGE_ASPECT_COLOR_BIT, 0, {} };
+    const VkClearRect rect { { { 0, 0 }, { 1, 1 } }, 0, 1 };
+
+    for (auto _ : state)
+    {
+        if (!graphics.Clear())
+        {
+            state.SkipWithError("the window has no area to render to");
+            break;
+        }
+
+        VkCommandBuffer commandBuffer = graphics.CommandBuffer();
+        for (uint32 i = 0; i < draws; ++i)
+            vkCmdClearAttachments(commandBuffer, 1, &attachment, 1, &rect);
+
+        graphics.Present();
+    }
+
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+BENCHMARK(BM_SerialRecording)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// CPU cost of giving each draw its own constants: a descriptor set allocated,
+// written and bound per draw (mode 0) against one bind of the heap and uniform
+// ring per frame with an index pushed per draw (mode 1). Only the binding
+// commands are recorded, there is no pipeline to draw with.
+static void BM_DrawBinding(benchmark::State & state)
+{
+    Graphics graphics;
+    graphics.Initialize(&BenchWindow());
+
+    const bool bindless = state.range(0) == 1;
+    const uint32 draws = uint32(state.range(1));
+    VkDevice device = graphics.Device();
+
+    VkDescriptorSetLayoutBinding binding { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr };
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+
+    VkDescriptorSetLayout setLayout{};
+    vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &setLayout;
+
+    VkPipelineLayout pipelineLayout{};
+    vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout);
+
+    // one pool per frame in flight, reset when the frame comes around again
+    const VkDescriptorPoolSize poolSize { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, draws };
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = draws;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    std::vector<VkDescriptorPool> pools(graphics.FramesInFlight());
+    for (VkDescriptorPool & pool : pools)
+        vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool);
+
+    VkBuffer buffer{};
+    Allocation allocation{};
+    graphics.Allocate(draws * 256, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &buffer, &allocation);
+
+    for (auto _ : state)
+    {
+        if (!graphics.Clear())
+        {
+            state.SkipWithError("the window has no area to render to");
+            break;
+        }
+
+        VkCommandBuffer commandBuffer = graphics.CommandBuffer();
+
+        if (bindless)
+        {
+            const UniformAllocation constants = graphics.Uniform(64);
+            graphics.BindResources(commandBuffer, constants.offset);
+
+            for (uint32 i = 0; i < draws; ++i)
+                vkCmdPushConstants(commandBuffer, graphics.PipelineLayout(), VK_SHADER_STAGE_ALL, 0, sizeof(i), &i);
+        }
+        else
+        {
+            VkDescriptorPool pool = pools[graphics.FrameIndex()];
+            vkResetDescriptorPool(device, pool, 0);
+
+            VkDescriptorSetAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocateInfo.descriptorPool = pool;
+            allocateInfo.descriptorSetCount = 1;
+            allocateInfo.pSetLayouts = &setLayout;
+
+            for (uint32 i = 0; i < draws; ++i)
+            {
+                VkDescriptorSet set{};
+                vkAllocateDescriptorSets(device, &allocateInfo, &set);
+
+                VkDescriptorBufferInfo bufferInfo { buffer, VkDeviceSize(i) * 256, 256 };
+
+                VkWriteDescriptorSet write{};
+                write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                write.dstSet = set;
+                write.descriptorCount = 1;
+                write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                write.pBufferInfo = &bufferInfo;
+
+                vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &set, 0, nullptr);
+            }
+        }
+
+        graphics.Present();
+    }
+
+    vkDeviceWaitIdle(device);
+    graphics.Free(buffer, allocation);
+    for (VkDescriptorPool pool : pools)
+        vkDestroyDescriptorPool(device, pool, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+BENCHMARK(BM_DrawBinding)->ArgsProduct({ { 0, 1 }, { 10000 } })->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,162 @@
+#include "Math.h"
+#include "MathBatch.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#ifdef LUNA_BENCH_GLM
+    #include <glm/glm.hpp>
+    #include <glm/gtc/matrix_transform.hpp>
+    #include <glm/gtc/quaternion.hpp>
+#endif
+
+using namespace Luna;
+using namespace Luna::Math;
+
+namespace
+{
+    constexpr uint32 POINT_COUNT = 1 << 16;
+    constexpr uint32 MATRIX_COUNT = 1 << 12;
+
+    const Mat4 & Transform()
+    {
+        static const Mat4 m = Mat4::Perspective(Radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f)
+            * Mat4::LookAt({ 0, 2, 5 }, { 0, 0, 0 }, { 0, 1, 0 })
+            * Mat4::TRS({ 1, 2, 3 }, Quat::Euler(0.3f, 0.7f, 0.1f), { 2, 2, 2 });
+        return m;
+    }
+
+    std::vector<Vec3> Points()
+    {
+        std::vector<Vec3> points(POINT_COUNT);
+        for (uint32 i = 0; i < POINT_COUNT; ++i)
+            points[i] = { float(i % 97), float(i % 89), float(i % 83) };
+        return points;
+    }
+
+    std::vector<Mat4> Matrices()
+    {
+        std::vector<Mat4> matrices(MATRIX_COUNT);
+        for (uint32 i = 0; i < MATRIX_COUNT; ++i)
+            matrices[i] = Mat4::TRS(Vec3(float(i)), Quat::AxisAngle({ 0, 1, 0 }, float(i)), Vec3(1.0f));
+        return matrices;
+    }
+}
+
+static void BM_MathMat4Multiply(benchmark::State & state)
+{
+    const auto a = Matrices();
+    const auto b = Matrices();
+    std::vector<Mat4> out(MATRIX_COUNT);
+
+    for (auto _ : state)
+    {
+        Multiply(a.data(), b.data(), out.data(), MATRIX_COUNT);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * MATRIX_COUNT);
+}
+BENCHMARK(BM_MathMat4Multiply);
+
+static void BM_MathTransformPoints(benchmark::State & state)
+{
+    const auto in = Points();
+    std::vector<Vec3> out(POINT_COUNT);
+
+    for (auto _ : state)
+    {
+        for (uint32 i = 0; i < POINT_COUNT; ++i)
+            out[i] = TransformPoint(Transform(), in[i]);
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * POINT_COUNT);
+}
+BENCHMARK(BM_MathTransformPoints);
+
+static void BM_MathTransformPointsBatch(benchmark::State & state)
+{
+    const auto in = Points();
+    std::vector<Vec3> out(POINT_COUNT);
+
+    for (auto _ : state)
+    {
+        TransformPoints(Transform(), in.data(), out.data(), POINT_COUNT);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * POINT_COUNT);
+}
+BENCHMARK(BM_MathTransformPointsBatch);
+
+static void BM_MathTransformPointsSoA(benchmark::State & state)
+{
+    std::vector<float> x(POINT_COUNT), y(POINT_COUNT), z(POINT_COUNT);
+    std::vector<float> ox(POINT_COUNT), oy(POINT_COUNT), oz(POINT_COUNT);
+
+    const auto in = Points();
+    for (uint32 i = 0; i < POINT_COUNT; ++i)
+    {
+        x[i] = in[i].x;
+        y[i] = in[i].y;
+        z[i] = in[i].z;
+    }
+
+    for (auto _ : state)
+    {
+        TransformPoints(Transform(), x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), POINT_COUNT);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * POINT_COUNT);
+}
+BENCHMARK(BM_MathTransformPointsSoA);
+
+#ifdef LUNA_BENCH_GLM
+
+static void BM_GlmMat4Multiply(benchmark::State & state)
+{
+    std::vector<glm::mat4> a(MATRIX_COUNT), b(MATRIX_COUNT), out(MATRIX_COUNT);
+    for (uint32 i = 0; i < MATRIX_COUNT; ++i)
+    {
+        const glm::mat4 r = glm::mat4_cast(glm::angleAxis(float(i), glm::vec3(0, 1, 0)));
+        a[i] = b[i] = glm::translate(glm::mat4(1.0f), glm::vec3(float(i))) * r;
+    }
+
+    for (auto _ : state)
+    {
+        for (uint32 i = 0; i < MATRIX_COUNT; ++i)
+            out[i] = a[i] * b[i];
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * MATRIX_COUNT);
+}
+BENCHMARK(BM_GlmMat4Multiply);
+
+static void BM_GlmTransformPoints(benchmark::State & state)
+{
+    glm::mat4 m;
+    for (uint32 i = 0; i < 4; ++i)
+        m[i] = glm::vec4(Transform()[i].x, Transform()[i].y, Transform()[i].z, Transform()[i].w);
+
+    const auto points = Points();
+    std::vector<glm::vec3> in(POINT_COUNT), out(POINT_COUNT);
+    for (uint32 i = 0; i < POINT_COUNT; ++i)
+        in[i] = { points[i].x, points[i].y, points[i].z };
+
+    for (auto _ : state)
+    {
+        for (uint32 i = 0; i < POINT_COUNT; ++i)
+            out[i] = glm::vec3(m * glm::vec4(in[i], 1.0f));
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * POINT_COUNT);
+}
+BENCHMARK(BM_GlmTransformPoints);
+
+#endif
@@ -0,0 +1,93 @@
+#include "MeshProcessing.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace Luna;
+using namespace Luna::Math;
+
+namespace
+{
+    // a height field grid with its triangles shuffled, about what an exporter
+    // that does not care about ordering writes out
+    MeshData Grid(const uint32 side)
+    {
+        MeshData mesh;
+
+        for (uint32 y = 0; y <= side; ++y)
+        {
+            for (uint32 x = 0; x <= side; ++x)
+            {
+                const float u = float(x) / float(side);
+                const float v = float(y) / float(side);
+                mesh.vertices.push_back({ Vec3{ u, 0.1f * float((x * 7 + y * 3) % 5), v }, Vec3{ 0.0f, 1.0f, 0.0f }, Vec2{ u, v } });
+            }
+        }
+
+        std::vector<std::array<uint32, 3>> triangles;
+        for (uint32 y = 0; y < side; ++y)
+        {
+            for (uint32 x = 0; x < side; ++x)
+            {
+                const uint32 corner = y * (side + 1) + x;
+                triangles.push_back({ corner, corner + side + 1, corner + 1 });
+                triangles.push_back({ corner + 1, corner + side + 1, corner + side + 2 });
+            }
+        }
+
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937{ 42 });
+
+        for (const auto & triangle : triangles)
+            mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+
+        return mesh;
+    }
+}
+
+// the whole offline pipeline; the counters show what the ordering buys the GPU
+static void BM_ProcessMesh(benchmark::State & state)
+{
+    const MeshData source = Grid(uint32(state.range(0)));
+    const CacheStats before = AnalyzeVertexCache(source.indices, uint32(source.vertices.size()));
+
+    MeshData mesh;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        mesh = source;
+        state.ResumeTiming();
+
+        ProcessMesh(mesh);
+        benchmark::DoNotOptimize(mesh.indices.data());
+    }
+
+    const CacheStats after = AnalyzeVertexCache(mesh.indices, uint32(mesh.vertices.size()));
+    const std::vector<uint8> packed = PackMesh(mesh);
+
+    MeshView view;
+    ReadMesh(packed, view);
+
+    state.counters["acmr_before"] = before.acmr;
+    state.counters["acmr_after"] = after.acmr;
+    state.counters["vertex_bytes_before"] = double(sizeof(MeshVertex));
+    state.counters["vertex_bytes_after"] = double(view.header->vertexStride);
+    state.SetItemsProcessed(state.iterations() * int64_t(source.indices.size() / 3));
+}
+BENCHMARK(BM_ProcessMesh)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+// the vertex stage's work measured on the FIFO model, per cache size
+static void BM_AnalyzeVertexCache(benchmark::State & state)
+{
+    MeshData mesh = Grid(256);
+    ProcessMesh(mesh);
+
+    for (auto _ : state)
+    {
+        const CacheStats stats = AnalyzeVertexCache(mesh.indices, uint32(mesh.vertices.size()), uint32(state.range(0)));
+        benchmark::DoNotOptimize(stats);
+    }
+
+    state.counters["acmr"] = AnalyzeVertexCache(mesh.indices, uint32(mesh.vertices.size()), uint32(state.range(0))).acmr;
+}
+BENCHMARK(BM_AnalyzeVertexCache)->Arg(8)->Arg(16)->Arg(32)->Unit(benchmark::kMicrosecond);
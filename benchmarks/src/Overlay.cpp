@@ -0,0 +1,43 @@
+#include "Overlay.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdlib>
+
+using namespace Luna;
+
+// the panel the engine builds every frame it is shown, which must stay well
+// under 0.1 ms; without a font (LUNA_BENCH_FONT) only the graph is measured
+static void BM_Overlay(benchmark::State & state)
+{
+    Overlay overlay;
+    const char * path = std::getenv("LUNA_BENCH_FONT");
+    if (!overlay.Load(path ? path : "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 13))
+        state.SetLabel("graph only");
+
+    Profiler profiler;
+    const char * const zones[] { "Streaming", "Update", "Systems", "Culling", "Draw" };
+
+    uint32 frame = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        profiler.BeginFrame();
+        for (const char * zone : zones)
+            ProfileScope scope(&profiler, zone);
+        profiler.EndFrame();
+        overlay.Event(frame % 4 == 0);
+        overlay.Frame(16.0 + 4.0 * std::sin(frame * 0.1));
+        state.ResumeTiming();
+
+        overlay.Begin();
+        overlay.Graph();
+        overlay.Stats(profiler.Report(), 256ULL << 20);
+        overlay.End();
+        overlay.Presented();
+        ++frame;
+    }
+
+    state.counters["sprites"] = overlay.Batch().InstanceCount();
+    state.counters["runs"] = overlay.Batch().RunCount();
+}
+BENCHMARK(BM_Overlay)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,88 @@
+#include "Canvas.h"
+#include <benchmark/benchmark.h>
+
+using namespace Luna;
+using namespace Luna::Math;
+
+namespace
+{
+    constexpr uint32 SPRITES = 100000;
+
+    // sprites spread over a 1280 x 720 screen, 16 textures and 4 layers
+    void Submit(SpriteBatch & batch)
+    {
+        uint32 seed = 12345;
+        auto random = [&seed]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return seed >> 8;
+        };
+
+        batch.Begin();
+
+        for (uint32 i = 0; i < SPRITES; ++i)
+        {
+            const uint32 r = random();
+            const Vec2 position { float(r % 1280), float((r >> 11) % 720) };
+            batch.Draw(r & 15, position, { 16.0f, 16.0f }, 0xffffffff, (r >> 4) & 3);
+        }
+
+        batch.End();
+    }
+}
+
+static void BM_SpriteBatchSubmit(benchmark::State & state)
+{
+    SpriteBatch batch(SPRITES);
+
+    for (auto _ : state)
+    {
+        Submit(batch);
+        benchmark::DoNotOptimize(batch.Instances());
+    }
+
+    state.SetItemsProcessed(state.iterations() * SPRITES);
+}
+BENCHMARK(BM_SpriteBatchSubmit)->Unit(benchmark::kMillisecond);
+
+static void BM_CanvasDraw(benchmark::State & state)
+{
+    SpriteBatch batch(SPRITES);
+    Submit(batch);
+
+    Canvas canvas(1280, 720);
+
+    // textures with transparent borders, so both blend paths are exercised
+    std::vector<uint32> texels(16 * 16);
+    for (uint32 y = 0; y < 16; ++y)
+        for (uint32 x = 0; x < 16; ++x)
+            texels[y * 16 + x] = (x == 0 || y == 0 || x == 15 || y == 15) ? 0x80ff8000 : 0xff2060c0;
+
+    for (uint32 i = 0; i < 16; ++i)
+        canvas.Texture(texels.data(), 16, 16);
+
+    for (auto _ : state)
+    {
+        canvas.Clear(0xff000000);
+        canvas.Draw(batch);
+        benchmark::DoNotOptimize(canvas.Pixels());
+    }
+
+    state.SetItemsProcessed(state.iterations() * SPRITES);
+}
+BENCHMARK(BM_CanvasDraw)->Unit(benchmark::kMillisecond);
+
+static void BM_BlendRow(benchmark::State & state)
+{
+    std::vector<uint32> dst(1280, 0xff000000);
+    std::vector<uint32> src(1280, 0x80ff8000);
+
+    for (auto _ : state)
+    {
+        BlendRow(dst.data(), src.data(), 1280, 0xffffffff);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1280);
+}
+BENCHMARK(BM_BlendRow);
@@ -0,0 +1,89 @@
+#include "Streamer.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+using namespace Luna;
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::vector<string> & Files()
+    {
+        static std::vector<string> paths = []
+        {
+            const fs::path root = fs::temp_directory_path() / "luna_bench_stream";
+            fs::create_directories(root);
+
+            std::vector<string> written;
+            for (uint32 i = 0; i < 2'000; ++i)
+            {
+                const fs::path path = root / (std::to_string(i) + ".bin");
+                std::ofstream file(path, std::ios::binary);
+                const string data(4096 + (i * 131) % 61440, char(i));
+                file.write(data.data(), std::streamsize(data.size()));
+                written.push_back(path.string());
+            }
+
+            return written;
+        }();
+
+        return paths;
+    }
+
+    ThreadPool & Pool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}
+
+// what a level load costs the frame when every file is read where it is needed
+static void BM_BlockingLoad(benchmark::State & state)
+{
+    std::vector<uint8> data;
+    for (auto _ : state)
+    {
+        for (const string & path : Files())
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            data.resize(size_t(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+            benchmark::DoNotOptimize(data.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * int64_t(Files().size()));
+}
+BENCHMARK(BM_BlockingLoad)->Unit(benchmark::kMillisecond);
+
+// the same files streamed, with Deliver called as the engine would each frame;
+// worst_ms is the longest Deliver, the time the load takes out of one frame
+static void BM_StreamedLoad(benchmark::State & state)
+{
+    Streamer streamer(&Pool(), 32, state.range(0) != 0);
+    double worst = 0.0;
+
+    for (auto _ : state)
+    {
+        uint64 bytes = 0;
+        for (const string & path : Files())
+            streamer.Load(path, STREAM_NORMAL, [&bytes](std::vector<uint8> & data, bool) { bytes += data.size(); });
+
+        while (streamer.Pending())
+        {
+            const auto start = std::chrono::steady_clock::now();
+            streamer.Deliver();
+            worst = std::max(worst, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    state.counters["uring"] = streamer.Uring();
+    state.counters["worst_ms"] = worst;
+    state.SetItemsProcessed(state.iterations() * int64_t(Files().size()));
+}
+BENCHMARK(BM_StreamedLoad)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
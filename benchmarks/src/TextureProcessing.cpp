@@ -0,0 +1,350 @@
+#include "TextureProcessing.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Luna;
+
+namespace
+{
+    // smooth gradients under a sharp checker, the mix that separates the encoders
+    const ImageData & Photo()
+    {
+        static const ImageData image = []
+        {
+            ImageData data { 1024, 1024, std::vector<uint8>(1024 * 1024 * 4) };
+            for (uint32 y = 0; y < data.height; ++y)
+            {
+                for (uint32 x = 0; x < data.width; ++x)
+                {
+                    uint8 * pixel = data.pixels.data() + (size_t(y) * data.width + x) * 4;
+                    pixel[0] = uint8(x / 4);
+                    pixel[1] = uint8(y / 4);
+                    pixel[2] = ((x / 32 + y / 32) & 1) ? uint8(200) : uint8(128 + 100 * std::sin(float(x) * 0.05f));
+                    pixel[3] = uint8(255 - (x + y) / 8);
+                }
+            }
+            return data;
+        }();
+
+        return image;
+    }
+
+    // Every 4x4 block a line between two colors that differ mostly in brightness,
+    // which all four formats represent well, with the texels placed along it in
+    // a shuffled order that differs per block: a misplaced index or endpoint then
+    // lands on a far color instead of hiding in a flat or mirrored block. The right
+    // half spans less of the line, so ETC2 picks a different table for it. Alpha
+    // follows the same line and crosses 128 for the BC1 punch through bit.
+    const ImageData & Detail()
+    {
+        static const ImageData image = []
+        {
+            ImageData data { 256, 256, std::vector<uint8>(256 * 256 * 4) };
+            for (uint32 y = 0; y < data.height; ++y)
+            {
+                for (uint32 x = 0; x < data.width; ++x)
+                {
+                    const uint32 hash = (x / 4 * 73856093U) ^ (y / 4 * 19349663U);
+                    const float along = float((x % 4 * 7 + y % 4 * 13 + hash % 16) % 16) / 15.0f;
+                    const float t = x % 4 < 2 ? along : 0.4f + 0.2f * along;
+                    const float base[4] { float(30 + hash % 100), float(30 + hash / 7 % 100), float(30 + hash / 49 % 100), 64.0f };
+                    const float delta = float(40 + hash / 343 % 60);
+
+                    uint8 * pixel = data.pixels.data() + (size_t(y) * data.width + x) * 4;
+                    for (uint32 c = 0; c < 3; ++c)
+                        pixel[c] = uint8(base[c] + delta * t + 0.5f);
+                    pixel[3] = uint8(base[3] + 160.0f * t + 0.5f);
+                }
+            }
+            return data;
+        }();
+
+        return image;
+    }
+
+    ThreadPool & Pool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // ---------------------------------------------------
+    // Reference decoders, written from the format specifications
+    // rather than from the encoder, so a wrong bit layout shows up
+    // as a collapsed PSNR instead of round tripping through itself
+    // ---------------------------------------------------
+
+    using Texels = uint8[16][4];
+
+    void Expand565(const uint16 packed, int32 (&color)[3])
+    {
+        const int32 r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // BC1 color block; inside BC3 it always has four colors
+    void DecodeColors(const uint8 * block, const bool fourOnly, Texels & texels)
+    {
+        uint16 c0, c1;
+        uint32 bits;
+        memcpy(&c0, block, 2);
+        memcpy(&c1, block + 2, 2);
+        memcpy(&bits, block + 4, 4);
+
+        const bool four = fourOnly || c0 > c1;
+        int32 palette[4][3];
+        Expand565(c0, palette[0]);
+        Expand565(c1, palette[1]);
+        for (uint32 c = 0; c < 3; ++c)
+        {
+            palette[2][c] = four ? (2 * palette[0][c] + palette[1][c]) / 3 : (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = four ? (palette[0][c] + 2 * palette[1][c]) / 3 : 0;
+        }
+
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            const uint32 index = (bits >> (2 * i)) & 3;
+            for (uint32 c = 0; c < 3; ++c)
+                texels[i][c] = uint8(palette[index][c]);
+            texels[i][3] = index == 3 && !four ? 0 : 255;
+        }
+    }
+
+    // BC3 alpha block, the same as BC4
+    void DecodeAlpha(const uint8 * block, Texels & texels)
+    {
+        const int32 a0 = block[0], a1 = block[1];
+        int32 palette[8] { a0, a1 };
+        for (int32 i = 1; i < 7; ++i)
+            palette[i + 1] = a0 > a1 ? ((7 - i) * a0 + i * a1) / 7 : i < 5 ? ((5 - i) * a0 + i * a1) / 5 : (i == 5 ? 0 : 255);
+
+        uint64 bits = 0;
+        for (uint32 i = 0; i < 6; ++i)
+            bits |= uint64(block[2 + i]) << (8 * i);
+
+        for (uint32 i = 0; i < 16; ++i)
+            texels[i][3] = uint8(palette[(bits >> (3 * i)) & 7]);
+    }
+
+    // BC7 mode 6 only, the one the encoder writes; false for any other mode
+    bool DecodeBc7(const uint8 * block, Texels & texels)
+    {
+        uint64 bits[2];
+        memcpy(bits, block, 16);
+
+        uint32 position = 0;
+        auto read = [&bits, &position](const uint32 count)
+        {
+            uint64 value = bits[position / 64] >> (position % 64);
+            if (position % 64 + count > 64)
+                value |= bits[position / 64 + 1] << (64 - position % 64);
+            position += count;
+            return uint32(value & ((1ULL << count) - 1));
+        };
+
+        if (read(7) != 1 << 6)
+            return false;
+
+        uint32 endpoints[2][4];
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            endpoints[0][c] = read(7) << 1;
+            endpoints[1][c] = read(7) << 1;
+        }
+        const uint32 p0 = read(1), p1 = read(1);
+
+        static constexpr uint32 weights[16] { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            const uint32 w = weights[read(i == 0 ? 3 : 4)];
+            for (uint32 c = 0; c < 4; ++c)
+                texels[i][c] = uint8(((endpoints[0][c] | p0) * (64 - w) + (endpoints[1][c] | p1) * w + 32) >> 6);
+        }
+
+        return true;
+    }
+
+    // ETC2 RGB in its individual and differential modes; false for T, H and planar
+    bool DecodeEtc(const uint8 * block, Texels & texels)
+    {
+        uint64 bits = 0;
+        for (uint32 i = 0; i < 8; ++i)
+            bits = (bits << 8) | block[i];
+
+        static constexpr int32 modifiers[8][2] { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+        const bool differential = (bits >> 33) & 1;
+        const bool flip = (bits >> 32) & 1;
+
+        int32 bases[2][3];
+        for (uint32 c = 0; c < 3; ++c)
+        {
+            if (differential)
+            {
+                const int32 first = int32(bits >> (59 - 8 * c)) & 31;
+                const int32 delta = ((int32(bits >> (56 - 8 * c)) & 7) ^ 4) - 4;
+                if (first + delta < 0 || first + delta > 31)
+                    return false;
+
+                bases[0][c] = (first << 3) | (first >> 2);
+                bases[1][c] = ((first + delta) << 3) | ((first + delta) >> 2);
+            }
+            else
+            {
+                bases[0][c] = (int32(bits >> (60 - 8 * c)) & 15) * 17;
+                bases[1][c] = (int32(bits >> (56 - 8 * c)) & 15) * 17;
+            }
+        }
+
+        for (uint32 x = 0; x < 4; ++x)
+        {
+            for (uint32 y = 0; y < 4; ++y)
+            {
+                const uint32 half = flip ? y / 2 : x / 2;
+                const uint32 table = uint32(bits >> (half ? 34 : 37)) & 7;
+                const uint32 bit = x * 4 + y;
+                const uint32 low = (bits >> bit) & 1, high = (bits >> (16 + bit)) & 1;
+                const int32 modifier = (high ? -1 : 1) * modifiers[table][low];
+
+                for (uint32 c = 0; c < 3; ++c)
+                    texels[y * 4 + x][c] = uint8(std::clamp(bases[half][c] + modifier, 0, 255));
+                texels[y * 4 + x][3] = 255;
+            }
+        }
+
+        return true;
+    }
+
+    // false when a block uses a layout the reference decoders do not know
+    bool DecodeImage(const std::vector<uint8> & blocks, const TextureFormat format,
+        const uint32 width, const uint32 height, ImageData & image)
+    {
+        const uint32 blocksWide = (width + 3) / 4;
+        const uint32 blockBytes = BlockBytes(format);
+        if (blocks.size() != LevelBytes(format, width, height))
+            return false;
+
+        image = { width, height, std::vector<uint8>(size_t(width) * height * 4) };
+
+        Texels texels;
+        for (uint32 by = 0; by < (height + 3) / 4; ++by)
+        {
+            for (uint32 bx = 0; bx < blocksWide; ++bx)
+            {
+                const uint8 * block = blocks.data() + (size_t(by) * blocksWide + bx) * blockBytes;
+                bool known = true;
+
+                switch (format)
+                {
+                case TEXTURE_BC1: DecodeColors(block, false, texels); break;
+                case TEXTURE_BC3: DecodeColors(block + 8, true, texels); DecodeAlpha(block, texels); break;
+                case TEXTURE_BC7: known = DecodeBc7(block, texels); break;
+                case TEXTURE_ETC2: known = DecodeEtc(block, texels); break;
+                default: return false;
+                }
+
+                if (!known)
+                    return false;
+
+                for (uint32 y = 0; y < 4 && by * 4 + y < height; ++y)
+                    for (uint32 x = 0; x < 4 && bx * 4 + x < width; ++x)
+                        memcpy(image.pixels.data() + ((size_t(by) * 4 + y) * width + bx * 4 + x) * 4, texels[y * 4 + x], 4);
+            }
+        }
+
+        return true;
+    }
+
+    // over the channels the format keeps; BC1 alpha is one bit, checked on its own
+    double Psnr(const ImageData & source, const ImageData & decoded, const TextureFormat format, uint32 & alphaErrors)
+    {
+        const uint32 channels = format == TEXTURE_BC3 || format == TEXTURE_BC7 ? 4 : 3;
+
+        double error = 0.0;
+        size_t count = 0;
+        alphaErrors = 0;
+
+        for (size_t i = 0; i < source.pixels.size(); i += 4)
+        {
+            if (format == TEXTURE_BC1 && (source.pixels[i + 3] >= 128) != (decoded.pixels[i + 3] == 255))
+                ++alphaErrors;
+
+            // transparent BC1 texels keep no color
+            if (format == TEXTURE_BC1 && source.pixels[i + 3] < 128)
+                continue;
+
+            for (uint32 c = 0; c < channels; ++c)
+            {
+                const double delta = double(source.pixels[i + c]) - double(decoded.pixels[i + c]);
+                error += delta * delta;
+            }
+            count += channels;
+        }
+
+        const double mse = count ? error / double(count) : 0.0;
+        return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+    }
+
+    // a few dB under what the encoders reach on Detail, far above a broken layout
+    double MinimumPsnr(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TEXTURE_BC1: return 32.0;
+        case TEXTURE_BC3: return 30.0;
+        case TEXTURE_BC7: return 40.0;
+        case TEXTURE_ETC2: return 31.0;
+        default: return 99.0;
+        }
+    }
+}
+
+// the whole chain of a 1024x1024 sRGB texture
+static void BM_GenerateMips(benchmark::State & state)
+{
+    const MipFilter filter = MipFilter(state.range(0));
+
+    for (auto _ : state)
+    {
+        const std::vector<ImageData> levels = GenerateMips(Photo(), true, filter, &Pool());
+        benchmark::DoNotOptimize(levels.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * int64_t(Photo().width) * Photo().height);
+}
+BENCHMARK(BM_GenerateMips)->Arg(MIP_BOX)->Arg(MIP_KAISER)->Unit(benchmark::kMillisecond);
+
+// one level per format; ratio is what the GPU saves in memory and upload bandwidth
+static void BM_EncodeImage(benchmark::State & state)
+{
+    const TextureFormat format = TextureFormat(state.range(0));
+
+    std::vector<uint8> blocks;
+    for (auto _ : state)
+    {
+        blocks = EncodeImage(Photo(), format, &Pool());
+        benchmark::DoNotOptimize(blocks.data());
+    }
+
+    // a detailed image decoded again by the reference decoders, a quality drop fails the run
+    const std::vector<uint8> detail = EncodeImage(Detail(), format, &Pool());
+    ImageData decoded;
+    uint32 alphaErrors = 0;
+    if (!DecodeImage(detail, format, Detail().width, Detail().height, decoded))
+    {
+        state.SkipWithError("a block does not decode");
+        return;
+    }
+
+    const double psnr = Psnr(Detail(), decoded, format, alphaErrors);
+    if (psnr < MinimumPsnr(format) || alphaErrors > 0)
+        state.SkipWithError("the decoded image is below the format's quality bound");
+
+    state.counters["psnr"] = psnr;
+    state.counters["ratio"] = double(Photo().pixels.size()) / double(blocks.size());
+    state.SetItemsProcessed(state.iterations() * int64_t(Photo().width) * Photo().height);
+}
+BENCHMARK(BM_EncodeImage)->Arg(TEXTURE_BC1)->Arg(TEXTURE_BC3)->Arg(TEXTURE_BC7)->Arg(TEXTURE_ETC2)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,79 @@
+#include "TransformHierarchy.h"
+#include <benchmark/benchmark.h>
+
+using namespace Luna;
+using namespace Luna::Math;
+
+namespace
+{
+    constexpr uint32 NODE_COUNT = 100'000;
+
+    // 100 roots with four children each, every child with four more and so on,
+    // which gives a 5 level tree with the bulk of the nodes in the last levels
+    void Populate(TransformHierarchy & hierarchy)
+    {
+        std::vector<Node> previous, current;
+
+        for (uint32 i = 0; i < 100; ++i)
+            previous.push_back(hierarchy.Create(NULL_NODE, { float(i), 0, 0 }));
+
+        while (hierarchy.Count() < NODE_COUNT)
+        {
+            current.clear();
+            for (uint32 i = 0; i < previous.size() * 4 && hierarchy.Count() < NODE_COUNT; ++i)
+            {
+                const Quat rotation = Quat::AxisAngle({ 0, 1, 0 }, 0.01f * float(i));
+                current.push_back(hierarchy.Create(previous[i / 4], { 1, 0, 0 }, rotation));
+            }
+            previous.swap(current);
+        }
+
+        hierarchy.Update();
+    }
+
+    ThreadPool & Pool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}
+
+// worst case: every root moves, so the whole tree is recomputed
+static void BM_HierarchyUpdateAll(benchmark::State & state)
+{
+    TransformHierarchy hierarchy;
+    Populate(hierarchy);
+
+    float t = 0.0f;
+    for (auto _ : state)
+    {
+        t += 0.01f;
+        for (Node root = 0; root < 100; ++root)
+            hierarchy.Position(root, { float(root), t, 0 });
+
+        hierarchy.Update(state.range(0) ? &Pool() : nullptr);
+    }
+
+    state.SetItemsProcessed(state.iterations() * NODE_COUNT);
+}
+BENCHMARK(BM_HierarchyUpdateAll)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// one percent of the leaves animate, the rest of the tree stays clean
+static void BM_HierarchyUpdateSparse(benchmark::State & state)
+{
+    TransformHierarchy hierarchy;
+    Populate(hierarchy);
+
+    float t = 0.0f;
+    for (auto _ : state)
+    {
+        t += 0.01f;
+        for (Node node = NODE_COUNT - 1; node > NODE_COUNT - 1000; --node)
+            hierarchy.Rotation(node, Quat::AxisAngle({ 0, 0, 1 }, t));
+
+        hierarchy.Update();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_HierarchyUpdateSparse)->Unit(benchmark::kMicrosecond);
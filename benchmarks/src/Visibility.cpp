@@ -0,0 +1,97 @@
+#include "Visibility.h"
+#include <benchmark/benchmark.h>
+
+using namespace Luna;
+using namespace Luna::Math;
+
+namespace
+{
+    // objects scattered on a 1000 x 1000 plane, roughly a quarter inside the view
+    void Populate(Visibility & visibility, const uint32 count)
+    {
+        uint32 seed = 12345;
+        auto random = [&seed]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return float(seed >> 8) / float(1 << 24);
+        };
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const Vec3 center { random() * 1000.0f - 500.0f, random() * 10.0f, random() * 1000.0f - 500.0f };
+
+            if (i & 1)
+                visibility.AddBox(center - Vec3(1.0f), center + Vec3(1.0f));
+            else
+                visibility.AddSphere(center, 1.0f);
+        }
+
+        const Mat4 view = Mat4::LookAt({ 0, 5, 0 }, { 0, 5, -1 }, { 0, 1, 0 });
+        visibility.Camera(Mat4::Perspective(Radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f) * view);
+    }
+
+    ThreadPool & Pool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}
+
+static void BM_FrustumCull(benchmark::State & state)
+{
+    Visibility visibility;
+    Populate(visibility, uint32(state.range(0)));
+
+    for (auto _ : state)
+    {
+        visibility.Cull(state.range(1) ? &Pool() : nullptr);
+        benchmark::DoNotOptimize(visibility.VisibleCount());
+    }
+
+    state.counters["visible"] = visibility.VisibleCount();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrustumCull)
+    ->Args({ 100'000, 0 })->Args({ 100'000, 1 })
+    ->Args({ 1'000'000, 0 })->Args({ 1'000'000, 1 })
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// a row of walls in front of the camera hides most of the view
+static void BM_OcclusionCull(benchmark::State & state)
+{
+    Visibility visibility;
+    Populate(visibility, uint32(state.range(0)));
+
+    for (float x = -40.0f; x < 40.0f; x += 10.0f)
+        visibility.Occlusion()->RasterizeBox({ x, 0, -25 }, { x + 8.0f, 20, -24 });
+
+    for (auto _ : state)
+    {
+        visibility.Cull(state.range(1) ? &Pool() : nullptr);
+        benchmark::DoNotOptimize(visibility.VisibleCount());
+    }
+
+    state.counters["visible"] = visibility.VisibleCount();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OcclusionCull)
+    ->Args({ 100'000, 0 })->Args({ 100'000, 1 })
+    ->Args({ 1'000'000, 0 })->Args({ 1'000'000, 1 })
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+static void BM_OcclusionRasterize(benchmark::State & state)
+{
+    OcclusionBuffer buffer;
+    const Mat4 viewProj = Mat4::Perspective(Radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f)
+        * Mat4::LookAt({ 0, 5, 0 }, { 0, 5, -1 }, { 0, 1, 0 });
+
+    for (auto _ : state)
+    {
+        buffer.Clear(viewProj);
+        for (float x = -40.0f; x < 40.0f; x += 10.0f)
+            buffer.RasterizeBox({ x, 0, -25 }, { x + 8.0f, 20, -24 });
+
+        benchmark::DoNotOptimize(buffer.Data());
+    }
+}
+BENCHMARK(BM_OcclusionRasterize)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,189 @@
+#include "World.h"
+#include "Scheduler.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace Luna;
+
+namespace
+{
+    struct Position { float x, y, z; };
+    struct Velocity { float x, y, z; };
+    struct Health   { float value; };
+    struct Color    { uint32 rgba; };
+
+    constexpr uint32 ENTITY_COUNT = 1'000'000;
+    constexpr float DT = 1.0f / 60.0f;
+
+    // half of the entities carry an extra component so the queries
+    // have to walk more than one archetype
+    World & Populated()
+    {
+        static World * world = []()
+        {
+            auto * w = new World();
+            for (uint32 i = 0; i < ENTITY_COUNT; ++i)
+            {
+                const float f = static_cast<float>(i);
+                if (i & 1)
+                    w->Create(Position{ f, f, f }, Velocity{ 1, 2, 3 }, Health{ 100 });
+                else
+                    w->Create(Position{ f, f, f }, Velocity{ 1, 2, 3 }, Health{ 100 }, Color{ 0xffffffff });
+            }
+            return w;
+        }();
+
+        return *world;
+    }
+
+    ThreadPool & Pool()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}
+
+static void BM_CreateEntities(benchmark::State & state)
+{
+    for (auto _ : state)
+    {
+        World world;
+        for (uint32 i = 0; i < ENTITY_COUNT; ++i)
+            world.Create(Position{}, Velocity{});
+
+        benchmark::DoNotOptimize(world.Count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_CreateEntities)->Unit(benchmark::kMillisecond);
+
+// baseline: the same data as an array of structs, as a monolithic Game would keep it
+static void BM_ArrayOfStructs(benchmark::State & state)
+{
+    struct Object
+    {
+        Position position;
+        Velocity velocity;
+        Health health;
+        Color color;
+        float transform[16];
+    };
+
+    std::vector<Object> objects(ENTITY_COUNT);
+
+    for (auto _ : state)
+    {
+        for (auto & object : objects)
+        {
+            object.position.x += object.velocity.x * DT;
+            object.position.y += object.velocity.y * DT;
+            object.position.z += object.velocity.z * DT;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_ArrayOfStructs)->Unit(benchmark::kMillisecond);
+
+static void BM_QueryEach(benchmark::State & state)
+{
+    Query<Position, Velocity> query(&Populated());
+
+    for (auto _ : state)
+    {
+        query.Each([](Position & position, const Velocity & velocity)
+        {
+            position.x += velocity.x * DT;
+            position.y += velocity.y * DT;
+            position.z += velocity.z * DT;
+        });
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_QueryEach)->Unit(benchmark::kMillisecond);
+
+static void BM_QueryEachChunk(benchmark::State & state)
+{
+    Query<Health> query(&Populated());
+
+    for (auto _ : state)
+    {
+        query.EachChunk([](const uint32 count, const Entity *, Health * health)
+        {
+            for (uint32 i = 0; i < count; ++i)
+                health[i].value -= DT;
+        });
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_QueryEachChunk)->Unit(benchmark::kMillisecond);
+
+static void BM_QueryParallelEach(benchmark::State & state)
+{
+    Query<Position, Velocity> query(&Populated());
+
+    for (auto _ : state)
+    {
+        query.ParallelEach(&Pool(), [](Position & position, const Velocity & velocity)
+        {
+            position.x += velocity.x * DT;
+            position.y += velocity.y * DT;
+            position.z += velocity.z * DT;
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_QueryParallelEach)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Movement and Decay touch disjoint components and share a stage,
+// Tint reads Health written by Decay so it runs in the stage after
+static void BM_SchedulerUpdate(benchmark::State & state)
+{
+    World & world = Populated();
+    Scheduler scheduler(&world, &Pool());
+
+    Query<Position, Velocity> movement(&world);
+    Query<Health> decay(&world);
+    Query<Health, Color> tint(&world);
+
+    scheduler.Add("Movement", Reads<Velocity>(), Writes<Position>(), [&](World &, double dt)
+    {
+        movement.Each([dt](Position & position, const Velocity & velocity)
+        {
+            position.x += velocity.x * float(dt);
+            position.y += velocity.y * float(dt);
+            position.z += velocity.z * float(dt);
+        });
+    });
+
+    scheduler.Add("Decay", 0, Writes<Health>(), [&](World &, double dt)
+    {
+        decay.Each([dt](Health & health) { health.value -= float(dt); });
+    });
+
+    scheduler.Add("Tint", Reads<Health>(), Writes<Color>(), [&](World &, double)
+    {
+        tint.Each([](const Health & health, Color & color)
+        {
+            color.rgba = (color.rgba & 0x00ffffff) | (uint32(health.value) << 24);
+        });
+    });
+
+    state.counters["stages"] = scheduler.StageCount();
+
+    for (auto _ : state)
+        scheduler.Update(DT);
+
+    state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+}
+BENCHMARK(BM_SchedulerUpdate)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -1,13 +1,11 @@
 #pragma once
 
 #include "All.h"
-#include <DirectXMath.h>
-using namespace DirectX;
 
 namespace Luna
 {
-    using Position = XMFLOAT3;
-    using Color = XMFLOAT4;
+    using Position = Math::Vec3;
+    using Color = Math::Vec4;
 
     struct Vertex
     {
@@ -1,5 +1,4 @@
 #include "Triangle.h"
-#include <DirectXColors.h>
 
 namespace Luna
 {
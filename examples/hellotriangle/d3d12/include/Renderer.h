@@ -2,13 +2,11 @@
 
 #include "All.h"
 #include <d3dcommon.h>
-#include <DirectXMath.h>
-using namespace DirectX;
 
 namespace Luna
 {
-    using Position = XMFLOAT3;
-    using Color = XMFLOAT4;
+    using Position = Math::Vec3;
+    using Color = Math::Vec4;
 
     struct Vertex
     {
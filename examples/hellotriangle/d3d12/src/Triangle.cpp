@@ -1,7 +1,5 @@
 #include "Triangle.h"
 
-#include <DirectXColors.h>
-
 namespace Luna
 {
     void Triangle::Init()
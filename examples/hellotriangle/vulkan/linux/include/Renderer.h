@@ -0,0 +1,40 @@
+#pragma once
+
+#include "All.h"
+#include "Mesh.h"
+
+namespace Luna
+{
+    using Position = Math::Vec3;
+    using Color = Math::Vec4;
+
+    struct Vertex
+    {
+        Position position;
+        Color color;
+    };
+
+    class Renderer final
+    {
+    private:
+        Graphics                * graphics;
+        Mesh                    * geometry;
+        ThreadPool              * threadPool;
+
+        VkPipeline                pipeline;
+        VkPipelineLayout          pipelineLayout;
+        std::future<VkPipeline>   pending;
+
+        VkPipeline CreatePipeline() const;
+
+    public:
+        explicit Renderer() noexcept;
+        ~Renderer();
+
+        void Initialize(Graphics * graphics, Mesh * geometry, ThreadPool * threadPool);
+
+        // rebuilds the pipeline from the shaders on disk, drawing goes on with the old one meanwhile
+        void Reload();
+        VkPipeline Pipeline();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "All.h"
+#include "Renderer.h"
+
+namespace Luna
+{
+    class Triangle final : public Game
+    {
+    private:
+        Renderer* renderer;
+        Mesh* geometry;
+
+    public:
+        void Init() override;
+        void Update() override;
+        void Finalize() override;
+        void Draw() override;
+
+        void BuildGeometry();
+    };
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "Triangle.h"
+#include "Utils.h"
+
+namespace Luna
+{
+    void Triangle::Init()
+    {
+        renderer = new Renderer();
+        geometry = new Mesh("Triangle");
+        BuildGeometry();
+    }
+
+    void Triangle::Update()
+    {
+        if(input->KeyDown(VK_ESCAPE))
+            window->Close();
+    }
+
+    void Triangle::Draw()
+    {
+        // the engine begins the render pass before Draw and presents after it
+        vkCmdBindPipeline(graphics->CommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->Pipeline());
+
+        VkDeviceSize offset{};
+        vkCmdBindVertexBuffers(graphics->CommandBuffer(), 0, 1, &geometry->vertexBuffer, &offset);
+
+        vkCmdDraw(graphics->CommandBuffer(), geometry->vertexCount, 1, 0, 0);
+    }
+
+    void Triangle::Finalize()
+    {
+        SafeDelete(renderer);
+        SafeDelete(geometry);
+    }
+
+    void Triangle::BuildGeometry()
+    {
+        constexpr Vertex vertices[]
+        {
+            { Position(0.0f, -0.5f, 0.0f), Color(Colors::Red) },
+            { Position(-0.5f, 0.5f, 0.0f), Color(Colors::Orange) },
+            { Position(0.5f, 0.5f, 0.0f), Color(Colors::Yellow) }
+        };
+
+        // the copy to the device local buffer happens with the first frame
+        graphics->Upload(geometry, vertices, Countof(vertices), sizeof(Vertex));
+
+        renderer->Initialize(graphics, geometry, threadPool);
+
+        // saving a recompiled .spv swaps the pipeline without a restart
+        watcher->Watch("Shaders", [this](const string & path)
+        {
+            if (path.ends_with(".spv"))
+                renderer->Reload();
+        });
+    }
+}
@@ -0,0 +1,61 @@
+#include "Triangle.h"
+#include "VkError.h"
+#include "MessageBox.h"
+
+// --headless [summary.json] runs 600 frames without a display and writes the PerfSummary
+static Luna::Engine * CreateEngine(int argc, char ** argv)
+{
+    using namespace Luna;
+
+    if (argc > 1 && string_view(argv[1]) == "--headless")
+        return new Engine(HeadlessConfig{ .frames = 600, .summary = argc > 2 ? argv[2] : "" });
+
+    return new Engine();
+}
+
+int main(int argc, char ** argv)
+{
+    using namespace Luna;
+
+#ifdef _DEBUG
+
+    try
+    {
+        Engine * engine = CreateEngine(argc, argv);
+        engine->window->Mode(WINDOWED);
+        engine->window->Size(800, 600);
+        engine->window->Color("#007acc");
+        engine->window->Title("Triangle");
+        engine->window->LostFocus(Engine::Pause);
+        engine->window->InFocus(Engine::Resume);
+
+        int exit = engine->Start(new Triangle());
+
+        delete engine;
+
+        return exit;
+    }
+    catch (const VkError & e)
+    {
+        MessageBox("Triangle", e.ToString().c_str());
+        return 0;
+    }
+
+#else
+
+    Engine * engine = CreateEngine(argc, argv);
+    engine->window->Mode(WINDOWED);
+    engine->window->Size(800, 600);
+    engine->window->Color("#007acc");
+    engine->window->Title("Triangle");
+    engine->window->LostFocus(Engine::Pause);
+    engine->window->InFocus(Engine::Resume);
+
+    int exit = engine->Start(new Triangle());
+
+    delete engine;
+
+    return exit;
+
+#endif
+}
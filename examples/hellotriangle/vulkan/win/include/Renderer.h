@@ -2,12 +2,11 @@
 
 #include "All.h"
 #include "Mesh.h"
-#include <glm/glm.hpp>
 
 namespace Luna
 {
-    using Position = glm::vec3;
-    using Color = glm::vec4;
+    using Position = Math::Vec3;
+    using Color = Math::Vec4;
 
     struct Vertex
     {
@@ -20,18 +19,22 @@ namespace Luna
     private:
         Graphics                * graphics;
         Mesh                    * geometry;
+        ThreadPool              * threadPool;
 
         VkPipeline                pipeline;
         VkPipelineLayout          pipelineLayout;
+        std::future<VkPipeline>   pending;
+
+        VkPipeline CreatePipeline() const;
 
     public:
         explicit Renderer() noexcept;
         ~Renderer();
 
-        void Initialize(Graphics * graphics, Mesh * geometry);
-        VkPipeline Pipeline() const noexcept;
-    };
+        void Initialize(Graphics * graphics, Mesh * geometry, ThreadPool * threadPool);
 
-    inline VkPipeline Renderer::Pipeline() const noexcept
-    { return pipeline; }
+        // rebuilds the pipeline from the shaders on disk, drawing goes on with the old one meanwhile
+        void Reload();
+        VkPipeline Pipeline();
+    };
 }
\ No newline at end of file
@@ -1,18 +1,13 @@
 #include "Renderer.h"
 #include "VkError.h"
 #include "Utils.h"
-#include <fstream>
-#include <vector>
-#include <filesystem>
-using std::ios;
 
 namespace Luna
 {
-    namespace fs = std::filesystem;
-
     Renderer::Renderer() noexcept
         : graphics{nullptr},
         geometry{nullptr},
+        threadPool{nullptr},
         pipeline{nullptr},
         pipelineLayout{nullptr}
     {
@@ -21,63 +16,49 @@ namespace Luna
 
     Renderer::~Renderer()
     {
+        // the pipeline may still be compiling on a worker
+        if (pending.valid())
+        {
+            graphics->Retire(pipeline);
+            pipeline = pending.get();
+        }
+
         vkDeviceWaitIdle(graphics->Device());
 
         vkDestroyPipelineLayout(graphics->Device(), pipelineLayout, nullptr);
         vkDestroyPipeline(graphics->Device(), pipeline, nullptr);
     }
 
-    static fs::path GetShaderPath(const string_view filename)
-    {
-        char exePath[MAX_PATH];
-        GetModuleFileNameA(nullptr, exePath, MAX_PATH);
-        
-        fs::path exeDir = fs::path(exePath).parent_path();
-        fs::path shaderPath = exeDir / filename.data();
-        
-        return shaderPath;
-    }
-
-    static VkShaderModule CreateShaderModule(VkDevice device, const string_view filename)
+    void Renderer::Initialize(Graphics* graphics, Mesh * geometry, ThreadPool * threadPool)
     {
-        const fs::path shaderPath = GetShaderPath(filename);
-        std::ifstream file(shaderPath.c_str(), ios::ate | ios::binary);
-
-        if (!file.is_open() || file.tellg() <= 0)
-            VkThrowIfFailure(VK_ERROR_INITIALIZATION_FAILED, "Shader not found or empty: " + shaderPath.string());
-
-        const auto size = file.tellg();
-        std::vector<char> fileBytes(static_cast<size_t>(size));
-        file.seekg(0, ios::beg);
-        file.read(fileBytes.data(), size);
-        file.close();
+        this->graphics = graphics;
+        this->geometry = geometry;
+        this->threadPool = threadPool;
 
-        VkShaderModuleCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = size;
-        createInfo.pCode = reinterpret_cast<uint32*>(fileBytes.data());
+        VkPipelineLayoutCreateInfo layoutCreateInfo{};
+        layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutCreateInfo.setLayoutCount = 0;
+        layoutCreateInfo.pSetLayouts = nullptr;
 
-        VkShaderModule shaderModule;
-        VkThrowIfFailed(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule));
+        VkThrowIfFailed(vkCreatePipelineLayout(graphics->Device(), &layoutCreateInfo, nullptr, &pipelineLayout));
 
-        return shaderModule;
+        // shaders are loaded and compiled on a worker while the game starts,
+        // later launches mostly hit the pipeline cache
+        pending = threadPool->Submit([this] { return CreatePipeline(); });
     }
 
-    void Renderer::Initialize(Graphics* graphics, Mesh * geometry)
+    VkPipeline Renderer::CreatePipeline() const
     {
-        this->graphics = graphics;
-        this->geometry = geometry;
-
         // -----------------------------------------------------------
-        // Pipeline layout
+        // Pipeline state
         // -----------------------------------------------------------
 
         // --------------------
         // ----- Shaders ------
         // --------------------
 
-        VkShaderModule vertexShaderModule = CreateShaderModule(graphics->Device(), "Shaders/Vertex.spv");
-        VkShaderModule fragmentShaderModule = CreateShaderModule(graphics->Device(), "Shaders/Fragment.spv");
+        VkShaderModule vertexShaderModule = graphics->CreateShaderModule("Shaders/Vertex.spv");
+        VkShaderModule fragmentShaderModule = graphics->CreateShaderModule("Shaders/Fragment.spv");
 
         VkPipelineShaderStageCreateInfo vertexShaderCreateInfo{};
         vertexShaderCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -123,7 +104,7 @@ namespace Luna
         vertexInputAttributeDescription[1].binding = 0;
         vertexInputAttributeDescription[1].location = 1;
         vertexInputAttributeDescription[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        vertexInputAttributeDescription[1].offset = sizeof(float) * geometry->vertexCount;
+        vertexInputAttributeDescription[1].offset = offsetof(Vertex, color);
 
         VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo{};
         vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -183,17 +164,6 @@ namespace Luna
         colorBlendCreateInfo.attachmentCount = 1;
         colorBlendCreateInfo.pAttachments = &colorBlendAttachmentState;
 
-        // ---------------------
-        // -- Pipeline Layout --
-        // ---------------------
-
-        VkPipelineLayoutCreateInfo layoutCreateInfo{};
-        layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        layoutCreateInfo.setLayoutCount = 0;
-        layoutCreateInfo.pSetLayouts = nullptr;
-
-        VkThrowIfFailed(vkCreatePipelineLayout(graphics->Device(), &layoutCreateInfo, nullptr, &pipelineLayout));
-
         // -------------------------
         // --- Graphics Pipeline ---
         // -------------------------
@@ -212,9 +182,36 @@ namespace Luna
         pipelineCreateInfo.renderPass = graphics->RenderPass();
         pipelineCreateInfo.subpass = 0;
 
-        VkThrowIfFailed(vkCreateGraphicsPipelines(graphics->Device(), nullptr, 1, &pipelineCreateInfo, nullptr, &pipeline));
+        VkPipeline created = graphics->CreatePipeline(pipelineCreateInfo);
 
         vkDestroyShaderModule(graphics->Device(), vertexShaderModule, nullptr);
         vkDestroyShaderModule(graphics->Device(), fragmentShaderModule, nullptr);
+
+        return created;
+    }
+
+    void Renderer::Reload()
+    {
+        // one rebuild at a time, a second save while compiling waits for the first
+        if (pending.valid())
+        {
+            graphics->Retire(pipeline);
+            pipeline = pending.get();
+        }
+
+        pending = threadPool->Submit([this] { return CreatePipeline(); });
+    }
+
+    VkPipeline Renderer::Pipeline()
+    {
+        // blocks only if the first frame is drawn before the worker is done,
+        // a reloaded pipeline is swapped in once it is ready
+        if (pending.valid() && (!pipeline || pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready))
+        {
+            graphics->Retire(pipeline);
+            pipeline = pending.get();
+        }
+
+        return pipeline;
     }
 }
\ No newline at end of file
@@ -1,7 +1,5 @@
 #include "Triangle.h"
-#include "Colors.h"
 #include "Utils.h"
-using namespace glm;
 
 namespace Luna
 {
@@ -20,7 +18,9 @@ namespace Luna
 
     void Triangle::Display()
     {
-        graphics->Clear();
+        // minimized windows have nothing to draw to
+        if (!graphics->Clear())
+            return;
 
         vkCmdBindPipeline(graphics->CommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->Pipeline());
 
@@ -29,9 +29,6 @@ namespace Luna
 
         vkCmdDraw(graphics->CommandBuffer(), geometry->vertexCount, 1, 0, 0);
 
-        vkCmdEndRenderPass(graphics->CommandBuffer());
-        vkEndCommandBuffer(graphics->CommandBuffer());
-
         graphics->Present();
     }
 
@@ -50,35 +47,16 @@ namespace Luna
             { Position(0.5f, 0.5f, 0.0f), Color(Colors::Yellow) }
         };
 
-        geometry->vertexCount = Countof(vertices);
-        geometry->vertexBufferSize = sizeof(Vertex) * geometry->vertexCount;
-        geometry->device = graphics->Device();
-
-        graphics->Allocate(
-            geometry->vertexBufferSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &geometry->vertexUploadBuffer.buffer,
-            &geometry->vertexUploadBuffer.memory
-        );
-
-        graphics->Copy(vertices, geometry->vertexBufferSize, geometry->vertexUploadBuffer.memory);
+        // the copy to the device local buffer happens with the first frame
+        graphics->Upload(geometry, vertices, Countof(vertices), sizeof(Vertex));
 
-        graphics->Allocate(
-            geometry->vertexBufferSize,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &geometry->vertexBuffer,
-            &geometry->vertexBufferMemory
-        );
+        renderer->Initialize(graphics, geometry, threadPool);
 
-        graphics->Copy(geometry->vertexBuffer, geometry->vertexUploadBuffer.buffer, geometry->vertexBufferSize);
-
-        vkDestroyBuffer(graphics->Device(), geometry->vertexUploadBuffer.buffer, nullptr);
-        vkFreeMemory(graphics->Device(), geometry->vertexUploadBuffer.memory, nullptr);
-        geometry->vertexUploadBuffer.buffer = nullptr;
-        geometry->vertexUploadBuffer.memory = nullptr;
-
-        renderer->Initialize(graphics, geometry);
+        // saving a recompiled .spv swaps the pipeline without a restart
+        watcher->Watch("Shaders", [this](const string & path)
+        {
+            if (path.ends_with(".spv"))
+                renderer->Reload();
+        });
     }
 }
\ No newline at end of file
@@ -2,7 +2,18 @@
 #include "Resource.h"
 #include "MessageBox.h"
 
-int main()
+// --headless [summary.json] runs 600 frames without a display and writes the PerfSummary
+static Luna::Engine * CreateEngine(int argc, char ** argv)
+{
+    using namespace Luna;
+
+    if (argc > 1 && string_view(argv[1]) == "--headless")
+        return new Engine(HeadlessConfig{ .frames = 600, .summary = argc > 2 ? argv[2] : "" });
+
+    return new Engine();
+}
+
+int main(int argc, char ** argv)
 {
     using namespace Luna;
 
@@ -10,7 +21,7 @@ int main()
 
     try
     {
-        Engine * engine = new Engine();
+        Engine * engine = CreateEngine(argc, argv);
         engine->window->Mode(WINDOWED);
         engine->window->Size(800, 600);
         engine->window->Color("#007acc");
@@ -34,7 +45,7 @@ int main()
 
 #else
 
-    Engine * engine = new Engine();
+    Engine * engine = CreateEngine(argc, argv);
     engine->window->Mode(WINDOWED);
     engine->window->Size(800, 600);
     engine->window->Color("#007acc");
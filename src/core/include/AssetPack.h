@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include <span>
+#include <vector>
+
+namespace Luna
+{
+    constexpr uint32 PACK_MAGIC = 0x4B41504C;       // "LPAK"
+    constexpr uint32 PACK_VERSION = 1;
+    constexpr uint32 PACK_ALIGNMENT = 16;           // of every entry's data, enough for SPIR-V and SIMD loads
+    constexpr uint32 PACK_EMPTY_BUCKET = 0xFFFFFFFF;
+
+    enum PackCompression : uint32 { PACK_NONE, PACK_LZ4, PACK_ZSTD };
+
+    // File layout: header, bucketCount bucket indices, entryCount entries,
+    // names, then the data of each entry at a PACK_ALIGNMENT boundary.
+    // Buckets are an open addressing table of entry indices on the name hash.
+    struct PackHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 entryCount;
+        uint32 bucketCount;                         // power of two, at least twice entryCount
+        uint64 namesOffset;
+        uint64 namesSize;
+    };
+
+    struct PackEntry
+    {
+        uint64 hash;
+        uint64 offset;                              // from the start of the file
+        uint64 size;                                // stored bytes
+        uint64 rawSize;                             // bytes after decompression
+        uint32 nameOffset;                          // into the names, not null terminated
+        uint32 nameLength;
+        uint32 compression;
+        uint32 reserved;
+    };
+
+    // Read only view of a pack made by Build. The file is mapped once and
+    // uncompressed entries are returned as spans into the mapping, valid until
+    // Close. Names use forward slashes and are relative to the packed directory.
+    class DLL AssetPack
+    {
+    private:
+        const uint8       * data;
+        uint64              size;
+        const PackHeader  * header;
+        const uint32      * buckets;
+        const PackEntry   * entries;
+        const char        * names;
+
+    #ifdef _WIN32
+        void              * file;
+        void              * mapping;
+    #endif
+
+        bool Validate() const noexcept;
+
+    public:
+        explicit AssetPack() noexcept;
+        ~AssetPack() noexcept;
+
+        AssetPack(const AssetPack &) = delete;
+        AssetPack & operator=(const AssetPack &) = delete;
+
+        bool Open(const string_view path);
+        void Close() noexcept;
+
+        // nullptr when the name is not in the pack
+        const PackEntry * Find(const string_view name) const noexcept;
+
+        // empty for compressed entries, use Read for those
+        std::span<const uint8> View(const PackEntry * entry) const noexcept;
+        std::span<const uint8> View(const string_view name) const noexcept;
+
+        // copies or decompresses the entry, false when its codec was not built in
+        bool Read(const PackEntry * entry, std::vector<uint8> & output) const;
+
+        string_view Name(const PackEntry * entry) const noexcept;
+        std::span<const PackEntry> Entries() const noexcept;
+        bool IsOpen() const noexcept;
+
+        static uint64 Hash(const string_view name) noexcept;
+        static bool Supports(const PackCompression compression) noexcept;
+
+        // packs every file under directory, what luna_pack runs at build time
+        static bool Build(const string_view directory, const string_view output, const PackCompression codec = PACK_NONE);
+    };
+
+    inline std::span<const uint8> AssetPack::View(const string_view name) const noexcept
+    { return View(Find(name)); }
+
+    inline string_view AssetPack::Name(const PackEntry * entry) const noexcept
+    { return { names + entry->nameOffset, entry->nameLength }; }
+
+    inline std::span<const PackEntry> AssetPack::Entries() const noexcept
+    { return { entries, header ? header->entryCount : 0 }; }
+
+    inline bool AssetPack::IsOpen() const noexcept
+    { return data != nullptr; }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "SpriteBatch.h"
+#include <vector>
+
+namespace Luna
+{
+    // CPU render target for platforms without a graphics backend. Pixels are
+    // 0xAARRGGBB, which is the XRGB8888 layout expected by X11 and wl_shm,
+    // and sprites are alpha blended into it with SSE/AVX2.
+    class DLL Canvas
+    {
+    private:
+        struct Image
+        {
+            uint32 width;
+            uint32 height;
+            std::vector<uint32> pixels;
+        };
+
+        uint32                  width;
+        uint32                  height;
+        std::vector<uint32>     pixels;
+        std::vector<Image>      textures;
+        std::vector<uint32>     row;
+        std::vector<int32>      columns;
+
+        void DrawSprite(const Image & image, const SpriteInstance & sprite) noexcept;
+
+    public:
+        explicit Canvas(const uint32 width, const uint32 height);
+
+        void Resize(const uint32 width, const uint32 height);
+        uint32 Texture(const uint32 * pixels, const uint32 width, const uint32 height);
+
+        // replaces a texture's pixels, the size may change
+        void Update(const uint32 texture, const uint32 * pixels, const uint32 width, const uint32 height);
+
+        void Clear(const uint32 color) noexcept;
+        void Draw(const SpriteBatch & batch) noexcept;
+
+        uint32 Width() const noexcept;
+        uint32 Height() const noexcept;
+        const uint32 * Pixels() const noexcept;
+    };
+
+    // dst = src * tint * alpha + dst * (1 - alpha), for a row of pixels
+    DLL void BlendRow(uint32 * dst, const uint32 * src, const uint32 count, const uint32 tint) noexcept;
+
+    inline uint32 Canvas::Width() const noexcept
+    { return width; }
+
+    inline uint32 Canvas::Height() const noexcept
+    { return height; }
+
+    inline const uint32 * Canvas::Pixels() const noexcept
+    { return pixels.data(); }
+}
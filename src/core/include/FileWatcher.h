@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Luna
+{
+    struct FileWatch
+    {
+        uint32 id;
+        int handle;                         // inotify watch of the directory, -1 when polled
+        string directory;
+        string file;                        // empty watches every file in the directory
+        std::function<void(const string & path)> changed;
+    };
+
+    // Calls back when watched files are written, created or renamed into place.
+    // On Linux the directories are watched with inotify; Handle can join a poll
+    // set and Update never blocks. Elsewhere Update compares modification times
+    // a few times a second. A change is reported once it has been quiet for the
+    // debounce time, so editors that save in several steps reload only once.
+    class DLL FileWatcher
+    {
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Change
+        {
+            Clock::time_point last;
+            std::vector<uint32> watches;
+        };
+
+        int                                 inotify;
+        std::vector<FileWatch>              watches;
+        std::unordered_map<string, Change>  changes;            // by full path
+        std::unordered_map<string, int64>   times;              // polled modification times
+        Clock::time_point                   polled;
+        double                              debounce;
+        uint32                              nextId;
+
+        void Touch(const string & path, const FileWatch & watch, const Clock::time_point now);
+        void Read(const Clock::time_point now);
+        void Poll(const Clock::time_point now);
+
+    public:
+        explicit FileWatcher() noexcept;
+        ~FileWatcher() noexcept;
+
+        FileWatcher(const FileWatcher &) = delete;
+        FileWatcher & operator=(const FileWatcher &) = delete;
+
+        // a file or a directory, relative paths start at the executable directory;
+        // 0 when the directory does not exist
+        uint32 Watch(const string_view path, std::function<void(const string & path)> changed);
+        void Unwatch(const uint32 id);
+
+        void Debounce(const double seconds) noexcept;
+
+        // runs the callbacks of settled changes on the calling thread, returns how many ran
+        uint32 Update();
+
+        // readable when events are waiting, -1 without inotify
+        int Handle() const noexcept;
+    };
+
+    inline void FileWatcher::Debounce(const double seconds) noexcept
+    { debounce = seconds; }
+
+    inline int FileWatcher::Handle() const noexcept
+    { return inotify; }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Math.h"
+#include "SpriteBatch.h"
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Luna
+{
+    constexpr uint32 FONT_ATLAS_WIDTH = 1024;
+    constexpr uint32 FONT_ATLAS_MAX_HEIGHT = 4096;
+    constexpr uint32 FONT_RUN_CACHE = 1024;         // shaped runs kept per generation
+
+    struct Glyph
+    {
+        uint16 x, y;                                // top left in the atlas, in pixels
+        uint16 width, height;
+        int16 left, top;                            // bitmap corner from the pen, top is above the baseline
+        float advance;
+    };
+
+    // a shaped UTF-8 run: glyph indices and pen positions from the top left of its box
+    struct TextRun
+    {
+        std::vector<uint32> glyphs;
+        std::vector<Math::Vec2> pens;
+        Math::Vec2 size;
+    };
+
+    struct FontFace;
+
+    // FreeType glyphs rasterized on first use into an atlas packed with a skyline,
+    // which grows downwards and starts over once it is full. Texels are white with
+    // the coverage in alpha, so the same uint32 pixels are 0xAARRGGBB for the
+    // Canvas and RGBA8 for the GPU. Shaped runs are cached by their text, and
+    // drawing a cached run is one sprite per glyph into a SpriteBatch.
+    class DLL Font
+    {
+    private:
+        struct SkylineNode
+        {
+            uint32 x;
+            uint32 y;
+            uint32 width;
+        };
+
+        // looks runs up by string_view, a cached run costs no allocation
+        struct TextHash
+        {
+            using is_transparent = void;
+            size_t operator()(const string_view text) const noexcept
+            { return std::hash<string_view>{}(text); }
+        };
+
+        using RunCache = std::unordered_map<string, TextRun, TextHash, std::equal_to<>>;
+
+        FontFace                                  * face;
+        uint32                                      pixelSize;
+        float                                       ascender;
+        float                                       lineHeight;
+
+        std::vector<uint32>                         atlas;
+        uint32                                      atlasHeight;
+        std::vector<SkylineNode>                    skyline;
+        uint32                                      dirtyFirst;
+        uint32                                      dirtyEnd;
+
+        std::vector<Glyph>                          glyphs;
+        uint32                                      ascii[128];         // glyph index + 1, 0 until rasterized
+        std::unordered_map<uint32, uint32>          others;
+        RunCache                                    runs;
+        RunCache                                    previousRuns;
+
+        bool Pack(const uint32 width, const uint32 height, uint32 & x, uint32 & y);
+        void Reset();
+        uint32 Rasterize(const uint32 codepoint);
+        uint32 Find(const uint32 codepoint);
+
+    public:
+        explicit Font() noexcept;
+        ~Font() noexcept;
+
+        Font(const Font &) = delete;
+        Font & operator=(const Font &) = delete;
+
+        // false without FreeType or when the file is not a font
+        bool Load(const string_view path, const uint32 pixelSize);
+
+        const TextRun & Shape(const string_view text);
+        Math::Vec2 Measure(const string_view text);
+
+        // position is the top left of the first line, texture the atlas in the renderer
+        void Draw(SpriteBatch & batch,
+            const uint32 texture,
+            const string_view text,
+            const Math::Vec2 & position,
+            const uint32 color = 0xffffffff,
+            const uint8 layer = 0);
+
+        // rows written since the last call, for the renderer to upload; false when none.
+        // When AtlasHeight changed, the texture is recreated and every row comes back.
+        bool Dirty(uint32 & firstRow, uint32 & rowCount) noexcept;
+
+        // uv of an opaque white texel, a sprite with it is a solid rectangle of its color
+        Math::Vec4 Solid() const noexcept;
+
+        const uint32 * Atlas() const noexcept;
+        uint32 AtlasWidth() const noexcept;
+        uint32 AtlasHeight() const noexcept;
+        float LineHeight() const noexcept;
+    };
+
+    // next code point of a UTF-8 string, U+FFFD for malformed bytes
+    DLL uint32 DecodeUtf8(const string_view text, size_t & position) noexcept;
+
+    inline Math::Vec4 Font::Solid() const noexcept
+    { return Math::Vec4{ 1.0f / FONT_ATLAS_WIDTH, 1.0f / atlasHeight, 1.0f / FONT_ATLAS_WIDTH, 1.0f / atlasHeight }; }
+
+    inline const uint32 * Font::Atlas() const noexcept
+    { return atlas.data(); }
+
+    inline uint32 Font::AtlasWidth() const noexcept
+    { return FONT_ATLAS_WIDTH; }
+
+    inline uint32 Font::AtlasHeight() const noexcept
+    { return atlasHeight; }
+
+    inline float Font::LineHeight() const noexcept
+    { return lineHeight; }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Profiler.h"
+#include <string>
+#include <vector>
+
+namespace Luna
+{
+    // A run without a display: no window events or input, a fixed time step, and
+    // a summary of the frames written at exit. Frame and duration limits both
+    // apply when set, the first one reached ends the run.
+    struct HeadlessConfig
+    {
+        uint32 frames = 1000;                       // 0 for no limit
+        double duration = 0.0;                      // simulated seconds, 0 for no limit
+        double frameTime = 1.0 / 60.0;              // the dt every frame gets, in seconds
+        string summary;                             // JSON file, stdout when empty
+    };
+
+    // Wall time of every frame and the profiler zones averaged over the run,
+    // written as JSON for CI to compare between builds.
+    class DLL PerfSummary
+    {
+    private:
+        struct Zone
+        {
+            string name;
+            uint32 depth;
+            uint32 count;
+            double cpu;
+            double gpu;
+            double cpuMax;
+        };
+
+        std::vector<float>  frameTimes;             // milliseconds
+        std::vector<Zone>   zones;
+        uint64              reportFrame;
+
+    public:
+        explicit PerfSummary() noexcept;
+
+        void Frame(const double milliseconds, const FrameReport & report);
+
+        string Json() const;
+        bool Write(const string_view path) const;
+    };
+}
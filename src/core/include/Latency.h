@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include <array>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Luna
+{
+    // where a tagged input event is seen on its way to the screen
+    enum LatencyStage
+    {
+        LATENCY_SENT,                               // injected, or the compositor's event time
+        LATENCY_RECEIVED,                           // read from the queue and through InputProc
+        LATENCY_UPDATE,                             // Update of the first frame after it
+        LATENCY_DRAW,
+        LATENCY_PRESENT,                            // that frame handed to the presentation engine
+        LATENCY_DISPLAYED,                          // on screen, from presentation feedback
+        LATENCY_STAGES
+    };
+
+    struct LatencyConfig
+    {
+        uint32 samples = 300;                       // events measured before the run ends
+        uint32 interval = 10;                       // frames between injected events
+        string report;                              // JSON file, stdout when empty
+    };
+
+    // Follows input events from injection to the screen. The engine tags one
+    // synthetic key press at a time, stamps it at every stage of the frame that
+    // picks it up, and matches presentation feedback to frames in the order they
+    // were presented: each presented frame gets exactly one Displayed or Discarded.
+    // All times are nanoseconds of CLOCK_MONOTONIC, the clock of X Present and
+    // of wp_presentation (QueryPerformanceCounter on Windows).
+    class DLL LatencyProbe
+    {
+    private:
+        struct Tag
+        {
+            uint64 frame;                           // 0 until a frame picks it up
+            uint64 stamps[LATENCY_STAGES];
+        };
+
+        enum Feedback { FEEDBACK_UNKNOWN, FEEDBACK_ON, FEEDBACK_OFF };
+
+        LatencyConfig                               config;
+        std::vector<Tag>                            tags;
+        std::deque<uint64>                          presented;      // frames waiting for feedback
+        std::vector<std::array<float, LATENCY_STAGES>> samples;     // milliseconds from LATENCY_SENT
+        uint64                                      frame;
+        uint64                                      lastSent;
+        uint32                                      lost;
+        Feedback                                    feedback;
+
+        void Complete(const Tag & tag);
+
+    public:
+        explicit LatencyProbe(const LatencyConfig & config);
+
+        // whether the engine should inject the next event this frame
+        bool Due() const noexcept;
+        bool Done() const noexcept;
+
+        void Sent(const uint64 time = Now());
+        // false when no tagged event is waiting, the event was a real one
+        bool Received(const uint64 time = Now());
+        // an event the probe did not inject, sent at the compositor's time
+        void Arrived(const uint64 sent, const uint64 time = Now());
+
+        void Stage(const LatencyStage stage, const uint64 time = Now());
+        void Displayed(const uint64 time);
+        void Discarded();
+
+        string Json(const string_view backend) const;
+        bool Write(const string_view backend) const;
+
+        static uint64 Now() noexcept;
+    };
+
+    inline bool LatencyProbe::Done() const noexcept
+    { return samples.size() >= config.samples; }
+}
@@ -0,0 +1,410 @@
+#pragma once
+
+#include "Types.h"
+#include <cmath>
+#include <type_traits>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+    #define LUNA_MATH_AVX2
+#endif
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+    #define LUNA_MATH_SSE4
+#endif
+
+// every x86-64 target, for kernels that only need 4-wide float math
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define LUNA_MATH_SSE2
+#endif
+
+#if defined(LUNA_MATH_SSE2) || defined(LUNA_MATH_SSE4) || defined(LUNA_MATH_AVX2)
+    #include <immintrin.h>
+#endif
+
+// Vector types are plain floats without padding, so they can be used directly
+// as vertex attributes and in constant buffers. SIMD registers only live inside
+// the functions. Every function is constexpr: the SIMD paths are skipped when
+// the compiler evaluates them at compile time.
+namespace Luna::Math
+{
+    constexpr float PI = 3.14159265358979323846f;
+
+    constexpr float Radians(const float degrees) noexcept
+    { return degrees * (PI / 180.0f); }
+
+    constexpr float Degrees(const float radians) noexcept
+    { return radians * (180.0f / PI); }
+
+    // ---------------------------------------------------
+    // Vec2
+    // ---------------------------------------------------
+
+    struct Vec2
+    {
+        float x, y;
+
+        constexpr Vec2() noexcept : x{}, y{} {}
+        constexpr Vec2(const float s) noexcept : x{s}, y{s} {}
+        constexpr Vec2(const float x, const float y) noexcept : x{x}, y{y} {}
+    };
+
+    constexpr Vec2 operator+(const Vec2 & a, const Vec2 & b) noexcept
+    { return { a.x + b.x, a.y + b.y }; }
+
+    constexpr Vec2 operator-(const Vec2 & a, const Vec2 & b) noexcept
+    { return { a.x - b.x, a.y - b.y }; }
+
+    constexpr Vec2 operator*(const Vec2 & a, const Vec2 & b) noexcept
+    { return { a.x * b.x, a.y * b.y }; }
+
+    constexpr Vec2 operator*(const Vec2 & a, const float s) noexcept
+    { return { a.x * s, a.y * s }; }
+
+    constexpr float Dot(const Vec2 & a, const Vec2 & b) noexcept
+    { return a.x * b.x + a.y * b.y; }
+
+    // ---------------------------------------------------
+    // Vec3
+    // ---------------------------------------------------
+
+    struct Vec3
+    {
+        float x, y, z;
+
+        constexpr Vec3() noexcept : x{}, y{}, z{} {}
+        constexpr Vec3(const float s) noexcept : x{s}, y{s}, z{s} {}
+        constexpr Vec3(const float x, const float y, const float z) noexcept : x{x}, y{y}, z{z} {}
+    };
+
+    constexpr Vec3 operator+(const Vec3 & a, const Vec3 & b) noexcept
+    { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+
+    constexpr Vec3 operator-(const Vec3 & a, const Vec3 & b) noexcept
+    { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+
+    constexpr Vec3 operator-(const Vec3 & a) noexcept
+    { return { -a.x, -a.y, -a.z }; }
+
+    constexpr Vec3 operator*(const Vec3 & a, const Vec3 & b) noexcept
+    { return { a.x * b.x, a.y * b.y, a.z * b.z }; }
+
+    constexpr Vec3 operator*(const Vec3 & a, const float s) noexcept
+    { return { a.x * s, a.y * s, a.z * s }; }
+
+    constexpr Vec3 operator*(const float s, const Vec3 & a) noexcept
+    { return { a.x * s, a.y * s, a.z * s }; }
+
+    constexpr Vec3 operator/(const Vec3 & a, const float s) noexcept
+    { return a * (1.0f / s); }
+
+    constexpr Vec3 & operator+=(Vec3 & a, const Vec3 & b) noexcept
+    { return a = a + b; }
+
+    constexpr Vec3 & operator-=(Vec3 & a, const Vec3 & b) noexcept
+    { return a = a - b; }
+
+    constexpr Vec3 & operator*=(Vec3 & a, const float s) noexcept
+    { return a = a * s; }
+
+    constexpr bool operator==(const Vec3 & a, const Vec3 & b) noexcept
+    { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+    constexpr float Dot(const Vec3 & a, const Vec3 & b) noexcept
+    { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    constexpr Vec3 Cross(const Vec3 & a, const Vec3 & b) noexcept
+    { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+
+    constexpr Vec3 Min(const Vec3 & a, const Vec3 & b) noexcept
+    { return { a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z }; }
+
+    constexpr Vec3 Max(const Vec3 & a, const Vec3 & b) noexcept
+    { return { a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z }; }
+
+    constexpr Vec3 Lerp(const Vec3 & a, const Vec3 & b, const float t) noexcept
+    { return a + (b - a) * t; }
+
+    inline float Length(const Vec3 & v) noexcept
+    { return std::sqrt(Dot(v, v)); }
+
+    inline Vec3 Normalize(const Vec3 & v) noexcept
+    { return v * (1.0f / Length(v)); }
+
+    // ---------------------------------------------------
+    // Vec4
+    // ---------------------------------------------------
+
+    struct Vec4
+    {
+        float x, y, z, w;
+
+        constexpr Vec4() noexcept : x{}, y{}, z{}, w{} {}
+        constexpr Vec4(const float s) noexcept : x{s}, y{s}, z{s}, w{s} {}
+        constexpr Vec4(const float x, const float y, const float z, const float w) noexcept : x{x}, y{y}, z{z}, w{w} {}
+        constexpr Vec4(const Vec3 & v, const float w) noexcept : x{v.x}, y{v.y}, z{v.z}, w{w} {}
+        constexpr explicit Vec4(const float * v) noexcept : x{v[0]}, y{v[1]}, z{v[2]}, w{v[3]} {}
+
+        constexpr Vec3 xyz() const noexcept { return { x, y, z }; }
+    };
+
+#ifdef LUNA_MATH_SSE4
+    inline __m128 Load(const Vec4 & v) noexcept
+    { return _mm_loadu_ps(&v.x); }
+
+    inline Vec4 Store(const __m128 m) noexcept
+    { Vec4 v; _mm_storeu_ps(&v.x, m); return v; }
+#endif
+
+    constexpr Vec4 operator+(const Vec4 & a, const Vec4 & b) noexcept
+    {
+    #ifdef LUNA_MATH_SSE4
+        if (!std::is_constant_evaluated())
+            return Store(_mm_add_ps(Load(a), Load(b)));
+    #endif
+        return { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w };
+    }
+
+    constexpr Vec4 operator-(const Vec4 & a, const Vec4 & b) noexcept
+    {
+    #ifdef LUNA_MATH_SSE4
+        if (!std::is_constant_evaluated())
+            return Store(_mm_sub_ps(Load(a), Load(b)));
+    #endif
+        return { a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w };
+    }
+
+    constexpr Vec4 operator*(const Vec4 & a, const Vec4 & b) noexcept
+    {
+    #ifdef LUNA_MATH_SSE4
+        if (!std::is_constant_evaluated())
+            return Store(_mm_mul_ps(Load(a), Load(b)));
+    #endif
+        return { a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
+    }
+
+    constexpr Vec4 operator*(const Vec4 & a, const float s) noexcept
+    {
+    #ifdef LUNA_MATH_SSE4
+        if (!std::is_constant_evaluated())
+            return Store(_mm_mul_ps(Load(a), _mm_set1_ps(s)));
+    #endif
+        return { a.x * s, a.y * s, a.z * s, a.w * s };
+    }
+
+    constexpr bool operator==(const Vec4 & a, const Vec4 & b) noexcept
+    { return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w; }
+
+    constexpr float Dot(const Vec4 & a, const Vec4 & b) noexcept
+    {
+    #ifdef LUNA_MATH_SSE4
+        if (!std::is_constant_evaluated())
+            return _mm_cvtss_f32(_mm_dp_ps(Load(a), Load(b), 0xff));
+    #endif
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+
+    constexpr Vec4 Lerp(const Vec4 & a, const Vec4 & b, const float t) noexcept
+    { return a + (b - a) * t; }
+
+    inline float Length(const Vec4 & v) noexcept
+    { return std::sqrt(Dot(v, v)); }
+
+    inline Vec4 Normalize(const Vec4 & v) noexcept
+    { return v * (1.0f / Length(v)); }
+
+    // ---------------------------------------------------
+    // Quat
+    // ---------------------------------------------------
+
+    struct Quat
+    {
+        float x, y, z, w;
+
+        constexpr Quat() noexcept : x{}, y{}, z{}, w{1.0f} {}
+        constexpr Quat(const float x, const float y, const float z, const float w) noexcept : x{x}, y{y}, z{z}, w{w} {}
+
+        static Quat AxisAngle(const Vec3 & axis, const float radians) noexcept;
+        static Quat Euler(const float pitch, const float yaw, const float roll) noexcept;
+    };
+
+    constexpr Quat operator*(const Quat & a, const Quat & b) noexcept
+    {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        };
+    }
+
+    constexpr Quat Conjugate(const Quat & q) noexcept
+    { return { -q.x, -q.y, -q.z, q.w }; }
+
+    constexpr float Dot(const Quat & a, const Quat & b) noexcept
+    { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    // v' = v + 2w(u x v) + 2u x (u x v)
+    constexpr Vec3 Rotate(const Quat & q, const Vec3 & v) noexcept
+    {
+        const Vec3 u { q.x, q.y, q.z };
+        const Vec3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+
+    inline Quat Normalize(const Quat & q) noexcept
+    {
+        const float inv = 1.0f / std::sqrt(Dot(q, q));
+        return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+    }
+
+    inline Quat Quat::AxisAngle(const Vec3 & axis, const float radians) noexcept
+    {
+        const Vec3 n = Normalize(axis) * std::sin(radians * 0.5f);
+        return { n.x, n.y, n.z, std::cos(radians * 0.5f) };
+    }
+
+    inline Quat Quat::Euler(const float pitch, const float yaw, const float roll) noexcept
+    {
+        return AxisAngle({ 0, 1, 0 }, yaw)
+            * AxisAngle({ 1, 0, 0 }, pitch)
+            * AxisAngle({ 0, 0, 1 }, roll);
+    }
+
+    Quat Slerp(const Quat & a, const Quat & b, const float t) noexcept;
+
+    // ---------------------------------------------------
+    // Mat4 (column major, like GLSL and HLSL with column_major packing)
+    // ---------------------------------------------------
+
+    struct alignas(16) Mat4
+    {
+        Vec4 columns[4];
+
+        constexpr Mat4() noexcept
+            : columns{ { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } } {}
+        constexpr Mat4(const Vec4 & c0, const Vec4 & c1, const Vec4 & c2, const Vec4 & c3) noexcept
+            : columns{ c0, c1, c2, c3 } {}
+
+        constexpr Vec4 & operator[](const uint32 i) noexcept { return columns[i]; }
+        constexpr const Vec4 & operator[](const uint32 i) const noexcept { return columns[i]; }
+
+        static constexpr Mat4 Identity() noexcept;
+        static constexpr Mat4 Translation(const Vec3 & t) noexcept;
+        static constexpr Mat4 Scaling(const Vec3 & s) noexcept;
+        static constexpr Mat4 Rotation(const Quat & q) noexcept;
+        static constexpr Mat4 TRS(const Vec3 & t, const Quat & r, const Vec3 & s) noexcept;
+
+        static Mat4 RotationX(const float radians) noexcept;
+        static Mat4 RotationY(const float radians) noexcept;
+        static Mat4 RotationZ(const float radians) noexcept;
+
+        // right handed, depth in [0, 1] as expected by Vulkan and Direct3D
+        static Mat4 Perspective(const float fovY, const float aspect, const float zNear, const float zFar) noexcept;
+        static Mat4 Orthographic(const float left, const float right, const float bottom, const float top,
+            const float zNear, const float zFar) noexcept;
+        static Mat4 LookAt(const Vec3 & eye, const Vec3 & target, const Vec3 & up) noexcept;
+    };
+
+    static_assert(sizeof(Vec2) == 8 && sizeof(Vec3) == 12 && sizeof(Vec4) == 16);
+    static_assert(sizeof(Quat) == 16 && sizeof(Mat4) == 64);
+
+    constexpr Mat4 Mat4::Identity() noexcept
+    { return Mat4(); }
+
+    constexpr Mat4 Mat4::Translation(const Vec3 & t) noexcept
+    { return { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 }, { t.x, t.y, t.z, 1 } }; }
+
+    constexpr Mat4 Mat4::Scaling(const Vec3 & s) noexcept
+    { return { { s.x, 0, 0, 0 }, { 0, s.y, 0, 0 }, { 0, 0, s.z, 0 }, { 0, 0, 0, 1 } }; }
+
+    constexpr Mat4 Mat4::Rotation(const Quat & q) noexcept
+    {
+        const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        return {
+            { 1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0 },
+            { 2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0 },
+            { 2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0 },
+            { 0, 0, 0, 1 }
+        };
+    }
+
+    constexpr Mat4 Mat4::TRS(const Vec3 & t, const Quat & r, const Vec3 & s) noexcept
+    {
+        Mat4 m = Rotation(r);
+        m.columns[0] = m.columns[0] * s.x;
+        m.columns[1] = m.columns[1] * s.y;
+        m.columns[2] = m.columns[2] * s.z;
+        m.columns[3] = { t.x, t.y, t.z, 1 };
+        return m;
+    }
+
+    constexpr Vec4 operator*(const Mat4 & m, const Vec4 & v) noexcept
+    {
+    #ifdef LUNA_MATH_SSE4
+        if (!std::is_constant_evaluated())
+        {
+            __m128 r = _mm_mul_ps(Load(m[0]), _mm_set1_ps(v.x));
+            r = _mm_add_ps(r, _mm_mul_ps(Load(m[1]), _mm_set1_ps(v.y)));
+            r = _mm_add_ps(r, _mm_mul_ps(Load(m[2]), _mm_set1_ps(v.z)));
+            r = _mm_add_ps(r, _mm_mul_ps(Load(m[3]), _mm_set1_ps(v.w)));
+            return Store(r);
+        }
+    #endif
+        return m[0] * v.x + m[1] * v.y + m[2] * v.z + m[3] * v.w;
+    }
+
+    constexpr Mat4 operator*(const Mat4 & a, const Mat4 & b) noexcept
+    {
+    #ifdef LUNA_MATH_AVX2
+        if (!std::is_constant_evaluated())
+        {
+            // two result columns per iteration, one in each 128-bit lane
+            const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[0]));
+            const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[1]));
+            const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[2]));
+            const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[3]));
+
+            Mat4 r;
+            for (uint32 i = 0; i < 4; i += 2)
+            {
+                const __m256 bc = _mm256_loadu_ps(&b[i].x);
+                __m256 c = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, 0x00));
+                c = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(bc, bc, 0x55), c);
+                c = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(bc, bc, 0xaa), c);
+                c = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(bc, bc, 0xff), c);
+                _mm256_storeu_ps(&r[i].x, c);
+            }
+            return r;
+        }
+    #endif
+        return { a * b[0], a * b[1], a * b[2], a * b[3] };
+    }
+
+    constexpr Vec3 TransformPoint(const Mat4 & m, const Vec3 & p) noexcept
+    { return (m * Vec4(p, 1.0f)).xyz(); }
+
+    constexpr Vec3 TransformVector(const Mat4 & m, const Vec3 & v) noexcept
+    { return (m * Vec4(v, 0.0f)).xyz(); }
+
+    constexpr Mat4 Transpose(const Mat4 & m) noexcept
+    {
+        return {
+            { m[0].x, m[1].x, m[2].x, m[3].x },
+            { m[0].y, m[1].y, m[2].y, m[3].y },
+            { m[0].z, m[1].z, m[2].z, m[3].z },
+            { m[0].w, m[1].w, m[2].w, m[3].w }
+        };
+    }
+
+    Mat4 Inverse(const Mat4 & m) noexcept;
+
+    // ---------------------------------------------------
+    // Batch transforms (see MathBatch.h for the 8-wide types)
+    // ---------------------------------------------------
+
+    void TransformPoints(const Mat4 & m, const Vec3 * in, Vec3 * out, const size_t count) noexcept;
+    void Multiply(const Mat4 * a, const Mat4 * b, Mat4 * out, const size_t count) noexcept;
+}
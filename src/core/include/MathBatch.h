@@ -0,0 +1,231 @@
+#pragma once
+
+#include "Math.h"
+
+// Structure of arrays variants that process eight elements per instruction
+// on AVX2 and fall back to plain loops (auto vectorized to SSE) elsewhere.
+namespace Luna::Math
+{
+    struct alignas(32) Float8
+    {
+        float v[8];
+    };
+
+    struct alignas(32) Vec3x8
+    {
+        float x[8];
+        float y[8];
+        float z[8];
+
+        // not an aggregate, so braced Vec3 arguments never pick the 8-wide overloads
+        Vec3x8() noexcept = default;
+
+        static Vec3x8 Load(const Vec3 * v) noexcept;
+        static Vec3x8 Load(const float * x, const float * y, const float * z) noexcept;
+        void Store(Vec3 * v) const noexcept;
+        void Store(float * x, float * y, float * z) const noexcept;
+    };
+
+#ifdef LUNA_MATH_AVX2
+    inline Vec3x8 Vec3x8::Load(const float * x, const float * y, const float * z) noexcept
+    {
+        Vec3x8 r;
+        _mm256_store_ps(r.x, _mm256_loadu_ps(x));
+        _mm256_store_ps(r.y, _mm256_loadu_ps(y));
+        _mm256_store_ps(r.z, _mm256_loadu_ps(z));
+        return r;
+    }
+
+    inline void Vec3x8::Store(float * ox, float * oy, float * oz) const noexcept
+    {
+        _mm256_storeu_ps(ox, _mm256_load_ps(x));
+        _mm256_storeu_ps(oy, _mm256_load_ps(y));
+        _mm256_storeu_ps(oz, _mm256_load_ps(z));
+    }
+#else
+    inline Vec3x8 Vec3x8::Load(const float * x, const float * y, const float * z) noexcept
+    {
+        Vec3x8 r;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            r.x[i] = x[i];
+            r.y[i] = y[i];
+            r.z[i] = z[i];
+        }
+        return r;
+    }
+
+    inline void Vec3x8::Store(float * ox, float * oy, float * oz) const noexcept
+    {
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            ox[i] = x[i];
+            oy[i] = y[i];
+            oz[i] = z[i];
+        }
+    }
+#endif
+
+    inline Vec3x8 Vec3x8::Load(const Vec3 * v) noexcept
+    {
+        Vec3x8 r;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            r.x[i] = v[i].x;
+            r.y[i] = v[i].y;
+            r.z[i] = v[i].z;
+        }
+        return r;
+    }
+
+    inline void Vec3x8::Store(Vec3 * v) const noexcept
+    {
+        for (uint32 i = 0; i < 8; ++i)
+            v[i] = { x[i], y[i], z[i] };
+    }
+
+#ifdef LUNA_MATH_AVX2
+    #define LUNA_VEC3X8_OP(name, intrinsic)                                         \
+    inline Vec3x8 name(const Vec3x8 & a, const Vec3x8 & b) noexcept                  \
+    {                                                                               \
+        Vec3x8 r;                                                                   \
+        _mm256_store_ps(r.x, intrinsic(_mm256_load_ps(a.x), _mm256_load_ps(b.x)));  \
+        _mm256_store_ps(r.y, intrinsic(_mm256_load_ps(a.y), _mm256_load_ps(b.y)));  \
+        _mm256_store_ps(r.z, intrinsic(_mm256_load_ps(a.z), _mm256_load_ps(b.z)));  \
+        return r;                                                                   \
+    }
+#else
+    #define LUNA_VEC3X8_OP(name, op)                                                \
+    inline Vec3x8 name(const Vec3x8 & a, const Vec3x8 & b) noexcept                  \
+    {                                                                               \
+        Vec3x8 r;                                                                   \
+        for (uint32 i = 0; i < 8; ++i)                                              \
+        {                                                                           \
+            r.x[i] = a.x[i] op b.x[i];                                              \
+            r.y[i] = a.y[i] op b.y[i];                                              \
+            r.z[i] = a.z[i] op b.z[i];                                              \
+        }                                                                           \
+        return r;                                                                   \
+    }
+#endif
+
+#ifdef LUNA_MATH_AVX2
+    LUNA_VEC3X8_OP(operator+, _mm256_add_ps)
+    LUNA_VEC3X8_OP(operator-, _mm256_sub_ps)
+    LUNA_VEC3X8_OP(operator*, _mm256_mul_ps)
+    LUNA_VEC3X8_OP(Min, _mm256_min_ps)
+    LUNA_VEC3X8_OP(Max, _mm256_max_ps)
+#else
+    LUNA_VEC3X8_OP(operator+, +)
+    LUNA_VEC3X8_OP(operator-, -)
+    LUNA_VEC3X8_OP(operator*, *)
+
+    inline Vec3x8 Min(const Vec3x8 & a, const Vec3x8 & b) noexcept
+    {
+        Vec3x8 r;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            r.x[i] = a.x[i] < b.x[i] ? a.x[i] : b.x[i];
+            r.y[i] = a.y[i] < b.y[i] ? a.y[i] : b.y[i];
+            r.z[i] = a.z[i] < b.z[i] ? a.z[i] : b.z[i];
+        }
+        return r;
+    }
+
+    inline Vec3x8 Max(const Vec3x8 & a, const Vec3x8 & b) noexcept
+    {
+        Vec3x8 r;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            r.x[i] = a.x[i] > b.x[i] ? a.x[i] : b.x[i];
+            r.y[i] = a.y[i] > b.y[i] ? a.y[i] : b.y[i];
+            r.z[i] = a.z[i] > b.z[i] ? a.z[i] : b.z[i];
+        }
+        return r;
+    }
+#endif
+
+    #undef LUNA_VEC3X8_OP
+
+    inline Vec3x8 operator*(const Vec3x8 & a, const float s) noexcept
+    {
+        Vec3x8 r;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            r.x[i] = a.x[i] * s;
+            r.y[i] = a.y[i] * s;
+            r.z[i] = a.z[i] * s;
+        }
+        return r;
+    }
+
+    inline Float8 Dot(const Vec3x8 & a, const Vec3x8 & b) noexcept
+    {
+        Float8 r;
+    #ifdef LUNA_MATH_AVX2
+        __m256 d = _mm256_mul_ps(_mm256_load_ps(a.x), _mm256_load_ps(b.x));
+        d = _mm256_fmadd_ps(_mm256_load_ps(a.y), _mm256_load_ps(b.y), d);
+        d = _mm256_fmadd_ps(_mm256_load_ps(a.z), _mm256_load_ps(b.z), d);
+        _mm256_store_ps(r.v, d);
+    #else
+        for (uint32 i = 0; i < 8; ++i)
+            r.v[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+    #endif
+        return r;
+    }
+
+    inline Vec3x8 Cross(const Vec3x8 & a, const Vec3x8 & b) noexcept
+    {
+        Vec3x8 r;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            r.x[i] = a.y[i] * b.z[i] - a.z[i] * b.y[i];
+            r.y[i] = a.z[i] * b.x[i] - a.x[i] * b.z[i];
+            r.z[i] = a.x[i] * b.y[i] - a.y[i] * b.x[i];
+        }
+        return r;
+    }
+
+    // w = 1 for points, w = 0 for vectors
+    inline Vec3x8 Transform(const Mat4 & m, const Vec3x8 & p, const float w) noexcept
+    {
+        Vec3x8 r;
+    #ifdef LUNA_MATH_AVX2
+        const __m256 px = _mm256_load_ps(p.x);
+        const __m256 py = _mm256_load_ps(p.y);
+        const __m256 pz = _mm256_load_ps(p.z);
+
+        float * out[3] { r.x, r.y, r.z };
+        const float Vec4::* row[3] { &Vec4::x, &Vec4::y, &Vec4::z };
+
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            __m256 c = _mm256_set1_ps(m[3].*row[i] * w);
+            c = _mm256_fmadd_ps(_mm256_set1_ps(m[0].*row[i]), px, c);
+            c = _mm256_fmadd_ps(_mm256_set1_ps(m[1].*row[i]), py, c);
+            c = _mm256_fmadd_ps(_mm256_set1_ps(m[2].*row[i]), pz, c);
+            _mm256_store_ps(out[i], c);
+        }
+    #else
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            r.x[i] = m[0].x * p.x[i] + m[1].x * p.y[i] + m[2].x * p.z[i] + m[3].x * w;
+            r.y[i] = m[0].y * p.x[i] + m[1].y * p.y[i] + m[2].y * p.z[i] + m[3].y * w;
+            r.z[i] = m[0].z * p.x[i] + m[1].z * p.y[i] + m[2].z * p.z[i] + m[3].z * w;
+        }
+    #endif
+        return r;
+    }
+
+    inline Vec3x8 TransformPoint(const Mat4 & m, const Vec3x8 & p) noexcept
+    { return Transform(m, p, 1.0f); }
+
+    inline Vec3x8 TransformVector(const Mat4 & m, const Vec3x8 & v) noexcept
+    { return Transform(m, v, 0.0f); }
+
+    // structure of arrays overload of TransformPoints from Math.h
+    void TransformPoints(const Mat4 & m,
+        const float * x, const float * y, const float * z,
+        float * outX, float * outY, float * outZ,
+        const size_t count) noexcept;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Math.h"
+#include <span>
+#include <vector>
+
+namespace Luna
+{
+    constexpr uint32 MESH_MAGIC = 0x48534D4C;       // "LMSH"
+    constexpr uint32 MESH_VERSION = 1;
+    constexpr uint32 MESH_CACHE_SIZE = 16;          // post-transform cache the ordering targets
+
+    struct MeshVertex
+    {
+        Math::Vec3 position;
+        Math::Vec3 normal;
+        Math::Vec2 texCoord;
+    };
+
+    // triangle list, indexed once Deduplicate ran
+    struct MeshData
+    {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32> indices;
+    };
+
+    // 16 bytes instead of 32: position in 16 bit units of the mesh bounds (w is
+    // padding), normal octahedron encoded to two 16 bit snorm, texCoord as halfs
+    struct PackedVertex
+    {
+        uint16 position[4];
+        int16 normal[2];
+        uint16 texCoord[2];
+    };
+
+    // File layout: header, vertexCount packed vertices, then indexCount indices of
+    // indexSize bytes at a 4 byte boundary. position = offset + unorm16 * scale.
+    struct MeshHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 vertexCount;
+        uint32 indexCount;
+        uint32 vertexStride;
+        uint32 indexSize;                           // 2 or 4
+        float offset[3];
+        float scale[3];
+    };
+
+    // header and pointers into a mesh file's bytes, which must outlive the view
+    struct MeshView
+    {
+        const MeshHeader * header;
+        const PackedVertex * vertices;
+        const void * indices;
+    };
+
+    struct CacheStats
+    {
+        float acmr;                                 // vertices transformed per triangle, 0.5 to 3
+        float atvr;                                 // vertices transformed per vertex, 1 is ideal
+    };
+
+    // ---------------------------------------------------
+    // Import
+    // ---------------------------------------------------
+
+    // OBJ (v, vt, vn and polygonal f) and glTF 2.0 (.gltf with external or base64
+    // buffers, .glb); every triangle primitive is merged without node transforms.
+    // Both leave an unindexed triangle list, missing normals are generated.
+    DLL bool ImportObj(const string_view path, MeshData & mesh);
+    DLL bool ImportGltf(const string_view path, MeshData & mesh);
+    DLL bool ImportMesh(const string_view path, MeshData & mesh);
+
+    // ---------------------------------------------------
+    // Processing, in the order ProcessMesh runs them
+    // ---------------------------------------------------
+
+    // merges bitwise equal vertices and builds the index buffer
+    DLL void Deduplicate(MeshData & mesh);
+
+    // Tipsify (Sander et al. 2007), linear time and close to Forsyth's ordering
+    DLL void OptimizeVertexCache(std::vector<uint32> & indices, const uint32 vertexCount,
+        const uint32 cacheSize = MESH_CACHE_SIZE);
+
+    // splits the cache ordered triangles in clusters where the cache restarts anyway,
+    // or where the cluster stays within threshold of its ACMR, and draws the clusters
+    // facing out of the mesh first so they occlude the rest
+    DLL void OptimizeOverdraw(std::vector<uint32> & indices, const std::vector<MeshVertex> & vertices,
+        const uint32 cacheSize = MESH_CACHE_SIZE, const float threshold = 1.05f);
+
+    // renumbers the vertices in the order the indices first use them
+    DLL void OptimizeVertexFetch(MeshData & mesh);
+
+    DLL void ProcessMesh(MeshData & mesh);
+
+    // FIFO cache simulation, the model the ordering is measured against
+    DLL CacheStats AnalyzeVertexCache(const std::vector<uint32> & indices, const uint32 vertexCount,
+        const uint32 cacheSize = MESH_CACHE_SIZE);
+
+    // ---------------------------------------------------
+    // Packed format
+    // ---------------------------------------------------
+
+    DLL std::vector<uint8> PackMesh(const MeshData & mesh);
+
+    // false when the bytes are not a whole mesh file
+    DLL bool ReadMesh(std::span<const uint8> bytes, MeshView & view);
+}
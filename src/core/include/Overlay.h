@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Canvas.h"
+#include "Font.h"
+#include "Profiler.h"
+#include "SpriteBatch.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Luna
+{
+    constexpr uint32 OVERLAY_HISTORY = 180;         // frames in the graph, 2 pixels each
+    constexpr float OVERLAY_WIDTH = 360.0f;
+    constexpr double OVERLAY_REFRESH = 250.0;       // milliseconds between updates of the numbers
+    constexpr uint32 OVERLAY_FONT_SIZE = 13;
+
+    // fixed width, so the columns of numbers line up
+#ifdef _WIN32
+    constexpr const char * OVERLAY_FONT = "C:/Windows/Fonts/consola.ttf";
+#else
+    constexpr const char * OVERLAY_FONT = "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf";
+#endif
+
+    // In-window performance panel, built immediate mode between Begin and End
+    // into one SpriteBatch with a single texture, the font atlas: backgrounds
+    // and graph bars are solid quads from Font::Solid, so the whole panel is
+    // one instanced draw. The numbers are averaged and formatted a few times
+    // per second, the frames in between draw cached runs.
+    class DLL Overlay
+    {
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Zone
+        {
+            const char * name;
+            uint32 depth;
+            double cpu;
+            double gpu;
+        };
+
+        // text at the left, then two numbers right aligned in their columns
+        struct Row
+        {
+            string cells[3];
+            uint32 color;
+        };
+
+        Font                font;
+        SpriteBatch         batch;
+        uint32              texture;
+        bool                visible;
+        bool                loaded;                     // a font was asked for, by the game or by default
+        const Canvas      * canvas;                     // holds the atlas at texture, when drawn by the CPU
+
+        float               history[OVERLAY_HISTORY];   // milliseconds
+        uint32              head;
+
+        Math::Vec2          origin;
+        float               top;
+
+        // sums since the last refresh
+        double              elapsed;
+        uint32              frames;
+        float               maximum;
+        uint64              reportFrame;
+        uint32              reports;
+        double              cpu;
+        double              gpu;
+        std::vector<Zone>   zones;
+        uint32              events;
+        uint32              inputs;
+        double              latency;
+
+        // input seen before the frame being built
+        uint32              pendingEvents;
+        bool                inputPending;
+        Clock::time_point   inputTime;
+
+        std::vector<Row>    rows;
+
+        void Strip(const float height);
+        void Accumulate(const FrameReport & report);
+        void Refresh(const uint64 gpuMemory);
+
+    public:
+        explicit Overlay();
+
+        // false without FreeType or when the file is not a font, the panel then has no text;
+        // without a call the first Begin loads OVERLAY_FONT
+        bool Load(const string_view path, const uint32 pixelSize);
+
+        void Toggle() noexcept;
+        bool Visible() const noexcept;
+
+        // the font atlas in the renderer, uploaded again when Glyphs().Dirty says so
+        void Texture(const uint32 texture) noexcept;
+        Font & Glyphs() noexcept;
+
+        // called by the engine every frame, shown or not
+        void Event(const bool input, const uint32 count = 1) noexcept;
+        void Frame(const double milliseconds) noexcept;
+        void Presented() noexcept;
+
+        void Begin(const Math::Vec2 & position = { 8.0f, 8.0f });
+        void Text(const string_view text, const uint32 color = 0xffe0e0e0);
+        void Graph();
+        void Stats(const FrameReport & report, const uint64 gpuMemory = 0);
+        void End();
+
+        // draws the panel with the CPU, for builds without a graphics backend,
+        // after End and before the window's Present
+        void Draw(Canvas & target);
+
+        const SpriteBatch & Batch() const noexcept;
+        SpriteBatch & Batch() noexcept;
+    };
+
+    // bytes of the process in physical memory
+    DLL uint64 ResidentMemory() noexcept;
+
+    // most bytes the process has had in physical memory, as the kernel counts it
+    DLL uint64 PeakMemory() noexcept;
+
+    inline void Overlay::Toggle() noexcept
+    { visible = !visible; }
+
+    inline bool Overlay::Visible() const noexcept
+    { return visible; }
+
+    inline void Overlay::Texture(const uint32 texture) noexcept
+    { this->texture = texture; }
+
+    inline Font & Overlay::Glyphs() noexcept
+    { return font; }
+
+    inline const SpriteBatch & Overlay::Batch() const noexcept
+    { return batch; }
+
+    inline SpriteBatch & Overlay::Batch() noexcept
+    { return batch; }
+}
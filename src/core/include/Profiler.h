@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include <chrono>
+#include <vector>
+
+namespace Luna
+{
+    struct ProfileEntry
+    {
+        const char * name;
+        uint32 depth;
+        double cpu;                         // milliseconds
+        double gpu;                         // milliseconds, 0 without a GPU marker
+    };
+
+    struct FrameReport
+    {
+        uint64 frame;
+        double cpu;                         // BeginFrame to EndFrame, milliseconds
+        double gpu;                         // first to last GPU command of the frame, milliseconds
+        std::vector<ProfileEntry> entries;  // in the order they were opened
+    };
+
+    // Per frame CPU scopes merged with the GPU timings a backend reads back
+    // frames later. A report is published once its GPU times arrive, or at
+    // EndFrame when no backend resolves them. Called from the main thread only.
+    class DLL Profiler
+    {
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr uint32 LATENCY = 8;    // frames a GPU result may arrive late
+
+        FrameReport                 reports[LATENCY];
+        FrameReport                 last;
+        std::vector<uint32>         open;
+        std::vector<Clock::time_point> starts;
+        Clock::time_point           frameStart;
+        uint64                      frame;
+        bool                        gpuResolved;
+
+        static double Milliseconds(const Clock::time_point start, const Clock::time_point end) noexcept;
+
+    public:
+        explicit Profiler() noexcept;
+
+        // set by a backend that calls Resolve for every frame it renders
+        void GpuResolved(const bool enable) noexcept;
+
+        void BeginFrame();
+        void EndFrame();
+
+        uint32 Begin(const char * name);
+        void End(const uint32 entry);
+
+        // GPU timings of an earlier frame, dropped if it left the window
+        void Gpu(const uint64 frame, const uint32 entry, const double ms) noexcept;
+        void Resolve(const uint64 frame, const double ms);
+
+        uint64 Frame() const noexcept;
+        const FrameReport & Report() const noexcept;
+    };
+
+    // times the enclosing block on the CPU
+    class ProfileScope
+    {
+    private:
+        Profiler * profiler;
+        uint32 entry;
+
+    public:
+        ProfileScope(Profiler * profiler, const char * name)
+            : profiler{ profiler }, entry{ profiler ? profiler->Begin(name) : 0 } {}
+        ~ProfileScope()
+        { if (profiler) profiler->End(entry); }
+
+        ProfileScope(const ProfileScope &) = delete;
+        ProfileScope & operator=(const ProfileScope &) = delete;
+    };
+
+    inline void Profiler::GpuResolved(const bool enable) noexcept
+    { gpuResolved = enable; }
+
+    inline uint64 Profiler::Frame() const noexcept
+    { return frame; }
+
+    inline const FrameReport & Profiler::Report() const noexcept
+    { return last; }
+}
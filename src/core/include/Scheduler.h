@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "World.h"
+#include "ThreadPool.h"
+#include <functional>
+#include <vector>
+
+namespace Luna
+{
+    struct System
+    {
+        string name;
+        ComponentMask reads;
+        ComponentMask writes;
+        std::function<void(World & world, double frameTime)> update;
+    };
+
+    // Runs the registered systems once per frame. Systems are grouped into
+    // stages: a system lands one stage after the last earlier system it
+    // conflicts with (write/write or read/write on the same component), and
+    // every system inside a stage runs in parallel on the thread pool.
+    // Systems must not create or destroy entities while the stage is running.
+    class DLL Scheduler
+    {
+    private:
+        World *                             world;
+        ThreadPool *                        threadPool;
+        std::vector<System>                 systems;
+        std::vector<std::vector<uint32>>    stages;
+        bool                                dirty;
+
+        void Build();
+
+    public:
+        explicit Scheduler(World * world, ThreadPool * threadPool) noexcept;
+
+        void Add(const string_view name,
+            const ComponentMask reads,
+            const ComponentMask writes,
+            std::function<void(World & world, double frameTime)> update);
+        void Remove(const string_view name);
+        void Clear() noexcept;
+
+        uint32 SystemCount() const noexcept;
+        uint32 StageCount();
+
+        void Update(const double frameTime);
+    };
+
+    inline uint32 Scheduler::SystemCount() const noexcept
+    { return static_cast<uint32>(systems.size()); }
+
+    inline void Scheduler::Clear() noexcept
+    { systems.clear(); stages.clear(); dirty = false; }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Math.h"
+#include <vector>
+
+namespace Luna
+{
+    // per instance data, read by the sprite vertex shader and by the Canvas
+    struct SpriteInstance
+    {
+        Math::Vec2 position;    // center, in pixels
+        Math::Vec2 size;        // in pixels
+        Math::Vec4 uv;          // u0, v0, u1, v1
+        uint32 color;           // 0xAARRGGBB tint
+        float rotation;         // radians around the center
+    };
+
+    // sprites sharing a texture and a layer, drawn with a single instanced draw
+    struct SpriteRun
+    {
+        uint32 texture;
+        uint32 layer;
+        uint32 first;
+        uint32 count;
+    };
+
+    // Collects sprites between Begin and End, then radix sorts them by layer
+    // and texture into a ring of instances. The ring lives in the batch by
+    // default, or in a persistently mapped GPU buffer given to Map, so the
+    // backend only records one instanced draw per run. Sprites in the same
+    // layer are drawn in submission order only when they share a texture.
+    // Both share one 32 bit sort key, layers are 0 to 255 and textures are
+    // indices below 2^24.
+    class DLL SpriteBatch
+    {
+    private:
+        std::vector<SpriteInstance> sprites;
+        std::vector<uint32>         keys;
+        std::vector<uint32>         order;
+        std::vector<uint32>         scratchKeys;
+        std::vector<uint32>         scratchOrder;
+        std::vector<SpriteRun>      runs;
+
+        std::vector<SpriteInstance> storage;
+        SpriteInstance *            ring;
+        uint32                      ringCapacity;
+        uint32                      ringHead;
+        uint32                      base;
+        uint32                      count;
+
+        void Sort();
+
+    public:
+        explicit SpriteBatch(const uint32 capacity = 65536);
+
+        // instances are written to this memory from now on
+        void Map(void * memory, const uint32 capacity) noexcept;
+
+        void Begin() noexcept;
+        void Draw(const uint32 texture, const SpriteInstance & sprite, const uint8 layer = 0);
+        void Draw(const uint32 texture,
+            const Math::Vec2 & position,
+            const Math::Vec2 & size,
+            const uint32 color = 0xffffffff,
+            const uint8 layer = 0);
+        void End();
+
+        // sorted instances of the last End, BaseInstance is their offset in the ring
+        const SpriteInstance * Instances() const noexcept;
+        uint32 InstanceCount() const noexcept;
+        uint32 BaseInstance() const noexcept;
+
+        const SpriteRun * Runs() const noexcept;
+        uint32 RunCount() const noexcept;
+    };
+
+    inline void SpriteBatch::Draw(const uint32 texture,
+        const Math::Vec2 & position,
+        const Math::Vec2 & size,
+        const uint32 color,
+        const uint8 layer)
+    { Draw(texture, SpriteInstance{ position, size, { 0, 0, 1, 1 }, color, 0.0f }, layer); }
+
+    inline const SpriteInstance * SpriteBatch::Instances() const noexcept
+    { return ring + base; }
+
+    inline uint32 SpriteBatch::InstanceCount() const noexcept
+    { return count; }
+
+    inline uint32 SpriteBatch::BaseInstance() const noexcept
+    { return base; }
+
+    inline const SpriteRun * SpriteBatch::Runs() const noexcept
+    { return runs.data(); }
+
+    inline uint32 SpriteBatch::RunCount() const noexcept
+    { return static_cast<uint32>(runs.size()); }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Luna
+{
+    enum StreamPriority : uint32
+    {
+        STREAM_URGENT,                      // needed this frame or the next
+        STREAM_HIGH,
+        STREAM_NORMAL,
+        STREAM_LOW,                         // prefetch
+        STREAM_PRIORITIES
+    };
+
+    using StreamId = uint64;
+
+    struct StreamRequest
+    {
+        string path;
+        uint64 offset;                      // a pack entry is its pack file with the entry's offset and size
+        uint64 size;                        // 0 reads to the end of the file
+        StreamPriority priority;
+
+        // on a pool worker, returning false fails the request; may be empty
+        std::function<bool(std::vector<uint8> & data)> decode;
+
+        // on the game thread inside Deliver, loaded is false when reading or decoding failed
+        std::function<void(std::vector<uint8> & data, bool loaded)> complete;
+    };
+
+    struct StreamJob;
+    struct StreamRing;
+
+    // Loads files in the background. Reads go through io_uring when the kernel
+    // allows it, otherwise through a small pool of reader threads, and decoding
+    // runs on the engine's thread pool, at most half of its workers at a time.
+    // Completions wait until Deliver, which the engine calls once per frame
+    // before Update and which stops after the frame budget is spent.
+    class DLL Streamer
+    {
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        ThreadPool *                        threadPool;
+        std::unique_ptr<ThreadPool>         readers;        // without io_uring
+        std::thread                         io;             // with io_uring
+        std::mutex                          mutex;
+        std::condition_variable             wake;
+        std::condition_variable             idle;
+        std::unordered_map<StreamId, std::unique_ptr<StreamJob>> jobs;
+        std::deque<StreamJob*>              queued[STREAM_PRIORITIES];
+        std::deque<StreamJob*>              decodes[STREAM_PRIORITIES];
+        std::deque<StreamJob*>              ready[STREAM_PRIORITIES];
+        StreamId                            nextId;
+        uint32                              depth;
+        uint32                              decoders;
+        uint32                              decoding;
+        double                              budget;
+        bool                                stop;
+        std::unique_ptr<StreamRing>         ring;
+
+        static StreamJob * Pop(std::deque<StreamJob*> (&queues)[STREAM_PRIORITIES]) noexcept;
+
+        void IoLoop();
+        void ReadNext();
+        void Decode(StreamJob * job);
+        void DecodeLoop();
+
+    public:
+        // depth is the number of reads kept in flight
+        explicit Streamer(ThreadPool * threadPool, const uint32 depth = 32, const bool uring = true);
+        ~Streamer() noexcept;
+
+        Streamer(const Streamer &) = delete;
+        Streamer & operator=(const Streamer &) = delete;
+
+        StreamId Load(StreamRequest && request);
+        StreamId Load(const string_view path, const StreamPriority priority,
+            std::function<void(std::vector<uint8> & data, bool loaded)> complete);
+
+        // complete is never called for a cancelled request, false once it was delivered
+        bool Cancel(const StreamId id);
+
+        // seconds of completion callbacks per Deliver, one callback always runs
+        void Budget(const double seconds) noexcept;
+
+        // runs completions, most urgent first, and returns how many ran
+        uint32 Deliver();
+
+        uint32 Pending() noexcept;
+        bool Uring() const noexcept;
+    };
+
+    inline void Streamer::Budget(const double seconds) noexcept
+    { budget = seconds; }
+
+    inline bool Streamer::Uring() const noexcept
+    { return ring != nullptr; }
+}
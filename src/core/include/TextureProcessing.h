@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "ThreadPool.h"
+#include <span>
+#include <vector>
+
+namespace Luna
+{
+    constexpr uint32 TEXTURE_MAGIC = 0x5845544C;    // "LTEX"
+    constexpr uint32 TEXTURE_VERSION = 1;
+    constexpr uint32 TEXTURE_MAX_LEVELS = 16;
+
+    // the layouts the GPU samples directly, every compressed format is 4x4 blocks
+    enum TextureFormat
+    {
+        TEXTURE_RGBA8,                              // uncompressed, 4 bytes per pixel
+        TEXTURE_BC1,                                // RGB with 1 bit alpha, 8 bytes per block
+        TEXTURE_BC3,                                // BC1 colors and BC4 alpha, 16 bytes per block
+        TEXTURE_BC7,                                // RGBA, 16 bytes per block
+        TEXTURE_ETC2,                               // ETC2 RGB8 for mobile GPUs, 8 bytes per block
+        TEXTURE_FORMATS
+    };
+
+    enum MipFilter
+    {
+        MIP_BOX,                                    // 2x2 average, fast and a bit blurry
+        MIP_KAISER                                  // windowed sinc, keeps detail
+    };
+
+    // RGBA8 pixels, rows packed
+    struct ImageData
+    {
+        uint32 width;
+        uint32 height;
+        std::vector<uint8> pixels;
+    };
+
+    // File layout: header, levelCount TextureLevel entries, then the levels at
+    // 16 byte boundaries, largest first, each in the format's upload layout.
+    struct TextureHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 format;
+        uint32 srgb;                                // 1 when the colors are sRGB encoded
+        uint32 width;
+        uint32 height;
+        uint32 levelCount;
+        uint32 reserved;
+    };
+
+    struct TextureLevel
+    {
+        uint64 offset;                              // from the start of the file
+        uint64 size;
+    };
+
+    // header and pointers into a texture file's bytes, which must outlive the view
+    struct TextureView
+    {
+        const TextureHeader * header;
+        const TextureLevel * levels;
+        const uint8 * data;                         // the whole file
+    };
+
+    // ---------------------------------------------------
+    // Mipmaps
+    // ---------------------------------------------------
+
+    // The full chain down to 1x1, the source image first. sRGB colors are filtered
+    // in linear space and alpha weights the colors, so mips neither darken nor
+    // bleed transparent texels. Rows are split among the pool's workers.
+    DLL std::vector<ImageData> GenerateMips(const ImageData & image,
+        const bool srgb,
+        const MipFilter filter = MIP_KAISER,
+        ThreadPool * pool = nullptr);
+
+    // ---------------------------------------------------
+    // Block compression
+    // ---------------------------------------------------
+
+    // bytes of a 4x4 block, or of a pixel for TEXTURE_RGBA8
+    DLL uint32 BlockBytes(const TextureFormat format) noexcept;
+    DLL uint64 LevelBytes(const TextureFormat format, const uint32 width, const uint32 height) noexcept;
+
+    // Blocks in rows, edge blocks repeat the last pixels. BC7 uses mode 6 only and
+    // ETC2 its ETC1 compatible modes, good quality at a fraction of an exhaustive
+    // encoder's time. Block rows are split among the pool's workers.
+    DLL std::vector<uint8> EncodeImage(const ImageData & image,
+        const TextureFormat format,
+        ThreadPool * pool = nullptr);
+
+    // ---------------------------------------------------
+    // Container
+    // ---------------------------------------------------
+
+    DLL std::vector<uint8> PackTexture(const std::vector<ImageData> & levels,
+        const TextureFormat format,
+        const bool srgb,
+        ThreadPool * pool = nullptr);
+
+    // false when the bytes are not a whole texture file
+    DLL bool ReadTexture(std::span<const uint8> bytes, TextureView & view);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Luna
+{
+    class DLL ThreadPool
+    {
+    private:
+        std::vector<std::thread>            workers;
+        std::deque<std::function<void()>>   tasks;
+        std::mutex                          mutex;
+        std::condition_variable             condition;
+        bool                                stop;
+
+        void Enqueue(std::function<void()> && task);
+        void WorkerLoop(const uint32 index) noexcept;
+
+    public:
+        explicit ThreadPool(const uint32 threadCount = 0) noexcept;
+        ~ThreadPool() noexcept;
+
+        uint32 Size() const noexcept;
+
+        // 1 to Size() on the pool's workers, 0 on any other thread, so
+        // per-thread resources can be indexed inside ParallelFor
+        static uint32 ThreadIndex() noexcept;
+
+        template<typename Func>
+        auto Submit(Func && func) -> std::future<decltype(func())>;
+
+        void ParallelFor(const uint32 count,
+            const uint32 grain,
+            const std::function<void(uint32 begin, uint32 end)> & func);
+    };
+
+    inline uint32 ThreadPool::Size() const noexcept
+    { return static_cast<uint32>(workers.size()); }
+
+    template<typename Func>
+    auto ThreadPool::Submit(Func && func) -> std::future<decltype(func())>
+    {
+        using Result = decltype(func());
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> result = task->get_future();
+
+        Enqueue([task]() { (*task)(); });
+
+        return result;
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Math.h"
+#include "ThreadPool.h"
+#include <cassert>
+#include <vector>
+
+namespace Luna
+{
+    // stable handle, the storage index of a node changes when the hierarchy is sorted;
+    // generation in the high 32 bits, slot in the low 32 bits like Entity
+    using Node = uint64;
+
+    constexpr Node NULL_NODE = ~Node{};
+
+    // Local TRS and world matrices kept in parallel arrays sorted by depth, so
+    // every parent is stored before its children and a single forward pass
+    // over the arrays updates the whole tree. Only dirty subtrees are touched,
+    // four nodes of a level at a time. Stale handles are ignored like in World.
+    class DLL TransformHierarchy
+    {
+    private:
+        enum : uint8 { LOCAL_DIRTY = 1, WORLD_DIRTY = 2 };
+        enum : uint32 { BATCH_WIDTH = 4 };
+
+        static constexpr uint32 NULL_INDEX = ~uint32{};
+
+        // storage, indexed by position in depth order
+        std::vector<Math::Vec3>     positions;
+        std::vector<Math::Quat>     rotations;
+        std::vector<Math::Vec3>     scales;
+        std::vector<Math::Mat4>     locals;
+        std::vector<Math::Mat4>     worlds;
+        std::vector<uint32>         parents;
+        std::vector<uint32>         depths;
+        std::vector<uint8>          flags;
+        std::vector<Node>           nodes;
+
+        // slot to storage index and generation, and first index of every depth level
+        std::vector<uint32>         indices;
+        std::vector<uint32>         generations;
+        std::vector<uint32>         freeSlots;
+        std::vector<uint32>         levels;
+
+        bool                        unsorted;
+        uint32                      dirtyCount;
+        uint32                      dirtyLevel;
+
+        void Sort();
+        void Reorder(const std::vector<uint32> & order);
+        void MarkDirty(const uint32 index, const uint8 flag) noexcept;
+        void UpdateRange(const uint32 begin, const uint32 end) noexcept;
+        void UpdateBatch(const uint32 * batch, const uint32 count) noexcept;
+        uint32 Index(const Node node) const noexcept;
+
+    public:
+        explicit TransformHierarchy() noexcept;
+
+        Node Create(const Node parent = NULL_NODE,
+            const Math::Vec3 & position = {},
+            const Math::Quat & rotation = {},
+            const Math::Vec3 & scale = Math::Vec3(1.0f));
+
+        // stale handles are ignored, a stale parent makes Create add a root
+        void Destroy(const Node node);
+        void Clear() noexcept;
+
+        void Parent(const Node node, const Node parent);
+        Node Parent(const Node node) const noexcept;
+
+        void Position(const Node node, const Math::Vec3 & position) noexcept;
+        void Rotation(const Node node, const Math::Quat & rotation) noexcept;
+        void Scale(const Node node, const Math::Vec3 & scale) noexcept;
+
+        const Math::Vec3 & Position(const Node node) const noexcept;
+        const Math::Quat & Rotation(const Node node) const noexcept;
+        const Math::Vec3 & Scale(const Node node) const noexcept;
+        const Math::Mat4 & Local(const Node node) const noexcept;
+        const Math::Mat4 & World(const Node node) const noexcept;
+
+        bool Alive(const Node node) const noexcept;
+        uint32 Count() const noexcept;
+        uint32 Levels() const noexcept;
+        uint32 DirtyCount() const noexcept;
+
+        // levels wider than minParallel are split across the pool
+        void Update(ThreadPool * pool = nullptr, const uint32 minParallel = 4096);
+    };
+
+    inline bool TransformHierarchy::Alive(const Node node) const noexcept
+    {
+        const uint32 slot = static_cast<uint32>(node);
+        return slot < indices.size()
+            && indices[slot] != NULL_INDEX
+            && generations[slot] == static_cast<uint32>(node >> 32);
+    }
+
+    // getters expect a live node, checked in debug builds
+    inline uint32 TransformHierarchy::Index(const Node node) const noexcept
+    { assert(Alive(node) && "Stale transform node"); return indices[static_cast<uint32>(node)]; }
+
+    inline Node TransformHierarchy::Parent(const Node node) const noexcept
+    {
+        if (!Alive(node))
+            return NULL_NODE;
+
+        const uint32 parent = parents[Index(node)];
+        return parent == NULL_INDEX ? NULL_NODE : nodes[parent];
+    }
+
+    inline void TransformHierarchy::Position(const Node node, const Math::Vec3 & position) noexcept
+    { if (Alive(node)) { positions[Index(node)] = position; MarkDirty(Index(node), LOCAL_DIRTY); } }
+
+    inline void TransformHierarchy::Rotation(const Node node, const Math::Quat & rotation) noexcept
+    { if (Alive(node)) { rotations[Index(node)] = rotation; MarkDirty(Index(node), LOCAL_DIRTY); } }
+
+    inline void TransformHierarchy::Scale(const Node node, const Math::Vec3 & scale) noexcept
+    { if (Alive(node)) { scales[Index(node)] = scale; MarkDirty(Index(node), LOCAL_DIRTY); } }
+
+    inline const Math::Vec3 & TransformHierarchy::Position(const Node node) const noexcept
+    { return positions[Index(node)]; }
+
+    inline const Math::Quat & TransformHierarchy::Rotation(const Node node) const noexcept
+    { return rotations[Index(node)]; }
+
+    inline const Math::Vec3 & TransformHierarchy::Scale(const Node node) const noexcept
+    { return scales[Index(node)]; }
+
+    inline const Math::Mat4 & TransformHierarchy::Local(const Node node) const noexcept
+    { return locals[Index(node)]; }
+
+    inline const Math::Mat4 & TransformHierarchy::World(const Node node) const noexcept
+    { return worlds[Index(node)]; }
+
+    inline uint32 TransformHierarchy::Count() const noexcept
+    { return static_cast<uint32>(nodes.size()); }
+
+    inline uint32 TransformHierarchy::Levels() const noexcept
+    { return static_cast<uint32>(levels.size() - 1); }
+
+    inline uint32 TransformHierarchy::DirtyCount() const noexcept
+    { return dirtyCount; }
+}
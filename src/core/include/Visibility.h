@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Math.h"
+#include "ThreadPool.h"
+#include <vector>
+
+namespace Luna
+{
+    struct DLL Frustum
+    {
+        // left, right, bottom, top, near, far with normalized xyz
+        Math::Vec4 planes[6];
+
+        static Frustum FromMatrix(const Math::Mat4 & viewProj) noexcept;
+    };
+
+    // Low resolution depth buffer filled with occluder triangles on the CPU.
+    // Bounds are occluded only when every pixel they cover is behind an occluder.
+    class DLL OcclusionBuffer
+    {
+    private:
+        uint32              width;
+        uint32              height;
+        std::vector<float>  depth;
+        Math::Mat4          viewProj;
+        uint32              triangleCount;
+
+    public:
+        explicit OcclusionBuffer(const uint32 width = 256, const uint32 height = 128);
+
+        void Clear(const Math::Mat4 & viewProj) noexcept;
+        void Rasterize(const Math::Vec3 * vertices, const uint32 * indices, const uint32 indexCount) noexcept;
+        void RasterizeBox(const Math::Vec3 & min, const Math::Vec3 & max) noexcept;
+
+        bool Visible(const Math::Vec3 & min, const Math::Vec3 & max) const noexcept;
+        bool Empty() const noexcept;
+
+        uint32 Width() const noexcept;
+        uint32 Height() const noexcept;
+        const float * Data() const noexcept;
+    };
+
+    inline bool OcclusionBuffer::Empty() const noexcept
+    { return triangleCount == 0; }
+
+    inline uint32 OcclusionBuffer::Width() const noexcept
+    { return width; }
+
+    inline uint32 OcclusionBuffer::Height() const noexcept
+    { return height; }
+
+    inline const float * OcclusionBuffer::Data() const noexcept
+    { return depth.data(); }
+
+    // Culls every registered object against the camera frustum, eight at a
+    // time on AVX2, and then against the occlusion buffer. Boxes and spheres
+    // share the same arrays: boxes have no radius and spheres no extents.
+    class DLL Visibility
+    {
+    private:
+        enum : uint32 { RANGE_SIZE = 16384 };
+
+        std::vector<float>                  centerX, centerY, centerZ;
+        std::vector<float>                  extentX, extentY, extentZ;
+        std::vector<float>                  radius;
+        std::vector<uint32>                 freeSlots;
+        uint32                              count;
+
+        Math::Mat4                          viewProj;
+        OcclusionBuffer                     occlusion;
+
+        std::vector<std::vector<uint32>>    ranges;
+        std::vector<uint32>                 visible;
+
+        uint32 Slot();
+        void CullRange(const Frustum & frustum, const uint32 range) noexcept;
+
+    public:
+        explicit Visibility() noexcept;
+
+        uint32 AddBox(const Math::Vec3 & min, const Math::Vec3 & max);
+        uint32 AddSphere(const Math::Vec3 & center, const float radius);
+        void Box(const uint32 id, const Math::Vec3 & min, const Math::Vec3 & max) noexcept;
+        void Sphere(const uint32 id, const Math::Vec3 & center, const float radius) noexcept;
+        void Remove(const uint32 id) noexcept;
+        void Clear() noexcept;
+
+        // sets the camera for the next Cull and clears the occlusion buffer
+        void Camera(const Math::Mat4 & viewProj) noexcept;
+        OcclusionBuffer * Occlusion() noexcept;
+
+        void Cull(ThreadPool * pool = nullptr);
+
+        uint32 Count() const noexcept;
+        uint32 VisibleCount() const noexcept;
+        const uint32 * Visible() const noexcept;
+    };
+
+    inline OcclusionBuffer * Visibility::Occlusion() noexcept
+    { return &occlusion; }
+
+    inline uint32 Visibility::Count() const noexcept
+    { return count - static_cast<uint32>(freeSlots.size()); }
+
+    inline uint32 Visibility::VisibleCount() const noexcept
+    { return static_cast<uint32>(visible.size()); }
+
+    inline const uint32 * Visibility::Visible() const noexcept
+    { return visible.data(); }
+}
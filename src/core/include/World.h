@@ -0,0 +1,401 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Luna
+{
+    // generation in the high 32 bits, slot index in the low 32 bits
+    using Entity = uint64;
+    using ComponentMask = uint64;
+
+    enum : uint32 { CHUNK_SIZE = 16384, MAX_COMPONENTS = 64 };
+
+    constexpr Entity NULL_ENTITY = ~Entity{};
+
+    struct ComponentInfo
+    {
+        uint32 size;
+        uint32 align;
+    };
+
+    class DLL Components
+    {
+    private:
+        // fixed size, Info reads it without the lock Register writes under
+        static std::array<ComponentInfo, MAX_COMPONENTS> infos;
+        static uint32 count;
+
+        static uint32 Register(const uint32 size, const uint32 align);
+
+    public:
+        // throws std::length_error past MAX_COMPONENTS types
+        template<typename T>
+        static uint32 Id();
+
+        template<typename... Ts>
+        static ComponentMask Mask();
+
+        static const ComponentInfo & Info(const uint32 id) noexcept;
+    };
+
+    template<typename T>
+    inline uint32 Components::Id()
+    {
+        // chunks move components with memcpy when entities change archetype
+        static_assert(std::is_trivially_copyable_v<T>, "Components must be trivially copyable");
+
+        static const uint32 id = Register(sizeof(T), alignof(T));
+        return id;
+    }
+
+    template<typename... Ts>
+    inline ComponentMask Components::Mask()
+    { return (ComponentMask{} | ... | (ComponentMask{1} << Id<Ts>())); }
+
+    inline const ComponentInfo & Components::Info(const uint32 id) noexcept
+    { return infos[id]; }
+
+    template<typename... Ts>
+    inline ComponentMask Reads()
+    { return Components::Mask<Ts...>(); }
+
+    template<typename... Ts>
+    inline ComponentMask Writes()
+    { return Components::Mask<Ts...>(); }
+
+    struct alignas(64) Chunk
+    {
+        uint8 data[CHUNK_SIZE];
+    };
+
+    // All entities with exactly the same set of components. Each 16 KB chunk
+    // stores the entity ids followed by one tightly packed array per component,
+    // and every chunk but the last one is always full.
+    class DLL Archetype
+    {
+    private:
+        friend class World;
+
+        ComponentMask                       mask;
+        std::vector<uint32>                 components;
+        std::array<uint32, MAX_COMPONENTS>  offsets;
+        std::vector<Chunk*>                 chunks;
+        uint32                              capacity;
+        uint32                              count;
+
+    public:
+        explicit Archetype(const ComponentMask mask) noexcept;
+        ~Archetype() noexcept;
+
+        ComponentMask Mask() const noexcept;
+        uint32 Count() const noexcept;
+        uint32 Capacity() const noexcept;
+        uint32 ChunkCount() const noexcept;
+        uint32 ChunkCount(const uint32 chunk) const noexcept;
+
+        Entity * Entities(const uint32 chunk) const noexcept;
+        void * Column(const uint32 chunk, const uint32 component) const noexcept;
+
+        template<typename T>
+        T * Column(const uint32 chunk) const;
+    };
+
+    inline ComponentMask Archetype::Mask() const noexcept
+    { return mask; }
+
+    inline uint32 Archetype::Count() const noexcept
+    { return count; }
+
+    inline uint32 Archetype::Capacity() const noexcept
+    { return capacity; }
+
+    inline uint32 Archetype::ChunkCount() const noexcept
+    { return static_cast<uint32>(chunks.size()); }
+
+    inline uint32 Archetype::ChunkCount(const uint32 chunk) const noexcept
+    {
+        const uint32 first = chunk * capacity;
+        return (count <= first) ? 0 : (count - first < capacity ? count - first : capacity);
+    }
+
+    inline Entity * Archetype::Entities(const uint32 chunk) const noexcept
+    { return reinterpret_cast<Entity*>(chunks[chunk]->data); }
+
+    inline void * Archetype::Column(const uint32 chunk, const uint32 component) const noexcept
+    { return chunks[chunk]->data + offsets[component]; }
+
+    template<typename T>
+    inline T * Archetype::Column(const uint32 chunk) const
+    { return reinterpret_cast<T*>(chunks[chunk]->data + offsets[Components::Id<T>()]); }
+
+    class DLL World
+    {
+    private:
+        struct Record
+        {
+            Archetype * archetype;
+            uint32 row;
+            uint32 generation;
+        };
+
+        std::vector<Record>                                     records;
+        std::vector<uint32>                                     freeSlots;
+        std::vector<std::unique_ptr<Archetype>>                 archetypes;
+        std::unordered_map<ComponentMask, Archetype*>           lookup;
+        uint32                                                  entityCount;
+
+        Archetype * FindArchetype(const ComponentMask mask);
+        void * Component(const Archetype * archetype, const uint32 row, const uint32 component) const noexcept;
+
+        uint32 Push(Archetype * archetype, const Entity entity);
+        void Erase(Archetype * archetype, const uint32 row) noexcept;
+        void Move(const Entity entity, Archetype * destination);
+        Entity Allocate(Archetype * archetype);
+
+    public:
+        explicit World() noexcept;
+        ~World() noexcept;
+
+        template<typename... Ts>
+        Entity Create(const Ts & ... components);
+        void Destroy(const Entity entity) noexcept;
+        void Clear() noexcept;
+
+        bool Alive(const Entity entity) const noexcept;
+        uint32 Count() const noexcept;
+
+        template<typename T>
+        T * Get(const Entity entity);
+
+        template<typename T>
+        bool Has(const Entity entity) const;
+
+        template<typename T>
+        void Add(const Entity entity, const T & component);
+
+        template<typename T>
+        void Remove(const Entity entity);
+
+        uint32 ArchetypeCount() const noexcept;
+        Archetype * ArchetypeAt(const uint32 index) const noexcept;
+
+        template<typename... Ts, typename Func>
+        void Each(Func && func);
+    };
+
+    inline uint32 World::Count() const noexcept
+    { return entityCount; }
+
+    inline bool World::Alive(const Entity entity) const noexcept
+    {
+        const uint32 slot = static_cast<uint32>(entity);
+        return slot < records.size()
+            && records[slot].archetype
+            && records[slot].generation == static_cast<uint32>(entity >> 32);
+    }
+
+    inline uint32 World::ArchetypeCount() const noexcept
+    { return static_cast<uint32>(archetypes.size()); }
+
+    inline Archetype * World::ArchetypeAt(const uint32 index) const noexcept
+    { return archetypes[index].get(); }
+
+    inline void * World::Component(const Archetype * archetype, const uint32 row, const uint32 component) const noexcept
+    {
+        const uint32 chunk = row / archetype->capacity;
+        const uint32 index = row % archetype->capacity;
+        return archetype->chunks[chunk]->data + archetype->offsets[component] + index * Components::Info(component).size;
+    }
+
+    template<typename... Ts>
+    Entity World::Create(const Ts & ... components)
+    {
+        Archetype * archetype = FindArchetype(Components::Mask<Ts...>());
+        const Entity entity = Allocate(archetype);
+        const uint32 row = records[static_cast<uint32>(entity)].row;
+
+        (std::memcpy(Component(archetype, row, Components::Id<Ts>()), &components, sizeof(Ts)), ...);
+
+        return entity;
+    }
+
+    template<typename T>
+    T * World::Get(const Entity entity)
+    {
+        if (!Has<T>(entity))
+            return nullptr;
+
+        const Record & record = records[static_cast<uint32>(entity)];
+        return static_cast<T*>(Component(record.archetype, record.row, Components::Id<T>()));
+    }
+
+    template<typename T>
+    bool World::Has(const Entity entity) const
+    {
+        return Alive(entity)
+            && (records[static_cast<uint32>(entity)].archetype->mask & Components::Mask<T>());
+    }
+
+    template<typename T>
+    void World::Add(const Entity entity, const T & component)
+    {
+        if (!Alive(entity))
+            return;
+
+        const Record & record = records[static_cast<uint32>(entity)];
+        if (!(record.archetype->mask & Components::Mask<T>()))
+            Move(entity, FindArchetype(record.archetype->mask | Components::Mask<T>()));
+
+        std::memcpy(Get<T>(entity), &component, sizeof(T));
+    }
+
+    template<typename T>
+    void World::Remove(const Entity entity)
+    {
+        if (!Has<T>(entity))
+            return;
+
+        const Record & record = records[static_cast<uint32>(entity)];
+        Move(entity, FindArchetype(record.archetype->mask & ~Components::Mask<T>()));
+    }
+
+    // Iterates every chunk of every archetype that has at least the requested
+    // components. Matching archetypes are cached and only new archetypes are
+    // tested again, so a Query kept across frames costs nothing to refresh.
+    template<typename... Ts>
+    class Query
+    {
+    private:
+        struct Range
+        {
+            Archetype * archetype;
+            uint32 chunk;
+        };
+
+        World *                     world;
+        ComponentMask               mask;
+        std::vector<Archetype*>     matches;
+        std::vector<Range>          ranges;
+        uint32                      archetypesSeen;
+
+        void Refresh();
+
+    public:
+        explicit Query(World * world);
+
+        uint32 Count();
+
+        template<typename Func>
+        void Each(Func && func);
+
+        template<typename Func>
+        void EachChunk(Func && func);
+
+        template<typename Func>
+        void ParallelEach(ThreadPool * pool, Func && func);
+
+        template<typename Func>
+        void ParallelEachChunk(ThreadPool * pool, Func && func);
+    };
+
+    template<typename... Ts>
+    Query<Ts...>::Query(World * world)
+        : world{world},
+        mask{Components::Mask<Ts...>()},
+        archetypesSeen{}
+    {
+    }
+
+    template<typename... Ts>
+    void Query<Ts...>::Refresh()
+    {
+        for (; archetypesSeen < world->ArchetypeCount(); ++archetypesSeen)
+        {
+            Archetype * archetype = world->ArchetypeAt(archetypesSeen);
+            if ((archetype->Mask() & mask) == mask)
+                matches.push_back(archetype);
+        }
+    }
+
+    template<typename... Ts>
+    uint32 Query<Ts...>::Count()
+    {
+        Refresh();
+
+        uint32 count = 0;
+        for (const Archetype * archetype : matches)
+            count += archetype->Count();
+
+        return count;
+    }
+
+    template<typename... Ts>
+    template<typename Func>
+    void Query<Ts...>::EachChunk(Func && func)
+    {
+        Refresh();
+
+        for (Archetype * archetype : matches)
+            for (uint32 chunk = 0; chunk < archetype->ChunkCount(); ++chunk)
+                func(archetype->ChunkCount(chunk), archetype->Entities(chunk), archetype->template Column<Ts>(chunk)...);
+    }
+
+    template<typename... Ts>
+    template<typename Func>
+    void Query<Ts...>::Each(Func && func)
+    {
+        EachChunk([&func](const uint32 count, const Entity *, Ts * ... columns)
+        {
+            for (uint32 i = 0; i < count; ++i)
+                func(columns[i]...);
+        });
+    }
+
+    template<typename... Ts>
+    template<typename Func>
+    void Query<Ts...>::ParallelEachChunk(ThreadPool * pool, Func && func)
+    {
+        Refresh();
+
+        ranges.clear();
+        for (Archetype * archetype : matches)
+            for (uint32 chunk = 0; chunk < archetype->ChunkCount(); ++chunk)
+                ranges.push_back({ archetype, chunk });
+
+        pool->ParallelFor(static_cast<uint32>(ranges.size()), 4, [this, &func](const uint32 begin, const uint32 end)
+        {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                Archetype * archetype = ranges[i].archetype;
+                const uint32 chunk = ranges[i].chunk;
+                func(archetype->ChunkCount(chunk), archetype->Entities(chunk), archetype->template Column<Ts>(chunk)...);
+            }
+        });
+    }
+
+    template<typename... Ts>
+    template<typename Func>
+    void Query<Ts...>::ParallelEach(ThreadPool * pool, Func && func)
+    {
+        ParallelEachChunk(pool, [&func](const uint32 count, const Entity *, Ts * ... columns)
+        {
+            for (uint32 i = 0; i < count; ++i)
+                func(columns[i]...);
+        });
+    }
+
+    template<typename... Ts, typename Func>
+    void World::Each(Func && func)
+    {
+        Query<Ts...> query(this);
+        query.Each(std::forward<Func>(func));
+    }
+}
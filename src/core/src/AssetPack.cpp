@@ -0,0 +1,415 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef LUNA_LZ4
+    #include <lz4.h>
+    #include <lz4hc.h>
+#endif
+
+#ifdef LUNA_ZSTD
+    #include <zstd.h>
+#endif
+
+namespace Luna
+{
+    struct PackFile
+    {
+        string name;
+        std::vector<uint8> data;
+        uint64 rawSize;
+        uint32 compression;
+    };
+
+    static bool Compress(PackFile & file, const PackCompression codec)
+    {
+        std::vector<uint8> packed;
+
+        switch (codec)
+        {
+    #ifdef LUNA_LZ4
+        case PACK_LZ4:
+        {
+            packed.resize(size_t(LZ4_compressBound(int(file.data.size()))));
+            const int written = LZ4_compress_HC(reinterpret_cast<const char*>(file.data.data()),
+                reinterpret_cast<char*>(packed.data()), int(file.data.size()), int(packed.size()), LZ4HC_CLEVEL_MAX);
+            if (written <= 0)
+                return false;
+            packed.resize(size_t(written));
+            break;
+        }
+    #endif
+
+    #ifdef LUNA_ZSTD
+        case PACK_ZSTD:
+        {
+            packed.resize(ZSTD_compressBound(file.data.size()));
+            const size_t written = ZSTD_compress(packed.data(), packed.size(), file.data.data(), file.data.size(), 19);
+            if (ZSTD_isError(written))
+                return false;
+            packed.resize(written);
+            break;
+        }
+    #endif
+
+        default:
+            return false;
+        }
+
+        // decompressing is only worth it when it saves an eighth of the entry
+        if (packed.size() > file.data.size() - file.data.size() / 8)
+            return false;
+
+        file.data = std::move(packed);
+        file.compression = codec;
+        return true;
+    }
+
+    static uint64 AlignUp(const uint64 value)
+    {
+        return (value + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+    }
+
+    // ---------------------------------------------------
+
+    AssetPack::AssetPack() noexcept
+        : data{nullptr},
+        size{},
+        header{nullptr},
+        buckets{nullptr},
+        entries{nullptr},
+        names{nullptr}
+    #ifdef _WIN32
+        , file{nullptr},
+        mapping{nullptr}
+    #endif
+    {
+    }
+
+    AssetPack::~AssetPack() noexcept
+    {
+        Close();
+    }
+
+    bool AssetPack::Open(const string_view path)
+    {
+        Close();
+        const string filename{ path };
+
+    #ifdef _WIN32
+        HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(handle, &fileSize);
+        file = handle;
+
+        if (fileSize.QuadPart > 0)
+            mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping)
+        {
+            data = static_cast<const uint8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            size = uint64(fileSize.QuadPart);
+        }
+    #else
+        const int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        // the mapping keeps the file alive, one open and one mmap for the whole pack
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void * view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED)
+            {
+                data = static_cast<const uint8*>(view);
+                size = uint64(info.st_size);
+            }
+        }
+
+        close(fd);
+    #endif
+
+        if (!data)
+        {
+            Close();
+            return false;
+        }
+
+        header = reinterpret_cast<const PackHeader*>(data);
+        buckets = reinterpret_cast<const uint32*>(data + sizeof(PackHeader));
+
+        if (!Validate())
+        {
+            Close();
+            return false;
+        }
+
+        entries = reinterpret_cast<const PackEntry*>(buckets + header->bucketCount);
+        names = reinterpret_cast<const char*>(data + header->namesOffset);
+        return true;
+    }
+
+    void AssetPack::Close() noexcept
+    {
+    #ifdef _WIN32
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file)
+            CloseHandle(file);
+
+        file = nullptr;
+        mapping = nullptr;
+    #else
+        if (data)
+            munmap(const_cast<uint8*>(data), size);
+    #endif
+
+        data = nullptr;
+        size = 0;
+        header = nullptr;
+        buckets = nullptr;
+        entries = nullptr;
+        names = nullptr;
+    }
+
+    // a truncated or foreign file is refused here, so lookups need no bound checks
+    bool AssetPack::Validate() const noexcept
+    {
+        if (size < sizeof(PackHeader) || header->magic != PACK_MAGIC || header->version != PACK_VERSION)
+            return false;
+
+        const uint32 bucketCount = header->bucketCount;
+        if (bucketCount == 0 || (bucketCount & (bucketCount - 1)) || bucketCount < uint64(header->entryCount) * 2)
+            return false;
+
+        const uint64 tableEnd = sizeof(PackHeader) + uint64(bucketCount) * sizeof(uint32)
+            + uint64(header->entryCount) * sizeof(PackEntry);
+
+        if (tableEnd > size || header->namesOffset < tableEnd || header->namesSize > size - header->namesOffset)
+            return false;
+
+        const uint32 * table = reinterpret_cast<const uint32*>(data + sizeof(PackHeader));
+        for (uint32 i = 0; i < bucketCount; ++i)
+        {
+            if (table[i] != PACK_EMPTY_BUCKET && table[i] >= header->entryCount)
+                return false;
+        }
+
+        const PackEntry * list = reinterpret_cast<const PackEntry*>(table + bucketCount);
+        for (uint32 i = 0; i < header->entryCount; ++i)
+        {
+            const PackEntry & entry = list[i];
+            if (entry.offset > size || entry.size > size - entry.offset
+                || uint64(entry.nameOffset) + entry.nameLength > header->namesSize
+                || entry.compression > PACK_ZSTD
+                || (entry.compression == PACK_NONE && entry.size != entry.rawSize))
+                return false;
+        }
+
+        return true;
+    }
+
+    const PackEntry * AssetPack::Find(const string_view name) const noexcept
+    {
+        if (!data)
+            return nullptr;
+
+        const uint64 hash = Hash(name);
+        const uint32 mask = header->bucketCount - 1;
+
+        // the table is at most half full, so probing ends at an empty bucket quickly
+        for (uint32 bucket = uint32(hash) & mask; buckets[bucket] != PACK_EMPTY_BUCKET; bucket = (bucket + 1) & mask)
+        {
+            const PackEntry * entry = entries + buckets[bucket];
+            if (entry->hash == hash && Name(entry) == name)
+                return entry;
+        }
+
+        return nullptr;
+    }
+
+    std::span<const uint8> AssetPack::View(const PackEntry * entry) const noexcept
+    {
+        if (!entry || entry->compression != PACK_NONE)
+            return {};
+
+        return { data + entry->offset, size_t(entry->size) };
+    }
+
+    bool AssetPack::Read(const PackEntry * entry, std::vector<uint8> & output) const
+    {
+        if (!entry)
+            return false;
+
+        const uint8 * source = data + entry->offset;
+        output.resize(size_t(entry->rawSize));
+
+        switch (entry->compression)
+        {
+        case PACK_NONE:
+            if (entry->size)
+                memcpy(output.data(), source, size_t(entry->size));
+            return true;
+
+    #ifdef LUNA_LZ4
+        case PACK_LZ4:
+            return LZ4_decompress_safe(reinterpret_cast<const char*>(source), reinterpret_cast<char*>(output.data()),
+                int(entry->size), int(entry->rawSize)) == int(entry->rawSize);
+    #endif
+
+    #ifdef LUNA_ZSTD
+        case PACK_ZSTD:
+            return ZSTD_decompress(output.data(), output.size(), source, size_t(entry->size)) == entry->rawSize;
+    #endif
+
+        default:
+            output.clear();
+            return false;
+        }
+    }
+
+    // FNV-1a, the packer and the reader must agree on it
+    uint64 AssetPack::Hash(const string_view name) noexcept
+    {
+        uint64 hash = 14695981039346656037ULL;
+        for (const char c : name)
+        {
+            hash ^= uint8(c);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    bool AssetPack::Supports(const PackCompression compression) noexcept
+    {
+        switch (compression)
+        {
+        case PACK_NONE:
+            return true;
+    #ifdef LUNA_LZ4
+        case PACK_LZ4:
+            return true;
+    #endif
+    #ifdef LUNA_ZSTD
+        case PACK_ZSTD:
+            return true;
+    #endif
+        default:
+            return false;
+        }
+    }
+
+    bool AssetPack::Build(const string_view directory, const string_view output, const PackCompression codec)
+    {
+        namespace fs = std::filesystem;
+
+        if (!Supports(codec))
+            return false;
+
+        const fs::path root{ directory };
+        std::error_code error;
+        std::vector<PackFile> files;
+
+        for (const fs::directory_entry & item : fs::recursive_directory_iterator(root, error))
+        {
+            if (!item.is_regular_file())
+                continue;
+
+            std::ifstream input(item.path(), std::ios::binary);
+            PackFile file{ item.path().lexically_relative(root).generic_string(), {}, 0, PACK_NONE };
+            file.data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+            file.rawSize = file.data.size();
+
+            if (codec != PACK_NONE && !file.data.empty())
+                Compress(file, codec);
+
+            files.push_back(std::move(file));
+        }
+
+        if (error)
+            return false;
+
+        // the same input always gives the same pack
+        std::sort(files.begin(), files.end(), [](const PackFile & a, const PackFile & b) { return a.name < b.name; });
+
+        PackHeader header{};
+        header.magic = PACK_MAGIC;
+        header.version = PACK_VERSION;
+        header.entryCount = uint32(files.size());
+        header.bucketCount = std::bit_ceil(std::max(2U, header.entryCount * 2));
+
+        std::vector<uint32> table(header.bucketCount, PACK_EMPTY_BUCKET);
+        std::vector<PackEntry> list(files.size());
+        string nameData;
+
+        for (const PackFile & file : files)
+            nameData += file.name;
+
+        header.namesOffset = sizeof(PackHeader) + table.size() * sizeof(uint32) + list.size() * sizeof(PackEntry);
+        header.namesSize = nameData.size();
+
+        uint64 offset = AlignUp(header.namesOffset + header.namesSize);
+        uint32 nameOffset = 0;
+
+        for (uint32 i = 0; i < files.size(); ++i)
+        {
+            const PackFile & file = files[i];
+            PackEntry & entry = list[i];
+
+            entry.hash = Hash(file.name);
+            entry.offset = offset;
+            entry.size = file.data.size();
+            entry.rawSize = file.rawSize;
+            entry.nameOffset = nameOffset;
+            entry.nameLength = uint32(file.name.size());
+            entry.compression = file.compression;
+
+            uint32 bucket = uint32(entry.hash) & (header.bucketCount - 1);
+            while (table[bucket] != PACK_EMPTY_BUCKET)
+                bucket = (bucket + 1) & (header.bucketCount - 1);
+            table[bucket] = i;
+
+            nameOffset += entry.nameLength;
+            offset = AlignUp(offset + entry.size);
+        }
+
+        std::ofstream stream(fs::path{ output }, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            return false;
+
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(uint32)));
+        stream.write(reinterpret_cast<const char*>(list.data()), std::streamsize(list.size() * sizeof(PackEntry)));
+        stream.write(nameData.data(), std::streamsize(nameData.size()));
+
+        const char padding[PACK_ALIGNMENT]{};
+        for (uint32 i = 0; i < files.size(); ++i)
+        {
+            stream.write(padding, std::streamsize(list[i].offset - uint64(stream.tellp())));
+            stream.write(reinterpret_cast<const char*>(files[i].data.data()), std::streamsize(files[i].data.size()));
+        }
+
+        return bool(stream);
+    }
+}
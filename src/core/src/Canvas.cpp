@@ -0,0 +1,239 @@
+#include "Canvas.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Luna
+{
+    // x / 255 rounded, exact for x in [0, 255 * 255]
+    constexpr uint32 Div255(const uint32 x) noexcept
+    { return (x + 128 + ((x + 128) >> 8)) >> 8; }
+
+#if defined(LUNA_MATH_AVX2)
+    inline __m256i Div255(const __m256i x) noexcept
+    {
+        const __m256i t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    // two pixels widened to 16 bits per channel
+    inline __m256i Blend(const __m256i src, const __m256i dst, const __m256i tint) noexcept
+    {
+        const __m256i s = Div255(_mm256_mullo_epi16(src, tint));
+        const __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xff), 0xff);
+        const __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+        return Div255(_mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(dst, inv)));
+    }
+#elif defined(LUNA_MATH_SSE4)
+    inline __m128i Div255(const __m128i x) noexcept
+    {
+        const __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    inline __m128i Blend(const __m128i src, const __m128i dst, const __m128i tint) noexcept
+    {
+        const __m128i s = Div255(_mm_mullo_epi16(src, tint));
+        const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xff), 0xff);
+        const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+        return Div255(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(dst, inv)));
+    }
+#endif
+
+    void BlendRow(uint32 * dst, const uint32 * src, const uint32 count, const uint32 tint) noexcept
+    {
+        uint32 i = 0;
+
+#if defined(LUNA_MATH_AVX2)
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i alpha = _mm256_set1_epi32(int32(0xff000000));
+        const __m256i tint16 = _mm256_unpacklo_epi8(_mm256_set1_epi32(int32(tint)), zero);
+        const bool opaqueTint = tint == 0xffffffff;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+
+            // fully transparent and fully opaque spans skip the arithmetic
+            if (_mm256_testz_si256(s, alpha))
+                continue;
+
+            if (opaqueTint && _mm256_testc_si256(s, alpha))
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), s);
+                continue;
+            }
+
+            const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            const __m256i lo = Blend(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), tint16);
+            const __m256i hi = Blend(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), tint16);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+        }
+#elif defined(LUNA_MATH_SSE4)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alpha = _mm_set1_epi32(int32(0xff000000));
+        const __m128i tint16 = _mm_unpacklo_epi8(_mm_set1_epi32(int32(tint)), zero);
+        const bool opaqueTint = tint == 0xffffffff;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+            if (_mm_testz_si128(s, alpha))
+                continue;
+
+            if (opaqueTint && _mm_testc_si128(s, alpha))
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+                continue;
+            }
+
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            const __m128i lo = Blend(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), tint16);
+            const __m128i hi = Blend(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), tint16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            uint32 s[4], d[4];
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                s[c] = Div255(((src[i] >> (c * 8)) & 0xff) * ((tint >> (c * 8)) & 0xff));
+                d[c] = (dst[i] >> (c * 8)) & 0xff;
+            }
+
+            uint32 out = 0;
+            for (uint32 c = 0; c < 4; ++c)
+                out |= Div255(s[c] * s[3] + d[c] * (255 - s[3])) << (c * 8);
+
+            dst[i] = out;
+        }
+    }
+
+    Canvas::Canvas(const uint32 width, const uint32 height)
+        : width{ width }, height{ height }, pixels(size_t(width) * height), row(width), columns(width)
+    {
+    }
+
+    void Canvas::Resize(const uint32 width, const uint32 height)
+    {
+        this->width = width;
+        this->height = height;
+        pixels.resize(size_t(width) * height);
+        row.resize(width);
+        columns.resize(width);
+    }
+
+    uint32 Canvas::Texture(const uint32 * data, const uint32 width, const uint32 height)
+    {
+        textures.push_back({ width, height, std::vector<uint32>(data, data + size_t(width) * height) });
+        return static_cast<uint32>(textures.size() - 1);
+    }
+
+    void Canvas::Update(const uint32 texture, const uint32 * data, const uint32 width, const uint32 height)
+    {
+        if (texture < textures.size())
+            textures[texture] = { width, height, std::vector<uint32>(data, data + size_t(width) * height) };
+    }
+
+    void Canvas::Clear(const uint32 color) noexcept
+    {
+        std::fill(pixels.begin(), pixels.end(), color);
+    }
+
+    void Canvas::DrawSprite(const Image & image, const SpriteInstance & sprite) noexcept
+    {
+        const bool rotated = sprite.rotation != 0.0f;
+        const float c = rotated ? std::cos(sprite.rotation) : 1.0f;
+        const float s = rotated ? std::sin(sprite.rotation) : 0.0f;
+        const float halfX = sprite.size.x * 0.5f;
+        const float halfY = sprite.size.y * 0.5f;
+
+        // screen space bounds of the rotated quad
+        const float extentX = std::fabs(c) * halfX + std::fabs(s) * halfY;
+        const float extentY = std::fabs(s) * halfX + std::fabs(c) * halfY;
+
+        // pixels whose centers fall inside the bounds
+        const int32 x0 = std::max(0, int32(std::ceil(sprite.position.x - extentX - 0.5f)));
+        const int32 x1 = std::min(int32(width), int32(std::ceil(sprite.position.x + extentX - 0.5f)));
+        const int32 y0 = std::max(0, int32(std::ceil(sprite.position.y - extentY - 0.5f)));
+        const int32 y1 = std::min(int32(height), int32(std::ceil(sprite.position.y + extentY - 0.5f)));
+
+        if (x0 >= x1 || y0 >= y1)
+            return;
+
+        // texel coordinates change linearly along a row
+        const float scaleU = (sprite.uv.z - sprite.uv.x) * image.width / sprite.size.x;
+        const float scaleV = (sprite.uv.w - sprite.uv.y) * image.height / sprite.size.y;
+        const float originU = sprite.uv.x * image.width + halfX * scaleU;
+        const float originV = sprite.uv.y * image.height + halfY * scaleV;
+
+        const int32 maxU = int32(image.width) - 1;
+        const int32 maxV = int32(image.height) - 1;
+        const uint32 span = uint32(x1 - x0);
+
+        if (!rotated)
+        {
+            // axis aligned sprites sample the same columns on every row
+            const float dx = x0 + 0.5f - sprite.position.x;
+            for (uint32 x = 0; x < span; ++x)
+                columns[x] = std::clamp(int32(originU + (dx + x) * scaleU), 0, maxU);
+
+            for (int32 y = y0; y < y1; ++y)
+            {
+                const int32 v = std::clamp(int32(originV + (y + 0.5f - sprite.position.y) * scaleV), 0, maxV);
+                const uint32 * texels = image.pixels.data() + size_t(v) * image.width;
+
+                for (uint32 x = 0; x < span; ++x)
+                    row[x] = texels[columns[x]];
+
+                BlendRow(pixels.data() + size_t(y) * width + x0, row.data(), span, sprite.color);
+            }
+
+            return;
+        }
+
+        for (int32 y = y0; y < y1; ++y)
+        {
+            const float dx = x0 + 0.5f - sprite.position.x;
+            const float dy = y + 0.5f - sprite.position.y;
+
+            // local coordinates relative to the center, rotated back to the quad
+            float lx = dx * c + dy * s;
+            float ly = dy * c - dx * s;
+
+            for (uint32 x = 0; x < span; ++x, lx += c, ly -= s)
+            {
+                if (std::fabs(lx) >= halfX || std::fabs(ly) >= halfY)
+                {
+                    row[x] = 0;
+                    continue;
+                }
+
+                const int32 u = std::clamp(int32(originU + lx * scaleU), 0, maxU);
+                const int32 v = std::clamp(int32(originV + ly * scaleV), 0, maxV);
+                row[x] = image.pixels[size_t(v) * image.width + u];
+            }
+
+            BlendRow(pixels.data() + size_t(y) * width + x0, row.data(), span, sprite.color);
+        }
+    }
+
+    void Canvas::Draw(const SpriteBatch & batch) noexcept
+    {
+        const SpriteInstance * instances = batch.Instances();
+
+        for (uint32 r = 0; r < batch.RunCount(); ++r)
+        {
+            const SpriteRun & run = batch.Runs()[r];
+
+            if (run.texture >= textures.size())
+                continue;
+
+            const Image & image = textures[run.texture];
+            for (uint32 i = run.first; i < run.first + run.count; ++i)
+                DrawSprite(image, instances[i]);
+        }
+    }
+}
@@ -0,0 +1,241 @@
+#include "FileWatcher.h"
+#include <algorithm>
+#include <filesystem>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace Luna
+{
+    namespace fs = std::filesystem;
+
+    // without inotify, how often the modification times are compared
+    constexpr double POLL_INTERVAL = 0.25;
+
+    static fs::path ExecutablePath(const string_view path)
+    {
+        const fs::path file { path };
+        if (file.is_absolute())
+            return file;
+
+    #ifdef _WIN32
+        char module[MAX_PATH];
+        GetModuleFileNameA(nullptr, module, MAX_PATH);
+        return fs::path{ module }.parent_path() / file;
+    #else
+        return fs::read_symlink("/proc/self/exe").parent_path() / file;
+    #endif
+    }
+
+    FileWatcher::FileWatcher() noexcept
+        : inotify{-1},
+        polled{ Clock::now() },
+        debounce{0.05},
+        nextId{1}
+    {
+    #ifndef _WIN32
+        inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    #endif
+    }
+
+    FileWatcher::~FileWatcher() noexcept
+    {
+    #ifndef _WIN32
+        if (inotify >= 0)
+            close(inotify);
+    #endif
+    }
+
+    uint32 FileWatcher::Watch(const string_view path, std::function<void(const string & path)> changed)
+    {
+        const fs::path target = ExecutablePath(path).lexically_normal();
+
+        std::error_code error;
+        const bool directory = fs::is_directory(target, error);
+
+        FileWatch watch{ nextId, -1,
+            (directory ? target : target.parent_path()).string(),
+            directory ? string{} : target.filename().string(),
+            std::move(changed) };
+
+        if (!fs::is_directory(watch.directory, error))
+            return 0;
+
+        // editors replace files by renaming over them, so the directory is watched
+        // rather than the file, whose watch would go with the old inode
+    #ifndef _WIN32
+        if (inotify >= 0)
+        {
+            watch.handle = inotify_add_watch(inotify, watch.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (watch.handle < 0)
+                return 0;
+        }
+    #endif
+
+        if (watch.handle < 0)
+        {
+            auto remember = [this](const fs::path & file)
+            {
+                std::error_code error;
+                times[file.string()] = fs::last_write_time(file, error).time_since_epoch().count();
+            };
+
+            if (directory)
+            {
+                for (const fs::directory_entry & item : fs::directory_iterator(target, error))
+                    remember(item.path());
+            }
+            else
+            {
+                remember(target);
+            }
+        }
+
+        watches.push_back(std::move(watch));
+        return nextId++;
+    }
+
+    void FileWatcher::Unwatch(const uint32 id)
+    {
+        auto found = std::find_if(watches.begin(), watches.end(), [id](const FileWatch & watch) { return watch.id == id; });
+        if (found == watches.end())
+            return;
+
+        const int handle = found->handle;
+        watches.erase(found);
+
+        // inotify hands out one watch per directory, shared by every Watch on it
+    #ifndef _WIN32
+        if (handle >= 0 && std::none_of(watches.begin(), watches.end(), [handle](const FileWatch & watch) { return watch.handle == handle; }))
+            inotify_rm_watch(inotify, handle);
+    #endif
+    }
+
+    void FileWatcher::Touch(const string & path, const FileWatch & watch, const Clock::time_point now)
+    {
+        Change & change = changes[path];
+        change.last = now;
+
+        if (std::find(change.watches.begin(), change.watches.end(), watch.id) == change.watches.end())
+            change.watches.push_back(watch.id);
+    }
+
+    void FileWatcher::Read(const Clock::time_point now)
+    {
+    #ifndef _WIN32
+        alignas(inotify_event) char buffer[4096];
+
+        ssize_t length;
+        while ((length = read(inotify, buffer, sizeof(buffer))) > 0)
+        {
+            for (ssize_t offset = 0; offset < length; )
+            {
+                const inotify_event * event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += ssize_t(sizeof(inotify_event) + event->len);
+
+                if (event->len == 0)
+                    continue;
+
+                const string_view name { event->name };
+                for (const FileWatch & watch : watches)
+                {
+                    if (watch.handle == event->wd && (watch.file.empty() || watch.file == name))
+                        Touch(watch.directory + '/' + string{ name }, watch, now);
+                }
+            }
+        }
+    #endif
+    }
+
+    void FileWatcher::Poll(const Clock::time_point now)
+    {
+        if (std::chrono::duration<double>(now - polled).count() < POLL_INTERVAL)
+            return;
+
+        polled = now;
+
+        auto check = [this, now](const fs::path & file, const FileWatch & watch)
+        {
+            std::error_code error;
+            const int64 time = fs::last_write_time(file, error).time_since_epoch().count();
+            if (error)
+                return;
+
+            auto [known, inserted] = times.try_emplace(file.string(), time);
+            if (inserted || known->second != time)
+            {
+                known->second = time;
+                Touch(file.string(), watch, now);
+            }
+        };
+
+        std::error_code error;
+        for (const FileWatch & watch : watches)
+        {
+            if (watch.handle >= 0)
+                continue;
+
+            if (!watch.file.empty())
+            {
+                check(fs::path{ watch.directory } / watch.file, watch);
+                continue;
+            }
+
+            for (const fs::directory_entry & item : fs::directory_iterator(watch.directory, error))
+            {
+                if (item.is_regular_file(error))
+                    check(item.path(), watch);
+            }
+        }
+    }
+
+    uint32 FileWatcher::Update()
+    {
+        if (watches.empty())
+            return 0;
+
+        const Clock::time_point now = Clock::now();
+
+        if (inotify >= 0)
+            Read(now);
+        else
+            Poll(now);
+
+        // callbacks may watch or unwatch, so settled changes are taken out first
+        std::vector<std::pair<string, std::vector<uint32>>> settled;
+        for (auto change = changes.begin(); change != changes.end(); )
+        {
+            if (std::chrono::duration<double>(now - change->second.last).count() < debounce)
+            {
+                ++change;
+                continue;
+            }
+
+            settled.emplace_back(change->first, std::move(change->second.watches));
+            change = changes.erase(change);
+        }
+
+        uint32 called = 0;
+        for (const auto & [path, ids] : settled)
+        {
+            for (const uint32 id : ids)
+            {
+                auto found = std::find_if(watches.begin(), watches.end(), [id](const FileWatch & watch) { return watch.id == id; });
+                if (found == watches.end())
+                    continue;
+
+                // a copy, the callback may change the watch list under it
+                const std::function<void(const string &)> changed = found->changed;
+                changed(path);
+                ++called;
+            }
+        }
+
+        return called;
+    }
+}
@@ -0,0 +1,421 @@
+#include "Font.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef LUNA_FREETYPE
+    #include <ft2build.h>
+    #include FT_FREETYPE_H
+#endif
+
+namespace Luna
+{
+    using namespace Math;
+
+    constexpr uint32 FONT_ATLAS_START_HEIGHT = 256;
+    constexpr uint32 FONT_ATLAS_EMPTY = 0x00ffffff;     // white, so filtering at glyph edges does not darken them
+
+    struct FontFace
+    {
+    #ifdef LUNA_FREETYPE
+        FT_Library library;
+        FT_Face face;
+    #endif
+        std::vector<uint32> indices;                    // FreeType index of each glyph, for kerning
+        uint32 resets;
+    };
+
+    uint32 DecodeUtf8(const string_view text, size_t & position) noexcept
+    {
+        const uint8 lead = uint8(text[position++]);
+        if (lead < 0x80)
+            return lead;
+
+        const uint32 length = lead >= 0xf0 ? 3 : lead >= 0xe0 ? 2 : lead >= 0xc0 ? 1 : 0;
+        if (length == 0 || lead >= 0xf8 || position + length > text.size())
+            return 0xfffd;
+
+        uint32 codepoint = lead & (0x3f >> length);
+        for (uint32 i = 0; i < length; ++i)
+        {
+            const uint8 next = uint8(text[position]);
+            if ((next & 0xc0) != 0x80)
+                return 0xfffd;
+
+            codepoint = (codepoint << 6) | (next & 0x3f);
+            ++position;
+        }
+
+        return codepoint;
+    }
+
+    Font::Font() noexcept
+        : face{nullptr},
+        pixelSize{},
+        ascender{},
+        lineHeight{},
+        atlasHeight{FONT_ATLAS_START_HEIGHT},
+        dirtyFirst{},
+        dirtyEnd{},
+        ascii{}
+    {
+        Reset();
+    }
+
+    Font::~Font() noexcept
+    {
+        if (!face)
+            return;
+
+    #ifdef LUNA_FREETYPE
+        if (face->face)
+            FT_Done_Face(face->face);
+        FT_Done_FreeType(face->library);
+    #endif
+        delete face;
+    }
+
+    bool Font::Load([[maybe_unused]] const string_view path, [[maybe_unused]] const uint32 pixelSize)
+    {
+        this->pixelSize = 0;
+
+    #ifdef LUNA_FREETYPE
+        if (!face)
+        {
+            face = new FontFace{};
+            if (FT_Init_FreeType(&face->library) != 0)
+            {
+                delete face;
+                face = nullptr;
+                return false;
+            }
+        }
+
+        if (face->face)
+            FT_Done_Face(face->face);
+        face->face = nullptr;
+
+        if (FT_New_Face(face->library, string{ path }.c_str(), 0, &face->face) != 0
+            || FT_Set_Pixel_Sizes(face->face, 0, pixelSize) != 0)
+        {
+            if (face->face)
+                FT_Done_Face(face->face);
+            face->face = nullptr;
+            return false;
+        }
+
+        this->pixelSize = pixelSize;
+        ascender = std::round(float(face->face->size->metrics.ascender) / 64.0f);
+        lineHeight = std::round(float(face->face->size->metrics.height) / 64.0f);
+
+        atlasHeight = FONT_ATLAS_START_HEIGHT;
+        Reset();
+        return true;
+    #else
+        return false;
+    #endif
+    }
+
+    void Font::Reset()
+    {
+        atlas.assign(size_t(FONT_ATLAS_WIDTH) * atlasHeight, FONT_ATLAS_EMPTY);
+        dirtyFirst = 0;
+        dirtyEnd = atlasHeight;
+
+        // a 2x2 opaque block in the corner, for solid quads drawn with the text
+        atlas[0] = atlas[1] = atlas[FONT_ATLAS_WIDTH] = atlas[FONT_ATLAS_WIDTH + 1] = 0xffffffff;
+        skyline.assign({ SkylineNode{ 0, 3, 3 }, SkylineNode{ 3, 0, FONT_ATLAS_WIDTH - 3 } });
+
+        glyphs.clear();
+        std::fill(std::begin(ascii), std::end(ascii), 0);
+        others.clear();
+        runs.clear();
+        previousRuns.clear();
+
+        if (face)
+        {
+            face->indices.clear();
+            ++face->resets;
+        }
+    }
+
+    bool Font::Pack(const uint32 width, const uint32 height, uint32 & x, uint32 & y)
+    {
+        if (width > FONT_ATLAS_WIDTH)
+            return false;
+
+        for (;;)
+        {
+            // bottom left: the lowest place the rectangle fits, narrower nodes on ties
+            size_t best = skyline.size();
+            uint32 bestTop = ~0U;
+            uint32 bestWidth = ~0U;
+
+            for (size_t i = 0; i < skyline.size() && skyline[i].x + width <= FONT_ATLAS_WIDTH; ++i)
+            {
+                uint32 top = 0;
+                uint32 remaining = width;
+                for (size_t j = i; ; ++j)
+                {
+                    top = std::max(top, skyline[j].y);
+                    if (skyline[j].width >= remaining)
+                        break;
+                    remaining -= skyline[j].width;
+                }
+
+                if (top + height > atlasHeight)
+                    continue;
+
+                if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth))
+                {
+                    best = i;
+                    bestTop = top;
+                    bestWidth = skyline[i].width;
+                }
+            }
+
+            if (best < skyline.size())
+            {
+                x = skyline[best].x;
+                y = bestTop;
+
+                // the new node covers the ones it sits on, which shrink or go
+                skyline.insert(skyline.begin() + best, SkylineNode{ x, y + height, width });
+                for (size_t i = best + 1; i < skyline.size(); )
+                {
+                    const uint32 end = x + width;
+                    if (skyline[i].x >= end)
+                        break;
+
+                    const uint32 overlap = end - skyline[i].x;
+                    if (skyline[i].width <= overlap)
+                    {
+                        skyline.erase(skyline.begin() + i);
+                        continue;
+                    }
+
+                    skyline[i].x += overlap;
+                    skyline[i].width -= overlap;
+                    break;
+                }
+
+                for (size_t i = 0; i + 1 < skyline.size(); )
+                {
+                    if (skyline[i].y == skyline[i + 1].y)
+                    {
+                        skyline[i].width += skyline[i + 1].width;
+                        skyline.erase(skyline.begin() + i + 1);
+                    }
+                    else
+                    {
+                        ++i;
+                    }
+                }
+
+                return true;
+            }
+
+            if (atlasHeight >= FONT_ATLAS_MAX_HEIGHT)
+                return false;
+
+            // rows are appended, what is packed keeps its place; the renderer sees
+            // the new height and uploads the atlas again
+            atlasHeight *= 2;
+            atlas.resize(size_t(FONT_ATLAS_WIDTH) * atlasHeight, FONT_ATLAS_EMPTY);
+            dirtyFirst = 0;
+            dirtyEnd = atlasHeight;
+        }
+    }
+
+    uint32 Font::Rasterize([[maybe_unused]] const uint32 codepoint)
+    {
+        Glyph glyph{};
+        uint32 index = 0;
+
+    #ifdef LUNA_FREETYPE
+        FT_Face ftFace = face->face;
+        index = FT_Get_Char_Index(ftFace, codepoint);
+
+        if (FT_Load_Glyph(ftFace, index, FT_LOAD_RENDER | FT_LOAD_TARGET_LIGHT) == 0)
+        {
+            const FT_GlyphSlot slot = ftFace->glyph;
+            const FT_Bitmap & bitmap = slot->bitmap;
+
+            glyph.width = uint16(bitmap.width);
+            glyph.height = uint16(bitmap.rows);
+            glyph.left = int16(slot->bitmap_left);
+            glyph.top = int16(slot->bitmap_top);
+            glyph.advance = float(slot->advance.x) / 64.0f;
+
+            // a texel of padding keeps filtering from reaching the neighbours
+            uint32 x = 0, y = 0;
+            if (glyph.width > 0 && glyph.height > 0)
+            {
+                if (!Pack(glyph.width + 1, glyph.height + 1, x, y))
+                {
+                    Reset();
+                    if (!Pack(glyph.width + 1, glyph.height + 1, x, y))
+                        glyph.width = glyph.height = 0;
+                }
+            }
+
+            glyph.x = uint16(x);
+            glyph.y = uint16(y);
+
+            for (uint32 row = 0; row < glyph.height; ++row)
+            {
+                const uint8 * coverage = bitmap.buffer + int32(row) * bitmap.pitch;
+                uint32 * texels = atlas.data() + size_t(y + row) * FONT_ATLAS_WIDTH + x;
+                for (uint32 column = 0; column < glyph.width; ++column)
+                    texels[column] = (uint32(coverage[column]) << 24) | FONT_ATLAS_EMPTY;
+            }
+
+            if (glyph.height > 0)
+            {
+                dirtyFirst = std::min(dirtyFirst, y);
+                dirtyEnd = std::max(dirtyEnd, y + glyph.height);
+            }
+        }
+    #endif
+
+        glyphs.push_back(glyph);
+        face->indices.push_back(index);
+        return uint32(glyphs.size() - 1);
+    }
+
+    uint32 Font::Find(const uint32 codepoint)
+    {
+        if (codepoint < 128)
+        {
+            if (ascii[codepoint] == 0)
+            {
+                const uint32 index = Rasterize(codepoint);
+                ascii[codepoint] = index + 1;
+            }
+            return ascii[codepoint] - 1;
+        }
+
+        auto found = others.find(codepoint);
+        if (found != others.end())
+            return found->second;
+
+        const uint32 index = Rasterize(codepoint);
+        others.emplace(codepoint, index);
+        return index;
+    }
+
+    const TextRun & Font::Shape(const string_view text)
+    {
+        auto found = runs.find(text);
+        if (found != runs.end())
+            return found->second;
+
+        // two generations: a run missed by this one survives if the last one had it
+        if (runs.size() >= FONT_RUN_CACHE)
+        {
+            previousRuns = std::move(runs);
+            runs.clear();
+        }
+
+        auto previous = previousRuns.find(text);
+        if (previous != previousRuns.end())
+            return runs.insert(previousRuns.extract(previous)).position->second;
+
+        TextRun run;
+        if (pixelSize == 0)
+            return runs.emplace(string{ text }, std::move(run)).first->second;
+
+        // an atlas that starts over halfway through invalidates the glyphs found so far
+        for (uint32 attempt = 0; attempt < 2; ++attempt)
+        {
+            const uint32 resets = face->resets;
+            run = TextRun{};
+
+            Vec2 pen { 0.0f, ascender };
+            [[maybe_unused]] uint32 previousIndex = 0;
+
+            for (size_t position = 0; position < text.size(); )
+            {
+                const uint32 codepoint = DecodeUtf8(text, position);
+                if (codepoint == '\n')
+                {
+                    run.size.x = std::max(run.size.x, pen.x);
+                    pen = Vec2{ 0.0f, pen.y + lineHeight };
+                    previousIndex = 0;
+                    continue;
+                }
+
+                const uint32 glyph = Find(codepoint);
+                const uint32 index = face->indices[glyph];
+
+            #ifdef LUNA_FREETYPE
+                if (previousIndex && index && FT_HAS_KERNING(face->face))
+                {
+                    FT_Vector kerning;
+                    if (FT_Get_Kerning(face->face, previousIndex, index, FT_KERNING_DEFAULT, &kerning) == 0)
+                        pen.x += float(kerning.x) / 64.0f;
+                }
+            #endif
+
+                run.glyphs.push_back(glyph);
+                run.pens.push_back(pen);
+                pen.x += glyphs[glyph].advance;
+                previousIndex = index;
+            }
+
+            run.size.x = std::max(run.size.x, pen.x);
+            run.size.y = pen.y - ascender + lineHeight;
+
+            if (resets == face->resets)
+                break;
+        }
+
+        return runs.emplace(string{ text }, std::move(run)).first->second;
+    }
+
+    Vec2 Font::Measure(const string_view text)
+    {
+        return Shape(text).size;
+    }
+
+    void Font::Draw(SpriteBatch & batch, const uint32 texture, const string_view text, const Vec2 & position,
+        const uint32 color, const uint8 layer)
+    {
+        const TextRun & run = Shape(text);
+
+        const float u = 1.0f / float(FONT_ATLAS_WIDTH);
+        const float v = 1.0f / float(atlasHeight);
+
+        for (size_t i = 0; i < run.glyphs.size(); ++i)
+        {
+            const Glyph & glyph = glyphs[run.glyphs[i]];
+            if (glyph.width == 0)
+                continue;
+
+            // whole pixels, so the atlas is sampled texel for texel
+            const float left = std::round(position.x + run.pens[i].x) + float(glyph.left);
+            const float top = std::round(position.y + run.pens[i].y) - float(glyph.top);
+            const Vec2 size { float(glyph.width), float(glyph.height) };
+
+            const SpriteInstance sprite {
+                Vec2{ left + size.x * 0.5f, top + size.y * 0.5f },
+                size,
+                Vec4{ glyph.x * u, glyph.y * v, (glyph.x + size.x) * u, (glyph.y + size.y) * v },
+                color,
+                0.0f };
+
+            batch.Draw(texture, sprite, layer);
+        }
+    }
+
+    bool Font::Dirty(uint32 & firstRow, uint32 & rowCount) noexcept
+    {
+        if (dirtyFirst >= dirtyEnd)
+            return false;
+
+        firstRow = dirtyFirst;
+        rowCount = dirtyEnd - dirtyFirst;
+        dirtyFirst = ~0U;
+        dirtyEnd = 0;
+        return true;
+    }
+}
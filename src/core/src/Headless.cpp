@@ -0,0 +1,109 @@
+#include "Headless.h"
+#include "Overlay.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace Luna
+{
+    template<typename... Args>
+    static void Append(string & text, const char * format, const Args... args)
+    {
+        char buffer[256];
+        const int length = snprintf(buffer, sizeof(buffer), format, args...);
+        text.append(buffer, size_t(std::clamp(length, 0, int(sizeof(buffer)) - 1)));
+    }
+
+    // names come from string literals in the code, only quotes and backslashes need escaping
+    static string Escape(const string_view name)
+    {
+        string escaped;
+        for (const char c : name)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    PerfSummary::PerfSummary() noexcept
+        : reportFrame{ ~0ULL }
+    {
+    }
+
+    void PerfSummary::Frame(const double milliseconds, const FrameReport & report)
+    {
+        frameTimes.push_back(float(milliseconds));
+
+        // a report arrives once, possibly frames after its own frame
+        if (report.frame == reportFrame)
+            return;
+        reportFrame = report.frame;
+
+        for (const ProfileEntry & entry : report.entries)
+        {
+            auto zone = std::find_if(zones.begin(), zones.end(), [&](const Zone & z)
+                { return z.depth == entry.depth && z.name == entry.name; });
+
+            if (zone == zones.end())
+                zone = zones.insert(zones.end(), Zone{ entry.name, entry.depth, 0, 0.0, 0.0, 0.0 });
+
+            ++zone->count;
+            zone->cpu += entry.cpu;
+            zone->gpu += entry.gpu;
+            zone->cpuMax = std::max(zone->cpuMax, entry.cpu);
+        }
+    }
+
+    string PerfSummary::Json() const
+    {
+        std::vector<float> sorted = frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for (const float time : sorted)
+            total += time;
+
+        const auto percentile = [&](const double p)
+        { return sorted.empty() ? 0.0 : double(sorted[std::min(sorted.size() - 1, size_t(p * sorted.size()))]); };
+
+        const size_t count = sorted.size();
+        string json = "{\n";
+        Append(json, "  \"frames\": %zu,\n", count);
+        Append(json, "  \"wall_seconds\": %.3f,\n", total / 1000.0);
+        Append(json, "  \"fps\": %.2f,\n", total > 0.0 ? 1000.0 * count / total : 0.0);
+        Append(json, "  \"frame_ms\": { \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+            count ? total / count : 0.0,
+            count ? double(sorted.front()) : 0.0,
+            percentile(0.50), percentile(0.90), percentile(0.99),
+            count ? double(sorted.back()) : 0.0);
+        Append(json, "  \"peak_memory_bytes\": %llu,\n", (unsigned long long)PeakMemory());
+
+        json += "  \"zones\": [";
+        for (size_t i = 0; i < zones.size(); ++i)
+        {
+            const Zone & zone = zones[i];
+            Append(json, "%s\n    { \"name\": \"%s\", \"depth\": %u, \"cpu_ms\": %.4f, \"cpu_max_ms\": %.4f, \"gpu_ms\": %.4f }",
+                i ? "," : "", Escape(zone.name).c_str(), zone.depth,
+                zone.cpu / zone.count, zone.cpuMax, zone.gpu / zone.count);
+        }
+        json += zones.empty() ? "]\n}\n" : "\n  ]\n}\n";
+
+        return json;
+    }
+
+    bool PerfSummary::Write(const string_view path) const
+    {
+        const string json = Json();
+
+        if (path.empty())
+            return fwrite(json.data(), 1, json.size(), stdout) == json.size();
+
+        FILE * file = fopen(string{ path }.c_str(), "wb");
+        if (!file)
+            return false;
+
+        const bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+        return fclose(file) == 0 && written;
+    }
+}
@@ -0,0 +1,257 @@
+#include "Latency.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Luna
+{
+    constexpr uint64 LATENCY_TIMEOUT = 1'000'000'000;    // a tag not on screen after a second is lost
+    constexpr size_t LATENCY_QUEUE = 8;                  // frames presented without feedback before giving up on it
+
+    static const char * const STAGE_NAMES[LATENCY_STAGES]
+    {
+        "sent", "received", "update", "draw", "present", "displayed"
+    };
+
+    template<typename... Args>
+    static void Append(string & text, const char * format, const Args... args)
+    {
+        char buffer[256];
+        const int length = snprintf(buffer, sizeof(buffer), format, args...);
+        text.append(buffer, size_t(std::clamp(length, 0, int(sizeof(buffer)) - 1)));
+    }
+
+    LatencyProbe::LatencyProbe(const LatencyConfig & config)
+        : config{ config },
+        frame{},
+        lastSent{},
+        lost{},
+        feedback{ FEEDBACK_UNKNOWN }
+    {
+        samples.reserve(config.samples);
+    }
+
+    uint64 LatencyProbe::Now() noexcept
+    {
+        // steady_clock is CLOCK_MONOTONIC on Linux
+        return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    bool LatencyProbe::Due() const noexcept
+    {
+        // one tag in flight at a time, so key presses and tags never pair up wrong
+        return tags.empty() && !Done() && frame >= lastSent + config.interval;
+    }
+
+    // ---------------------------------------------------
+
+    void LatencyProbe::Sent(const uint64 time)
+    {
+        Tag tag{};
+        tag.stamps[LATENCY_SENT] = time;
+        tags.push_back(tag);
+        lastSent = frame;
+    }
+
+    bool LatencyProbe::Received(const uint64 time)
+    {
+        for (Tag & tag : tags)
+        {
+            if (tag.stamps[LATENCY_RECEIVED] == 0)
+            {
+                tag.stamps[LATENCY_RECEIVED] = time;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void LatencyProbe::Arrived(const uint64 sent, const uint64 time)
+    {
+        if (Done() || !tags.empty())
+            return;
+
+        Tag tag{};
+        tag.stamps[LATENCY_SENT] = std::min(sent, time);
+        tag.stamps[LATENCY_RECEIVED] = time;
+        tags.push_back(tag);
+    }
+
+    void LatencyProbe::Stage(const LatencyStage stage, const uint64 time)
+    {
+        if (stage == LATENCY_UPDATE)
+        {
+            ++frame;
+
+            const auto expired = std::remove_if(tags.begin(), tags.end(), [time](const Tag & tag)
+                { return time - tag.stamps[LATENCY_SENT] > LATENCY_TIMEOUT; });
+            lost += uint32(tags.end() - expired);
+            tags.erase(expired, tags.end());
+
+            // a frame that skipped Present hands its tags to this one
+            for (Tag & tag : tags)
+                if (tag.stamps[LATENCY_RECEIVED] != 0 && tag.stamps[LATENCY_PRESENT] == 0)
+                    tag.frame = frame;
+        }
+
+        for (Tag & tag : tags)
+            if (tag.frame == frame)
+                tag.stamps[stage] = time;
+
+        if (stage != LATENCY_PRESENT)
+            return;
+
+        if (feedback != FEEDBACK_OFF)
+            presented.push_back(frame);
+
+        // no feedback for a while: this presentation path has none, the frame ends at Present
+        if (feedback == FEEDBACK_UNKNOWN && presented.size() > LATENCY_QUEUE)
+        {
+            feedback = FEEDBACK_OFF;
+            presented.clear();
+        }
+
+        if (feedback != FEEDBACK_OFF)
+            return;
+
+        for (auto tag = tags.begin(); tag != tags.end();)
+        {
+            if (tag->frame != 0 && tag->frame <= frame)
+            {
+                Complete(*tag);
+                tag = tags.erase(tag);
+            }
+            else
+            {
+                ++tag;
+            }
+        }
+    }
+
+    void LatencyProbe::Displayed(const uint64 time)
+    {
+        if (feedback == FEEDBACK_OFF || presented.empty())
+            return;
+
+        feedback = FEEDBACK_ON;
+        const uint64 shown = presented.front();
+        presented.pop_front();
+
+        for (auto tag = tags.begin(); tag != tags.end();)
+        {
+            if (tag->frame == shown)
+            {
+                tag->stamps[LATENCY_DISPLAYED] = time;
+                Complete(*tag);
+                tag = tags.erase(tag);
+            }
+            else
+            {
+                ++tag;
+            }
+        }
+    }
+
+    void LatencyProbe::Discarded()
+    {
+        if (feedback == FEEDBACK_OFF || presented.empty())
+            return;
+
+        feedback = FEEDBACK_ON;
+        const uint64 dropped = presented.front();
+        presented.pop_front();
+
+        // the input shows up in the next frame that reaches the screen
+        for (Tag & tag : tags)
+            if (tag.frame == dropped)
+                tag.frame = dropped + 1;
+    }
+
+    void LatencyProbe::Complete(const Tag & tag)
+    {
+        if (Done())
+            return;
+
+        std::array<float, LATENCY_STAGES> sample{};
+        for (uint32 stage = LATENCY_RECEIVED; stage < LATENCY_STAGES; ++stage)
+            if (tag.stamps[stage] >= tag.stamps[LATENCY_SENT])
+                sample[stage] = float(double(tag.stamps[stage] - tag.stamps[LATENCY_SENT]) / 1'000'000.0);
+
+        samples.push_back(sample);
+    }
+
+    // ---------------------------------------------------
+
+    string LatencyProbe::Json(const string_view backend) const
+    {
+        string json = "{\n";
+        Append(json, "  \"backend\": \"%.*s\",\n", int(backend.size()), backend.data());
+        Append(json, "  \"samples\": %zu,\n", samples.size());
+        Append(json, "  \"lost\": %u,\n", lost);
+        Append(json, "  \"display_feedback\": %s,\n", feedback == FEEDBACK_ON ? "true" : "false");
+        json += "  \"stages\": [";
+
+        // the time from injection to each stage, and spent in it since the previous one
+        std::vector<float> total, step;
+        bool first = true;
+        for (uint32 stage = LATENCY_RECEIVED; stage < LATENCY_STAGES; ++stage)
+        {
+            if (stage == LATENCY_DISPLAYED && feedback != FEEDBACK_ON)
+                continue;
+
+            total.clear();
+            step.clear();
+            for (const auto & sample : samples)
+            {
+                total.push_back(sample[stage]);
+                step.push_back(std::max(sample[stage] - sample[stage - 1], 0.0f));
+            }
+
+            std::sort(total.begin(), total.end());
+            std::sort(step.begin(), step.end());
+
+            const auto distribution = [&json](const char * name, const std::vector<float> & sorted)
+            {
+                double sum = 0.0;
+                for (const float value : sorted)
+                    sum += value;
+
+                const auto percentile = [&sorted](const double p)
+                { return sorted.empty() ? 0.0 : double(sorted[std::min(sorted.size() - 1, size_t(p * sorted.size()))]); };
+
+                Append(json, "\"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f }",
+                    name,
+                    sorted.empty() ? 0.0 : sum / sorted.size(),
+                    percentile(0.50), percentile(0.90), percentile(0.99),
+                    sorted.empty() ? 0.0 : double(sorted.back()));
+            };
+
+            Append(json, "%s\n    { \"stage\": \"%s\", ", first ? "" : ",", STAGE_NAMES[stage]);
+            distribution("total_ms", total);
+            json += ", ";
+            distribution("step_ms", step);
+            json += " }";
+            first = false;
+        }
+
+        json += first ? "]\n}\n" : "\n  ]\n}\n";
+        return json;
+    }
+
+    bool LatencyProbe::Write(const string_view backend) const
+    {
+        const string json = Json(backend);
+
+        if (config.report.empty())
+            return fwrite(json.data(), 1, json.size(), stdout) == json.size();
+
+        FILE * file = fopen(config.report.c_str(), "wb");
+        if (!file)
+            return false;
+
+        const bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+        return fclose(file) == 0 && written;
+    }
+}
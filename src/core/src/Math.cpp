@@ -0,0 +1,189 @@
+#include "Math.h"
+#include "MathBatch.h"
+
+namespace Luna::Math
+{
+    Quat Slerp(const Quat & a, const Quat & b, const float t) noexcept
+    {
+        Quat end = b;
+        float cosTheta = Dot(a, b);
+
+        // take the short way around
+        if (cosTheta < 0.0f)
+        {
+            end = { -b.x, -b.y, -b.z, -b.w };
+            cosTheta = -cosTheta;
+        }
+
+        float wa = 1.0f - t;
+        float wb = t;
+
+        // nearly parallel quaternions fall back to a normalized lerp
+        if (cosTheta < 0.9995f)
+        {
+            const float theta = std::acos(cosTheta);
+            const float sinTheta = std::sin(theta);
+            wa = std::sin((1.0f - t) * theta) / sinTheta;
+            wb = std::sin(t * theta) / sinTheta;
+        }
+
+        return Normalize(Quat {
+            a.x * wa + end.x * wb,
+            a.y * wa + end.y * wb,
+            a.z * wa + end.z * wb,
+            a.w * wa + end.w * wb });
+    }
+
+    Mat4 Mat4::RotationX(const float radians) noexcept
+    {
+        const float c = std::cos(radians), s = std::sin(radians);
+        return { { 1, 0, 0, 0 }, { 0, c, s, 0 }, { 0, -s, c, 0 }, { 0, 0, 0, 1 } };
+    }
+
+    Mat4 Mat4::RotationY(const float radians) noexcept
+    {
+        const float c = std::cos(radians), s = std::sin(radians);
+        return { { c, 0, -s, 0 }, { 0, 1, 0, 0 }, { s, 0, c, 0 }, { 0, 0, 0, 1 } };
+    }
+
+    Mat4 Mat4::RotationZ(const float radians) noexcept
+    {
+        const float c = std::cos(radians), s = std::sin(radians);
+        return { { c, s, 0, 0 }, { -s, c, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } };
+    }
+
+    Mat4 Mat4::Perspective(const float fovY, const float aspect, const float zNear, const float zFar) noexcept
+    {
+        const float f = 1.0f / std::tan(fovY * 0.5f);
+        const float range = zFar / (zNear - zFar);
+
+        return {
+            { f / aspect, 0, 0, 0 },
+            { 0, f, 0, 0 },
+            { 0, 0, range, -1 },
+            { 0, 0, zNear * range, 0 }
+        };
+    }
+
+    Mat4 Mat4::Orthographic(const float left, const float right, const float bottom, const float top,
+        const float zNear, const float zFar) noexcept
+    {
+        return {
+            { 2.0f / (right - left), 0, 0, 0 },
+            { 0, 2.0f / (top - bottom), 0, 0 },
+            { 0, 0, 1.0f / (zNear - zFar), 0 },
+            { -(right + left) / (right - left), -(top + bottom) / (top - bottom), zNear / (zNear - zFar), 1 }
+        };
+    }
+
+    Mat4 Mat4::LookAt(const Vec3 & eye, const Vec3 & target, const Vec3 & up) noexcept
+    {
+        const Vec3 f = Normalize(target - eye);
+        const Vec3 s = Normalize(Cross(f, up));
+        const Vec3 u = Cross(s, f);
+
+        return {
+            { s.x, u.x, -f.x, 0 },
+            { s.y, u.y, -f.y, 0 },
+            { s.z, u.z, -f.z, 0 },
+            { -Dot(s, eye), -Dot(u, eye), Dot(f, eye), 1 }
+        };
+    }
+
+    Mat4 Inverse(const Mat4 & m) noexcept
+    {
+        const float * a = &m[0].x;
+        float inv[16];
+
+        inv[0]  =  a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+        inv[4]  = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+        inv[8]  =  a[4] * a[9]  * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+        inv[12] = -a[4] * a[9]  * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+        inv[1]  = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+        inv[5]  =  a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+        inv[9]  = -a[0] * a[9]  * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+        inv[13] =  a[0] * a[9]  * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+        inv[2]  =  a[1] * a[6]  * a[15] - a[1] * a[7]  * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7]  - a[13] * a[3] * a[6];
+        inv[6]  = -a[0] * a[6]  * a[15] + a[0] * a[7]  * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7]  + a[12] * a[3] * a[6];
+        inv[10] =  a[0] * a[5]  * a[15] - a[0] * a[7]  * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7]  - a[12] * a[3] * a[5];
+        inv[14] = -a[0] * a[5]  * a[14] + a[0] * a[6]  * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6]  + a[12] * a[2] * a[5];
+        inv[3]  = -a[1] * a[6]  * a[11] + a[1] * a[7]  * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9]  * a[2] * a[7]  + a[9]  * a[3] * a[6];
+        inv[7]  =  a[0] * a[6]  * a[11] - a[0] * a[7]  * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8]  * a[2] * a[7]  - a[8]  * a[3] * a[6];
+        inv[11] = -a[0] * a[5]  * a[11] + a[0] * a[7]  * a[9]  + a[4] * a[1] * a[11] - a[4] * a[3] * a[9]  - a[8]  * a[1] * a[7]  + a[8]  * a[3] * a[5];
+        inv[15] =  a[0] * a[5]  * a[10] - a[0] * a[6]  * a[9]  - a[4] * a[1] * a[10] + a[4] * a[2] * a[9]  + a[8]  * a[1] * a[6]  - a[8]  * a[2] * a[5];
+
+        const float det = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+        const float invDet = (det != 0.0f) ? 1.0f / det : 0.0f;
+
+        Mat4 r;
+        float * out = &r[0].x;
+        for (uint32 i = 0; i < 16; ++i)
+            out[i] = inv[i] * invDet;
+
+        return r;
+    }
+
+    void TransformPoints(const Mat4 & m, const Vec3 * in, Vec3 * out, const size_t count) noexcept
+    {
+        // interleaved input does not map well to 8-wide registers, a scalar
+        // loop with the matrix kept in registers is faster than gathering
+        const Vec4 c0 = m[0], c1 = m[1], c2 = m[2], c3 = m[3];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vec3 p = in[i];
+            out[i] = {
+                c0.x * p.x + c1.x * p.y + c2.x * p.z + c3.x,
+                c0.y * p.x + c1.y * p.y + c2.y * p.z + c3.y,
+                c0.z * p.x + c1.z * p.y + c2.z * p.z + c3.z };
+        }
+    }
+
+    void TransformPoints(const Mat4 & m,
+        const float * x, const float * y, const float * z,
+        float * outX, float * outY, float * outZ,
+        const size_t count) noexcept
+    {
+        size_t i = 0;
+
+    #if defined(LUNA_MATH_AVX2)
+        for (; i + 8 <= count; i += 8)
+            TransformPoint(m, Vec3x8::Load(x + i, y + i, z + i)).Store(outX + i, outY + i, outZ + i);
+    #elif defined(LUNA_MATH_SSE4)
+        const float * row[3] { &m[0].x, &m[0].y, &m[0].z };
+        float * out[3] { outX, outY, outZ };
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 px = _mm_loadu_ps(x + i);
+            const __m128 py = _mm_loadu_ps(y + i);
+            const __m128 pz = _mm_loadu_ps(z + i);
+
+            for (uint32 r = 0; r < 3; ++r)
+            {
+                __m128 c = _mm_set1_ps(row[r][12]);
+                c = _mm_add_ps(c, _mm_mul_ps(_mm_set1_ps(row[r][0]), px));
+                c = _mm_add_ps(c, _mm_mul_ps(_mm_set1_ps(row[r][4]), py));
+                c = _mm_add_ps(c, _mm_mul_ps(_mm_set1_ps(row[r][8]), pz));
+                _mm_storeu_ps(out[r] + i, c);
+            }
+        }
+    #endif
+
+        const Vec4 c0 = m[0], c1 = m[1], c2 = m[2], c3 = m[3];
+
+        for (; i < count; ++i)
+        {
+            const float px = x[i], py = y[i], pz = z[i];
+            outX[i] = c0.x * px + c1.x * py + c2.x * pz + c3.x;
+            outY[i] = c0.y * px + c1.y * py + c2.y * pz + c3.y;
+            outZ[i] = c0.z * px + c1.z * py + c2.z * pz + c3.z;
+        }
+    }
+
+    void Multiply(const Mat4 * a, const Mat4 * b, Mat4 * out, const size_t count) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = a[i] * b[i];
+    }
+}
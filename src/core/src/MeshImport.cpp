@@ -0,0 +1,620 @@
+#include "MeshProcessing.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Luna
+{
+    using namespace Math;
+    namespace fs = std::filesystem;
+
+    static bool ReadFile(const fs::path & path, std::vector<uint8> & data)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        data.resize(size_t(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+        return bool(file);
+    }
+
+    // area weighted, for the vertices that came without a normal
+    static void GenerateNormals(MeshData & mesh, const uint32 first)
+    {
+        for (uint32 i = first; i + 2 < mesh.vertices.size(); i += 3)
+        {
+            MeshVertex * triangle = &mesh.vertices[i];
+            if (!(triangle[0].normal == Vec3{}) || !(triangle[1].normal == Vec3{}) || !(triangle[2].normal == Vec3{}))
+                continue;
+
+            const Vec3 normal = Cross(triangle[1].position - triangle[0].position, triangle[2].position - triangle[0].position);
+            const float length = Length(normal);
+            const Vec3 unit = length > 0.0f ? normal / length : Vec3{ 0.0f, 0.0f, 1.0f };
+
+            triangle[0].normal = triangle[1].normal = triangle[2].normal = unit;
+        }
+    }
+
+    // ---------------------------------------------------
+    // OBJ
+    // ---------------------------------------------------
+
+    static const char * SkipSpaces(const char * text, const char * end) noexcept
+    {
+        while (text < end && (*text == ' ' || *text == '\t'))
+            ++text;
+        return text;
+    }
+
+    static const char * ParseFloat(const char * text, const char * end, float & value) noexcept
+    {
+        text = SkipSpaces(text, end);
+        const auto [next, error] = std::from_chars(text, end, value);
+        return error == std::errc{} ? next : text;
+    }
+
+    bool ImportObj(const string_view path, MeshData & mesh)
+    {
+        std::vector<uint8> data;
+        if (!ReadFile(fs::path{ path }, data))
+            return false;
+
+        std::vector<Vec3> positions;
+        std::vector<Vec3> normals;
+        std::vector<Vec2> texCoords;
+        std::vector<MeshVertex> polygon;
+
+        const uint32 first = uint32(mesh.vertices.size());
+        const char * text = reinterpret_cast<const char*>(data.data());
+        const char * end = text + data.size();
+
+        while (text < end)
+        {
+            const char * lineEnd = static_cast<const char*>(memchr(text, '\n', size_t(end - text)));
+            if (!lineEnd)
+                lineEnd = end;
+
+            const char * line = SkipSpaces(text, lineEnd);
+            text = lineEnd + 1;
+
+            if (lineEnd - line < 2)
+                continue;
+
+            if (line[0] == 'v' && line[1] == ' ')
+            {
+                Vec3 p;
+                ParseFloat(ParseFloat(ParseFloat(line + 2, lineEnd, p.x), lineEnd, p.y), lineEnd, p.z);
+                positions.push_back(p);
+            }
+            else if (line[0] == 'v' && line[1] == 'n')
+            {
+                Vec3 n;
+                ParseFloat(ParseFloat(ParseFloat(line + 2, lineEnd, n.x), lineEnd, n.y), lineEnd, n.z);
+                normals.push_back(n);
+            }
+            else if (line[0] == 'v' && line[1] == 't')
+            {
+                Vec2 t;
+                ParseFloat(ParseFloat(line + 2, lineEnd, t.x), lineEnd, t.y);
+                texCoords.push_back(t);
+            }
+            else if (line[0] == 'f' && line[1] == ' ')
+            {
+                polygon.clear();
+
+                // v, v/t, v//n or v/t/n, negative indices count from the end
+                const char * cursor = line + 2;
+                while ((cursor = SkipSpaces(cursor, lineEnd)) < lineEnd && *cursor != '\r')
+                {
+                    int64 reference[3] {};
+                    for (uint32 k = 0; k < 3 && cursor < lineEnd; ++k)
+                    {
+                        if (*cursor != '/')
+                            cursor = std::from_chars(cursor, lineEnd, reference[k]).ptr;
+                        if (cursor >= lineEnd || *cursor != '/')
+                            break;
+                        ++cursor;
+                    }
+
+                    auto resolve = [](const int64 index, const size_t count) -> int64
+                    { return index < 0 ? int64(count) + index : index - 1; };
+
+                    const int64 p = resolve(reference[0], positions.size());
+                    const int64 t = resolve(reference[1], texCoords.size());
+                    const int64 n = resolve(reference[2], normals.size());
+
+                    if (reference[0] == 0 || p < 0 || p >= int64(positions.size()))
+                        return false;
+
+                    MeshVertex vertex{};
+                    vertex.position = positions[size_t(p)];
+                    if (reference[1] != 0 && t >= 0 && t < int64(texCoords.size()))
+                        vertex.texCoord = texCoords[size_t(t)];
+                    if (reference[2] != 0 && n >= 0 && n < int64(normals.size()))
+                        vertex.normal = normals[size_t(n)];
+
+                    polygon.push_back(vertex);
+
+                    while (cursor < lineEnd && *cursor != ' ' && *cursor != '\t' && *cursor != '\r')
+                        ++cursor;
+                }
+
+                // fan, OBJ polygons are convex
+                for (uint32 i = 2; i < polygon.size(); ++i)
+                {
+                    mesh.vertices.push_back(polygon[0]);
+                    mesh.vertices.push_back(polygon[i - 1]);
+                    mesh.vertices.push_back(polygon[i]);
+                }
+            }
+        }
+
+        GenerateNormals(mesh, first);
+        return true;
+    }
+
+    // ---------------------------------------------------
+    // JSON, only as much as glTF needs
+    // ---------------------------------------------------
+
+    struct Json
+    {
+        enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+        Type type = NUL;
+        double number = 0.0;
+        string text;
+        std::vector<Json> items;
+        std::vector<std::pair<string, Json>> members;
+
+        const Json & operator[](const string_view key) const noexcept
+        {
+            static const Json missing;
+            for (const auto & [name, value] : members)
+            {
+                if (name == key)
+                    return value;
+            }
+            return missing;
+        }
+
+        const Json & operator[](const size_t index) const noexcept
+        {
+            static const Json missing;
+            return index < items.size() ? items[index] : missing;
+        }
+
+        int64 Int(const int64 fallback = -1) const noexcept
+        { return type == NUMBER ? int64(number) : fallback; }
+    };
+
+    class JsonParser
+    {
+    private:
+        const char * text;
+        const char * end;
+        uint32 depth;
+
+        void Skip() noexcept
+        {
+            while (text < end && (*text == ' ' || *text == '\t' || *text == '\n' || *text == '\r'))
+                ++text;
+        }
+
+        bool Match(const string_view word) noexcept
+        {
+            if (size_t(end - text) < word.size() || string_view(text, word.size()) != word)
+                return false;
+            text += word.size();
+            return true;
+        }
+
+        bool String(string & output)
+        {
+            ++text;
+            while (text < end && *text != '"')
+            {
+                if (*text == '\\' && text + 1 < end)
+                {
+                    ++text;
+                    switch (*text)
+                    {
+                    case 'n': output += '\n'; break;
+                    case 't': output += '\t'; break;
+                    case 'r': output += '\r'; break;
+                    case 'b': output += '\b'; break;
+                    case 'f': output += '\f'; break;
+                    case 'u':
+                        // names and URIs in glTF files are ASCII in practice
+                        if (end - text < 5)
+                            return false;
+                        output += '?';
+                        text += 4;
+                        break;
+                    default: output += *text; break;
+                    }
+                    ++text;
+                    continue;
+                }
+
+                output += *text++;
+            }
+
+            if (text >= end)
+                return false;
+
+            ++text;
+            return true;
+        }
+
+    public:
+        JsonParser(const char * text, const char * end) noexcept
+            : text{text}, end{end}, depth{} {}
+
+        bool Parse(Json & value)
+        {
+            Skip();
+            if (text >= end || ++depth > 64)
+                return false;
+
+            bool parsed = false;
+            switch (*text)
+            {
+            case '{':
+                value.type = Json::OBJECT;
+                ++text;
+                Skip();
+                if (text < end && *text == '}')
+                {
+                    ++text;
+                    parsed = true;
+                    break;
+                }
+                while (text < end)
+                {
+                    Skip();
+                    if (text >= end || *text != '"')
+                        break;
+
+                    value.members.emplace_back();
+                    if (!String(value.members.back().first))
+                        break;
+
+                    Skip();
+                    if (text >= end || *text++ != ':' || !Parse(value.members.back().second))
+                        break;
+
+                    Skip();
+                    if (text < end && *text == ',')
+                    {
+                        ++text;
+                        continue;
+                    }
+
+                    parsed = text < end && *text++ == '}';
+                    break;
+                }
+                break;
+
+            case '[':
+                value.type = Json::ARRAY;
+                ++text;
+                Skip();
+                if (text < end && *text == ']')
+                {
+                    ++text;
+                    parsed = true;
+                    break;
+                }
+                while (text < end)
+                {
+                    value.items.emplace_back();
+                    if (!Parse(value.items.back()))
+                        break;
+
+                    Skip();
+                    if (text < end && *text == ',')
+                    {
+                        ++text;
+                        continue;
+                    }
+
+                    parsed = text < end && *text++ == ']';
+                    break;
+                }
+                break;
+
+            case '"':
+                value.type = Json::STRING;
+                parsed = String(value.text);
+                break;
+
+            case 't':
+            case 'f':
+                value.type = Json::BOOLEAN;
+                value.number = *text == 't';
+                parsed = Match("true") || Match("false");
+                break;
+
+            case 'n':
+                parsed = Match("null");
+                break;
+
+            default:
+            {
+                value.type = Json::NUMBER;
+                const auto [next, error] = std::from_chars(text, end, value.number);
+                parsed = error == std::errc{};
+                text = next;
+                break;
+            }
+            }
+
+            --depth;
+            return parsed;
+        }
+    };
+
+    // ---------------------------------------------------
+    // glTF
+    // ---------------------------------------------------
+
+    static bool DecodeBase64(const string_view input, std::vector<uint8> & output)
+    {
+        auto value = [](const char c) -> int32
+        {
+            if (c >= 'A' && c <= 'Z') return c - 'A';
+            if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+            if (c >= '0' && c <= '9') return c - '0' + 52;
+            if (c == '+') return 62;
+            if (c == '/') return 63;
+            return -1;
+        };
+
+        uint32 bits = 0;
+        int32 count = 0;
+        for (const char c : input)
+        {
+            if (c == '=')
+                break;
+
+            const int32 v = value(c);
+            if (v < 0)
+                return false;
+
+            bits = (bits << 6) | uint32(v);
+            count += 6;
+            if (count >= 8)
+            {
+                count -= 8;
+                output.push_back(uint8(bits >> count));
+            }
+        }
+
+        return true;
+    }
+
+    struct GltfAccessor
+    {
+        const uint8 * data;
+        uint32 count;
+        uint32 components;
+        uint32 componentType;
+        uint32 stride;
+        bool normalized;
+
+        float Float(const uint32 index, const uint32 component) const noexcept
+        {
+            const uint8 * element = data + size_t(index) * stride;
+            switch (componentType)
+            {
+            case 5126: { float v; memcpy(&v, element + component * 4, 4); return v; }
+            case 5123: { uint16 v; memcpy(&v, element + component * 2, 2); return normalized ? v / 65535.0f : float(v); }
+            case 5121: { uint8 v = element[component]; return normalized ? v / 255.0f : float(v); }
+            case 5122: { int16 v; memcpy(&v, element + component * 2, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : float(v); }
+            case 5120: { int8 v = int8(element[component]); return normalized ? std::max(v / 127.0f, -1.0f) : float(v); }
+            default: return 0.0f;
+            }
+        }
+
+        uint32 Index(const uint32 index) const noexcept
+        {
+            const uint8 * element = data + size_t(index) * stride;
+            switch (componentType)
+            {
+            case 5125: { uint32 v; memcpy(&v, element, 4); return v; }
+            case 5123: { uint16 v; memcpy(&v, element, 2); return v; }
+            case 5121: return element[0];
+            default: return 0;
+            }
+        }
+    };
+
+    static uint32 ComponentSize(const int64 componentType) noexcept
+    {
+        switch (componentType)
+        {
+        case 5120: case 5121: return 1;
+        case 5122: case 5123: return 2;
+        case 5125: case 5126: return 4;
+        default: return 0;
+        }
+    }
+
+    static uint32 ComponentCount(const string & type) noexcept
+    {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4") return 4;
+        return 0;
+    }
+
+    // bounds checked view of an accessor, false for sparse or out of range ones
+    static bool Accessor(const Json & gltf, const std::vector<std::vector<uint8>> & buffers,
+        const int64 index, GltfAccessor & accessor)
+    {
+        const Json & source = gltf["accessors"][size_t(index)];
+        const Json & view = gltf["bufferViews"][size_t(source["bufferView"].Int())];
+        const int64 buffer = view["buffer"].Int();
+
+        if (source.type != Json::OBJECT || view.type != Json::OBJECT || buffer < 0 || size_t(buffer) >= buffers.size())
+            return false;
+
+        accessor.componentType = uint32(source["componentType"].Int(0));
+        accessor.components = ComponentCount(source["type"].text);
+        accessor.count = uint32(source["count"].Int(0));
+        accessor.normalized = source["normalized"].number != 0.0;
+
+        const uint32 elementSize = ComponentSize(accessor.componentType) * accessor.components;
+        accessor.stride = uint32(view["byteStride"].Int(elementSize));
+
+        const uint64 offset = uint64(view["byteOffset"].Int(0)) + uint64(source["byteOffset"].Int(0));
+        const uint64 viewEnd = uint64(view["byteOffset"].Int(0)) + uint64(view["byteLength"].Int(0));
+
+        if (elementSize == 0 || accessor.stride < elementSize || viewEnd > buffers[size_t(buffer)].size()
+            || (accessor.count > 0 && offset + uint64(accessor.count - 1) * accessor.stride + elementSize > viewEnd))
+            return false;
+
+        accessor.data = buffers[size_t(buffer)].data() + offset;
+        return true;
+    }
+
+    bool ImportGltf(const string_view path, MeshData & mesh)
+    {
+        const fs::path file { path };
+
+        std::vector<uint8> data;
+        if (!ReadFile(file, data))
+            return false;
+
+        std::vector<std::vector<uint8>> buffers;
+        string_view json { reinterpret_cast<const char*>(data.data()), data.size() };
+        std::vector<uint8> binary;
+
+        // GLB: 12 byte header, then a JSON chunk and an optional BIN chunk
+        if (data.size() >= 20 && memcmp(data.data(), "glTF", 4) == 0)
+        {
+            uint32 length;
+            memcpy(&length, data.data() + 12, 4);
+            if (20 + uint64(length) > data.size())
+                return false;
+
+            json = { reinterpret_cast<const char*>(data.data() + 20), length };
+
+            const uint64 binStart = 20 + uint64(length);
+            if (binStart + 8 <= data.size())
+            {
+                uint32 binLength;
+                memcpy(&binLength, data.data() + binStart, 4);
+                if (binStart + 8 + binLength > data.size())
+                    return false;
+                binary.assign(data.begin() + std::ptrdiff_t(binStart + 8), data.begin() + std::ptrdiff_t(binStart + 8 + binLength));
+            }
+        }
+
+        Json gltf;
+        JsonParser parser(json.data(), json.data() + json.size());
+        if (!parser.Parse(gltf) || gltf.type != Json::OBJECT)
+            return false;
+
+        for (const Json & buffer : gltf["buffers"].items)
+        {
+            const string & uri = buffer["uri"].text;
+            buffers.emplace_back();
+
+            if (uri.empty())
+            {
+                buffers.back() = binary;
+            }
+            else if (uri.starts_with("data:"))
+            {
+                const size_t comma = uri.find(";base64,");
+                if (comma == string::npos || !DecodeBase64(string_view(uri).substr(comma + 8), buffers.back()))
+                    return false;
+            }
+            else if (!ReadFile(file.parent_path() / uri, buffers.back()))
+            {
+                return false;
+            }
+        }
+
+        const uint32 first = uint32(mesh.vertices.size());
+
+        for (const Json & source : gltf["meshes"].items)
+        {
+            for (const Json & primitive : source["primitives"].items)
+            {
+                // triangles only, points and lines have nothing to optimize
+                if (primitive["mode"].Int(4) != 4)
+                    continue;
+
+                const Json & attributes = primitive["attributes"];
+                GltfAccessor positions{}, normals{}, texCoords{}, indices{};
+
+                // the types the specification allows for each attribute, anything
+                // else would be read past the end of its elements
+                if (!Accessor(gltf, buffers, attributes["POSITION"].Int(), positions)
+                    || positions.components != 3 || positions.componentType != 5126)
+                    return false;
+
+                const bool hasNormals = attributes["NORMAL"].type == Json::NUMBER;
+                if (hasNormals && (!Accessor(gltf, buffers, attributes["NORMAL"].Int(), normals)
+                    || normals.components != 3 || normals.componentType != 5126 || normals.count != positions.count))
+                    return false;
+
+                // float, or unsigned byte and short normalized to [0, 1]
+                const bool hasTexCoords = attributes["TEXCOORD_0"].type == Json::NUMBER;
+                if (hasTexCoords && (!Accessor(gltf, buffers, attributes["TEXCOORD_0"].Int(), texCoords)
+                    || texCoords.components != 2 || texCoords.count != positions.count
+                    || (texCoords.componentType != 5126 && !(texCoords.normalized
+                        && (texCoords.componentType == 5121 || texCoords.componentType == 5123)))))
+                    return false;
+
+                const bool indexed = primitive["indices"].type == Json::NUMBER;
+                if (indexed && (!Accessor(gltf, buffers, primitive["indices"].Int(), indices) || indices.components != 1
+                    || (indices.componentType != 5121 && indices.componentType != 5123 && indices.componentType != 5125)))
+                    return false;
+
+                const uint32 count = (indexed ? indices.count : positions.count) / 3 * 3;
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    const uint32 index = indexed ? indices.Index(i) : i;
+                    if (index >= positions.count)
+                        return false;
+
+                    MeshVertex vertex{};
+                    vertex.position = { positions.Float(index, 0), positions.Float(index, 1), positions.Float(index, 2) };
+                    if (hasNormals)
+                        vertex.normal = { normals.Float(index, 0), normals.Float(index, 1), normals.Float(index, 2) };
+                    if (hasTexCoords)
+                        vertex.texCoord = { texCoords.Float(index, 0), texCoords.Float(index, 1) };
+
+                    mesh.vertices.push_back(vertex);
+                }
+            }
+        }
+
+        GenerateNormals(mesh, first);
+        return true;
+    }
+
+    bool ImportMesh(const string_view path, MeshData & mesh)
+    {
+        string extension = fs::path{ path }.extension().string();
+        for (char & c : extension)
+            c = char(std::tolower(uint8(c)));
+
+        if (extension == ".obj")
+            return ImportObj(path, mesh);
+        if (extension == ".gltf" || extension == ".glb")
+            return ImportGltf(path, mesh);
+
+        return false;
+    }
+}
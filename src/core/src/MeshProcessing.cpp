@@ -0,0 +1,489 @@
+#include "MeshProcessing.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace Luna
+{
+    using namespace Math;
+
+    // triangles using each vertex, as offsets into one list
+    struct Adjacency
+    {
+        std::vector<uint32> offsets;
+        std::vector<uint32> triangles;
+
+        Adjacency(const std::vector<uint32> & indices, const uint32 vertexCount)
+            : offsets(vertexCount + 1, 0), triangles(indices.size())
+        {
+            for (const uint32 index : indices)
+                ++offsets[index + 1];
+
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            std::vector<uint32> fill(offsets.begin(), offsets.end() - 1);
+            for (uint32 i = 0; i < indices.size(); ++i)
+                triangles[fill[indices[i]]++] = i / 3;
+        }
+    };
+
+    // misses of each triangle against a FIFO cache of cacheSize vertices
+    class CacheSimulation
+    {
+    private:
+        std::vector<uint32> timestamps;
+        uint32 time;
+        uint32 cacheSize;
+
+    public:
+        CacheSimulation(const uint32 vertexCount, const uint32 cacheSize)
+            : timestamps(vertexCount, 0), time{ cacheSize + 1 }, cacheSize{ cacheSize } {}
+
+        uint32 Triangle(const uint32 * triangle) noexcept
+        {
+            uint32 misses = 0;
+            for (uint32 i = 0; i < 3; ++i)
+            {
+                if (time - timestamps[triangle[i]] > cacheSize)
+                {
+                    timestamps[triangle[i]] = time++;
+                    ++misses;
+                }
+            }
+
+            return misses;
+        }
+
+        void Flush() noexcept
+        { time += cacheSize + 1; }
+    };
+
+    // ---------------------------------------------------
+
+    void Deduplicate(MeshData & mesh)
+    {
+        struct VertexHash
+        {
+            size_t operator()(const MeshVertex & vertex) const noexcept
+            {
+                // FNV-1a over the bytes, the struct has no padding
+                const uint8 * bytes = reinterpret_cast<const uint8*>(&vertex);
+                uint64 hash = 14695981039346656037ULL;
+                for (uint32 i = 0; i < sizeof(MeshVertex); ++i)
+                    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+                return size_t(hash);
+            }
+        };
+
+        struct VertexEqual
+        {
+            bool operator()(const MeshVertex & a, const MeshVertex & b) const noexcept
+            { return memcmp(&a, &b, sizeof(MeshVertex)) == 0; }
+        };
+
+        if (mesh.indices.empty())
+        {
+            mesh.indices.resize(mesh.vertices.size());
+            std::iota(mesh.indices.begin(), mesh.indices.end(), 0U);
+        }
+
+        std::unordered_map<MeshVertex, uint32, VertexHash, VertexEqual> unique;
+        unique.reserve(mesh.indices.size());
+
+        std::vector<MeshVertex> vertices;
+        for (uint32 & index : mesh.indices)
+        {
+            auto [found, inserted] = unique.try_emplace(mesh.vertices[index], uint32(vertices.size()));
+            if (inserted)
+                vertices.push_back(mesh.vertices[index]);
+
+            index = found->second;
+        }
+
+        mesh.vertices = std::move(vertices);
+    }
+
+    void OptimizeVertexCache(std::vector<uint32> & indices, const uint32 vertexCount, const uint32 cacheSize)
+    {
+        const uint32 triangleCount = uint32(indices.size() / 3);
+        if (triangleCount == 0)
+            return;
+
+        const Adjacency adjacency(indices, vertexCount);
+
+        std::vector<uint32> live(vertexCount);
+        for (uint32 v = 0; v < vertexCount; ++v)
+            live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+        std::vector<uint32> timestamps(vertexCount, 0);
+        std::vector<uint32> deadEnds;
+        std::vector<uint32> candidates;
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32> output;
+        output.reserve(indices.size());
+
+        uint32 time = cacheSize + 1;
+        uint32 cursor = 0;
+
+        // a vertex that still has triangles, from the dead end stack or the input order
+        auto skipDeadEnd = [&]() -> int64
+        {
+            while (!deadEnds.empty())
+            {
+                const uint32 vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (live[vertex] > 0)
+                    return vertex;
+            }
+
+            for (; cursor < vertexCount; ++cursor)
+            {
+                if (live[cursor] > 0)
+                    return cursor;
+            }
+
+            return -1;
+        };
+
+        int64 fan = skipDeadEnd();
+        while (fan >= 0)
+        {
+            candidates.clear();
+
+            for (uint32 i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; ++i)
+            {
+                const uint32 triangle = adjacency.triangles[i];
+                if (emitted[triangle])
+                    continue;
+
+                for (uint32 k = 0; k < 3; ++k)
+                {
+                    const uint32 vertex = indices[triangle * 3 + k];
+                    output.push_back(vertex);
+                    deadEnds.push_back(vertex);
+                    candidates.push_back(vertex);
+                    --live[vertex];
+
+                    if (time - timestamps[vertex] > cacheSize)
+                        timestamps[vertex] = time++;
+                }
+
+                emitted[triangle] = true;
+            }
+
+            // the candidate that will still be in the cache once its remaining
+            // triangles are emitted, and among those the one that entered first
+            int64 next = -1;
+            int64 best = -1;
+            for (const uint32 vertex : candidates)
+            {
+                if (live[vertex] == 0)
+                    continue;
+
+                int64 priority = 0;
+                if (time - timestamps[vertex] + 2 * live[vertex] <= cacheSize)
+                    priority = time - timestamps[vertex];
+
+                if (priority > best)
+                {
+                    best = priority;
+                    next = vertex;
+                }
+            }
+
+            fan = next >= 0 ? next : skipDeadEnd();
+        }
+
+        indices = std::move(output);
+    }
+
+    void OptimizeOverdraw(std::vector<uint32> & indices, const std::vector<MeshVertex> & vertices,
+        const uint32 cacheSize, const float threshold)
+    {
+        const uint32 triangleCount = uint32(indices.size() / 3);
+        if (triangleCount < 2)
+            return;
+
+        const uint32 vertexCount = uint32(vertices.size());
+
+        // hard boundaries, where every vertex of a triangle misses the cache
+        std::vector<uint32> hard;
+        {
+            CacheSimulation cache(vertexCount, cacheSize);
+            for (uint32 t = 0; t < triangleCount; ++t)
+            {
+                if (cache.Triangle(&indices[t * 3]) == 3)
+                    hard.push_back(t);
+            }
+        }
+        hard.push_back(triangleCount);
+
+        // soft boundaries inside each, where splitting keeps the ACMR within threshold
+        std::vector<uint32> clusters;
+        for (uint32 h = 0; h + 1 < hard.size(); ++h)
+        {
+            const uint32 start = hard[h];
+            const uint32 end = hard[h + 1];
+
+            CacheSimulation cache(vertexCount, cacheSize);
+            uint32 misses = 0;
+            for (uint32 t = start; t < end; ++t)
+                misses += cache.Triangle(&indices[t * 3]);
+
+            const float limit = threshold * float(misses) / float(end - start);
+
+            cache.Flush();
+            clusters.push_back(start);
+
+            uint32 clusterStart = start;
+            uint32 clusterMisses = 0;
+            for (uint32 t = start; t < end; ++t)
+            {
+                clusterMisses += cache.Triangle(&indices[t * 3]);
+
+                if (t + 1 < end && float(clusterMisses) / float(t + 1 - clusterStart) <= limit)
+                {
+                    clusters.push_back(t + 1);
+                    clusterStart = t + 1;
+                    clusterMisses = 0;
+                    cache.Flush();
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // area weighted centroids and normals
+        Vec3 meshCentroid;
+        float meshArea = 0.0f;
+
+        const uint32 clusterCount = uint32(clusters.size() - 1);
+        std::vector<Vec3> centroids(clusterCount);
+        std::vector<Vec3> normals(clusterCount);
+
+        for (uint32 c = 0; c < clusterCount; ++c)
+        {
+            float area = 0.0f;
+            for (uint32 t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                const Vec3 & a = vertices[indices[t * 3]].position;
+                const Vec3 & b = vertices[indices[t * 3 + 1]].position;
+                const Vec3 & d = vertices[indices[t * 3 + 2]].position;
+
+                const Vec3 normal = Cross(b - a, d - a);
+                const float weight = Length(normal);
+
+                centroids[c] += (a + b + d) * (weight / 3.0f);
+                normals[c] += normal;
+                area += weight;
+            }
+
+            meshCentroid += centroids[c];
+            meshArea += area;
+            centroids[c] = area > 0.0f ? centroids[c] / area : centroids[c];
+        }
+
+        if (meshArea > 0.0f)
+            meshCentroid = meshCentroid / meshArea;
+
+        std::vector<float> keys(clusterCount);
+        for (uint32 c = 0; c < clusterCount; ++c)
+            keys[c] = Dot(centroids[c] - meshCentroid, normals[c]);
+
+        std::vector<uint32> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0U);
+        std::stable_sort(order.begin(), order.end(), [&keys](const uint32 a, const uint32 b) { return keys[a] > keys[b]; });
+
+        std::vector<uint32> output;
+        output.reserve(indices.size());
+        for (const uint32 c : order)
+            output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+
+        indices = std::move(output);
+    }
+
+    void OptimizeVertexFetch(MeshData & mesh)
+    {
+        constexpr uint32 UNUSED = 0xFFFFFFFF;
+
+        std::vector<uint32> remap(mesh.vertices.size(), UNUSED);
+        std::vector<MeshVertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+
+        // unused vertices are dropped
+        for (uint32 & index : mesh.indices)
+        {
+            if (remap[index] == UNUSED)
+            {
+                remap[index] = uint32(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        mesh.vertices = std::move(vertices);
+    }
+
+    void ProcessMesh(MeshData & mesh)
+    {
+        Deduplicate(mesh);
+        OptimizeVertexCache(mesh.indices, uint32(mesh.vertices.size()));
+        OptimizeOverdraw(mesh.indices, mesh.vertices);
+        OptimizeVertexFetch(mesh);
+    }
+
+    CacheStats AnalyzeVertexCache(const std::vector<uint32> & indices, const uint32 vertexCount, const uint32 cacheSize)
+    {
+        const uint32 triangleCount = uint32(indices.size() / 3);
+        if (triangleCount == 0 || vertexCount == 0)
+            return { 0.0f, 0.0f };
+
+        CacheSimulation cache(vertexCount, cacheSize);
+        uint32 misses = 0;
+        for (uint32 t = 0; t < triangleCount; ++t)
+            misses += cache.Triangle(&indices[t * 3]);
+
+        return { float(misses) / float(triangleCount), float(misses) / float(vertexCount) };
+    }
+
+    // ---------------------------------------------------
+    // Packed format
+    // ---------------------------------------------------
+
+    static uint16 Half(const float value) noexcept
+    {
+        uint32 bits;
+        memcpy(&bits, &value, sizeof(bits));
+
+        const uint32 sign = (bits >> 16) & 0x8000;
+        const int32 exponent = int32((bits >> 23) & 0xFF) - 127 + 15;
+        const uint32 mantissa = bits & 0x7FFFFF;
+
+        // texture coordinates never need denormals, infinities or NaN
+        if (exponent <= 0)
+            return uint16(sign);
+        if (exponent >= 31)
+            return uint16(sign | 0x7BFF);
+
+        // round to nearest
+        uint32 half = sign | (uint32(exponent) << 10) | (mantissa >> 13);
+        if (mantissa & 0x1000)
+            ++half;
+
+        return uint16(half);
+    }
+
+    static int16 Snorm16(const float value) noexcept
+    {
+        return int16(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    // Cigolle et al. 2014, the unit sphere folded onto the [-1, 1] square
+    static void OctEncode(const Vec3 & normal, int16 output[2]) noexcept
+    {
+        const float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+        float x = sum > 0.0f ? normal.x / sum : 0.0f;
+        float y = sum > 0.0f ? normal.y / sum : 0.0f;
+
+        if (normal.z < 0.0f)
+        {
+            const float foldX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            const float foldY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldX;
+            y = foldY;
+        }
+
+        output[0] = Snorm16(x);
+        output[1] = Snorm16(y);
+    }
+
+    std::vector<uint8> PackMesh(const MeshData & mesh)
+    {
+        Vec3 low { mesh.vertices.empty() ? 0.0f : 3.4e38f };
+        Vec3 high { mesh.vertices.empty() ? 0.0f : -3.4e38f };
+        for (const MeshVertex & vertex : mesh.vertices)
+        {
+            low = Min(low, vertex.position);
+            high = Max(high, vertex.position);
+        }
+
+        const Vec3 extent = high - low;
+        const Vec3 scale { extent.x / 65535.0f, extent.y / 65535.0f, extent.z / 65535.0f };
+
+        MeshHeader header{};
+        header.magic = MESH_MAGIC;
+        header.version = MESH_VERSION;
+        header.vertexCount = uint32(mesh.vertices.size());
+        header.indexCount = uint32(mesh.indices.size());
+        header.vertexStride = sizeof(PackedVertex);
+        header.indexSize = mesh.vertices.size() <= 0x10000 ? 2 : 4;
+        header.offset[0] = low.x;
+        header.offset[1] = low.y;
+        header.offset[2] = low.z;
+        header.scale[0] = scale.x;
+        header.scale[1] = scale.y;
+        header.scale[2] = scale.z;
+
+        const size_t vertexBytes = mesh.vertices.size() * sizeof(PackedVertex);
+        std::vector<uint8> output(sizeof(MeshHeader) + vertexBytes + mesh.indices.size() * header.indexSize);
+        memcpy(output.data(), &header, sizeof(header));
+
+        auto quantize = [](const float value, const float origin, const float step)
+        {
+            return uint16(step > 0.0f ? std::lround(std::clamp((value - origin) / step, 0.0f, 65535.0f)) : 0);
+        };
+
+        PackedVertex * packed = reinterpret_cast<PackedVertex*>(output.data() + sizeof(MeshHeader));
+        for (const MeshVertex & vertex : mesh.vertices)
+        {
+            PackedVertex out{};
+            out.position[0] = quantize(vertex.position.x, low.x, scale.x);
+            out.position[1] = quantize(vertex.position.y, low.y, scale.y);
+            out.position[2] = quantize(vertex.position.z, low.z, scale.z);
+            OctEncode(vertex.normal, out.normal);
+            out.texCoord[0] = Half(vertex.texCoord.x);
+            out.texCoord[1] = Half(vertex.texCoord.y);
+            *packed++ = out;
+        }
+
+        uint8 * indices = output.data() + sizeof(MeshHeader) + vertexBytes;
+        if (header.indexSize == 2)
+        {
+            for (const uint32 index : mesh.indices)
+            {
+                const uint16 value = uint16(index);
+                memcpy(indices, &value, sizeof(value));
+                indices += sizeof(value);
+            }
+        }
+        else
+        {
+            memcpy(indices, mesh.indices.data(), mesh.indices.size() * sizeof(uint32));
+        }
+
+        return output;
+    }
+
+    bool ReadMesh(std::span<const uint8> bytes, MeshView & view)
+    {
+        if (bytes.size() < sizeof(MeshHeader))
+            return false;
+
+        const MeshHeader * header = reinterpret_cast<const MeshHeader*>(bytes.data());
+        if (header->magic != MESH_MAGIC || header->version != MESH_VERSION
+            || header->vertexStride != sizeof(PackedVertex)
+            || (header->indexSize != 2 && header->indexSize != 4))
+            return false;
+
+        const uint64 vertexBytes = uint64(header->vertexCount) * sizeof(PackedVertex);
+        const uint64 indexBytes = uint64(header->indexCount) * header->indexSize;
+        if (sizeof(MeshHeader) + vertexBytes + indexBytes > bytes.size())
+            return false;
+
+        view.header = header;
+        view.vertices = reinterpret_cast<const PackedVertex*>(bytes.data() + sizeof(MeshHeader));
+        view.indices = bytes.data() + sizeof(MeshHeader) + vertexBytes;
+        return true;
+    }
+}
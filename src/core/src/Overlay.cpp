@@ -0,0 +1,342 @@
+#include "Overlay.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+namespace Luna
+{
+    using namespace Math;
+
+    constexpr uint32 OVERLAY_BACKGROUND = 0xc0101010;
+    constexpr uint32 OVERLAY_TEXT = 0xffe0e0e0;
+    constexpr uint32 OVERLAY_DIM = 0xff909090;
+    constexpr float OVERLAY_MARGIN = 6.0f;
+    constexpr float OVERLAY_COLUMNS[2] { 260.0f, 350.0f };   // right edges of the numbers
+
+    // the graph spans two frames at 60 Hz
+    constexpr float GRAPH_HEIGHT = 64.0f;
+    constexpr float GRAPH_SCALE = 1000.0f / 30.0f;
+    constexpr float GRAPH_TARGET = 1000.0f / 60.0f;
+
+    template<typename... Args>
+    static string Print(const char * format, const Args... args)
+    {
+        char text[128];
+        const int length = snprintf(text, sizeof(text), format, args...);
+        return string(text, size_t(std::clamp(length, 0, int(sizeof(text)) - 1)));
+    }
+
+    uint64 ResidentMemory() noexcept
+    {
+    #ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return 0;
+
+        return counters.WorkingSetSize;
+    #else
+        FILE * file = fopen("/proc/self/statm", "r");
+        if (!file)
+            return 0;
+
+        unsigned long size = 0, resident = 0;
+        const int read = fscanf(file, "%lu %lu", &size, &resident);
+        fclose(file);
+
+        return read == 2 ? uint64(resident) * uint64(sysconf(_SC_PAGESIZE)) : 0;
+    #endif
+    }
+
+    uint64 PeakMemory() noexcept
+    {
+    #ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return 0;
+
+        return counters.PeakWorkingSetSize;
+    #else
+        // ru_maxrss is in kilobytes on Linux
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+
+        return uint64(usage.ru_maxrss) * 1024;
+    #endif
+    }
+
+    Overlay::Overlay()
+        : batch{ 4096 },
+        texture{},
+        visible{},
+        loaded{},
+        canvas{},
+        history{},
+        head{},
+        top{},
+        elapsed{},
+        frames{},
+        maximum{},
+        reportFrame{ ~0ULL },
+        reports{},
+        cpu{},
+        gpu{},
+        events{},
+        inputs{},
+        latency{},
+        pendingEvents{},
+        inputPending{}
+    {
+    }
+
+    bool Overlay::Load(const string_view path, const uint32 pixelSize)
+    {
+        rows.clear();
+        loaded = true;
+        return font.Load(path, pixelSize);
+    }
+
+    // ---------------------------------------------------
+
+    void Overlay::Event(const bool input, const uint32 count) noexcept
+    {
+        pendingEvents += count;
+        if (input && !inputPending)
+        {
+            inputPending = true;
+            inputTime = Clock::now();
+        }
+    }
+
+    void Overlay::Frame(const double milliseconds) noexcept
+    {
+        history[head] = float(milliseconds);
+        head = (head + 1) % OVERLAY_HISTORY;
+
+        elapsed += milliseconds;
+        ++frames;
+        maximum = std::max(maximum, float(milliseconds));
+
+        events += pendingEvents;
+        pendingEvents = 0;
+    }
+
+    void Overlay::Presented() noexcept
+    {
+        if (!inputPending)
+            return;
+
+        latency += std::chrono::duration<double, std::milli>(Clock::now() - inputTime).count();
+        ++inputs;
+        inputPending = false;
+    }
+
+    // ---------------------------------------------------
+
+    void Overlay::Begin(const Vec2 & position)
+    {
+        if (!loaded)
+            Load(OVERLAY_FONT, OVERLAY_FONT_SIZE);
+
+        batch.Begin();
+        origin = position;
+        top = position.y;
+    }
+
+    void Overlay::Strip(const float height)
+    {
+        batch.Draw(texture, SpriteInstance{
+            Vec2{ origin.x + OVERLAY_WIDTH * 0.5f, top + height * 0.5f },
+            Vec2{ OVERLAY_WIDTH, height },
+            font.Solid(),
+            OVERLAY_BACKGROUND,
+            0.0f });
+    }
+
+    void Overlay::Text(const string_view text, const uint32 color)
+    {
+        if (font.LineHeight() == 0.0f)
+            return;
+
+        const float height = font.LineHeight() + 2.0f;
+        Strip(height);
+        font.Draw(batch, texture, text, Vec2{ origin.x + OVERLAY_MARGIN, top + 1.0f }, color);
+        top += height;
+    }
+
+    void Overlay::Graph()
+    {
+        const float height = GRAPH_HEIGHT + 2.0f * OVERLAY_MARGIN;
+        Strip(height);
+
+        const float bottom = top + OVERLAY_MARGIN + GRAPH_HEIGHT;
+        const float width = (OVERLAY_WIDTH - 2.0f * OVERLAY_MARGIN) / OVERLAY_HISTORY;
+        const Vec4 solid = font.Solid();
+
+        // oldest frame at the left
+        for (uint32 i = 0; i < OVERLAY_HISTORY; ++i)
+        {
+            const float sample = history[(head + i) % OVERLAY_HISTORY];
+            if (sample <= 0.0f)
+                continue;
+
+            const float bar = std::min(sample / GRAPH_SCALE, 1.0f) * GRAPH_HEIGHT;
+            const uint32 color = sample <= GRAPH_TARGET * 1.05f ? 0xff40c040
+                : sample <= GRAPH_SCALE * 1.05f ? 0xffe0c040 : 0xffe04040;
+
+            batch.Draw(texture, SpriteInstance{
+                Vec2{ origin.x + OVERLAY_MARGIN + (float(i) + 0.5f) * width, bottom - bar * 0.5f },
+                Vec2{ width, bar },
+                solid,
+                color,
+                0.0f });
+        }
+
+        const float target = bottom - GRAPH_TARGET / GRAPH_SCALE * GRAPH_HEIGHT;
+        batch.Draw(texture, SpriteInstance{
+            Vec2{ origin.x + OVERLAY_WIDTH * 0.5f, target },
+            Vec2{ OVERLAY_WIDTH - 2.0f * OVERLAY_MARGIN, 1.0f },
+            solid,
+            0x80ffffff,
+            0.0f });
+
+        top += height;
+    }
+
+    // ---------------------------------------------------
+
+    void Overlay::Accumulate(const FrameReport & report)
+    {
+        if (report.frame == reportFrame)
+            return;
+        reportFrame = report.frame;
+
+        // scopes that open and close from frame to frame start the averages over
+        bool same = zones.size() == report.entries.size();
+        for (size_t i = 0; same && i < zones.size(); ++i)
+            same = zones[i].name == report.entries[i].name && zones[i].depth == report.entries[i].depth;
+
+        if (!same)
+        {
+            zones.clear();
+            for (const ProfileEntry & entry : report.entries)
+                zones.push_back(Zone{ entry.name, entry.depth, 0.0, 0.0 });
+            reports = 0;
+            cpu = gpu = 0.0;
+        }
+
+        for (size_t i = 0; i < zones.size(); ++i)
+        {
+            zones[i].cpu += report.entries[i].cpu;
+            zones[i].gpu += report.entries[i].gpu;
+        }
+
+        cpu += report.cpu;
+        gpu += report.gpu;
+        ++reports;
+    }
+
+    void Overlay::Refresh(const uint64 gpuMemory)
+    {
+        const auto milliseconds = [](const double sum, const uint32 count)
+        { return count > 0 ? Print("%.2f", sum / count) : string{ "-" }; };
+
+        const auto megabytes = [](const uint64 bytes)
+        { return Print("%.1f MB", double(bytes) / (1024.0 * 1024.0)); };
+
+        rows.clear();
+
+        if (frames > 0)
+            rows.push_back(Row{ { Print("%.0f fps    avg %.2f ms    max %.2f ms",
+                1000.0 * frames / elapsed, elapsed / frames, double(maximum)), "", "" }, OVERLAY_TEXT });
+
+        rows.push_back(Row{ { "ms", "cpu", "gpu" }, OVERLAY_DIM });
+        rows.push_back(Row{ { "frame", milliseconds(cpu, reports), gpu > 0.0 ? milliseconds(gpu, reports) : "-" }, OVERLAY_TEXT });
+
+        for (Zone & zone : zones)
+        {
+            rows.push_back(Row{ { string(2 * (zone.depth + 1), ' ') + zone.name,
+                milliseconds(zone.cpu, reports),
+                zone.gpu > 0.0 ? milliseconds(zone.gpu, reports) : "-" }, OVERLAY_TEXT });
+            zone.cpu = zone.gpu = 0.0;
+        }
+
+        rows.push_back(Row{ { "memory", megabytes(ResidentMemory()), gpuMemory ? megabytes(gpuMemory) : "-" }, OVERLAY_TEXT });
+        rows.push_back(Row{ { "events", frames > 0 ? Print("%.1f", double(events) / frames) : "-", "" }, OVERLAY_TEXT });
+        rows.push_back(Row{ { "input latency", milliseconds(latency, inputs), "" }, OVERLAY_TEXT });
+
+        elapsed = 0.0;
+        frames = 0;
+        maximum = 0.0f;
+        reports = 0;
+        cpu = gpu = 0.0;
+        events = 0;
+        inputs = 0;
+        latency = 0.0;
+    }
+
+    void Overlay::Stats(const FrameReport & report, const uint64 gpuMemory)
+    {
+        Accumulate(report);
+
+        if (rows.empty() || elapsed >= OVERLAY_REFRESH)
+            Refresh(gpuMemory);
+
+        if (font.LineHeight() == 0.0f)
+            return;
+
+        const float height = font.LineHeight() + 2.0f;
+        for (const Row & row : rows)
+        {
+            Strip(height);
+            font.Draw(batch, texture, row.cells[0], Vec2{ origin.x + OVERLAY_MARGIN, top + 1.0f }, row.color);
+
+            for (uint32 column = 0; column < 2; ++column)
+            {
+                const string & cell = row.cells[column + 1];
+                if (cell.empty())
+                    continue;
+
+                const float left = origin.x + OVERLAY_COLUMNS[column] - font.Measure(cell).x;
+                font.Draw(batch, texture, cell, Vec2{ left, top + 1.0f }, row.color);
+            }
+
+            top += height;
+        }
+    }
+
+    void Overlay::End()
+    {
+        batch.End();
+    }
+
+    void Overlay::Draw(Canvas & target)
+    {
+        if (!visible)
+            return;
+
+        // the batch of this frame already points at the texture set before Begin,
+        // so a new canvas gets the atlas now and shows the panel from the next frame
+        uint32 firstRow, rowCount;
+        if (canvas != &target)
+        {
+            font.Dirty(firstRow, rowCount);
+            texture = target.Texture(font.Atlas(), font.AtlasWidth(), font.AtlasHeight());
+            canvas = &target;
+            return;
+        }
+
+        if (font.Dirty(firstRow, rowCount))
+            target.Update(texture, font.Atlas(), font.AtlasWidth(), font.AtlasHeight());
+
+        target.Draw(batch);
+    }
+}
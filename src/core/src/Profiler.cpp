@@ -0,0 +1,97 @@
+#include "Profiler.h"
+
+namespace Luna
+{
+    Profiler::Profiler() noexcept
+        : reports{}, last{}, frame{ 0 }, gpuResolved{ false }
+    {
+    }
+
+    double Profiler::Milliseconds(const Clock::time_point start, const Clock::time_point end) noexcept
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void Profiler::BeginFrame()
+    {
+        ++frame;
+
+        // entries keep their capacity from the frame that used the slot before
+        FrameReport & report = reports[frame % LATENCY];
+        report.frame = frame;
+        report.cpu = 0.0;
+        report.gpu = 0.0;
+        report.entries.clear();
+
+        open.clear();
+        starts.clear();
+        frameStart = Clock::now();
+    }
+
+    void Profiler::EndFrame()
+    {
+        const Clock::time_point now = Clock::now();
+        FrameReport & report = reports[frame % LATENCY];
+
+        // scopes left open are closed at the end of the frame
+        while (!open.empty())
+        {
+            report.entries[open.back()].cpu = Milliseconds(starts.back(), now);
+            open.pop_back();
+            starts.pop_back();
+        }
+
+        report.cpu = Milliseconds(frameStart, now);
+
+        if (!gpuResolved)
+            last = report;
+    }
+
+    uint32 Profiler::Begin(const char * name)
+    {
+        std::vector<ProfileEntry> & entries = reports[frame % LATENCY].entries;
+        const uint32 entry = static_cast<uint32>(entries.size());
+
+        entries.push_back({ name, static_cast<uint32>(open.size()), 0.0, 0.0 });
+        open.push_back(entry);
+        starts.push_back(Clock::now());
+        return entry;
+    }
+
+    void Profiler::End(const uint32 entry)
+    {
+        const Clock::time_point now = Clock::now();
+        std::vector<ProfileEntry> & entries = reports[frame % LATENCY].entries;
+
+        // closing a scope also closes anything opened inside it
+        while (!open.empty())
+        {
+            const uint32 top = open.back();
+            entries[top].cpu = Milliseconds(starts.back(), now);
+            open.pop_back();
+            starts.pop_back();
+
+            if (top == entry)
+                break;
+        }
+    }
+
+    void Profiler::Gpu(const uint64 frame, const uint32 entry, const double ms) noexcept
+    {
+        FrameReport & report = reports[frame % LATENCY];
+
+        if (report.frame == frame && entry < report.entries.size())
+            report.entries[entry].gpu = ms;
+    }
+
+    void Profiler::Resolve(const uint64 frame, const double ms)
+    {
+        FrameReport & report = reports[frame % LATENCY];
+
+        if (report.frame != frame || frame == this->frame)
+            return;
+
+        report.gpu = ms;
+        last = report;
+    }
+}
@@ -0,0 +1,85 @@
+#include "Scheduler.h"
+#include <algorithm>
+
+namespace Luna
+{
+    Scheduler::Scheduler(World * world, ThreadPool * threadPool) noexcept
+        : world{world},
+        threadPool{threadPool},
+        dirty{false}
+    {
+    }
+
+    void Scheduler::Add(const string_view name,
+        const ComponentMask reads,
+        const ComponentMask writes,
+        std::function<void(World & world, double frameTime)> update)
+    {
+        systems.push_back({ string(name), reads, writes, std::move(update) });
+        dirty = true;
+    }
+
+    void Scheduler::Remove(const string_view name)
+    {
+        std::erase_if(systems, [name](const System & system) { return system.name == name; });
+        dirty = true;
+    }
+
+    static bool Conflict(const System & a, const System & b) noexcept
+    {
+        return (a.writes & (b.reads | b.writes)) || (b.writes & a.reads);
+    }
+
+    void Scheduler::Build()
+    {
+        stages.clear();
+
+        std::vector<uint32> level(systems.size());
+        for (uint32 i = 0; i < systems.size(); ++i)
+        {
+            level[i] = 0;
+            for (uint32 j = 0; j < i; ++j)
+            {
+                if (Conflict(systems[i], systems[j]))
+                    level[i] = std::max(level[i], level[j] + 1);
+            }
+
+            if (level[i] >= stages.size())
+                stages.resize(level[i] + 1);
+
+            stages[level[i]].push_back(i);
+        }
+
+        dirty = false;
+    }
+
+    uint32 Scheduler::StageCount()
+    {
+        if (dirty)
+            Build();
+
+        return static_cast<uint32>(stages.size());
+    }
+
+    void Scheduler::Update(const double frameTime)
+    {
+        if (dirty)
+            Build();
+
+        for (const auto & stage : stages)
+        {
+            if (stage.size() == 1)
+            {
+                systems[stage[0]].update(*world, frameTime);
+                continue;
+            }
+
+            threadPool->ParallelFor(static_cast<uint32>(stage.size()), 1,
+                [this, &stage, frameTime](const uint32 begin, const uint32 end)
+                {
+                    for (uint32 i = begin; i < end; ++i)
+                        systems[stage[i]].update(*world, frameTime);
+                });
+        }
+    }
+}
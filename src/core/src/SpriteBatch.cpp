@@ -0,0 +1,132 @@
+#include "SpriteBatch.h"
+
+namespace Luna
+{
+    // sort key: layer in the high 8 bits, texture in the low 24 bits
+    constexpr uint32 TEXTURE_BITS = 24;
+    constexpr uint32 TEXTURE_MASK = (1u << TEXTURE_BITS) - 1;
+
+    SpriteBatch::SpriteBatch(const uint32 capacity)
+        : storage(capacity),
+        ring{ storage.data() },
+        ringCapacity{ capacity },
+        ringHead{},
+        base{},
+        count{}
+    {
+    }
+
+    void SpriteBatch::Map(void * memory, const uint32 capacity) noexcept
+    {
+        storage.clear();
+        storage.shrink_to_fit();
+
+        ring = static_cast<SpriteInstance*>(memory);
+        ringCapacity = capacity;
+        ringHead = 0;
+        base = 0;
+        count = 0;
+    }
+
+    void SpriteBatch::Begin() noexcept
+    {
+        sprites.clear();
+        keys.clear();
+        runs.clear();
+    }
+
+    void SpriteBatch::Draw(const uint32 texture, const SpriteInstance & sprite, const uint8 layer)
+    {
+        sprites.push_back(sprite);
+        keys.push_back((uint32(layer) << TEXTURE_BITS) | (texture & TEXTURE_MASK));
+    }
+
+    void SpriteBatch::Sort()
+    {
+        const uint32 size = static_cast<uint32>(keys.size());
+
+        order.resize(size);
+        scratchKeys.resize(size);
+        scratchOrder.resize(size);
+
+        for (uint32 i = 0; i < size; ++i)
+            order[i] = i;
+
+        // stable LSD radix sort, one byte per pass
+        for (uint32 shift = 0; shift < 32; shift += 8)
+        {
+            uint32 histogram[256] {};
+            for (uint32 i = 0; i < size; ++i)
+                ++histogram[(keys[i] >> shift) & 0xff];
+
+            // most frames use few textures and layers, so whole passes are skipped
+            if (histogram[(keys[0] >> shift) & 0xff] == size)
+                continue;
+
+            uint32 offset = 0;
+            for (uint32 & bucket : histogram)
+            {
+                const uint32 bucketSize = bucket;
+                bucket = offset;
+                offset += bucketSize;
+            }
+
+            for (uint32 i = 0; i < size; ++i)
+            {
+                const uint32 slot = histogram[(keys[i] >> shift) & 0xff]++;
+                scratchKeys[slot] = keys[i];
+                scratchOrder[slot] = order[i];
+            }
+
+            keys.swap(scratchKeys);
+            order.swap(scratchOrder);
+        }
+    }
+
+    void SpriteBatch::End()
+    {
+        count = 0;
+
+        if (sprites.empty())
+            return;
+
+        Sort();
+
+        uint32 size = static_cast<uint32>(sprites.size());
+
+        if (size > ringCapacity)
+        {
+            // a mapped ring can not grow, the sprites that do not fit are dropped
+            if (storage.empty())
+            {
+                size = ringCapacity;
+            }
+            else
+            {
+                storage.resize(size);
+                ring = storage.data();
+                ringCapacity = size;
+                ringHead = 0;
+            }
+        }
+
+        if (ringHead + size > ringCapacity)
+            ringHead = 0;
+
+        base = ringHead;
+        ringHead += size;
+        count = size;
+
+        SpriteInstance * out = ring + base;
+
+        for (uint32 i = 0; i < size; ++i)
+        {
+            out[i] = sprites[order[i]];
+
+            if (runs.empty() || keys[i] != keys[i - 1])
+                runs.push_back({ keys[i] & TEXTURE_MASK, keys[i] >> TEXTURE_BITS, i, 0 });
+
+            ++runs.back().count;
+        }
+    }
+}
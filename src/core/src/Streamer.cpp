@@ -0,0 +1,503 @@
+#include "Streamer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #define LUNA_URING
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace Luna
+{
+    struct StreamJob
+    {
+        StreamId id;
+        StreamRequest request;
+        std::vector<uint8> data;
+        uint64 read;                        // bytes read so far
+        int file;
+        bool loaded;
+        bool cancelled;
+    };
+
+    // largest single read, IORING_OP_READ takes a 32 bit length
+    constexpr uint64 MAX_READ = 1ULL << 30;
+
+    // ---------------------------------------------------
+    // io_uring without liburing: the rings are mapped once and
+    // only touched by the I/O thread
+    // ---------------------------------------------------
+
+#ifdef LUNA_URING
+    struct StreamRing
+    {
+        int fd;
+        uint8 * sq;
+        uint8 * cq;
+        size_t sqSize;
+        size_t cqSize;
+        io_uring_sqe * sqes;
+        uint32 entries;
+        io_uring_params params;
+
+        StreamRing() noexcept
+            : fd{-1}, sq{nullptr}, cq{nullptr}, sqSize{}, cqSize{}, sqes{nullptr}, entries{}, params{}
+        {
+        }
+
+        ~StreamRing() noexcept
+        {
+            if (sqes)
+                munmap(sqes, entries * sizeof(io_uring_sqe));
+            if (cq && cq != sq)
+                munmap(cq, cqSize);
+            if (sq)
+                munmap(sq, sqSize);
+            if (fd >= 0)
+                close(fd);
+        }
+
+        bool Create(const uint32 depth)
+        {
+            fd = int(syscall(__NR_io_uring_setup, depth, &params));
+            if (fd < 0)
+                return false;
+
+            entries = params.sq_entries;
+            sqSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+            cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (single)
+                sqSize = cqSize = std::max(sqSize, cqSize);
+
+            void * view = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (view == MAP_FAILED)
+                return false;
+            sq = static_cast<uint8*>(view);
+
+            if (single)
+            {
+                cq = sq;
+            }
+            else
+            {
+                view = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+                if (view == MAP_FAILED)
+                    return false;
+                cq = static_cast<uint8*>(view);
+            }
+
+            view = mmap(nullptr, entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+            if (view == MAP_FAILED)
+                return false;
+            sqes = static_cast<io_uring_sqe*>(view);
+
+            return true;
+        }
+
+        uint32 * Sq(const uint32 offset) const noexcept
+        { return reinterpret_cast<uint32*>(sq + offset); }
+
+        uint32 * Cq(const uint32 offset) const noexcept
+        { return reinterpret_cast<uint32*>(cq + offset); }
+
+        void Read(StreamJob * job)
+        {
+            const uint32 tail = *Sq(params.sq_off.tail);
+            const uint32 index = tail & *Sq(params.sq_off.ring_mask);
+
+            io_uring_sqe & sqe = sqes[index];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = job->file;
+            sqe.addr = uint64(reinterpret_cast<uintptr_t>(job->data.data() + job->read));
+            sqe.len = uint32(std::min(MAX_READ, job->data.size() - job->read));
+            sqe.off = job->request.offset + job->read;
+            sqe.user_data = uint64(reinterpret_cast<uintptr_t>(job));
+
+            Sq(params.sq_off.array)[index] = index;
+            __atomic_store_n(Sq(params.sq_off.tail), tail + 1, __ATOMIC_RELEASE);
+        }
+
+        // submits what was queued and blocks until at least wait reads finish
+        void Submit(const uint32 count, const uint32 wait)
+        {
+            syscall(__NR_io_uring_enter, fd, count, wait, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        }
+
+        bool Complete(StreamJob *& job, int32 & result) noexcept
+        {
+            const uint32 head = *Cq(params.cq_off.head);
+            if (head == __atomic_load_n(Cq(params.cq_off.tail), __ATOMIC_ACQUIRE))
+                return false;
+
+            const io_uring_cqe * cqes = reinterpret_cast<const io_uring_cqe*>(cq + params.cq_off.cqes);
+            const io_uring_cqe & cqe = cqes[head & *Cq(params.cq_off.ring_mask)];
+            job = reinterpret_cast<StreamJob*>(uintptr_t(cqe.user_data));
+            result = cqe.res;
+
+            __atomic_store_n(Cq(params.cq_off.head), head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+    };
+#else
+    struct StreamRing
+    {
+    };
+#endif
+
+    // ---------------------------------------------------
+
+    Streamer::Streamer(ThreadPool * threadPool, const uint32 depth, const bool uring)
+        : threadPool{ threadPool },
+        nextId{1},
+        depth{ std::max(1U, depth) },
+        decoders{ std::max(1U, threadPool->Size() / 2) },
+        decoding{},
+        budget{0.002},
+        stop{false}
+    {
+    #ifdef LUNA_URING
+        if (uring)
+        {
+            ring = std::make_unique<StreamRing>();
+            if (ring->Create(this->depth))
+                io = std::thread(&Streamer::IoLoop, this);
+            else
+                ring.reset();
+        }
+    #endif
+
+        // blocking reads on their own threads, so a slow disk never holds up
+        // the workers the frame depends on
+        if (!ring)
+            readers = std::make_unique<ThreadPool>(std::clamp(this->depth, 1U, 4U));
+    }
+
+    Streamer::~Streamer() noexcept
+    {
+        {
+            std::lock_guard lock(mutex);
+            stop = true;
+        }
+
+        wake.notify_all();
+
+        if (io.joinable())
+            io.join();
+
+        readers.reset();
+
+        std::unique_lock lock(mutex);
+        idle.wait(lock, [this] { return decoding == 0; });
+    }
+
+    StreamJob * Streamer::Pop(std::deque<StreamJob*> (&queues)[STREAM_PRIORITIES]) noexcept
+    {
+        for (auto & queue : queues)
+        {
+            if (!queue.empty())
+            {
+                StreamJob * job = queue.front();
+                queue.pop_front();
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    StreamId Streamer::Load(StreamRequest && request)
+    {
+        auto job = std::make_unique<StreamJob>();
+        job->request = std::move(request);
+        job->request.priority = std::min(job->request.priority, STREAM_LOW);
+        job->read = 0;
+        job->file = -1;
+        job->loaded = false;
+        job->cancelled = false;
+
+        StreamId id;
+        {
+            std::lock_guard lock(mutex);
+            id = nextId++;
+            job->id = id;
+            queued[job->request.priority].push_back(job.get());
+            jobs.emplace(id, std::move(job));
+        }
+
+        // each task reads whatever is most urgent when it runs
+        if (readers)
+            readers->Submit([this] { ReadNext(); });
+        else
+            wake.notify_one();
+
+        return id;
+    }
+
+    StreamId Streamer::Load(const string_view path, const StreamPriority priority,
+        std::function<void(std::vector<uint8> & data, bool loaded)> complete)
+    {
+        return Load(StreamRequest{ string{ path }, 0, 0, priority, nullptr, std::move(complete) });
+    }
+
+    bool Streamer::Cancel(const StreamId id)
+    {
+        std::lock_guard lock(mutex);
+
+        auto found = jobs.find(id);
+        if (found == jobs.end())
+            return false;
+
+        StreamJob * job = found->second.get();
+        auto & queue = queued[job->request.priority];
+        auto waiting = std::find(queue.begin(), queue.end(), job);
+
+        if (waiting == queue.end())
+        {
+            // in flight, dropped when it comes back
+            job->cancelled = true;
+            return true;
+        }
+
+        queue.erase(waiting);
+        jobs.erase(found);
+        return true;
+    }
+
+    // ---------------------------------------------------
+    // Reading
+    // ---------------------------------------------------
+
+#ifdef LUNA_URING
+    // sizes the buffer, false when the file or the range is missing
+    static bool Open(StreamJob * job)
+    {
+        job->file = open(job->request.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (job->file < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(job->file, &info) == 0)
+        {
+            const uint64 end = uint64(info.st_size);
+            const uint64 size = job->request.size ? job->request.size : end - std::min(end, job->request.offset);
+
+            if (job->request.offset + size <= end)
+            {
+                job->data.resize(size_t(size));
+                return true;
+            }
+        }
+
+        close(job->file);
+        job->file = -1;
+        return false;
+    }
+
+    void Streamer::IoLoop()
+    {
+        std::vector<StreamJob*> batch;
+        uint32 inFlight = 0;
+
+        auto queuedAny = [this]
+        {
+            return std::any_of(std::begin(queued), std::end(queued), [](const auto & queue) { return !queue.empty(); });
+        };
+
+        while (true)
+        {
+            {
+                std::unique_lock lock(mutex);
+                if (inFlight == 0)
+                    wake.wait(lock, [&] { return stop || queuedAny(); });
+
+                if (stop && inFlight == 0)
+                    return;
+
+                while (!stop && inFlight + batch.size() < depth)
+                {
+                    StreamJob * job = Pop(queued);
+                    if (!job)
+                        break;
+                    batch.push_back(job);
+                }
+            }
+
+            uint32 submitted = 0;
+            for (StreamJob * job : batch)
+            {
+                if (Open(job) && !job->data.empty())
+                {
+                    ring->Read(job);
+                    ++submitted;
+                    continue;
+                }
+
+                if (job->file >= 0)
+                {
+                    close(job->file);
+                    job->file = -1;
+                    job->loaded = true;
+                }
+
+                Decode(job);
+            }
+
+            batch.clear();
+            inFlight += submitted;
+
+            // new requests wait for the next completion, reads are short enough for that
+            ring->Submit(submitted, inFlight ? 1 : 0);
+
+            StreamJob * job;
+            int32 result;
+            while (ring->Complete(job, result))
+            {
+                if (result > 0)
+                    job->read += uint64(result);
+
+                // large or interrupted reads come back short, ask for the rest
+                if (result > 0 && job->read < job->data.size())
+                {
+                    ring->Read(job);
+                    ring->Submit(1, 0);
+                    continue;
+                }
+
+                --inFlight;
+                close(job->file);
+                job->file = -1;
+                job->loaded = job->read == job->data.size();
+                Decode(job);
+            }
+        }
+    }
+#else
+    void Streamer::IoLoop()
+    {
+    }
+#endif
+
+    void Streamer::ReadNext()
+    {
+        StreamJob * job;
+        {
+            std::lock_guard lock(mutex);
+            if (stop || !(job = Pop(queued)))
+                return;
+        }
+
+        std::ifstream file(job->request.path, std::ios::binary | std::ios::ate);
+        if (file)
+        {
+            const uint64 end = uint64(file.tellg());
+            const uint64 size = job->request.size ? job->request.size : end - std::min(end, job->request.offset);
+
+            if (job->request.offset + size <= end)
+            {
+                job->data.resize(size_t(size));
+                file.seekg(std::streamoff(job->request.offset));
+                file.read(reinterpret_cast<char*>(job->data.data()), std::streamsize(size));
+                job->loaded = bool(file);
+            }
+        }
+
+        Decode(job);
+    }
+
+    // ---------------------------------------------------
+    // Decoding and delivery
+    // ---------------------------------------------------
+
+    void Streamer::Decode(StreamJob * job)
+    {
+        {
+            std::lock_guard lock(mutex);
+
+            if (!job->loaded || job->cancelled || !job->request.decode)
+            {
+                ready[job->request.priority].push_back(job);
+                return;
+            }
+
+            decodes[job->request.priority].push_back(job);
+
+            if (decoding == decoders)
+                return;
+
+            ++decoding;
+        }
+
+        // a pool without workers runs the task right here
+        threadPool->Submit([this] { DecodeLoop(); });
+    }
+
+    void Streamer::DecodeLoop()
+    {
+        std::unique_lock lock(mutex);
+
+        while (StreamJob * job = Pop(decodes))
+        {
+            if (!job->cancelled && !stop)
+            {
+                lock.unlock();
+                job->loaded = job->request.decode(job->data);
+                lock.lock();
+            }
+
+            ready[job->request.priority].push_back(job);
+        }
+
+        if (--decoding == 0)
+            idle.notify_all();
+    }
+
+    uint32 Streamer::Deliver()
+    {
+        const Clock::time_point start = Clock::now();
+        uint32 delivered = 0;
+
+        while (true)
+        {
+            std::unique_ptr<StreamJob> job;
+            {
+                std::lock_guard lock(mutex);
+
+                StreamJob * next = Pop(ready);
+                if (!next)
+                    break;
+
+                auto found = jobs.find(next->id);
+                job = std::move(found->second);
+                jobs.erase(found);
+            }
+
+            if (job->cancelled)
+                continue;
+
+            if (job->request.complete)
+                job->request.complete(job->data, job->loaded);
+
+            ++delivered;
+
+            if (std::chrono::duration<double>(Clock::now() - start).count() >= budget)
+                break;
+        }
+
+        return delivered;
+    }
+
+    uint32 Streamer::Pending() noexcept
+    {
+        std::lock_guard lock(mutex);
+        return uint32(jobs.size());
+    }
+}
@@ -0,0 +1,734 @@
+#include "TextureProcessing.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Luna
+{
+    // 4x4 texels in rows, RGBA
+    using Block = uint8[16][4];
+
+    // BC7 4 bit index weights, out of 64
+    constexpr uint32 BC7_WEIGHTS[16] { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // ETC1 intensity modifiers, the negated pair follows
+    constexpr int32 ETC_MODIFIERS[8][2] { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+
+    static void Rows(ThreadPool * pool, const uint32 count, const uint32 grain,
+        const std::function<void(uint32 begin, uint32 end)> & func)
+    {
+        if (pool)
+            pool->ParallelFor(count, grain, func);
+        else
+            func(0, count);
+    }
+
+    static void Fetch(const ImageData & image, const uint32 blockX, const uint32 blockY, Block & block) noexcept
+    {
+        for (uint32 y = 0; y < 4; ++y)
+        {
+            const uint32 row = std::min(blockY * 4 + y, image.height - 1);
+            for (uint32 x = 0; x < 4; ++x)
+            {
+                const uint32 column = std::min(blockX * 4 + x, image.width - 1);
+                memcpy(block[y * 4 + x], image.pixels.data() + (size_t(row) * image.width + column) * 4, 4);
+            }
+        }
+    }
+
+    // largest eigenvector of the covariance by power iteration, the line the
+    // endpoints are placed on
+    template<uint32 N>
+    static void PrincipalAxis(const float (&points)[16][N], const uint32 count, float (&mean)[N], float (&axis)[N]) noexcept
+    {
+        for (uint32 c = 0; c < N; ++c)
+        {
+            mean[c] = 0.0f;
+            for (uint32 i = 0; i < count; ++i)
+                mean[c] += points[i][c];
+            mean[c] /= float(count);
+        }
+
+        float covariance[N][N] {};
+        for (uint32 i = 0; i < count; ++i)
+        {
+            for (uint32 a = 0; a < N; ++a)
+                for (uint32 b = 0; b < N; ++b)
+                    covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+        }
+
+        for (uint32 c = 0; c < N; ++c)
+            axis[c] = 1.0f;
+
+        for (uint32 iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[N] {};
+            float length = 0.0f;
+            for (uint32 a = 0; a < N; ++a)
+            {
+                for (uint32 b = 0; b < N; ++b)
+                    next[a] += covariance[a][b] * axis[b];
+                length = std::max(length, std::fabs(next[a]));
+            }
+
+            if (length < 1e-6f)
+                break;
+
+            for (uint32 c = 0; c < N; ++c)
+                axis[c] = next[c] / length;
+        }
+    }
+
+    // endpoints at the extremes of the projections on the axis
+    template<uint32 N>
+    static void RangeFit(const float (&points)[16][N], const uint32 count, float (&low)[N], float (&high)[N]) noexcept
+    {
+        float mean[N], axis[N];
+        PrincipalAxis(points, count, mean, axis);
+
+        float lowest = 3.4e38f, highest = -3.4e38f;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float t = 0.0f;
+            for (uint32 c = 0; c < N; ++c)
+                t += (points[i][c] - mean[c]) * axis[c];
+            lowest = std::min(lowest, t);
+            highest = std::max(highest, t);
+        }
+
+        float length = 0.0f;
+        for (uint32 c = 0; c < N; ++c)
+            length += axis[c] * axis[c];
+        length = length > 0.0f ? 1.0f / length : 0.0f;
+
+        for (uint32 c = 0; c < N; ++c)
+        {
+            low[c] = std::clamp(mean[c] + axis[c] * lowest * length, 0.0f, 255.0f);
+            high[c] = std::clamp(mean[c] + axis[c] * highest * length, 0.0f, 255.0f);
+        }
+    }
+
+    // endpoints minimizing the squared error for fixed interpolation weights
+    template<uint32 N>
+    static bool LeastSquares(const float (&points)[16][N], const float * weights, const uint32 count,
+        float (&low)[N], float (&high)[N]) noexcept
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[N] {}, bx[N] {};
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const float b = weights[i];
+            const float a = 1.0f - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (uint32 c = 0; c < N; ++c)
+            {
+                ax[c] += a * points[i][c];
+                bx[c] += b * points[i][c];
+            }
+        }
+
+        const float determinant = aa * bb - ab * ab;
+        if (std::fabs(determinant) < 1e-6f)
+            return false;
+
+        for (uint32 c = 0; c < N; ++c)
+        {
+            low[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+            high[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------
+    // BC1 colors
+    // ---------------------------------------------------
+
+    static uint16 To565(const float (&color)[3]) noexcept
+    {
+        return uint16((std::lround(color[0] * 31.0f / 255.0f) << 11)
+            | (std::lround(color[1] * 63.0f / 255.0f) << 5)
+            | std::lround(color[2] * 31.0f / 255.0f));
+    }
+
+    static void From565(const uint16 packed, int32 (&color)[3]) noexcept
+    {
+        const int32 r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // indices and error of an endpoint pair; three colors keeps index 3 for
+    // transparent texels, four colors needs c0 > c1 and three c0 <= c1, which the
+    // caller fixes by swapping
+    static uint32 ColorIndices(const Block & block, const bool (&opaque)[16], const uint16 c0, const uint16 c1,
+        const bool three, uint8 (&indices)[16]) noexcept
+    {
+        int32 palette[4][3];
+        From565(c0, palette[0]);
+        From565(c1, palette[1]);
+        for (uint32 c = 0; c < 3; ++c)
+        {
+            if (three)
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+            else
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+        }
+
+        uint32 error = 0;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            if (!opaque[i])
+            {
+                indices[i] = 3;
+                continue;
+            }
+
+            uint32 best = ~0U;
+            for (uint32 k = 0; k < (three ? 3U : 4U); ++k)
+            {
+                uint32 distance = 0;
+                for (uint32 c = 0; c < 3; ++c)
+                    distance += uint32((block[i][c] - palette[k][c]) * (block[i][c] - palette[k][c]));
+
+                if (distance < best)
+                {
+                    best = distance;
+                    indices[i] = uint8(k);
+                }
+            }
+            error += best;
+        }
+
+        return error;
+    }
+
+    static void EncodeColors(const Block & block, const bool punchThrough, uint8 * out) noexcept
+    {
+        bool opaque[16];
+        float points[16][3];
+        uint32 count = 0;
+
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            opaque[i] = !punchThrough || block[i][3] >= 128;
+            if (opaque[i])
+            {
+                for (uint32 c = 0; c < 3; ++c)
+                    points[count][c] = float(block[i][c]);
+                ++count;
+            }
+        }
+
+        const bool three = count < 16;
+        uint16 c0 = 0, c1 = 0;
+
+        // a block with no opaque texel keeps index 3 everywhere
+        uint8 indices[16];
+        memset(indices, three ? 3 : 0, sizeof(indices));
+
+        if (count > 0)
+        {
+            float low[3], high[3];
+            RangeFit(points, count, low, high);
+
+            c0 = To565(high);
+            c1 = To565(low);
+            uint32 error = ColorIndices(block, opaque, c0, c1, three, indices);
+
+            // two rounds of least squares on the chosen indices
+            const float positions[4] { 0.0f, 1.0f, three ? 0.5f : 1.0f / 3.0f, 2.0f / 3.0f };
+            for (uint32 round = 0; round < 2 && error > 0; ++round)
+            {
+                float weights[16];
+                for (uint32 i = 0, k = 0; i < 16; ++i)
+                {
+                    if (opaque[i])
+                        weights[k++] = positions[indices[i]];
+                }
+
+                if (!LeastSquares(points, weights, count, high, low))
+                    break;
+
+                const uint16 r0 = To565(high), r1 = To565(low);
+                uint8 refined[16];
+                const uint32 refinedError = ColorIndices(block, opaque, r0, r1, three, refined);
+                if (refinedError >= error)
+                    break;
+
+                c0 = r0;
+                c1 = r1;
+                error = refinedError;
+                memcpy(indices, refined, sizeof(indices));
+            }
+        }
+
+        // the order of the endpoints selects the mode, swapping them mirrors the indices
+        if ((three && c0 > c1) || (!three && c0 < c1))
+        {
+            std::swap(c0, c1);
+            for (uint8 & index : indices)
+            {
+                if (index < 2 || !three)
+                    index ^= 1;
+            }
+        }
+        else if (!three && c0 == c1)
+        {
+            memset(indices, 0, sizeof(indices));
+        }
+
+        uint32 bits = 0;
+        for (uint32 i = 0; i < 16; ++i)
+            bits |= uint32(indices[i]) << (2 * i);
+
+        memcpy(out, &c0, 2);
+        memcpy(out + 2, &c1, 2);
+        memcpy(out + 4, &bits, 4);
+    }
+
+    // ---------------------------------------------------
+    // BC4 alpha
+    // ---------------------------------------------------
+
+    static uint32 AlphaIndices(const uint8 (&values)[16], const uint8 a0, const uint8 a1, uint8 (&indices)[16]) noexcept
+    {
+        int32 palette[8] { a0, a1 };
+        if (a0 > a1)
+        {
+            for (int32 i = 1; i < 7; ++i)
+                palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+        else
+        {
+            for (int32 i = 1; i < 5; ++i)
+                palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint32 error = 0;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            uint32 best = ~0U;
+            for (uint32 k = 0; k < 8; ++k)
+            {
+                const uint32 distance = uint32((values[i] - palette[k]) * (values[i] - palette[k]));
+                if (distance < best)
+                {
+                    best = distance;
+                    indices[i] = uint8(k);
+                }
+            }
+            error += best;
+        }
+
+        return error;
+    }
+
+    static void EncodeAlpha(const Block & block, uint8 * out) noexcept
+    {
+        uint8 values[16];
+        uint8 low = 255, high = 0;
+        uint8 innerLow = 255, innerHigh = 0;
+
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            values[i] = block[i][3];
+            low = std::min(low, values[i]);
+            high = std::max(high, values[i]);
+
+            if (values[i] != 0 && values[i] != 255)
+            {
+                innerLow = std::min(innerLow, values[i]);
+                innerHigh = std::max(innerHigh, values[i]);
+            }
+        }
+
+        // eight interpolated values, or six with exact 0 and 255 for blocks that have both
+        uint8 a0 = high, a1 = low;
+        uint8 indices[16];
+        uint32 error = AlphaIndices(values, a0, a1, indices);
+
+        if (innerLow > innerHigh)
+            innerLow = innerHigh = 0;
+
+        uint8 six[16];
+        if (error > 0 && AlphaIndices(values, innerLow, innerHigh, six) < error)
+        {
+            a0 = innerLow;
+            a1 = innerHigh;
+            memcpy(indices, six, sizeof(indices));
+        }
+
+        uint64 bits = 0;
+        for (uint32 i = 0; i < 16; ++i)
+            bits |= uint64(indices[i]) << (3 * i);
+
+        out[0] = a0;
+        out[1] = a1;
+        for (uint32 i = 0; i < 6; ++i)
+            out[2 + i] = uint8(bits >> (8 * i));
+    }
+
+    // ---------------------------------------------------
+    // BC7 mode 6
+    // ---------------------------------------------------
+
+    // 7 bit endpoint and the shared low bit that brings it closest
+    static void QuantizeBc7(const float (&color)[4], uint8 (&quantized)[4], uint8 & pbit) noexcept
+    {
+        float bestError = 3.4e38f;
+        for (uint8 p = 0; p < 2; ++p)
+        {
+            uint8 candidate[4];
+            float error = 0.0f;
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                candidate[c] = uint8(std::clamp(std::lround((color[c] - float(p)) * 0.5f), 0L, 127L));
+                const float value = float((candidate[c] << 1) | p) - color[c];
+                error += value * value;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                pbit = p;
+                memcpy(quantized, candidate, 4);
+            }
+        }
+    }
+
+    static uint32 Bc7Indices(const Block & block, const uint8 (&e0)[4], const uint8 p0,
+        const uint8 (&e1)[4], const uint8 p1, uint8 (&indices)[16]) noexcept
+    {
+        int32 palette[16][4];
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            const int32 a = (e0[c] << 1) | p0;
+            const int32 b = (e1[c] << 1) | p1;
+            for (uint32 k = 0; k < 16; ++k)
+                palette[k][c] = (a * int32(64 - BC7_WEIGHTS[k]) + b * int32(BC7_WEIGHTS[k]) + 32) >> 6;
+        }
+
+        uint32 error = 0;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            uint32 best = ~0U;
+            for (uint32 k = 0; k < 16; ++k)
+            {
+                uint32 distance = 0;
+                for (uint32 c = 0; c < 4; ++c)
+                    distance += uint32((block[i][c] - palette[k][c]) * (block[i][c] - palette[k][c]));
+
+                if (distance < best)
+                {
+                    best = distance;
+                    indices[i] = uint8(k);
+                }
+            }
+            error += best;
+        }
+
+        return error;
+    }
+
+    static void EncodeBc7(const Block & block, uint8 * out) noexcept
+    {
+        float points[16][4];
+        for (uint32 i = 0; i < 16; ++i)
+            for (uint32 c = 0; c < 4; ++c)
+                points[i][c] = float(block[i][c]);
+
+        float low[4], high[4];
+        RangeFit(points, 16, low, high);
+
+        uint8 e0[4], e1[4], p0 = 0, p1 = 0, indices[16];
+        QuantizeBc7(low, e0, p0);
+        QuantizeBc7(high, e1, p1);
+        uint32 error = Bc7Indices(block, e0, p0, e1, p1, indices);
+
+        for (uint32 round = 0; round < 2 && error > 0; ++round)
+        {
+            float weights[16];
+            for (uint32 i = 0; i < 16; ++i)
+                weights[i] = float(BC7_WEIGHTS[indices[i]]) / 64.0f;
+
+            if (!LeastSquares(points, weights, 16, low, high))
+                break;
+
+            uint8 r0[4], r1[4], q0 = 0, q1 = 0, refined[16];
+            QuantizeBc7(low, r0, q0);
+            QuantizeBc7(high, r1, q1);
+            const uint32 refinedError = Bc7Indices(block, r0, q0, r1, q1, refined);
+            if (refinedError >= error)
+                break;
+
+            memcpy(e0, r0, 4);
+            memcpy(e1, r1, 4);
+            p0 = q0;
+            p1 = q1;
+            error = refinedError;
+            memcpy(indices, refined, sizeof(indices));
+        }
+
+        // the first index drops its top bit, so it has to be below 8
+        if (indices[0] >= 8)
+        {
+            std::swap(e0, e1);
+            std::swap(p0, p1);
+            for (uint8 & index : indices)
+                index = uint8(15 - index);
+        }
+
+        uint64 bits[2] {};
+        uint32 position = 0;
+        auto write = [&bits, &position](const uint64 value, const uint32 count)
+        {
+            bits[position / 64] |= value << (position % 64);
+            if (position % 64 + count > 64)
+                bits[position / 64 + 1] |= value >> (64 - position % 64);
+            position += count;
+        };
+
+        write(1 << 6, 7);
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            write(e0[c], 7);
+            write(e1[c], 7);
+        }
+        write(p0, 1);
+        write(p1, 1);
+        for (uint32 i = 0; i < 16; ++i)
+            write(indices[i], i == 0 ? 3 : 4);
+
+        memcpy(out, bits, 16);
+    }
+
+    // ---------------------------------------------------
+    // ETC2 RGB, individual and differential modes
+    // ---------------------------------------------------
+
+    // best modifier table of a half block around its base color, the selectors in
+    // ETC order (bit 1 negates, bit 0 picks the large modifier)
+    static uint32 EtcSubblock(const Block & block, const uint32 (&texels)[8], const int32 (&base)[3],
+        uint32 & table, uint8 (&selectors)[8]) noexcept
+    {
+        uint32 bestError = ~0U;
+        for (uint32 t = 0; t < 8; ++t)
+        {
+            const int32 modifiers[4] { ETC_MODIFIERS[t][0], ETC_MODIFIERS[t][1], -ETC_MODIFIERS[t][0], -ETC_MODIFIERS[t][1] };
+
+            uint32 error = 0;
+            uint8 chosen[8];
+            for (uint32 i = 0; i < 8 && error < bestError; ++i)
+            {
+                const uint8 * texel = block[texels[i]];
+
+                uint32 best = ~0U;
+                for (uint32 k = 0; k < 4; ++k)
+                {
+                    uint32 distance = 0;
+                    for (uint32 c = 0; c < 3; ++c)
+                    {
+                        const int32 value = std::clamp(base[c] + modifiers[k], 0, 255) - texel[c];
+                        distance += uint32(value * value);
+                    }
+
+                    if (distance < best)
+                    {
+                        best = distance;
+                        chosen[i] = uint8(k);
+                    }
+                }
+                error += best;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                table = t;
+                memcpy(selectors, chosen, sizeof(selectors));
+            }
+        }
+
+        return bestError;
+    }
+
+    static void EncodeEtc(const Block & block, uint8 * out) noexcept
+    {
+        uint64 bestBits = 0;
+        uint32 bestError = ~0U;
+
+        for (uint32 flip = 0; flip < 2; ++flip)
+        {
+            // side by side 2x4 halves, or 4x2 halves on top of each other
+            uint32 texels[2][8];
+            for (uint32 half = 0; half < 2; ++half)
+            {
+                for (uint32 i = 0; i < 8; ++i)
+                {
+                    const uint32 x = flip ? i % 4 : half * 2 + i % 2;
+                    const uint32 y = flip ? half * 2 + i / 4 : i / 2;
+                    texels[half][i] = y * 4 + x;
+                }
+            }
+
+            float average[2][3] {};
+            for (uint32 half = 0; half < 2; ++half)
+            {
+                for (uint32 i = 0; i < 8; ++i)
+                    for (uint32 c = 0; c < 3; ++c)
+                        average[half][c] += float(block[texels[half][i]][c]) / 8.0f;
+            }
+
+            // differential while the second color is within -4..3 of the first in
+            // 5 bits, ETC2 reads other modes from overflowing sums
+            int32 first5[3], second5[3];
+            bool differential = true;
+            for (uint32 c = 0; c < 3; ++c)
+            {
+                first5[c] = int32(std::lround(average[0][c] * 31.0f / 255.0f));
+                second5[c] = int32(std::lround(average[1][c] * 31.0f / 255.0f));
+                const int32 delta = second5[c] - first5[c];
+                differential = differential && delta >= -4 && delta <= 3;
+            }
+
+            int32 bases[2][3];
+            uint64 bits = 0;
+            for (uint32 c = 0; c < 3; ++c)
+            {
+                if (differential)
+                {
+                    bases[0][c] = (first5[c] << 3) | (first5[c] >> 2);
+                    bases[1][c] = (second5[c] << 3) | (second5[c] >> 2);
+                    bits |= uint64(first5[c]) << (59 - 8 * c);
+                    bits |= uint64((second5[c] - first5[c]) & 7) << (56 - 8 * c);
+                }
+                else
+                {
+                    const int32 first4 = int32(std::lround(average[0][c] * 15.0f / 255.0f));
+                    const int32 second4 = int32(std::lround(average[1][c] * 15.0f / 255.0f));
+                    bases[0][c] = first4 * 17;
+                    bases[1][c] = second4 * 17;
+                    bits |= uint64(first4) << (60 - 8 * c);
+                    bits |= uint64(second4) << (56 - 8 * c);
+                }
+            }
+
+            uint32 error = 0;
+            for (uint32 half = 0; half < 2; ++half)
+            {
+                uint32 table = 0;
+                uint8 selectors[8];
+                error += EtcSubblock(block, texels[half], bases[half], table, selectors);
+
+                bits |= uint64(table) << (half ? 34 : 37);
+
+                // selector bits are stored column by column
+                for (uint32 i = 0; i < 8; ++i)
+                {
+                    const uint32 texel = texels[half][i];
+                    const uint32 bit = (texel % 4) * 4 + texel / 4;
+                    bits |= uint64(selectors[i] >> 1) << (16 + bit);
+                    bits |= uint64(selectors[i] & 1) << bit;
+                }
+            }
+
+            bits |= uint64(differential ? 1 : 0) << 33;
+            bits |= uint64(flip) << 32;
+
+            if (error < bestError)
+            {
+                bestError = error;
+                bestBits = bits;
+            }
+        }
+
+        for (uint32 i = 0; i < 8; ++i)
+            out[i] = uint8(bestBits >> (56 - 8 * i));
+    }
+
+    // ---------------------------------------------------
+
+    uint32 BlockBytes(const TextureFormat format) noexcept
+    {
+        switch (format)
+        {
+        case TEXTURE_BC1:
+        case TEXTURE_ETC2:
+            return 8;
+        case TEXTURE_BC3:
+        case TEXTURE_BC7:
+            return 16;
+        default:
+            return 4;
+        }
+    }
+
+    uint64 LevelBytes(const TextureFormat format, const uint32 width, const uint32 height) noexcept
+    {
+        if (format == TEXTURE_RGBA8)
+            return uint64(width) * height * 4;
+
+        return uint64((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+    }
+
+    std::vector<uint8> EncodeImage(const ImageData & image, const TextureFormat format, ThreadPool * pool)
+    {
+        if (format == TEXTURE_RGBA8 || image.width == 0 || image.height == 0)
+            return image.pixels;
+
+        const uint32 blocksWide = (image.width + 3) / 4;
+        const uint32 blocksHigh = (image.height + 3) / 4;
+        const uint32 blockBytes = BlockBytes(format);
+
+        // BC1 spends index 3 on transparency only when the image needs it
+        bool punchThrough = false;
+        for (size_t i = 3; format == TEXTURE_BC1 && !punchThrough && i < image.pixels.size(); i += 4)
+            punchThrough = image.pixels[i] < 128;
+
+        std::vector<uint8> output(size_t(blocksWide) * blocksHigh * blockBytes);
+
+        Rows(pool, blocksHigh, 4, [&](const uint32 begin, const uint32 end)
+        {
+            Block block;
+            for (uint32 y = begin; y < end; ++y)
+            {
+                for (uint32 x = 0; x < blocksWide; ++x)
+                {
+                    uint8 * out = output.data() + (size_t(y) * blocksWide + x) * blockBytes;
+                    Fetch(image, x, y, block);
+
+                    switch (format)
+                    {
+                    case TEXTURE_BC1:
+                        EncodeColors(block, punchThrough, out);
+                        break;
+                    case TEXTURE_BC3:
+                        EncodeAlpha(block, out);
+                        EncodeColors(block, false, out + 8);
+                        break;
+                    case TEXTURE_BC7:
+                        EncodeBc7(block, out);
+                        break;
+                    default:
+                        EncodeEtc(block, out);
+                        break;
+                    }
+                }
+            }
+        });
+
+        return output;
+    }
+}
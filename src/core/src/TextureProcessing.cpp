@@ -0,0 +1,279 @@
+#include "TextureProcessing.h"
+#include "Math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Luna
+{
+    using namespace Math;
+
+    // the Kaiser window of the nvtt mipmap filter
+    constexpr float KAISER_WIDTH = 3.0f;
+    constexpr float KAISER_ALPHA = 4.0f;
+
+    // source taps and their weights for one destination pixel
+    struct FilterTaps
+    {
+        int32 first;
+        std::vector<float> weights;
+    };
+
+    static void Rows(ThreadPool * pool, const uint32 count, const uint32 grain,
+        const std::function<void(uint32 begin, uint32 end)> & func)
+    {
+        if (pool)
+            pool->ParallelFor(count, grain, func);
+        else
+            func(0, count);
+    }
+
+    static float SrgbToLinear(const float c) noexcept
+    { return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f); }
+
+    static float LinearToSrgb(const float c) noexcept
+    { return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f; }
+
+    static float BesselI0(const float x) noexcept
+    {
+        float sum = 1.0f, term = 1.0f;
+        for (int32 k = 1; k < 20; ++k)
+        {
+            term *= (x * 0.5f / float(k)) * (x * 0.5f / float(k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // t in destination pixels
+    static float Weight(const MipFilter filter, const float t) noexcept
+    {
+        const float a = std::fabs(t);
+
+        if (filter == MIP_BOX)
+            return a < 0.5f ? 1.0f : (a == 0.5f ? 0.5f : 0.0f);
+
+        if (a >= KAISER_WIDTH)
+            return 0.0f;
+
+        const float sinc = a < 1e-5f ? 1.0f : std::sin(PI * a) / (PI * a);
+        const float r = a / KAISER_WIDTH;
+        return sinc * BesselI0(KAISER_ALPHA * std::sqrt(1.0f - r * r)) / BesselI0(KAISER_ALPHA);
+    }
+
+    // taps of a size to next reduction, clamped at the edges
+    static std::vector<FilterTaps> Taps(const MipFilter filter, const uint32 size, const uint32 next)
+    {
+        const float scale = float(size) / float(next);
+        const float radius = (filter == MIP_BOX ? 0.5f : KAISER_WIDTH) * scale;
+
+        std::vector<FilterTaps> taps(next);
+        for (uint32 i = 0; i < next; ++i)
+        {
+            const float center = (float(i) + 0.5f) * scale;
+            const int32 first = int32(std::floor(center - radius));
+            const int32 last = int32(std::ceil(center + radius));
+
+            FilterTaps & tap = taps[i];
+            tap.first = first;
+
+            float sum = 0.0f;
+            for (int32 j = first; j <= last; ++j)
+            {
+                const float weight = Weight(filter, (float(j) + 0.5f - center) / scale);
+                tap.weights.push_back(weight);
+                sum += weight;
+            }
+
+            for (float & weight : tap.weights)
+                weight /= sum;
+        }
+
+        return taps;
+    }
+
+    // ---------------------------------------------------
+
+    std::vector<ImageData> GenerateMips(const ImageData & image, const bool srgb, const MipFilter filter, ThreadPool * pool)
+    {
+        std::vector<ImageData> levels { image };
+        if (image.width == 0 || image.height == 0)
+            return levels;
+
+        float toLinear[256];
+        for (uint32 i = 0; i < 256; ++i)
+            toLinear[i] = srgb ? SrgbToLinear(float(i) / 255.0f) : float(i) / 255.0f;
+
+        // linear colors premultiplied by alpha, filtered from level to level in
+        // float so the 8 bit rounding does not pile up down the chain
+        uint32 width = image.width;
+        uint32 height = image.height;
+        std::vector<Vec4> source(size_t(width) * height);
+
+        Rows(pool, height, 64, [&](const uint32 begin, const uint32 end)
+        {
+            for (uint32 y = begin; y < end; ++y)
+            {
+                const uint8 * in = image.pixels.data() + size_t(y) * width * 4;
+                Vec4 * out = source.data() + size_t(y) * width;
+                for (uint32 x = 0; x < width; ++x, in += 4)
+                {
+                    const float alpha = float(in[3]) / 255.0f;
+                    out[x] = Vec4{ toLinear[in[0]], toLinear[in[1]], toLinear[in[2]], 1.0f } * alpha;
+                    out[x].w = alpha;
+                }
+            }
+        });
+
+        std::vector<Vec4> horizontal;
+        std::vector<Vec4> target;
+
+        while (width > 1 || height > 1)
+        {
+            const uint32 nextWidth = std::max(1U, width / 2);
+            const uint32 nextHeight = std::max(1U, height / 2);
+
+            const std::vector<FilterTaps> columns = Taps(filter, width, nextWidth);
+            const std::vector<FilterTaps> rows = Taps(filter, height, nextHeight);
+
+            horizontal.resize(size_t(nextWidth) * height);
+            target.resize(size_t(nextWidth) * nextHeight);
+
+            Rows(pool, height, 32, [&](const uint32 begin, const uint32 end)
+            {
+                for (uint32 y = begin; y < end; ++y)
+                {
+                    const Vec4 * in = source.data() + size_t(y) * width;
+                    Vec4 * out = horizontal.data() + size_t(y) * nextWidth;
+
+                    for (uint32 x = 0; x < nextWidth; ++x)
+                    {
+                        const FilterTaps & tap = columns[x];
+
+                        Vec4 sum{};
+                        for (uint32 k = 0; k < tap.weights.size(); ++k)
+                            sum = sum + in[std::clamp(tap.first + int32(k), 0, int32(width) - 1)] * tap.weights[k];
+                        out[x] = sum;
+                    }
+                }
+            });
+
+            Rows(pool, nextHeight, 16, [&](const uint32 begin, const uint32 end)
+            {
+                for (uint32 y = begin; y < end; ++y)
+                {
+                    const FilterTaps & tap = rows[y];
+                    Vec4 * out = target.data() + size_t(y) * nextWidth;
+                    std::fill(out, out + nextWidth, Vec4{});
+
+                    // whole rows at a time, the inner loop walks memory in order
+                    for (uint32 k = 0; k < tap.weights.size(); ++k)
+                    {
+                        const int32 row = std::clamp(tap.first + int32(k), 0, int32(height) - 1);
+                        const Vec4 * in = horizontal.data() + size_t(row) * nextWidth;
+                        const float weight = tap.weights[k];
+
+                        for (uint32 x = 0; x < nextWidth; ++x)
+                            out[x] = out[x] + in[x] * weight;
+                    }
+                }
+            });
+
+            ImageData level { nextWidth, nextHeight, std::vector<uint8>(size_t(nextWidth) * nextHeight * 4) };
+
+            Rows(pool, nextHeight, 32, [&](const uint32 begin, const uint32 end)
+            {
+                for (uint32 y = begin; y < end; ++y)
+                {
+                    const Vec4 * in = target.data() + size_t(y) * nextWidth;
+                    uint8 * out = level.pixels.data() + size_t(y) * nextWidth * 4;
+
+                    for (uint32 x = 0; x < nextWidth; ++x, out += 4)
+                    {
+                        // the Kaiser lobes can overshoot
+                        const float alpha = std::clamp(in[x].w, 0.0f, 1.0f);
+                        const float inverse = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+                        const float color[3] { in[x].x * inverse, in[x].y * inverse, in[x].z * inverse };
+
+                        for (uint32 c = 0; c < 3; ++c)
+                        {
+                            const float value = std::clamp(color[c], 0.0f, 1.0f);
+                            out[c] = uint8(std::lround((srgb ? LinearToSrgb(value) : value) * 255.0f));
+                        }
+                        out[3] = uint8(std::lround(alpha * 255.0f));
+                    }
+                }
+            });
+
+            levels.push_back(std::move(level));
+            std::swap(source, target);
+            width = nextWidth;
+            height = nextHeight;
+        }
+
+        return levels;
+    }
+
+    // ---------------------------------------------------
+
+    std::vector<uint8> PackTexture(const std::vector<ImageData> & levels, const TextureFormat format, const bool srgb, ThreadPool * pool)
+    {
+        if (levels.empty() || levels.size() > TEXTURE_MAX_LEVELS || format >= TEXTURE_FORMATS)
+            return {};
+
+        TextureHeader header{};
+        header.magic = TEXTURE_MAGIC;
+        header.version = TEXTURE_VERSION;
+        header.format = format;
+        header.srgb = srgb ? 1 : 0;
+        header.width = levels[0].width;
+        header.height = levels[0].height;
+        header.levelCount = uint32(levels.size());
+
+        const uint64 indexEnd = sizeof(TextureHeader) + levels.size() * sizeof(TextureLevel);
+        std::vector<uint8> output(indexEnd);
+        memcpy(output.data(), &header, sizeof(header));
+
+        for (uint32 i = 0; i < levels.size(); ++i)
+        {
+            const std::vector<uint8> blocks = EncodeImage(levels[i], format, pool);
+
+            const TextureLevel level { (output.size() + 15) & ~uint64(15), blocks.size() };
+            memcpy(output.data() + sizeof(TextureHeader) + i * sizeof(TextureLevel), &level, sizeof(level));
+
+            output.resize(level.offset);
+            output.insert(output.end(), blocks.begin(), blocks.end());
+        }
+
+        return output;
+    }
+
+    bool ReadTexture(std::span<const uint8> bytes, TextureView & view)
+    {
+        if (bytes.size() < sizeof(TextureHeader))
+            return false;
+
+        const TextureHeader * header = reinterpret_cast<const TextureHeader*>(bytes.data());
+        if (header->magic != TEXTURE_MAGIC || header->version != TEXTURE_VERSION
+            || header->format >= TEXTURE_FORMATS
+            || header->levelCount == 0 || header->levelCount > TEXTURE_MAX_LEVELS
+            || sizeof(TextureHeader) + header->levelCount * sizeof(TextureLevel) > bytes.size())
+            return false;
+
+        const TextureLevel * levels = reinterpret_cast<const TextureLevel*>(bytes.data() + sizeof(TextureHeader));
+        for (uint32 i = 0; i < header->levelCount; ++i)
+        {
+            const uint32 width = std::max(1U, header->width >> i);
+            const uint32 height = std::max(1U, header->height >> i);
+
+            if (levels[i].size != LevelBytes(TextureFormat(header->format), width, height)
+                || levels[i].offset > bytes.size() || levels[i].size > bytes.size() - levels[i].offset)
+                return false;
+        }
+
+        view.header = header;
+        view.levels = levels;
+        view.data = bytes.data();
+        return true;
+    }
+}
@@ -0,0 +1,143 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+namespace Luna
+{
+    static thread_local uint32 threadIndex = 0;
+
+    ThreadPool::ThreadPool(const uint32 threadCount) noexcept
+        : stop{false}
+    {
+        uint32 count = threadCount;
+
+        // keep one core for the thread that owns the pool (the engine loop)
+        if (count == 0)
+            count = std::max(1U, std::thread::hardware_concurrency()) - 1;
+
+        workers.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+            workers.emplace_back(&ThreadPool::WorkerLoop, this, i + 1);
+    }
+
+    ThreadPool::~ThreadPool() noexcept
+    {
+        {
+            std::lock_guard lock(mutex);
+            stop = true;
+        }
+
+        condition.notify_all();
+
+        for (auto & worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> && task)
+    {
+        if (workers.empty())
+        {
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+
+        condition.notify_one();
+    }
+
+    uint32 ThreadPool::ThreadIndex() noexcept
+    {
+        return threadIndex;
+    }
+
+    void ThreadPool::WorkerLoop(const uint32 index) noexcept
+    {
+        threadIndex = index;
+
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [this] { return stop || !tasks.empty(); });
+
+                if (stop && tasks.empty())
+                    return;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    void ThreadPool::ParallelFor(const uint32 count,
+        const uint32 grain,
+        const std::function<void(uint32 begin, uint32 end)> & func)
+    {
+        if (count == 0)
+            return;
+
+        const uint32 step = std::max(1U, grain);
+        const uint32 batches = (count + step - 1) / step;
+
+        if (batches == 1 || workers.empty())
+        {
+            func(0, count);
+            return;
+        }
+
+        // Helpers only take part while there are unclaimed batches, so the
+        // caller never waits on a task that is still sitting in the queue.
+        // That keeps nested ParallelFor calls from worker threads deadlock free.
+        struct Batches
+        {
+            std::atomic<uint32> next{0};
+            std::atomic<uint32> active{0};
+            const std::function<void(uint32, uint32)> * func;
+            uint32 count;
+            uint32 step;
+            uint32 batches;
+
+            void Run() noexcept
+            {
+                uint32 batch;
+                while ((batch = next.fetch_add(1)) < batches)
+                {
+                    const uint32 begin = batch * step;
+                    (*func)(begin, std::min(begin + step, count));
+                }
+            }
+        };
+
+        auto state = std::make_shared<Batches>();
+        state->func = &func;
+        state->count = count;
+        state->step = step;
+        state->batches = batches;
+
+        const uint32 helpers = std::min(Size(), batches - 1);
+        for (uint32 i = 0; i < helpers; ++i)
+        {
+            Enqueue([state]()
+            {
+                state->active.fetch_add(1);
+                state->Run();
+                if (state->active.fetch_sub(1) == 1)
+                    state->active.notify_all();
+            });
+        }
+
+        state->Run();
+
+        uint32 active;
+        while ((active = state->active.load()) != 0)
+            state->active.wait(active);
+    }
+}
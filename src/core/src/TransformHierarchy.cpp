@@ -0,0 +1,443 @@
+#include "TransformHierarchy.h"
+#include <algorithm>
+#include <type_traits>
+
+namespace Luna
+{
+    // four floats, one per node of a batch
+#ifdef LUNA_MATH_SSE2
+    using Lanes = __m128;
+
+    static inline Lanes Load(const float * p) noexcept { return _mm_loadu_ps(p); }
+    static inline void Store(float * p, const Lanes v) noexcept { _mm_storeu_ps(p, v); }
+    static inline Lanes Set(const float a, const float b, const float c, const float d) noexcept { return _mm_setr_ps(a, b, c, d); }
+    static inline Lanes Splat(const float a) noexcept { return _mm_set1_ps(a); }
+    static inline Lanes Add(const Lanes a, const Lanes b) noexcept { return _mm_add_ps(a, b); }
+    static inline Lanes Sub(const Lanes a, const Lanes b) noexcept { return _mm_sub_ps(a, b); }
+    static inline Lanes Mul(const Lanes a, const Lanes b) noexcept { return _mm_mul_ps(a, b); }
+    static inline void Transpose(Lanes & a, Lanes & b, Lanes & c, Lanes & d) noexcept { _MM_TRANSPOSE4_PS(a, b, c, d); }
+
+    template<int I>
+    static inline Lanes Broadcast(const Lanes a) noexcept { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(I, I, I, I)); }
+#else
+    struct Lanes { float v[4]; };
+
+    static inline Lanes Load(const float * p) noexcept { return { p[0], p[1], p[2], p[3] }; }
+    static inline void Store(float * p, const Lanes v) noexcept { for (uint32 i = 0; i < 4; ++i) p[i] = v.v[i]; }
+    static inline Lanes Set(const float a, const float b, const float c, const float d) noexcept { return { a, b, c, d }; }
+    static inline Lanes Splat(const float a) noexcept { return { a, a, a, a }; }
+
+    static inline Lanes Add(const Lanes a, const Lanes b) noexcept
+    { return { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] }; }
+
+    static inline Lanes Sub(const Lanes a, const Lanes b) noexcept
+    { return { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] }; }
+
+    static inline Lanes Mul(const Lanes a, const Lanes b) noexcept
+    { return { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] }; }
+
+    static inline void Transpose(Lanes & a, Lanes & b, Lanes & c, Lanes & d) noexcept
+    {
+        const Lanes r[4] { a, b, c, d };
+        a = { r[0].v[0], r[1].v[0], r[2].v[0], r[3].v[0] };
+        b = { r[0].v[1], r[1].v[1], r[2].v[1], r[3].v[1] };
+        c = { r[0].v[2], r[1].v[2], r[2].v[2], r[3].v[2] };
+        d = { r[0].v[3], r[1].v[3], r[2].v[3], r[3].v[3] };
+    }
+
+    template<int I>
+    static inline Lanes Broadcast(const Lanes a) noexcept { return Splat(a.v[I]); }
+#endif
+
+    static constexpr Math::Mat4 IDENTITY;
+
+    // out = parent * local for a local matrix with (0, 0, 0, 1) as last row,
+    // one output column per register and no shuffles but the broadcasts
+    static inline void MultiplyAffine(const Math::Mat4 & parent, const Math::Mat4 & local, Math::Mat4 & out) noexcept
+    {
+        const Lanes p0 = Load(&parent[0].x), p1 = Load(&parent[1].x);
+        const Lanes p2 = Load(&parent[2].x), p3 = Load(&parent[3].x);
+
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            const Lanes l = Load(&local[c].x);
+            Lanes r = Add(Add(Mul(p0, Broadcast<0>(l)), Mul(p1, Broadcast<1>(l))), Mul(p2, Broadcast<2>(l)));
+            if (c == 3)
+                r = Add(r, p3);
+            Store(&out[c].x, r);
+        }
+    }
+
+    TransformHierarchy::TransformHierarchy() noexcept
+        : levels{ 0 }, unsorted{}, dirtyCount{}, dirtyLevel{ NULL_INDEX }
+    {
+    }
+
+    Node TransformHierarchy::Create(const Node parent,
+        const Math::Vec3 & position,
+        const Math::Quat & rotation,
+        const Math::Vec3 & scale)
+    {
+        const uint32 parentIndex = Alive(parent) ? Index(parent) : NULL_INDEX;
+        const uint32 depth = (parentIndex == NULL_INDEX) ? 0 : depths[parentIndex] + 1;
+        const uint32 index = Count();
+
+        uint32 slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            indices[slot] = index;
+        }
+        else
+        {
+            slot = static_cast<uint32>(indices.size());
+            indices.push_back(index);
+            generations.push_back(0);
+        }
+
+        const Node node = (Node{generations[slot]} << 32) | slot;
+
+        positions.push_back(position);
+        rotations.push_back(rotation);
+        scales.push_back(scale);
+        locals.emplace_back();
+        worlds.emplace_back();
+        parents.push_back(parentIndex);
+        depths.push_back(depth);
+        flags.push_back(LOCAL_DIRTY);
+        nodes.push_back(node);
+        ++dirtyCount;
+        dirtyLevel = std::min(dirtyLevel, depth);
+
+        // appending to the deepest level (or opening a new one) keeps the depth order
+        if (!unsorted)
+        {
+            const uint32 deepest = Levels();
+
+            if (deepest > 0 && depth == deepest - 1)
+                ++levels.back();
+            else if (depth == deepest)
+                levels.push_back(levels.back() + 1);
+            else
+                unsorted = true;
+        }
+
+        return node;
+    }
+
+    void TransformHierarchy::Destroy(const Node node)
+    {
+        if (!Alive(node))
+            return;
+
+        if (unsorted)
+            Sort();
+
+        // descendants are always stored after their ancestors
+        const uint32 first = Index(node);
+        std::vector<uint8> dead(Count());
+        dead[first] = 1;
+
+        for (uint32 i = first + 1; i < Count(); ++i)
+            if (parents[i] != NULL_INDEX && dead[parents[i]])
+                dead[i] = 1;
+
+        std::vector<uint32> order;
+        order.reserve(Count());
+
+        for (uint32 i = 0; i < Count(); ++i)
+        {
+            if (!dead[i])
+            {
+                order.push_back(i);
+                continue;
+            }
+
+            if (flags[i])
+                --dirtyCount;
+
+            const uint32 slot = static_cast<uint32>(nodes[i]);
+            indices[slot] = NULL_INDEX;
+            ++generations[slot];
+            freeSlots.push_back(slot);
+        }
+
+        Reorder(order);
+    }
+
+    void TransformHierarchy::Clear() noexcept
+    {
+        positions.clear();
+        rotations.clear();
+        scales.clear();
+        locals.clear();
+        worlds.clear();
+        parents.clear();
+        depths.clear();
+        flags.clear();
+        nodes.clear();
+        levels.assign(1, 0);
+        unsorted = false;
+        dirtyCount = 0;
+        dirtyLevel = NULL_INDEX;
+
+        // slots are kept so handles from before the clear stay stale
+        for (uint32 slot = 0; slot < indices.size(); ++slot)
+        {
+            if (indices[slot] != NULL_INDEX)
+            {
+                indices[slot] = NULL_INDEX;
+                ++generations[slot];
+                freeSlots.push_back(slot);
+            }
+        }
+    }
+
+    void TransformHierarchy::Parent(const Node node, const Node parent)
+    {
+        if (!Alive(node) || (parent != NULL_NODE && !Alive(parent)))
+            return;
+
+        const uint32 index = Index(node);
+        const uint32 parentIndex = (parent == NULL_NODE) ? NULL_INDEX : Index(parent);
+
+        // a node can not become a child of its own subtree
+        for (uint32 i = parentIndex; i != NULL_INDEX; i = parents[i])
+            if (i == index)
+                return;
+
+        parents[index] = parentIndex;
+        unsorted = true;
+        MarkDirty(index, WORLD_DIRTY);
+    }
+
+    void TransformHierarchy::MarkDirty(const uint32 index, const uint8 flag) noexcept
+    {
+        if (!flags[index])
+            ++dirtyCount;
+
+        flags[index] |= flag;
+        dirtyLevel = std::min(dirtyLevel, depths[index]);
+    }
+
+    void TransformHierarchy::Sort()
+    {
+        const uint32 count = Count();
+
+        // recompute depths, parents may be stored after their children here
+        std::vector<uint32> chain;
+        std::fill(depths.begin(), depths.end(), NULL_INDEX);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            uint32 j = i;
+            while (j != NULL_INDEX && depths[j] == NULL_INDEX)
+            {
+                chain.push_back(j);
+                j = parents[j];
+            }
+
+            uint32 depth = (j == NULL_INDEX) ? 0 : depths[j] + 1;
+            while (!chain.empty())
+            {
+                depths[chain.back()] = depth++;
+                chain.pop_back();
+            }
+        }
+
+        // stable counting sort by depth
+        uint32 deepest = 0;
+        for (uint32 i = 0; i < count; ++i)
+            deepest = std::max(deepest, depths[i] + 1);
+
+        std::vector<uint32> offsets(deepest + 1);
+        for (uint32 i = 0; i < count; ++i)
+            ++offsets[depths[i] + 1];
+
+        for (uint32 d = 1; d <= deepest; ++d)
+            offsets[d] += offsets[d - 1];
+
+        std::vector<uint32> order(count);
+        for (uint32 i = 0; i < count; ++i)
+            order[offsets[depths[i]]++] = i;
+
+        // depths may have changed under the dirty nodes
+        if (dirtyCount)
+            dirtyLevel = 0;
+
+        Reorder(order);
+    }
+
+    void TransformHierarchy::Reorder(const std::vector<uint32> & order)
+    {
+        const uint32 count = static_cast<uint32>(order.size());
+
+        std::vector<uint32> remap(Count(), NULL_INDEX);
+        for (uint32 i = 0; i < count; ++i)
+            remap[order[i]] = i;
+
+        auto permute = [&](auto & array)
+        {
+            std::remove_reference_t<decltype(array)> sorted(count);
+            for (uint32 i = 0; i < count; ++i)
+                sorted[i] = array[order[i]];
+            array.swap(sorted);
+        };
+
+        permute(positions);
+        permute(rotations);
+        permute(scales);
+        permute(locals);
+        permute(worlds);
+        permute(parents);
+        permute(depths);
+        permute(flags);
+        permute(nodes);
+
+        levels.assign(1, 0);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (parents[i] != NULL_INDEX)
+                parents[i] = remap[parents[i]];
+
+            indices[static_cast<uint32>(nodes[i])] = i;
+
+            if (depths[i] + 1 >= levels.size())
+                levels.resize(depths[i] + 2, i);
+
+            levels.back() = i + 1;
+        }
+
+        unsorted = false;
+    }
+
+    void TransformHierarchy::UpdateRange(const uint32 begin, const uint32 end) noexcept
+    {
+        // a range never holds a node and its parent, so moved nodes can wait
+        // for a full batch as long as the flags are written right away
+        uint32 moved[BATCH_WIDTH];
+        uint32 count = 0;
+
+        for (uint32 i = begin; i < end; ++i)
+        {
+            const uint32 parent = parents[i];
+            uint8 flag = flags[i];
+
+            if (parent != NULL_INDEX && (flags[parent] & WORLD_DIRTY))
+                flag |= WORLD_DIRTY;
+
+            if (!flag)
+                continue;
+
+            flags[i] = flag | WORLD_DIRTY;
+
+            if (flag & LOCAL_DIRTY)
+            {
+                moved[count++] = i;
+                if (count == BATCH_WIDTH)
+                {
+                    UpdateBatch(moved, count);
+                    count = 0;
+                }
+            }
+            else
+            {
+                // the local matrix is unchanged, only the parent moved
+                MultiplyAffine(parent == NULL_INDEX ? IDENTITY : worlds[parent], locals[i], worlds[i]);
+            }
+        }
+
+        if (count)
+            UpdateBatch(moved, count);
+    }
+
+    void TransformHierarchy::UpdateBatch(const uint32 * batch, const uint32 count) noexcept
+    {
+        // TRS of four nodes at once, one per lane, in structure of arrays form:
+        // the quaternion to matrix expansion is most of the arithmetic of a
+        // moved node and needs no shuffles but the transposes in and out.
+        // Unused lanes repeat the first node and are stored to scratch.
+        Math::Mat4 scratch;
+        Math::Mat4 * local[BATCH_WIDTH];
+        uint32 lane[BATCH_WIDTH];
+
+        for (uint32 l = 0; l < BATCH_WIDTH; ++l)
+        {
+            lane[l] = batch[l < count ? l : 0];
+            local[l] = l < count ? &locals[lane[l]] : &scratch;
+        }
+
+        Lanes qx = Load(&rotations[lane[0]].x), qy = Load(&rotations[lane[1]].x);
+        Lanes qz = Load(&rotations[lane[2]].x), qw = Load(&rotations[lane[3]].x);
+        Transpose(qx, qy, qz, qw);
+
+        const Math::Vec3 * t[BATCH_WIDTH] { &positions[lane[0]], &positions[lane[1]], &positions[lane[2]], &positions[lane[3]] };
+        const Math::Vec3 * s[BATCH_WIDTH] { &scales[lane[0]], &scales[lane[1]], &scales[lane[2]], &scales[lane[3]] };
+
+        const Lanes sx = Set(s[0]->x, s[1]->x, s[2]->x, s[3]->x);
+        const Lanes sy = Set(s[0]->y, s[1]->y, s[2]->y, s[3]->y);
+        const Lanes sz = Set(s[0]->z, s[1]->z, s[2]->z, s[3]->z);
+
+        const Lanes one = Splat(1.0f), two = Splat(2.0f), zero = Splat(0.0f);
+        const Lanes xx = Mul(qx, qx), yy = Mul(qy, qy), zz = Mul(qz, qz);
+        const Lanes xy = Mul(qx, qy), xz = Mul(qx, qz), yz = Mul(qy, qz);
+        const Lanes wx = Mul(qw, qx), wy = Mul(qw, qy), wz = Mul(qw, qz);
+
+        // Mat4::TRS: rotation columns scaled, translation in the last column
+        Lanes columns[4][4] {
+            { Mul(Sub(one, Mul(two, Add(yy, zz))), sx), Mul(Mul(two, Add(xy, wz)), sx), Mul(Mul(two, Sub(xz, wy)), sx), zero },
+            { Mul(Mul(two, Sub(xy, wz)), sy), Mul(Sub(one, Mul(two, Add(xx, zz))), sy), Mul(Mul(two, Add(yz, wx)), sy), zero },
+            { Mul(Mul(two, Add(xz, wy)), sz), Mul(Mul(two, Sub(yz, wx)), sz), Mul(Sub(one, Mul(two, Add(xx, yy))), sz), zero },
+            { Set(t[0]->x, t[1]->x, t[2]->x, t[3]->x), Set(t[0]->y, t[1]->y, t[2]->y, t[3]->y), Set(t[0]->z, t[1]->z, t[2]->z, t[3]->z), one }
+        };
+
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            Transpose(columns[c][0], columns[c][1], columns[c][2], columns[c][3]);
+
+            for (uint32 n = 0; n < BATCH_WIDTH; ++n)
+                Store(&(*local[n])[c].x, columns[c][n]);
+        }
+
+        for (uint32 n = 0; n < count; ++n)
+        {
+            const uint32 i = batch[n];
+            MultiplyAffine(parents[i] == NULL_INDEX ? IDENTITY : worlds[parents[i]], locals[i], worlds[i]);
+        }
+    }
+
+    void TransformHierarchy::Update(ThreadPool * pool, const uint32 minParallel)
+    {
+        if (unsorted)
+            Sort();
+
+        if (dirtyCount == 0)
+            return;
+
+        // a level only reads the world matrices and flags of the level above,
+        // and nothing above the shallowest dirty node can change
+        for (uint32 d = dirtyLevel; d < Levels(); ++d)
+        {
+            const uint32 begin = levels[d];
+            const uint32 size = levels[d + 1] - begin;
+
+            if (pool && size >= minParallel)
+            {
+                pool->ParallelFor(size, 1024, [this, begin](uint32 first, uint32 last)
+                {
+                    UpdateRange(begin + first, begin + last);
+                });
+            }
+            else
+            {
+                UpdateRange(begin, begin + size);
+            }
+        }
+
+        std::fill(flags.begin() + levels[dirtyLevel], flags.end(), uint8{});
+        dirtyCount = 0;
+        dirtyLevel = NULL_INDEX;
+    }
+}
@@ -0,0 +1,458 @@
+#include "Visibility.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cfloat>
+
+namespace Luna
+{
+    // extents of removed objects and padding, never inside any plane
+    constexpr float EMPTY_EXTENT = -1e30f;
+
+    // clip space w below this is treated as crossing the near plane
+    constexpr float MIN_W = 1e-4f;
+
+    // ---------------------------------------------------
+    // Frustum
+    // ---------------------------------------------------
+
+    Frustum Frustum::FromMatrix(const Math::Mat4 & m) noexcept
+    {
+        auto row = [&m](const uint32 r)
+        {
+            return Math::Vec4((&m[0].x)[r], (&m[1].x)[r], (&m[2].x)[r], (&m[3].x)[r]);
+        };
+
+        const Math::Vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+        // clip space depth is in [0, w]
+        Frustum frustum {{ r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2 }};
+
+        for (auto & plane : frustum.planes)
+            plane = plane * (1.0f / Math::Length(plane.xyz()));
+
+        return frustum;
+    }
+
+    // ---------------------------------------------------
+    // OcclusionBuffer
+    // ---------------------------------------------------
+
+    OcclusionBuffer::OcclusionBuffer(const uint32 width, const uint32 height)
+        : width{ width }, height{ height }, depth(size_t(width) * height, FLT_MAX), triangleCount{}
+    {
+    }
+
+    void OcclusionBuffer::Clear(const Math::Mat4 & viewProj) noexcept
+    {
+        this->viewProj = viewProj;
+        std::fill(depth.begin(), depth.end(), FLT_MAX);
+        triangleCount = 0;
+    }
+
+    void OcclusionBuffer::Rasterize(const Math::Vec3 * vertices, const uint32 * indices, const uint32 indexCount) noexcept
+    {
+        const float halfWidth = 0.5f * width;
+        const float halfHeight = 0.5f * height;
+
+        for (uint32 t = 0; t + 2 < indexCount; t += 3)
+        {
+            Math::Vec3 screen[3];
+            bool clipped = false;
+
+            for (uint32 v = 0; v < 3; ++v)
+            {
+                const Math::Vec4 clip = viewProj * Math::Vec4(vertices[indices[t + v]], 1.0f);
+
+                // occluders are optional, anything crossing the near plane is skipped
+                if (clip.w < MIN_W)
+                {
+                    clipped = true;
+                    break;
+                }
+
+                const float invW = 1.0f / clip.w;
+                screen[v] = {
+                    (clip.x * invW + 1.0f) * halfWidth,
+                    (1.0f - clip.y * invW) * halfHeight,
+                    clip.z * invW };
+            }
+
+            if (clipped)
+                continue;
+
+            auto edge = [](const Math::Vec3 & a, const Math::Vec3 & b, const float x, const float y)
+            { return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x); };
+
+            float area = edge(screen[0], screen[1], screen[2].x, screen[2].y);
+            if (std::fabs(area) < 1e-6f)
+                continue;
+
+            // both windings are accepted
+            if (area < 0.0f)
+            {
+                std::swap(screen[1], screen[2]);
+                area = -area;
+            }
+
+            const int32 minX = std::max(0, int32(std::floor(std::min({ screen[0].x, screen[1].x, screen[2].x }))));
+            const int32 maxX = std::min(int32(width) - 1, int32(std::ceil(std::max({ screen[0].x, screen[1].x, screen[2].x }))));
+            const int32 minY = std::max(0, int32(std::floor(std::min({ screen[0].y, screen[1].y, screen[2].y }))));
+            const int32 maxY = std::min(int32(height) - 1, int32(std::ceil(std::max({ screen[0].y, screen[1].y, screen[2].y }))));
+
+            const float invArea = 1.0f / area;
+            ++triangleCount;
+
+            for (int32 y = minY; y <= maxY; ++y)
+            {
+                float * row = depth.data() + size_t(y) * width;
+                const float py = y + 0.5f;
+
+                for (int32 x = minX; x <= maxX; ++x)
+                {
+                    const float px = x + 0.5f;
+                    const float w0 = edge(screen[1], screen[2], px, py);
+                    const float w1 = edge(screen[2], screen[0], px, py);
+                    const float w2 = edge(screen[0], screen[1], px, py);
+
+                    if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                        continue;
+
+                    const float z = (w0 * screen[0].z + w1 * screen[1].z + w2 * screen[2].z) * invArea;
+                    row[x] = std::min(row[x], z);
+                }
+            }
+        }
+    }
+
+    void OcclusionBuffer::RasterizeBox(const Math::Vec3 & min, const Math::Vec3 & max) noexcept
+    {
+        static constexpr uint32 indices[]
+        {
+            0, 1, 3, 0, 3, 2,   4, 6, 7, 4, 7, 5,
+            0, 4, 5, 0, 5, 1,   2, 3, 7, 2, 7, 6,
+            0, 2, 6, 0, 6, 4,   1, 5, 7, 1, 7, 3
+        };
+
+        Math::Vec3 corners[8];
+        for (uint32 i = 0; i < 8; ++i)
+            corners[i] = { (i & 4) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 1) ? max.z : min.z };
+
+        Rasterize(corners, indices, 36);
+    }
+
+    bool OcclusionBuffer::Visible(const Math::Vec3 & min, const Math::Vec3 & max) const noexcept
+    {
+        float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+        float maxX = -FLT_MAX, maxY = -FLT_MAX;
+
+        // corners are the projected min corner plus the projected edges
+        const Math::Vec4 origin = viewProj * Math::Vec4(min, 1.0f);
+        const Math::Vec4 dx = viewProj[0] * (max.x - min.x);
+        const Math::Vec4 dy = viewProj[1] * (max.y - min.y);
+        const Math::Vec4 dz = viewProj[2] * (max.z - min.z);
+
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            Math::Vec4 clip = origin;
+            if (i & 4) clip = clip + dx;
+            if (i & 2) clip = clip + dy;
+            if (i & 1) clip = clip + dz;
+
+            if (clip.w < MIN_W)
+                return true;
+
+            const float invW = 1.0f / clip.w;
+            const float x = (clip.x * invW + 1.0f) * 0.5f * width;
+            const float y = (1.0f - clip.y * invW) * 0.5f * height;
+
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            minZ = std::min(minZ, clip.z * invW);
+        }
+
+        const int32 x0 = std::max(0, int32(std::floor(minX)));
+        const int32 x1 = std::min(int32(width) - 1, int32(std::floor(maxX)));
+        const int32 y0 = std::max(0, int32(std::floor(minY)));
+        const int32 y1 = std::min(int32(height) - 1, int32(std::floor(maxY)));
+
+        // nearest point of the bounds against the farthest occluder under it
+        for (int32 y = y0; y <= y1; ++y)
+        {
+            const float * row = depth.data() + size_t(y) * width;
+            for (int32 x = x0; x <= x1; ++x)
+                if (minZ <= row[x])
+                    return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------
+    // Visibility
+    // ---------------------------------------------------
+
+    Visibility::Visibility() noexcept
+        : count{}
+    {
+    }
+
+    uint32 Visibility::Slot()
+    {
+        uint32 id;
+        if (!freeSlots.empty())
+        {
+            id = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            // arrays are padded to a multiple of 8 with empty objects
+            if (count == centerX.size())
+            {
+                const size_t size = centerX.size() + 8;
+                centerX.resize(size);
+                centerY.resize(size);
+                centerZ.resize(size);
+                extentX.resize(size, EMPTY_EXTENT);
+                extentY.resize(size, EMPTY_EXTENT);
+                extentZ.resize(size, EMPTY_EXTENT);
+                radius.resize(size);
+            }
+
+            id = count++;
+        }
+
+        // the slot is in use from here on, so Box and Sphere accept it
+        extentX[id] = 0.0f;
+        return id;
+    }
+
+    uint32 Visibility::AddBox(const Math::Vec3 & min, const Math::Vec3 & max)
+    {
+        const uint32 id = Slot();
+        Box(id, min, max);
+        return id;
+    }
+
+    uint32 Visibility::AddSphere(const Math::Vec3 & center, const float r)
+    {
+        const uint32 id = Slot();
+        Sphere(id, center, r);
+        return id;
+    }
+
+    void Visibility::Box(const uint32 id, const Math::Vec3 & min, const Math::Vec3 & max) noexcept
+    {
+        // a removed slot would come back to life, and Cull would see it again
+        const bool removed = id >= count || extentX[id] == EMPTY_EXTENT;
+        assert(!removed && "Visibility object changed after Remove");
+        if (removed)
+            return;
+
+        const Math::Vec3 center = (min + max) * 0.5f;
+        const Math::Vec3 extent = (max - min) * 0.5f;
+
+        centerX[id] = center.x;
+        centerY[id] = center.y;
+        centerZ[id] = center.z;
+        extentX[id] = extent.x;
+        extentY[id] = extent.y;
+        extentZ[id] = extent.z;
+        radius[id] = 0.0f;
+    }
+
+    void Visibility::Sphere(const uint32 id, const Math::Vec3 & center, const float r) noexcept
+    {
+        // a removed slot would come back to life, and Cull would see it again
+        const bool removed = id >= count || extentX[id] == EMPTY_EXTENT;
+        assert(!removed && "Visibility object changed after Remove");
+        if (removed)
+            return;
+
+        centerX[id] = center.x;
+        centerY[id] = center.y;
+        centerZ[id] = center.z;
+        extentX[id] = extentY[id] = extentZ[id] = 0.0f;
+        radius[id] = r;
+    }
+
+    void Visibility::Remove(const uint32 id) noexcept
+    {
+        // removed slots keep EMPTY_EXTENT until Slot hands them out again,
+        // a second Remove would put the slot twice on the free list
+        const bool removed = id >= count || extentX[id] == EMPTY_EXTENT;
+        assert(!removed && "Visibility object removed twice");
+        if (removed)
+            return;
+
+        extentX[id] = extentY[id] = extentZ[id] = EMPTY_EXTENT;
+        radius[id] = 0.0f;
+        freeSlots.push_back(id);
+    }
+
+    void Visibility::Clear() noexcept
+    {
+        centerX.clear();
+        centerY.clear();
+        centerZ.clear();
+        extentX.clear();
+        extentY.clear();
+        extentZ.clear();
+        radius.clear();
+        freeSlots.clear();
+        visible.clear();
+        count = 0;
+    }
+
+    void Visibility::Camera(const Math::Mat4 & viewProj) noexcept
+    {
+        this->viewProj = viewProj;
+        occlusion.Clear(viewProj);
+    }
+
+    void Visibility::CullRange(const Frustum & frustum, const uint32 range) noexcept
+    {
+        const uint32 begin = range * RANGE_SIZE;
+        const uint32 end = std::min(begin + RANGE_SIZE, static_cast<uint32>(centerX.size()));
+
+        std::vector<uint32> & out = ranges[range];
+        out.resize(end - begin);
+
+        uint32 n = 0;
+        uint32 i = begin;
+
+        // |n|.e + r is the projected size of the bounds on the plane normal
+#if defined(LUNA_MATH_AVX2)
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+        for (; i < end; i += 8)
+        {
+            const __m256 cx = _mm256_loadu_ps(&centerX[i]);
+            const __m256 cy = _mm256_loadu_ps(&centerY[i]);
+            const __m256 cz = _mm256_loadu_ps(&centerZ[i]);
+            const __m256 ex = _mm256_loadu_ps(&extentX[i]);
+            const __m256 ey = _mm256_loadu_ps(&extentY[i]);
+            const __m256 ez = _mm256_loadu_ps(&extentZ[i]);
+            const __m256 r = _mm256_loadu_ps(&radius[i]);
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+            for (const auto & plane : frustum.planes)
+            {
+                const __m256 nx = _mm256_set1_ps(plane.x);
+                const __m256 ny = _mm256_set1_ps(plane.y);
+                const __m256 nz = _mm256_set1_ps(plane.z);
+
+                __m256 d = _mm256_fmadd_ps(nx, cx, _mm256_set1_ps(plane.w));
+                d = _mm256_fmadd_ps(ny, cy, d);
+                d = _mm256_fmadd_ps(nz, cz, d);
+                d = _mm256_add_ps(d, r);
+                d = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, nx), ex, d);
+                d = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, ny), ey, d);
+                d = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, nz), ez, d);
+
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+
+            for (uint32 bits = uint32(_mm256_movemask_ps(inside)); bits; bits &= bits - 1)
+                out[n++] = i + std::countr_zero(bits);
+        }
+#elif defined(LUNA_MATH_SSE4)
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        for (; i < end; i += 4)
+        {
+            const __m128 cx = _mm_loadu_ps(&centerX[i]);
+            const __m128 cy = _mm_loadu_ps(&centerY[i]);
+            const __m128 cz = _mm_loadu_ps(&centerZ[i]);
+            const __m128 ex = _mm_loadu_ps(&extentX[i]);
+            const __m128 ey = _mm_loadu_ps(&extentY[i]);
+            const __m128 ez = _mm_loadu_ps(&extentZ[i]);
+            const __m128 r = _mm_loadu_ps(&radius[i]);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for (const auto & plane : frustum.planes)
+            {
+                const __m128 nx = _mm_set1_ps(plane.x);
+                const __m128 ny = _mm_set1_ps(plane.y);
+                const __m128 nz = _mm_set1_ps(plane.z);
+
+                __m128 d = _mm_add_ps(_mm_mul_ps(nx, cx), _mm_set1_ps(plane.w));
+                d = _mm_add_ps(d, _mm_mul_ps(ny, cy));
+                d = _mm_add_ps(d, _mm_mul_ps(nz, cz));
+                d = _mm_add_ps(d, r);
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex));
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey));
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+            }
+
+            for (uint32 bits = uint32(_mm_movemask_ps(inside)); bits; bits &= bits - 1)
+                out[n++] = i + std::countr_zero(bits);
+        }
+#else
+        for (; i < end; ++i)
+        {
+            bool inside = true;
+
+            for (const auto & plane : frustum.planes)
+            {
+                const float d = plane.x * centerX[i] + plane.y * centerY[i] + plane.z * centerZ[i] + plane.w
+                    + std::fabs(plane.x) * extentX[i] + std::fabs(plane.y) * extentY[i] + std::fabs(plane.z) * extentZ[i]
+                    + radius[i];
+
+                inside = inside && d >= 0.0f;
+            }
+
+            if (inside)
+                out[n++] = i;
+        }
+#endif
+
+        out.resize(n);
+
+        if (occlusion.Empty())
+            return;
+
+        auto occluded = [this](const uint32 id)
+        {
+            const Math::Vec3 center { centerX[id], centerY[id], centerZ[id] };
+            const Math::Vec3 extent = Math::Vec3(extentX[id], extentY[id], extentZ[id]) + Math::Vec3(radius[id]);
+            return !occlusion.Visible(center - extent, center + extent);
+        };
+
+        out.erase(std::remove_if(out.begin(), out.end(), occluded), out.end());
+    }
+
+    void Visibility::Cull(ThreadPool * pool)
+    {
+        const Frustum frustum = Frustum::FromMatrix(viewProj);
+        const uint32 rangeCount = static_cast<uint32>((centerX.size() + RANGE_SIZE - 1) / RANGE_SIZE);
+
+        ranges.resize(rangeCount);
+
+        if (pool && rangeCount > 1)
+        {
+            pool->ParallelFor(rangeCount, 1, [this, &frustum](uint32 begin, uint32 end)
+            {
+                for (uint32 range = begin; range < end; ++range)
+                    CullRange(frustum, range);
+            });
+        }
+        else
+        {
+            for (uint32 range = 0; range < rangeCount; ++range)
+                CullRange(frustum, range);
+        }
+
+        // ranges are concatenated in order, so the list stays sorted by id
+        visible.clear();
+        for (uint32 range = 0; range < rangeCount; ++range)
+            visible.insert(visible.end(), ranges[range].begin(), ranges[range].end());
+    }
+}
@@ -0,0 +1,216 @@
+#include "World.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace Luna
+{
+    std::array<ComponentInfo, MAX_COMPONENTS> Components::infos;
+    uint32 Components::count = 0;
+
+    uint32 Components::Register(const uint32 size, const uint32 align)
+    {
+        static std::mutex mutex;
+        std::lock_guard lock(mutex);
+
+        // the id is a bit of ComponentMask and an index of Archetype::offsets
+        if (count == MAX_COMPONENTS)
+            throw std::length_error("Luna: more than MAX_COMPONENTS component types");
+
+        infos[count] = { size, align };
+        return count++;
+    }
+
+    // ---------------------------------------------------
+    // Archetype
+    // ---------------------------------------------------
+
+    Archetype::Archetype(const ComponentMask mask) noexcept
+        : mask{mask},
+        offsets{},
+        capacity{},
+        count{}
+    {
+        uint32 rowSize = sizeof(Entity);
+        for (uint32 id = 0; id < MAX_COMPONENTS; ++id)
+        {
+            if (mask & (ComponentMask{1} << id))
+            {
+                components.push_back(id);
+                rowSize += Components::Info(id).size;
+            }
+        }
+
+        // reserve the worst case alignment padding between the arrays
+        uint32 padding = 0;
+        for (const uint32 id : components)
+            padding += Components::Info(id).align;
+
+        capacity = std::max(1U, (CHUNK_SIZE - padding) / rowSize);
+
+        uint32 offset = capacity * sizeof(Entity);
+        for (const uint32 id : components)
+        {
+            const ComponentInfo & info = Components::Info(id);
+            offset = (offset + info.align - 1) & ~(info.align - 1);
+            offsets[id] = offset;
+            offset += capacity * info.size;
+        }
+    }
+
+    Archetype::~Archetype() noexcept
+    {
+        for (Chunk * chunk : chunks)
+            delete chunk;
+    }
+
+    // ---------------------------------------------------
+    // World
+    // ---------------------------------------------------
+
+    World::World() noexcept : entityCount{}
+    {
+    }
+
+    World::~World() noexcept
+    {
+    }
+
+    Archetype * World::FindArchetype(const ComponentMask mask)
+    {
+        auto found = lookup.find(mask);
+        if (found != lookup.end())
+            return found->second;
+
+        archetypes.push_back(std::make_unique<Archetype>(mask));
+        Archetype * archetype = archetypes.back().get();
+        lookup.emplace(mask, archetype);
+
+        return archetype;
+    }
+
+    uint32 World::Push(Archetype * archetype, const Entity entity)
+    {
+        const uint32 row = archetype->count;
+
+        if (row == archetype->ChunkCount() * archetype->capacity)
+            archetype->chunks.push_back(new Chunk);
+
+        archetype->count++;
+        archetype->Entities(row / archetype->capacity)[row % archetype->capacity] = entity;
+
+        return row;
+    }
+
+    void World::Erase(Archetype * archetype, const uint32 row) noexcept
+    {
+        // swap the last row into the hole so the chunks stay packed
+        const uint32 last = archetype->count - 1;
+
+        if (row != last)
+        {
+            for (const uint32 id : archetype->components)
+                std::memcpy(Component(archetype, row, id), Component(archetype, last, id), Components::Info(id).size);
+
+            const Entity moved = archetype->Entities(last / archetype->capacity)[last % archetype->capacity];
+            archetype->Entities(row / archetype->capacity)[row % archetype->capacity] = moved;
+            records[static_cast<uint32>(moved)].row = row;
+        }
+
+        archetype->count--;
+
+        // keep one spare chunk around to avoid thrashing on the boundary
+        const uint32 needed = (archetype->count + archetype->capacity - 1) / archetype->capacity;
+        while (archetype->ChunkCount() > needed + 1)
+        {
+            delete archetype->chunks.back();
+            archetype->chunks.pop_back();
+        }
+    }
+
+    void World::Move(const Entity entity, Archetype * destination)
+    {
+        Record & record = records[static_cast<uint32>(entity)];
+        Archetype * source = record.archetype;
+
+        const uint32 row = Push(destination, entity);
+
+        for (const uint32 id : destination->components)
+        {
+            if (source->mask & (ComponentMask{1} << id))
+                std::memcpy(Component(destination, row, id), Component(source, record.row, id), Components::Info(id).size);
+            else
+                std::memset(Component(destination, row, id), 0, Components::Info(id).size);
+        }
+
+        Erase(source, record.row);
+
+        record.archetype = destination;
+        record.row = row;
+    }
+
+    Entity World::Allocate(Archetype * archetype)
+    {
+        uint32 slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32>(records.size());
+            records.push_back({ nullptr, 0, 0 });
+        }
+
+        Record & record = records[slot];
+        const Entity entity = (Entity{record.generation} << 32) | slot;
+
+        record.archetype = archetype;
+        record.row = Push(archetype, entity);
+        entityCount++;
+
+        return entity;
+    }
+
+    void World::Destroy(const Entity entity) noexcept
+    {
+        if (!Alive(entity))
+            return;
+
+        const uint32 slot = static_cast<uint32>(entity);
+        Record & record = records[slot];
+
+        Erase(record.archetype, record.row);
+
+        record.archetype = nullptr;
+        record.generation++;
+        freeSlots.push_back(slot);
+        entityCount--;
+    }
+
+    void World::Clear() noexcept
+    {
+        for (uint32 slot = 0; slot < records.size(); ++slot)
+        {
+            if (records[slot].archetype)
+            {
+                records[slot].archetype = nullptr;
+                records[slot].generation++;
+                freeSlots.push_back(slot);
+            }
+        }
+
+        // archetypes stay alive so cached queries remain valid
+        for (auto & archetype : archetypes)
+        {
+            for (Chunk * chunk : archetype->chunks)
+                delete chunk;
+
+            archetype->chunks.clear();
+            archetype->count = 0;
+        }
+
+        entityCount = 0;
+    }
+}
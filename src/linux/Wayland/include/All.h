@@ -7,5 +7,24 @@
 #include "Window.h"
 #include "Input.h"
 #include "Timer.h"
+#include "Math.h"
+#include "Colors.h"
+#include "ThreadPool.h"
+#include "World.h"
+#include "Scheduler.h"
+#include "TransformHierarchy.h"
+#include "Visibility.h"
+#include "SpriteBatch.h"
+#include "Canvas.h"
+#include "Profiler.h"
+#include "AssetPack.h"
+#include "MeshProcessing.h"
+#include "TextureProcessing.h"
+#include "Font.h"
+#include "Overlay.h"
+#include "Headless.h"
+#include "Latency.h"
+#include "Streamer.h"
+#include "FileWatcher.h"
 #include "Game.h"
 #include "Engine.h"
\ No newline at end of file
@@ -1,9 +1,21 @@
 #pragma once
 
+#ifdef LUNA_VULKAN
+#include "Graphics.h"
+#include "SpriteRenderer.h"
+#endif
 #include "Window.h"
 #include "Input.h"
 #include "Timer.h"
 #include "Game.h"
+#include "Scheduler.h"
+#include "Visibility.h"
+#include "Profiler.h"
+#include "Streamer.h"
+#include "FileWatcher.h"
+#include "Overlay.h"
+#include "Headless.h"
+#include "Latency.h"
 #include "Export.h"
 
 namespace Luna
@@ -13,27 +25,56 @@ namespace Luna
     private:
         static Timer timer;
         static bool paused;
+        static bool headless;
+        static HeadlessConfig config;
 
+        void Allocate() noexcept;
         double FrameTime() noexcept;
+        void Frame();
         int32 Loop();
+        int32 HeadlessLoop();
 
         static bool quit;
         static void Quit(void *data, struct xdg_toplevel *toplevel);
         static void Display(void *data, wl_callback *callback, uint32 time);
 
     public:
+    #ifdef LUNA_VULKAN
+        static Graphics * graphics;
+        static SpriteRenderer * sprites;
+    #endif
         static Window * window;
         static Input * input;
         static Game * game;
         static double frameTime;
+        static ThreadPool * threadPool;
+        static World * world;
+        static Scheduler * scheduler;
+        static Visibility * visibility;
+        static Profiler * profiler;
+        static Streamer * streamer;
+        static FileWatcher * watcher;
+        static Overlay * overlay;
+        static LatencyProbe * latency;
         
         explicit Engine() noexcept;
+
+        // no display: Start runs the game for the configured frames without
+        // events, then writes the PerfSummary and returns 0 if it was written
+        explicit Engine(const HeadlessConfig & config) noexcept;
         ~Engine() noexcept;
 
         int32 Start(Game * const game);
 
+        // traces key presses to the screen until the samples are measured, then
+        // ends the loop and writes the report. Wayland clients cannot inject
+        // input, the presses come from the compositor's seat (a test client,
+        // a virtual keyboard or a real one) and are timed from their event time
+        void MeasureLatency(const LatencyConfig & config);
+
         static void Pause() noexcept;
         static void Resume() noexcept;
+        static bool Headless() noexcept;
     };
 
     inline void Engine::Pause() noexcept
@@ -41,4 +82,7 @@ namespace Luna
 
     inline void Engine::Resume() noexcept
     { paused = false; timer.Start(); }
+
+    inline bool Engine::Headless() noexcept
+    { return headless; }
 }
\ No newline at end of file
@@ -25,6 +25,9 @@ namespace Luna
         static int32 mouseX;
         static int32 mouseY;
         static int16 mouseWheel;
+        static uint32 events;
+        static uint32 pressTime;
+        static bool pressed;
         
         static xkb_context* context;
         static xkb_keymap* keymap;
@@ -82,6 +85,13 @@ namespace Luna
 
         void Read() noexcept;
         static const char* Text() noexcept;
+
+        // key, button, motion and wheel events since the last call
+        static uint32 Events() noexcept;
+
+        // whether a key went down since the last call, and the compositor's
+        // millisecond time of the first one
+        static bool KeyPressed(uint32 & time) noexcept;
     };
 
     inline bool Input::KeyDown(const uint32 vkcode) noexcept
@@ -98,4 +108,10 @@ namespace Luna
 
     inline const char* Input::Text() noexcept
     { return text.c_str(); }
+
+    inline uint32 Input::Events() noexcept
+    { const uint32 count = events; events = 0; return count; }
+
+    inline bool Input::KeyPressed(uint32 & time) noexcept
+    { time = pressTime; const bool down = pressed; pressed = false; return down; }
 }
\ No newline at end of file
@@ -4,8 +4,10 @@
 #include "Export.h"
 #include <wayland-client.h>
 #include <wayland-cursor.h>
+#include <ctime>
 #include "xdg-shell-client-protocol.h"
 #include "xdg-decoration-unstable-v1.h"
+#include "presentation-time-client-protocol.h"
 
 namespace Luna
 {
@@ -39,6 +41,16 @@ namespace Luna
         uint32 mode;
     };
 
+    // shared memory buffer the CPU presents through, the compositor reads it until released
+    struct PresentBuffer
+    {
+        wl_buffer * buffer;
+        uint32 * pixels;
+        uint32 width;
+        uint32 height;
+        bool busy;
+    };
+
     class DLL Window
     {
     private:
@@ -58,6 +70,8 @@ namespace Luna
         int32		                        windowCenterX;
         int32		                        windowCenterY;
 
+        PresentBuffer                       presentBuffers[2];
+
         static void (*inFocus)();
         static void (*lostFocus)();
         static void (*onClose)(void*, xdg_toplevel*);
@@ -71,6 +85,8 @@ namespace Luna
         static zxdg_decoration_manager_v1*  decoManager;
         static wl_output *                  output;
         static OutputInfo *                 monitor;
+        static wp_presentation *            presentation;
+        static uint32                       presentClock;
 
         static void OutputHandleGeometry(void *userData, wl_output *wl_output,
             int32 x, int32 y,
@@ -94,6 +110,11 @@ namespace Luna
             
         static void OutputHandleDone(void *userData, wl_output *wl_output);
 
+        static void BufferHandleRelease(void *userData, wl_buffer *wlBuffer);
+
+        static void PresentationHandleClock(void *userData, wp_presentation *presentation,
+            uint32 clock);
+
         static void RegistryHandleGlobal(
             void *userData,
             struct wl_registry *registry,
@@ -104,7 +125,8 @@ namespace Luna
         uint32 GetColor(const string hexColor) noexcept;
 
     public:
-        explicit Window() noexcept;
+        // a headless window connects to no compositor, its calls do nothing
+        explicit Window(const bool headless = false) noexcept;
         ~Window() noexcept;
 
         wl_display* Display() const noexcept;
@@ -121,6 +143,7 @@ namespace Luna
         string Title() const noexcept;
         uint32 Color() const noexcept;
         float AspectRatio() const noexcept;
+        bool Headless() const noexcept;
 
         void Icon(const string_view filename) noexcept;
         void Cursor(const string_view filename) noexcept;
@@ -132,12 +155,18 @@ namespace Luna
         void Close() noexcept;
         bool Create() noexcept;
 
+        // copies 0xAARRGGBB pixels to the window, for software rendering
+        void Present(const uint32 * pixels, const uint32 width, const uint32 height) noexcept;
+
         void InFocus(void(*func)()) noexcept;
         void LostFocus(void(*func)()) noexcept;
         void OnClose(void(*func)(void*, xdg_toplevel*)) noexcept;
         void OnDisplay(void(*func)(void*, wl_callback*, uint32)) noexcept;
 
         static xdg_toplevel_listener* XDGTopLevelListener() noexcept;
+
+        // null when the compositor has no wp_presentation or times it off CLOCK_MONOTONIC
+        static wp_presentation* Presentation() noexcept;
     };
 
     inline wl_display* Window::Display() const noexcept
@@ -179,6 +208,9 @@ namespace Luna
     inline float Window::AspectRatio() const noexcept
     { return windowWidth / float(windowHeight); }
 
+    inline bool Window::Headless() const noexcept
+    { return display == nullptr; }
+
     inline void Window::Icon(const string_view filename) noexcept
     {}
 
@@ -208,4 +240,7 @@ namespace Luna
 
     inline xdg_toplevel_listener* Window::XDGTopLevelListener() noexcept
     { return toplevelListener; }
+
+    inline wp_presentation* Window::Presentation() noexcept
+    { return presentClock == CLOCK_MONOTONIC ? presentation : nullptr; }
 }
\ No newline at end of file
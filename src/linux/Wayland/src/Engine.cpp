@@ -1,5 +1,6 @@
 #include "Engine.h"
 #include "KeyCodes.h"
+#include <algorithm>
 #include <cstdio>
 #include <cstdarg>
 #include <format>
@@ -7,11 +8,26 @@ using std::format;
 
 namespace Luna 
 {
+#ifdef LUNA_VULKAN
+    Graphics* Engine::graphics  = nullptr;
+    SpriteRenderer* Engine::sprites = nullptr;
+#endif
     Window*   Engine::window = nullptr;
     Input*    Engine::input = nullptr;
     Game*     Engine::game = nullptr;
+    ThreadPool* Engine::threadPool = nullptr;
+    World*    Engine::world = nullptr;
+    Scheduler* Engine::scheduler = nullptr;
+    Visibility* Engine::visibility = nullptr;
+    Profiler* Engine::profiler = nullptr;
+    Streamer* Engine::streamer = nullptr;
+    FileWatcher* Engine::watcher = nullptr;
+    Overlay* Engine::overlay = nullptr;
+    LatencyProbe* Engine::latency = nullptr;
     bool      Engine::quit = false;
     bool      Engine::paused = false;
+    bool      Engine::headless = false;
+    HeadlessConfig Engine::config;
     double    Engine::frameTime = {};
     Timer     Engine::timer;
 
@@ -24,13 +40,50 @@ namespace Luna
     Engine::Engine() noexcept
     {
         wl_log_set_handler_client(WaylandLogHandler);
-        window = new Window();
+        Allocate();
+    }
+
+    Engine::Engine(const HeadlessConfig & config) noexcept
+    {
+        wl_log_set_handler_client(WaylandLogHandler);
+        headless = true;
+        this->config = config;
+        Allocate();
+    }
+
+    void Engine::Allocate() noexcept
+    {
+        window = new Window(headless);
+        threadPool = new ThreadPool();
+        world = new World();
+        scheduler = new Scheduler(world, threadPool);
+        visibility = new Visibility();
+        profiler = new Profiler();
+        streamer = new Streamer(threadPool);
+        watcher = new FileWatcher();
+        overlay = new Overlay();
+    #ifdef LUNA_VULKAN
+        graphics = new Graphics();
+    #endif
     }
 
     Engine::~Engine() noexcept
     {
+        delete latency;
+        delete overlay;
+        delete watcher;
+        delete streamer;
         delete game;
+        delete profiler;
+        delete visibility;
+        delete scheduler;
+        delete world;
+        delete threadPool;
         delete input;
+    #ifdef LUNA_VULKAN
+        delete sprites;
+        delete graphics;
+    #endif
         delete window;
     }
 
@@ -38,11 +91,25 @@ namespace Luna
     {
         this->game = game;
 
-        window->Create();
+        if (!headless)
+            window->Create();
 
         input = new Input();
 
-        return Loop();
+    #ifdef LUNA_VULKAN
+        graphics->Initialize(window);
+        graphics->Profile(profiler);
+        sprites = new SpriteRenderer();
+        sprites->Initialize(graphics);
+    #endif
+
+        return headless ? HeadlessLoop() : Loop();
+    }
+
+    void Engine::MeasureLatency(const LatencyConfig & config)
+    {
+        delete latency;
+        latency = new LatencyProbe(config);
     }
 
     void Engine::Quit(void *data, xdg_toplevel *toplevel)
@@ -79,6 +146,132 @@ namespace Luna
         return frameTime;
     }
 
+    // ---------------------------------------------------
+    // Latency probe: key presses from the compositor, the frames
+    // they reach traced on screen by wp_presentation feedback
+    // ---------------------------------------------------
+
+    static void ProbePresented(void *data, wp_presentation_feedback *feedback,
+        uint32 secHi, uint32 secLo, uint32 nsec, uint32 refresh, uint32 seqHi, uint32 seqLo, uint32 flags)
+    {
+        const uint64 seconds = (uint64(secHi) << 32) | secLo;
+        static_cast<LatencyProbe*>(data)->Displayed(seconds * 1'000'000'000 + nsec);
+        wp_presentation_feedback_destroy(feedback);
+    }
+
+    static void ProbeDiscarded(void *data, wp_presentation_feedback *feedback)
+    {
+        static_cast<LatencyProbe*>(data)->Discarded();
+        wp_presentation_feedback_destroy(feedback);
+    }
+
+    static void ProbeFeedback(const Window * window, LatencyProbe * latency)
+    {
+        static const wp_presentation_feedback_listener feedbackListener = {
+            .sync_output = [](void*, wp_presentation_feedback*, wl_output*) {},
+            .presented = ProbePresented,
+            .discarded = ProbeDiscarded
+        };
+
+        // asked for before the commit it reports on
+        wp_presentation * presentation = Window::Presentation();
+        if (presentation)
+            wp_presentation_feedback_add_listener(
+                wp_presentation_feedback(presentation, window->Surface()), &feedbackListener, latency);
+    }
+
+    static void ProbeArrived(LatencyProbe * latency)
+    {
+        uint32 time = 0;
+        if (!Input::KeyPressed(time))
+            return;
+
+        // key times are milliseconds that wrap, on CLOCK_MONOTONIC in the
+        // common compositors; an age past a second means another clock
+        const uint64 now = LatencyProbe::Now();
+        const uint32 age = uint32(now / 1'000'000) - time;
+        latency->Arrived(age < 1000 ? now - uint64(age) * 1'000'000 : now, now);
+    }
+
+    void Engine::Frame()
+    {
+        profiler->BeginFrame();
+        frameTime = headless ? config.frameTime : FrameTime();
+        overlay->Frame(frameTime * 1000.0);
+        {
+            ProfileScope scope(profiler, "Streaming");
+            watcher->Update();
+            streamer->Deliver();
+        }
+        if (overlay->Visible())
+        {
+            // the game may add rows with overlay->Text until Draw
+            ProfileScope scope(profiler, "Overlay");
+        #ifdef LUNA_VULKAN
+            overlay->Texture(sprites->Atlas(overlay->Glyphs()));
+        #endif
+            overlay->Begin();
+            overlay->Graph();
+        #ifdef LUNA_VULKAN
+            overlay->Stats(profiler->Report(), graphics->Allocator()->Used());
+        #else
+            overlay->Stats(profiler->Report());
+        #endif
+        }
+        {
+            ProfileScope scope(profiler, "Update");
+            if (latency)
+                latency->Stage(LATENCY_UPDATE);
+            game->Update();
+        }
+        {
+            ProfileScope scope(profiler, "Systems");
+            scheduler->Update(frameTime);
+        }
+        {
+            ProfileScope scope(profiler, "Culling");
+            visibility->Cull(threadPool);
+        }
+        {
+            ProfileScope scope(profiler, "Draw");
+            if (latency)
+                latency->Stage(LATENCY_DRAW);
+
+        #ifdef LUNA_VULKAN
+            if (graphics->Clear())
+            {
+                if (latency)
+                    ProbeFeedback(window, latency);
+                game->Draw();
+
+                // the panel goes over the scene, its instances written straight into the sprite ring
+                if (overlay->Visible())
+                {
+                    sprites->Map(overlay->Batch());
+                    overlay->End();
+                    sprites->Atlas(overlay->Glyphs());
+                    sprites->Draw(overlay->Batch());
+                }
+
+                graphics->Present();
+                if (latency)
+                    latency->Stage(LATENCY_PRESENT);
+            }
+        #else
+            // the game presents its own canvas, overlay->Draw puts the panel on it
+            if (overlay->Visible())
+                overlay->End();
+            if (latency)
+                ProbeFeedback(window, latency);
+            game->Draw();
+            if (latency)
+                latency->Stage(LATENCY_PRESENT);
+        #endif
+        }
+        overlay->Presented();
+        profiler->EndFrame();
+    }
+
     int32 Engine::Loop()
     {
         timer.Start();
@@ -87,34 +280,72 @@ namespace Luna
         window->OnDisplay(Display);
         input->Initialize(window->Display());
 
+        // read_events blocks until the compositor sends something, a second blocking
+        // dispatch would return 0 when every event belongs to the Vulkan WSI queue
         do
         {
+            int32 dispatched = 0;
             while (wl_display_prepare_read(window->Display()) != 0)
-                wl_display_dispatch_pending(window->Display());
+                dispatched += std::max(0, wl_display_dispatch_pending(window->Display()));
             wl_display_flush(window->Display());
             wl_display_read_events(window->Display());
-            wl_display_dispatch_pending(window->Display());
+            dispatched += std::max(0, wl_display_dispatch_pending(window->Display()));
+            overlay->Event(Input::Events() > 0, uint32(dispatched));
+
+            if (latency)
+                ProbeArrived(latency);
 
             if (input->KeyPress(VK_PAUSE))
                 (paused) ? Resume() : Pause();
 
+        #ifdef LUNA_VULKAN
+            if (input->KeyPress(VK_F3))
+                overlay->Toggle();
+        #endif
+
             if (!paused)
             {
-                frameTime = FrameTime();
-                game->Update();
-                game->Draw();
+                Frame();
             }
             else
             {
                 game->OnPause();
             }
-        } while (wl_display_dispatch(window->Display()) && !quit);
+
+            if (latency && latency->Done())
+                quit = true;
+        } while (!quit && wl_display_dispatch_pending(window->Display()) != -1);
 
         game->Finalize();
 
+        if (latency)
+            latency->Write("wayland");
+
         return 0;
     }
 
+    int32 Engine::HeadlessLoop()
+    {
+        PerfSummary summary;
+        double simulated = 0.0;
+        game->Init();
+        timer.Start();
+
+        for (uint32 frames = 0;
+            (config.frames == 0 || frames < config.frames) &&
+            (config.duration <= 0.0 || simulated < config.duration);
+            ++frames)
+        {
+            Frame();
+            simulated += config.frameTime;
+            summary.Frame(timer.Reset() * 1000.0, profiler->Report());
+        }
+
+        game->Finalize();
+
+        return summary.Write(config.summary) ? 0 : 1;
+    }
+
     void Engine::Display(void *data, wl_callback *callback, uint32 time)
     {
         wl_callback_destroy(callback);
@@ -19,6 +19,9 @@ namespace Luna
     int32 Input::mouseX = 0;
     int32 Input::mouseY = 0;
     int16 Input::mouseWheel = 0;
+    uint32 Input::events = 0;
+    uint32 Input::pressTime = 0;
+    bool Input::pressed = false;
     
     xkb_state* Input::state = nullptr;
     xkb_context* Input::context = nullptr;
@@ -34,9 +37,14 @@ namespace Luna
         xkb_state_unref(state);
         xkb_keymap_unref(keymap);
         xkb_context_unref(context);
-        wl_pointer_destroy(pointer);
-        wl_keyboard_destroy(keyboard);
-        wl_seat_destroy(seat);
+
+        // none of them exist in headless runs
+        if (pointer)
+            wl_pointer_destroy(pointer);
+        if (keyboard)
+            wl_keyboard_destroy(keyboard);
+        if (seat)
+            wl_seat_destroy(seat);
     }
 
     xkb_keycode_t Input::KeysymToKeycode(const xkb_keysym_t keysym) noexcept
@@ -131,6 +139,13 @@ namespace Luna
         xkb_keysym_t sym = xkb_state_key_get_one_sym(Input::state, keycode);
 
         const bool isPressed = (state == WL_KEYBOARD_KEY_STATE_PRESSED);
+        ++events;
+
+        if (isPressed && !pressed)
+        {
+            pressTime = time;
+            pressed = true;
+        }
 
         if(read && isPressed)
             ProcessText(sym);
@@ -158,11 +173,13 @@ namespace Luna
     {
         mouseX = wl_fixed_to_int(sx);
         mouseY = wl_fixed_to_int(sy);
+        ++events;
     }
 
     void Input::HandlePointerAxis(void* userData, wl_pointer* pointer, 
         uint32 time, uint32 axis, wl_fixed_t value)
     {
+        ++events;
         if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL)
         {
             if (wl_fixed_to_int(value) > 0) mouseWheel = -1;
@@ -174,6 +191,7 @@ namespace Luna
         uint32 serial, uint32 time, uint32 button, uint32 state)
     {
         uint32 vkCode{};
+        ++events;
 
         switch (button)
         {
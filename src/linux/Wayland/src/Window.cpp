@@ -2,6 +2,7 @@
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/mman.h>
+#include <cstring>
 
 namespace Luna
 {
@@ -13,14 +14,17 @@ namespace Luna
     zxdg_decoration_manager_v1* Window::decoManager = nullptr;
     wl_output * Window::output = nullptr;
     OutputInfo * Window::monitor = nullptr;
+    wp_presentation * Window::presentation = nullptr;
+    uint32 Window::presentClock = ~0u;
 
     void (*Window::inFocus)() = nullptr;
     void (*Window::lostFocus)() = nullptr;
     void (*Window::onClose)(void*, xdg_toplevel*) = nullptr;
     void (*Window::onDisplay)(void*, wl_callback*, uint32) = nullptr;
 
-    Window::Window() noexcept
-        : registry{nullptr},
+    Window::Window(const bool headless) noexcept
+        : display{nullptr},
+        registry{nullptr},
         window{nullptr},
         xdgSurface{nullptr},
         xdgToplevel{nullptr},
@@ -28,11 +32,20 @@ namespace Luna
         windowWidth{},
         windowHeight{},
         windowPosX{},
-        windowPosY{}
+        windowPosY{},
+        presentBuffers{}
     {
-        display = wl_display_connect(nullptr);  
         windowColor = 0xFFFFFF;
         windowTitle = string("Windows Game");
+
+        if (headless)
+        {
+            windowMode = WINDOWED;
+            Size(1280, 720);
+            return;
+        }
+
+        display = wl_display_connect(nullptr);  
         windowMode = FULLSCREEN;
         windowCenterX = windowWidth / 2;
         windowCenterY = windowHeight / 2;
@@ -40,9 +53,24 @@ namespace Luna
 
     Window::~Window() noexcept
     {
+        if (!display)
+            return;
+
         if (buffer)
             wl_buffer_destroy(buffer);
+
+        for (const PresentBuffer & present : presentBuffers)
+        {
+            if (present.buffer)
+            {
+                wl_buffer_destroy(present.buffer);
+                munmap(present.pixels, size_t(present.width) * present.height * 4);
+            }
+        }
         
+        if (presentation)
+            wp_presentation_destroy(presentation);
+
         wl_output_destroy(output);    
         zxdg_toplevel_decoration_v1_destroy(decoration);
         xdg_toplevel_destroy(xdgToplevel);
@@ -266,6 +294,21 @@ namespace Luna
         {
             decoManager = reinterpret_cast<zxdg_decoration_manager_v1*>(wl_registry_bind(registry, id, &zxdg_decoration_manager_v1_interface, 1));
         }
+        else if (_interface == wp_presentation_interface.name)
+        {
+            static const wp_presentation_listener presentationListener = {
+                .clock_id = PresentationHandleClock,
+            };
+
+            presentation = reinterpret_cast<wp_presentation*>(wl_registry_bind(registry, id, &wp_presentation_interface, 1));
+            wp_presentation_add_listener(presentation, &presentationListener, nullptr);
+        }
+    }
+
+    void Window::PresentationHandleClock(void *userData, wp_presentation *presentation,
+        uint32 clock)
+    {
+        presentClock = clock;
     }
 
     wl_buffer* CreateShmBuffer(int32 width, int32 height, uint32 color, wl_shm * shm)
@@ -301,6 +344,89 @@ namespace Luna
         return buffer;
     }
 
+    void Window::BufferHandleRelease(void *userData, wl_buffer *wlBuffer)
+    {
+        static_cast<PresentBuffer*>(userData)->busy = false;
+    }
+
+    void Window::Present(const uint32 * pixels, const uint32 width, const uint32 height) noexcept
+    {
+        if (!display || width == 0 || height == 0)
+            return;
+
+        static const wl_buffer_listener bufferListener = {
+            .release = BufferHandleRelease,
+        };
+
+        // the compositor may read a buffer until it releases it, so frames
+        // alternate between two and wait only when both are still held
+        wl_display_dispatch_pending(display);
+
+        PresentBuffer * present = nullptr;
+        while (!present)
+        {
+            for (PresentBuffer & candidate : presentBuffers)
+            {
+                if (!candidate.busy)
+                {
+                    present = &candidate;
+                    break;
+                }
+            }
+
+            if (!present && wl_display_dispatch(display) < 0)
+                return;
+        }
+
+        // kept between frames and only replaced when the size changes
+        if (present->width != width || present->height != height)
+        {
+            if (present->buffer)
+            {
+                wl_buffer_destroy(present->buffer);
+                munmap(present->pixels, size_t(present->width) * present->height * 4);
+                *present = PresentBuffer{};
+            }
+
+            const size_t size = size_t(width) * height * 4;
+
+            int32 fd = syscall(SYS_memfd_create, "present", 0);
+            if (fd < 0)
+                return;
+
+            if (ftruncate(fd, size) < 0)
+            {
+                close(fd);
+                return;
+            }
+
+            void * data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                return;
+            }
+
+            wl_shm_pool * pool = wl_shm_create_pool(shm, fd, int32(size));
+            present->buffer = wl_shm_pool_create_buffer(pool, 0, width, height, width * 4, WL_SHM_FORMAT_XRGB8888);
+            present->pixels = reinterpret_cast<uint32*>(data);
+            present->width = width;
+            present->height = height;
+            wl_buffer_add_listener(present->buffer, &bufferListener, present);
+
+            wl_shm_pool_destroy(pool);
+            close(fd);
+        }
+
+        memcpy(present->pixels, pixels, size_t(width) * height * 4);
+        present->busy = true;
+
+        wl_surface_attach(window, present->buffer, 0, 0);
+        wl_surface_damage_buffer(window, 0, 0, width, height);
+        wl_surface_commit(window);
+        wl_display_flush(display);
+    }
+
     bool Window::Create() noexcept
     {
         if(!display)
@@ -1,9 +1,21 @@
 #pragma once
 
+#ifdef LUNA_VULKAN
+#include "Graphics.h"
+#include "SpriteRenderer.h"
+#endif
 #include "Window.h"
 #include "Input.h"
 #include "Timer.h"
 #include "Game.h"
+#include "Scheduler.h"
+#include "Visibility.h"
+#include "Profiler.h"
+#include "Streamer.h"
+#include "FileWatcher.h"
+#include "Overlay.h"
+#include "Headless.h"
+#include "Latency.h"
 #include "Export.h"
 
 namespace Luna
@@ -13,23 +25,50 @@ namespace Luna
     private:
         static Timer timer;
         static bool paused;
+        static bool headless;
+        static HeadlessConfig config;
 
+        void Allocate() noexcept;
         double FrameTime() noexcept;
+        void Frame();
         int32 Loop();
+        int32 HeadlessLoop();
 
     public:
+    #ifdef LUNA_VULKAN
+        static Graphics * graphics;
+        static SpriteRenderer * sprites;
+    #endif
         static Window * window;
         static Input * input;
         static Game * game;
         static double frameTime;
+        static ThreadPool * threadPool;
+        static World * world;
+        static Scheduler * scheduler;
+        static Visibility * visibility;
+        static Profiler * profiler;
+        static Streamer * streamer;
+        static FileWatcher * watcher;
+        static Overlay * overlay;
+        static LatencyProbe * latency;
         
         explicit Engine() noexcept;
+
+        // no display: Start runs the game for the configured frames without
+        // events, then writes the PerfSummary and returns 0 if it was written
+        explicit Engine(const HeadlessConfig & config) noexcept;
         ~Engine() noexcept;
 
         int32 Start(Game * const game);
 
+        // injects tagged key presses with XTest until the samples are measured,
+        // then ends the loop and writes the report; needs the XTest extension
+        void MeasureLatency(const LatencyConfig & config);
+
         static void Pause() noexcept;
         static void Resume() noexcept;
+        static bool Headless() noexcept;
 
         static void EngineProc(xcb_generic_event_t * const event);
     };
@@ -39,4 +78,7 @@ namespace Luna
 
     inline void Engine::Resume() noexcept
     { paused = false; timer.Start(); }
+
+    inline bool Engine::Headless() noexcept
+    { return headless; }
 }
\ No newline at end of file
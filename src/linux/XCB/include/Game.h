@@ -1,7 +1,17 @@
 #pragma once
 
+#ifdef LUNA_VULKAN
+#include "Graphics.h"
+#include "SpriteRenderer.h"
+#endif
 #include "Window.h"
 #include "Input.h"
+#include "Scheduler.h"
+#include "Visibility.h"
+#include "Profiler.h"
+#include "Streamer.h"
+#include "FileWatcher.h"
+#include "Overlay.h"
 #include "Export.h"
 #include <unistd.h>
 
@@ -10,9 +20,21 @@ namespace Luna
     class DLL Game
     {
     protected:
+    #ifdef LUNA_VULKAN
+        static Graphics *& graphics;
+        static SpriteRenderer *& sprites;
+    #endif
         static Window*   & window;
         static Input*    & input;
         static double    & frameTime;
+        static ThreadPool* & threadPool;
+        static World*    & world;
+        static Scheduler*& scheduler;
+        static Visibility*& visibility;
+        static Profiler*& profiler;
+        static Streamer*& streamer;
+        static FileWatcher*& watcher;
+        static Overlay*& overlay;
         
     public:
         explicit Game() noexcept;
@@ -31,6 +31,7 @@ namespace Luna
 
         xcb_atom_t        wmDeleteWindow;
         xcb_atom_t        wmProtocols;
+        xcb_gcontext_t    presentContext;
 
         static void (*inFocus)();
         static void (*lostFocus)();
@@ -38,7 +39,8 @@ namespace Luna
         uint32 GetColor(const string && hexColor) noexcept;
         
     public:
-        explicit Window() noexcept;
+        // a headless window opens no display, its calls do nothing
+        explicit Window(const bool headless = false) noexcept;
         ~Window() noexcept;
 
         xcb_connection_t* Connection() const noexcept;
@@ -52,6 +54,7 @@ namespace Luna
         string Title() const noexcept;
         xcb_colormap_t Color() const noexcept;
         float AspectRatio() const noexcept;
+        bool Headless() const noexcept;
 
         void Icon(const string_view filename) noexcept;
         void Cursor(const string_view filename) noexcept;
@@ -64,6 +67,9 @@ namespace Luna
         void Close() noexcept;
         bool Create() noexcept;
 
+        // copies 0xAARRGGBB pixels to the window, for software rendering
+        void Present(const uint32 * pixels, const uint32 width, const uint32 height) noexcept;
+
         void InFocus(void(*func)()) noexcept;
         void LostFocus(void(*func)()) noexcept;
 
@@ -103,11 +109,14 @@ namespace Luna
     inline float Window::AspectRatio() const noexcept
     { return windowWidth / float(windowHeight); }
 
+    inline bool Window::Headless() const noexcept
+    { return windowConnection == nullptr; }
+
     inline void Window::Icon(const string_view filename) noexcept
     { windowIcon = filename; }
 
     inline void Window::Cursor(const string_view filename) noexcept
-    { windowCursor = XcursorFilenameLoadCursor(windowDisplay, filename.data()); }
+    { if (windowDisplay) windowCursor = XcursorFilenameLoadCursor(windowDisplay, filename.data()); }
 
     inline void Window::Title(const string_view title) noexcept
     { windowTitle = title; }
@@ -119,7 +128,7 @@ namespace Luna
     { windowColor = GetColor(color.data()); }
     
     inline void Window::HideCursor(const bool hide) const noexcept
-    { hide ? xcb_xfixes_hide_cursor(windowConnection, windowHandle) : xcb_xfixes_show_cursor(windowConnection, windowHandle); }
+    { if (windowConnection) hide ? xcb_xfixes_hide_cursor(windowConnection, windowHandle) : xcb_xfixes_show_cursor(windowConnection, windowHandle); }
 
     inline void Window::InFocus(void(*func)()) noexcept
     { inFocus = func; }
@@ -1,26 +1,82 @@
 #include "Engine.h"
 #include "KeyCodes.h"
+#include <xcb/xtest.h>
+#include <xcb/xcb_keysyms.h>
+#ifdef LUNA_XCB_PRESENT
+#include <xcb/present.h>
+#endif
 #include <format>
 using std::format;
 
 namespace Luna
 {
+#ifdef LUNA_VULKAN
+    Graphics* Engine::graphics  = nullptr;
+    SpriteRenderer* Engine::sprites = nullptr;
+#endif
     Window*   Engine::window = nullptr;
     Input*    Engine::input = nullptr;
     Game*     Engine::game = nullptr;
+    ThreadPool* Engine::threadPool = nullptr;
+    World*    Engine::world = nullptr;
+    Scheduler* Engine::scheduler = nullptr;
+    Visibility* Engine::visibility = nullptr;
+    Profiler* Engine::profiler = nullptr;
+    Streamer* Engine::streamer = nullptr;
+    FileWatcher* Engine::watcher = nullptr;
+    Overlay* Engine::overlay = nullptr;
+    LatencyProbe* Engine::latency = nullptr;
     double    Engine::frameTime = {};
     bool      Engine::paused = false;
+    bool      Engine::headless = false;
+    HeadlessConfig Engine::config;
     Timer     Engine::timer;
 
     Engine::Engine() noexcept
     {
-        window = new Window();
+        Allocate();
+    }
+
+    Engine::Engine(const HeadlessConfig & config) noexcept
+    {
+        headless = true;
+        this->config = config;
+        Allocate();
+    }
+
+    void Engine::Allocate() noexcept
+    {
+        window = new Window(headless);
+        threadPool = new ThreadPool();
+        world = new World();
+        scheduler = new Scheduler(world, threadPool);
+        visibility = new Visibility();
+        profiler = new Profiler();
+        streamer = new Streamer(threadPool);
+        watcher = new FileWatcher();
+        overlay = new Overlay();
+    #ifdef LUNA_VULKAN
+        graphics = new Graphics();
+    #endif
     }
 
     Engine::~Engine() noexcept
     {
+        delete latency;
+        delete overlay;
+        delete watcher;
+        delete streamer;
         delete game;
+        delete profiler;
+        delete visibility;
+        delete scheduler;
+        delete world;
+        delete threadPool;
         delete input;
+    #ifdef LUNA_VULKAN
+        delete sprites;
+        delete graphics;
+    #endif
         delete window;
     }
 
@@ -28,11 +84,25 @@ namespace Luna
     {
         this->game = game;
 
-        window->Create();
+        if (!headless)
+            window->Create();
 
         input = new Input();
 
-        return Loop();
+    #ifdef LUNA_VULKAN
+        graphics->Initialize(window);
+        graphics->Profile(profiler);
+        sprites = new SpriteRenderer();
+        sprites->Initialize(graphics);
+    #endif
+
+        return headless ? HeadlessLoop() : Loop();
+    }
+
+    void Engine::MeasureLatency(const LatencyConfig & config)
+    {
+        delete latency;
+        latency = new LatencyProbe(config);
     }
 
     double Engine::FrameTime() noexcept
@@ -81,6 +151,172 @@ namespace Luna
         return (message->data.data32[0] == wmDeleteWindow) ? true : false;
     }
 
+    // ---------------------------------------------------
+    // Latency probe: F20 presses sent through XTest, the frames
+    // they reach traced on screen by Present CompleteNotify events
+    // ---------------------------------------------------
+
+    static xcb_keycode_t probeKey = 0;
+    static uint8 presentOpcode = 0;
+
+    static void BeginProbe(const Window * window)
+    {
+        xcb_connection_t * connection = window->Connection();
+
+        const xcb_query_extension_reply_t * xtest = xcb_get_extension_data(connection, &xcb_test_id);
+        if (xtest && xtest->present)
+        {
+            xcb_key_symbols_t * symbols = xcb_key_symbols_alloc(connection);
+            for (const xcb_keysym_t keysym : { xcb_keysym_t(VK_F20), xcb_keysym_t(XKB_KEY_Scroll_Lock) })
+            {
+                xcb_keycode_t * keycodes = xcb_key_symbols_get_keycode(symbols, keysym);
+                if (keycodes)
+                {
+                    probeKey = keycodes[0];
+                    free(keycodes);
+                }
+                if (probeKey)
+                    break;
+            }
+            xcb_key_symbols_free(symbols);
+        }
+
+    #ifdef LUNA_XCB_PRESENT
+        const xcb_query_extension_reply_t * present = xcb_get_extension_data(connection, &xcb_present_id);
+        if (present && present->present)
+        {
+            free(xcb_present_query_version_reply(connection,
+                xcb_present_query_version(connection, XCB_PRESENT_MAJOR_VERSION, XCB_PRESENT_MINOR_VERSION), nullptr));
+
+            presentOpcode = present->major_opcode;
+            xcb_present_select_input(connection, xcb_generate_id(connection), window->Id(),
+                XCB_PRESENT_EVENT_MASK_COMPLETE_NOTIFY);
+        }
+    #endif
+    }
+
+    static void InjectProbe(const Window * window, LatencyProbe * latency)
+    {
+        if (!probeKey)
+            return;
+
+        xcb_connection_t * connection = window->Connection();
+
+        // XTest sends keys to the focus, which can only move to a mapped window
+        xcb_get_window_attributes_reply_t * attributes = xcb_get_window_attributes_reply(connection,
+            xcb_get_window_attributes(connection, window->Id()), nullptr);
+        const bool viewable = attributes && attributes->map_state == XCB_MAP_STATE_VIEWABLE;
+        free(attributes);
+
+        if (!viewable)
+            return;
+
+        xcb_set_input_focus(connection, XCB_INPUT_FOCUS_PARENT, window->Id(), XCB_CURRENT_TIME);
+
+        latency->Sent();
+        xcb_test_fake_input(connection, XCB_KEY_PRESS, probeKey, XCB_CURRENT_TIME, XCB_NONE, 0, 0, 0);
+        xcb_test_fake_input(connection, XCB_KEY_RELEASE, probeKey, XCB_CURRENT_TIME, XCB_NONE, 0, 0, 0);
+        xcb_flush(connection);
+    }
+
+    // true for the presentation events, which are not for the game
+    static bool ProbePresent(const xcb_generic_event_t * event, LatencyProbe * latency)
+    {
+    #ifdef LUNA_XCB_PRESENT
+        if ((event->response_type & 0x7f) != XCB_GE_GENERIC
+            || reinterpret_cast<const xcb_ge_generic_event_t*>(event)->extension != presentOpcode)
+            return false;
+
+        const auto * complete = reinterpret_cast<const xcb_present_complete_notify_event_t*>(event);
+        if (complete->event_type == XCB_PRESENT_COMPLETE_NOTIFY && complete->kind == XCB_PRESENT_COMPLETE_KIND_PIXMAP)
+        {
+            if (complete->mode == XCB_PRESENT_COMPLETE_MODE_SKIP)
+                latency->Discarded();
+            else
+                latency->Displayed(complete->ust * 1000);
+        }
+
+        return true;
+    #else
+        return false;
+    #endif
+    }
+
+    void Engine::Frame()
+    {
+        profiler->BeginFrame();
+        frameTime = headless ? config.frameTime : FrameTime();
+        overlay->Frame(frameTime * 1000.0);
+        {
+            ProfileScope scope(profiler, "Streaming");
+            watcher->Update();
+            streamer->Deliver();
+        }
+        if (overlay->Visible())
+        {
+            // the game may add rows with overlay->Text until Draw
+            ProfileScope scope(profiler, "Overlay");
+        #ifdef LUNA_VULKAN
+            overlay->Texture(sprites->Atlas(overlay->Glyphs()));
+        #endif
+            overlay->Begin();
+            overlay->Graph();
+        #ifdef LUNA_VULKAN
+            overlay->Stats(profiler->Report(), graphics->Allocator()->Used());
+        #else
+            overlay->Stats(profiler->Report());
+        #endif
+        }
+        {
+            ProfileScope scope(profiler, "Update");
+            if (latency)
+                latency->Stage(LATENCY_UPDATE);
+            game->Update();
+        }
+        {
+            ProfileScope scope(profiler, "Systems");
+            scheduler->Update(frameTime);
+        }
+        {
+            ProfileScope scope(profiler, "Culling");
+            visibility->Cull(threadPool);
+        }
+        {
+            ProfileScope scope(profiler, "Draw");
+            if (latency)
+                latency->Stage(LATENCY_DRAW);
+
+        #ifdef LUNA_VULKAN
+            if (graphics->Clear())
+            {
+                game->Draw();
+
+                // the panel goes over the scene, its instances written straight into the sprite ring
+                if (overlay->Visible())
+                {
+                    sprites->Map(overlay->Batch());
+                    overlay->End();
+                    sprites->Atlas(overlay->Glyphs());
+                    sprites->Draw(overlay->Batch());
+                }
+
+                graphics->Present();
+                if (latency)
+                    latency->Stage(LATENCY_PRESENT);
+            }
+        #else
+            // the game presents its own canvas, overlay->Draw puts the panel on it
+            if (overlay->Visible())
+                overlay->End();
+            game->Draw();
+            if (latency)
+                latency->Stage(LATENCY_PRESENT);
+        #endif
+        }
+        overlay->Presented();
+        profiler->EndFrame();
+    }
+
     int32 Engine::Loop()
     {
         timer.Start();
@@ -89,15 +325,35 @@ namespace Luna
         xcb_generic_event_t * event = nullptr;
         input->Initialize(window->Connection(), window->Id(), event);
 
+        if (latency)
+            BeginProbe(window);
+
         bool quit = false;
         do
         {
+            if (latency && latency->Due())
+                InjectProbe(window, latency);
+
             while ((event = xcb_poll_for_event(window->Connection())) != nullptr)
             {
+                if (latency && ProbePresent(event, latency))
+                {
+                    free(event);
+                    continue;
+                }
+
                 if (Quit(event, window->WMDeleteWindow()))
                     quit = true;
 
+                const uint8 type = event->response_type & 0x7f;
+                overlay->Event(type >= XCB_KEY_PRESS && type <= XCB_MOTION_NOTIFY);
+
                 EngineProc(event);
+
+                if (latency && type == XCB_KEY_PRESS
+                    && reinterpret_cast<const xcb_key_press_event_t*>(event)->detail == probeKey)
+                    latency->Received();
+
                 free(event);
 
                 if(quit)
@@ -107,22 +363,54 @@ namespace Luna
             if (input->XKeyPress(VK_PAUSE))
                 (paused) ? Resume() : Pause();
 
+        #ifdef LUNA_VULKAN
+            if (input->XKeyPress(VK_F3))
+                overlay->Toggle();
+        #endif
+
             if (!paused)
             {
-                frameTime = FrameTime();
-                game->Update();
-                game->Draw();
+                Frame();
             }
             else
             {
                 game->OnPause();
             }
+
+            if (latency && latency->Done())
+                quit = true;
         } while (!quit);
 
         game->Finalize();
+
+        if (latency)
+            latency->Write("xcb");
+
         return 0;
     }
 
+    int32 Engine::HeadlessLoop()
+    {
+        PerfSummary summary;
+        double simulated = 0.0;
+        game->Init();
+        timer.Start();
+
+        for (uint32 frames = 0;
+            (config.frames == 0 || frames < config.frames) &&
+            (config.duration <= 0.0 || simulated < config.duration);
+            ++frames)
+        {
+            Frame();
+            simulated += config.frameTime;
+            summary.Frame(timer.Reset() * 1000.0, profiler->Report());
+        }
+
+        game->Finalize();
+
+        return summary.Write(config.summary) ? 0 : 1;
+    }
+
     void Engine::EngineProc(xcb_generic_event_t * const event)
     {
         if (event->response_type == XCB_EXPOSE)
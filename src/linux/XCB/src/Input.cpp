@@ -31,11 +31,17 @@ namespace Luna
         xkb_state_unref(state);
         xkb_keymap_unref(keymap);
         xkb_context_unref(context);
-        xcb_key_symbols_free(keysyms);
+
+        if (keysyms)
+            xcb_key_symbols_free(keysyms);
     }
 
     xkb_keycode_t Input::KeysymToKeycode(const xkb_keysym_t keysym) const noexcept
     {
+        // never initialized in headless runs, no key is ever down
+        if (!keymap)
+            return 0;
+
         for (xcb_keycode_t kc = xkb_keymap_min_keycode(keymap); kc <= xkb_keymap_max_keycode(keymap); ++kc)
         {
             xcb_keysym_t key = xcb_key_symbols_get_keysym(keysyms, kc, 0);
@@ -97,6 +103,9 @@ namespace Luna
     void Input::Read() noexcept
     {
         text.clear();
+        if (!connection)
+            return;
+
         Input::Reader(event);
     }
 
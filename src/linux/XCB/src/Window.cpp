@@ -3,17 +3,33 @@
 #include <xcb/xcb_icccm.h>
 #include <unistd.h>
 #include <png.h>
+#include <algorithm>
 
 namespace Luna
 {
     void (*Window::inFocus)() = nullptr;
     void (*Window::lostFocus)() = nullptr;
 
-    Window::Window() noexcept 
-        : windowHandle{}, 
+    Window::Window(const bool headless) noexcept 
+        : windowDisplay{},
+        windowConnection{},
+        windowHandle{}, 
+        windowScreen{},
+        windowCursor{},
+        windowColor{},
         windowPosX{}, 
-        windowPosY{}
+        windowPosY{},
+        presentContext{}
     {
+        windowTitle = string("Window Game");
+
+        if (headless)
+        {
+            windowMode = WINDOWED;
+            Size(1280, 720);
+            return;
+        }
+
         windowDisplay = XOpenDisplay(nullptr);
         windowConnection = XGetXCBConnection(windowDisplay);
         windowCursor = XcursorFilenameLoadCursor(windowDisplay, "left_ptr");
@@ -22,7 +38,6 @@ namespace Luna
         windowWidth = windowScreen->width_in_pixels;
         windowHeight = windowScreen->height_in_pixels;
         windowColor = windowScreen->white_pixel;
-        windowTitle = string("Window Game");
         windowMode = FULLSCREEN;
         windowCenterX = windowWidth / 2;
         windowCenterY = windowHeight / 2;
@@ -32,6 +47,12 @@ namespace Luna
 
     Window::~Window() noexcept
     {
+        if (!windowConnection)
+            return;
+
+        if (presentContext)
+            xcb_free_gc(windowConnection, presentContext);
+
         xcb_unmap_window(windowConnection, windowHandle);
         xcb_destroy_window(windowConnection, windowHandle);
         xcb_disconnect(windowConnection);
@@ -40,6 +61,10 @@ namespace Luna
     uint32 Window::GetColor(const string && hexColor) noexcept
     {
         const uint32 rgb = stoul(hexColor.substr(1), nullptr, 16);
+
+        // the offscreen target of a headless run still clears to the window color
+        if (!windowConnection)
+            return rgb;
     
         uint16 r = ((rgb >> 16) & 0xFF) * 0x0101;
         uint16 g = ((rgb >> 8) & 0xFF) * 0x0101;
@@ -65,12 +90,18 @@ namespace Luna
         windowCenterX = windowWidth / 2;
         windowCenterY = windowHeight / 2;
 
-        windowPosX = (windowScreen->width_in_pixels - windowWidth) / 2;
-        windowPosY = (windowScreen->height_in_pixels - windowHeight) / 2;
+        if (windowScreen)
+        {
+            windowPosX = (windowScreen->width_in_pixels - windowWidth) / 2;
+            windowPosY = (windowScreen->height_in_pixels - windowHeight) / 2;
+        }
     }
 
     void Window::Close() noexcept
     {
+        if (!windowConnection)
+            return;
+
         xcb_client_message_event_t event{};
         event.response_type = XCB_CLIENT_MESSAGE;
         event.format = 32;
@@ -308,7 +339,7 @@ namespace Luna
 
     bool Window::Create() noexcept
     {
-        if(xcb_connection_has_error(windowConnection))
+        if(!windowConnection || xcb_connection_has_error(windowConnection))
             return false;
 
         xcb_create_window_value_list_t attributes{};
@@ -380,6 +411,43 @@ namespace Luna
         return true;
     }
 
+    void Window::Present(const uint32 * pixels, const uint32 width, const uint32 height) noexcept
+    {
+        if (!windowConnection)
+            return;
+
+        if (!presentContext)
+        {
+            presentContext = xcb_generate_id(windowConnection);
+            xcb_create_gc(windowConnection, presentContext, windowHandle, 0, nullptr);
+        }
+
+        // large images are split in bands that fit in a single request
+        const uint32 stride = width * 4;
+        const uint32 maxBytes = xcb_get_maximum_request_length(windowConnection) * 4 - sizeof(xcb_put_image_request_t);
+        const uint32 bandRows = std::max(1u, maxBytes / stride);
+
+        for (uint32 y = 0; y < height; y += bandRows)
+        {
+            const uint32 rows = std::min(bandRows, height - y);
+
+            xcb_put_image(
+                windowConnection,
+                XCB_IMAGE_FORMAT_Z_PIXMAP,
+                windowHandle,
+                presentContext,
+                static_cast<uint16>(width), static_cast<uint16>(rows),
+                0, static_cast<int16>(y),
+                0,
+                windowScreen->root_depth,
+                rows * stride,
+                reinterpret_cast<const uint8*>(pixels + size_t(y) * width)
+            );
+        }
+
+        xcb_flush(windowConnection);
+    }
+
     void Window::WinProc(const xcb_generic_event_t * const event)
     {
         switch(event->response_type & 0x7f)
@@ -46,11 +46,12 @@ namespace Luna
         static void InputProc(const XEvent * const event);
     };
 
+    // without a display (headless runs) no key is ever down
     inline bool Input::KeyDown(const uint32 vkcode) const noexcept
-    { return keys[XKeysymToKeycode(display, vkcode)]; }
+    { return display && keys[XKeysymToKeycode(display, vkcode)]; }
 
     inline bool Input::KeyUp(const uint32 vkcode) const noexcept
-    { return !(keys[XKeysymToKeycode(display, vkcode)]); }
+    { return !KeyDown(vkcode); }
 
     inline int32 Input::MouseX() const noexcept
     { return mouseX; }
@@ -5,6 +5,7 @@
 #include <X11/Xlib.h>
 #include <X11/Xcursor/Xcursor.h>
 #include <X11/extensions/Xfixes.h>
+#include <vector>
 
 namespace Luna
 {
@@ -40,7 +41,8 @@ namespace Luna
         uint32 GetColor(const char * color) noexcept;
         
     public:
-        explicit Window() noexcept;
+        // a headless window opens no display, its calls do nothing
+        explicit Window(const bool headless = false) noexcept;
         ~Window() noexcept;
 
         Display* XDisplay() const noexcept;
@@ -54,6 +56,7 @@ namespace Luna
         string Title() const noexcept;
         XColor Color() const noexcept;
         float AspectRatio() const noexcept;
+        bool Headless() const noexcept;
 
         void Icon(const string_view filename) noexcept;
         void Cursor(const string_view filename) noexcept;
@@ -62,16 +65,25 @@ namespace Luna
         void Mode(const uint32 mode) noexcept;
         void Color(const string_view hex) noexcept;
 
+        // replaces the title the window manager shows, Title() stays the same
+        void Caption(const string_view text) const noexcept;
+
         void HideCursor(const bool hide) const noexcept;
         void Close() noexcept;
         bool Create() noexcept;
 
+        // copies 0xAARRGGBB pixels to the window, for software rendering
+        void Present(const uint32 * pixels, const uint32 width, const uint32 height) const noexcept;
+
         void InFocus(void(*func)()) noexcept;
         void LostFocus(void(*func)()) noexcept;
 
         static void WinProc(const XEvent * const event);
     };
 
+    // PNG file in the _NET_WM_ICON layout: width, height, then 0xAARRGGBB pixels, one per long
+    DLL bool DecodeIcon(const string_view filename, std::vector<unsigned long> & icon);
+
     inline Display* Window::XDisplay() const noexcept
     { return windowDisplay; }
 
@@ -105,11 +117,14 @@ namespace Luna
     inline float Window::AspectRatio() const noexcept
     { return windowWidth / float(windowHeight); }
 
+    inline bool Window::Headless() const noexcept
+    { return windowDisplay == nullptr; }
+
     inline void Window::Icon(const string_view filename) noexcept
     { windowIcon = filename; }
 
     inline void Window::Cursor(const string_view filename) noexcept
-    { windowCursor = XcursorFilenameLoadCursor(windowDisplay, filename.data()); }
+    { if (windowDisplay) windowCursor = XcursorFilenameLoadCursor(windowDisplay, filename.data()); }
 
     inline void Window::Title(const string_view title) noexcept
     { windowTitle = title; }
@@ -121,7 +136,7 @@ namespace Luna
     { windowColor.pixel = GetColor(hex.data()); }
     
     inline void Window::HideCursor(const bool hide) const noexcept
-    { hide ? XFixesHideCursor(windowDisplay, windowHandle) : XFixesShowCursor(windowDisplay, windowHandle); }
+    { if (windowDisplay) hide ? XFixesHideCursor(windowDisplay, windowHandle) : XFixesShowCursor(windowDisplay, windowHandle); }
 
     inline void Window::InFocus(void(*func)()) noexcept
     { inFocus = func; }
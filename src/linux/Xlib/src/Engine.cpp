@@ -1,27 +1,81 @@
 #include "Engine.h"
 #include "KeyCodes.h"
-#include <X11/Xatom.h>
+#include <X11/extensions/XTest.h>
+#ifdef LUNA_XPRESENT
+#include <X11/extensions/Xpresent.h>
+#endif
 #include <format>
 using std::format;
 
 namespace Luna
 {
+#ifdef LUNA_VULKAN
+    Graphics* Engine::graphics  = nullptr;
+    SpriteRenderer* Engine::sprites = nullptr;
+#endif
     Window*   Engine::window = nullptr;
     Input*    Engine::input = nullptr;
     Game*     Engine::game = nullptr;
+    ThreadPool* Engine::threadPool = nullptr;
+    World*    Engine::world = nullptr;
+    Scheduler* Engine::scheduler = nullptr;
+    Visibility* Engine::visibility = nullptr;
+    Profiler* Engine::profiler = nullptr;
+    Streamer* Engine::streamer = nullptr;
+    FileWatcher* Engine::watcher = nullptr;
+    Overlay* Engine::overlay = nullptr;
+    LatencyProbe* Engine::latency = nullptr;
     double    Engine::frameTime = {};
     bool      Engine::paused = false;
+    bool      Engine::headless = false;
+    HeadlessConfig Engine::config;
     Timer     Engine::timer;
 
     Engine::Engine() noexcept
     {
-        window = new Window();
+        Allocate();
+    }
+
+    Engine::Engine(const HeadlessConfig & config) noexcept
+    {
+        headless = true;
+        this->config = config;
+        Allocate();
+    }
+
+    void Engine::Allocate() noexcept
+    {
+        window = new Window(headless);
+        threadPool = new ThreadPool();
+        world = new World();
+        scheduler = new Scheduler(world, threadPool);
+        visibility = new Visibility();
+        profiler = new Profiler();
+        streamer = new Streamer(threadPool);
+        watcher = new FileWatcher();
+        overlay = new Overlay();
+    #ifdef LUNA_VULKAN
+        graphics = new Graphics();
+    #endif
     }
 
     Engine::~Engine() noexcept
     {
+        delete latency;
+        delete overlay;
+        delete watcher;
+        delete streamer;
         delete game;
+        delete profiler;
+        delete visibility;
+        delete scheduler;
+        delete world;
+        delete threadPool;
         delete input;
+    #ifdef LUNA_VULKAN
+        delete sprites;
+        delete graphics;
+    #endif
         delete window;
     }
 
@@ -29,11 +83,25 @@ namespace Luna
     {
         this->game = game;
 
-        window->Create();
+        if (!headless)
+            window->Create();
 
         input = new Input();
 
-        return Loop();
+    #ifdef LUNA_VULKAN
+        graphics->Initialize(window);
+        graphics->Profile(profiler);
+        sprites = new SpriteRenderer();
+        sprites->Initialize(graphics);
+    #endif
+
+        return headless ? HeadlessLoop() : Loop();
+    }
+
+    void Engine::MeasureLatency(const LatencyConfig & config)
+    {
+        delete latency;
+        latency = new LatencyProbe(config);
     }
 
     double Engine::FrameTime() noexcept
@@ -55,30 +123,7 @@ namespace Luna
             string title = format("{}    FPS: {}    Frame Time: {:.3f} (ms)",
                 window->Title().c_str(), frameCount, frameTime * 1000);
 
-            static Atom _NET_WM_NAME = XInternAtom(window->XDisplay(), "_NET_WM_NAME", false);
-            static Atom UTF8_STRING = XInternAtom(window->XDisplay(), "UTF8_STRING", false);
-
-            XChangeProperty(
-                window->XDisplay(),
-                window->Id(),
-                _NET_WM_NAME,
-                UTF8_STRING,
-                8,
-                PropModeReplace,
-                reinterpret_cast<const uint8*>(title.c_str()),
-                static_cast<int32>(title.size())
-            );
-
-            XChangeProperty(
-                window->XDisplay(),
-                window->Id(),
-                XA_WM_NAME,
-                XA_STRING,
-                8,
-                PropModeReplace,
-                reinterpret_cast<const uint8*>(title.c_str()),
-                static_cast<int32>(title.size())
-            );
+            window->Caption(title);
 
             frameCount = 0;
             totalTime -= 1.0;
@@ -96,6 +141,154 @@ namespace Luna
         return false;
     }
 
+    // ---------------------------------------------------
+    // Latency probe: F20 presses sent through XTest, the frames
+    // they reach traced on screen by Present CompleteNotify events
+    // ---------------------------------------------------
+
+    static KeyCode probeKey = 0;
+    static int32 presentOpcode = -1;
+
+    static void BeginProbe(const Window * window)
+    {
+        Display * display = window->XDisplay();
+
+        int32 eventBase, errorBase, major, minor;
+        if (XTestQueryExtension(display, &eventBase, &errorBase, &major, &minor))
+        {
+            probeKey = XKeysymToKeycode(display, VK_F20);
+            if (!probeKey)
+                probeKey = XKeysymToKeycode(display, XK_Scroll_Lock);
+        }
+
+    #ifdef LUNA_XPRESENT
+        if (XPresentQueryExtension(display, &presentOpcode, &eventBase, &errorBase))
+            XPresentSelectInput(display, window->Id(), PresentCompleteNotifyMask);
+    #endif
+    }
+
+    static void InjectProbe(const Window * window, LatencyProbe * latency)
+    {
+        if (!probeKey)
+            return;
+
+        Display * display = window->XDisplay();
+
+        // XTest sends keys to the focus, which can only move to a mapped window
+        XWindowAttributes attributes{};
+        XGetWindowAttributes(display, window->Id(), &attributes);
+        if (attributes.map_state != IsViewable)
+            return;
+
+        XSetInputFocus(display, window->Id(), RevertToParent, CurrentTime);
+
+        latency->Sent();
+        XTestFakeKeyEvent(display, probeKey, True, CurrentTime);
+        XTestFakeKeyEvent(display, probeKey, False, CurrentTime);
+        XFlush(display);
+    }
+
+    // true for the presentation events, which are not for the game
+    static bool ProbePresent(const Window * window, XEvent * event, LatencyProbe * latency)
+    {
+    #ifdef LUNA_XPRESENT
+        if (event->type != GenericEvent || event->xcookie.extension != presentOpcode)
+            return false;
+
+        if (XGetEventData(window->XDisplay(), &event->xcookie))
+        {
+            const auto * complete = static_cast<const XPresentCompleteNotifyEvent*>(event->xcookie.data);
+            if (event->xcookie.evtype == PresentCompleteNotify && complete->kind == PresentCompleteKindPixmap)
+            {
+                if (complete->mode == PresentCompleteModeSkip)
+                    latency->Discarded();
+                else
+                    latency->Displayed(complete->ust * 1000);
+            }
+            XFreeEventData(window->XDisplay(), &event->xcookie);
+        }
+
+        return true;
+    #else
+        return false;
+    #endif
+    }
+
+    void Engine::Frame()
+    {
+        profiler->BeginFrame();
+        frameTime = headless ? config.frameTime : FrameTime();
+        overlay->Frame(frameTime * 1000.0);
+        {
+            ProfileScope scope(profiler, "Streaming");
+            watcher->Update();
+            streamer->Deliver();
+        }
+        if (overlay->Visible())
+        {
+            // the game may add rows with overlay->Text until Draw
+            ProfileScope scope(profiler, "Overlay");
+        #ifdef LUNA_VULKAN
+            overlay->Texture(sprites->Atlas(overlay->Glyphs()));
+        #endif
+            overlay->Begin();
+            overlay->Graph();
+        #ifdef LUNA_VULKAN
+            overlay->Stats(profiler->Report(), graphics->Allocator()->Used());
+        #else
+            overlay->Stats(profiler->Report());
+        #endif
+        }
+        {
+            ProfileScope scope(profiler, "Update");
+            if (latency)
+                latency->Stage(LATENCY_UPDATE);
+            game->Update();
+        }
+        {
+            ProfileScope scope(profiler, "Systems");
+            scheduler->Update(frameTime);
+        }
+        {
+            ProfileScope scope(profiler, "Culling");
+            visibility->Cull(threadPool);
+        }
+        {
+            ProfileScope scope(profiler, "Draw");
+            if (latency)
+                latency->Stage(LATENCY_DRAW);
+
+        #ifdef LUNA_VULKAN
+            if (graphics->Clear())
+            {
+                game->Draw();
+
+                // the panel goes over the scene, its instances written straight into the sprite ring
+                if (overlay->Visible())
+                {
+                    sprites->Map(overlay->Batch());
+                    overlay->End();
+                    sprites->Atlas(overlay->Glyphs());
+                    sprites->Draw(overlay->Batch());
+                }
+
+                graphics->Present();
+                if (latency)
+                    latency->Stage(LATENCY_PRESENT);
+            }
+        #else
+            // the game presents its own canvas, overlay->Draw puts the panel on it
+            if (overlay->Visible())
+                overlay->End();
+            game->Draw();
+            if (latency)
+                latency->Stage(LATENCY_PRESENT);
+        #endif
+        }
+        overlay->Presented();
+        profiler->EndFrame();
+    }
+
     int32 Engine::Loop()
     {
         timer.Start();
@@ -103,34 +296,82 @@ namespace Luna
         game->Init();
         input->Initialize(window->XDisplay(), window->Id(), &event);
 
+        bool closing = false;
+        if (latency)
+            BeginProbe(window);
+
         do
         {
+            if (latency && latency->Due())
+                InjectProbe(window, latency);
+
             while (XPending(window->XDisplay()))
             {
                 XNextEvent(window->XDisplay(), &event);
+                if (latency && ProbePresent(window, &event, latency))
+                    continue;
+
+                overlay->Event(event.type >= KeyPress && event.type <= MotionNotify);
                 EngineProc(&event);
+
+                if (latency && event.type == KeyPress && event.xkey.keycode == probeKey)
+                    latency->Received();
             }
             
             if (input->XKeyPress(VK_PAUSE))
                 (paused) ? Resume() : Pause();
+
+        #ifdef LUNA_VULKAN
+            if (input->XKeyPress(VK_F3))
+                overlay->Toggle();
+        #endif
             
             if (!paused)
             {
-                frameTime = FrameTime();
-                game->Update();
-                game->Draw();
+                Frame();
             }
             else
             {
                 game->OnPause();
             }
+
+            if (latency && latency->Done() && !closing)
+            {
+                window->Close();
+                closing = true;
+            }
         } while (!Quit(&event, window->WMDeleteWindow()));
 
         game->Finalize();
 
+        if (latency)
+            latency->Write("xlib");
+
         return 0;
     }
 
+    int32 Engine::HeadlessLoop()
+    {
+        PerfSummary summary;
+        double simulated = 0.0;
+        game->Init();
+        timer.Start();
+
+        for (uint32 frames = 0;
+            (config.frames == 0 || frames < config.frames) &&
+            (config.duration <= 0.0 || simulated < config.duration);
+            ++frames)
+        {
+            Frame();
+            simulated += config.frameTime;
+            summary.Frame(timer.Reset() * 1000.0, profiler->Report());
+        }
+
+        game->Finalize();
+
+        return summary.Write(config.summary) ? 0 : 1;
+    }
+
     void Engine::EngineProc(const XEvent * const event)
     {
         if (event->type == Expose)
@@ -21,10 +21,11 @@ namespace Luna
 
     Input::~Input() noexcept
     {
-        XUnsetICFocus(xic);
-
         if (xic)
+        {
+            XUnsetICFocus(xic);
             XDestroyIC(xic);
+        }
 
         if (xim)
 		    XCloseIM(xim);
@@ -54,6 +55,9 @@ namespace Luna
 
     bool Input::XKeyPress(const uint32 vkcode) noexcept
     {
+        if (!display)
+            return false;
+
         auto keycode = XKeysymToKeycode(display, vkcode);
 
         if (ctrl[keycode])
@@ -75,6 +79,9 @@ namespace Luna
     void Input::Read() noexcept
     {
         text.clear();
+        if (!display)
+            return;
+
         Input::Reader(event);
     }
 
@@ -1,5 +1,6 @@
 #include "Window.h"
 #include <unistd.h>
+#include <cstdlib>
 #include <X11/Xutil.h>
 #include <X11/cursorfont.h>
 #include <X11/Xatom.h>
@@ -10,12 +11,25 @@ namespace Luna
     void (*Window::inFocus)() = nullptr;
     void (*Window::lostFocus)() = nullptr;
 
-    Window::Window() noexcept
-        : windowHandle{},
+    Window::Window(const bool headless) noexcept
+        : windowDisplay{},
+        windowHandle{},
+        windowScreen{},
         windowPosX{},
         windowPosY{},
-        windowIcon{}
+        windowIcon{},
+        windowCursor{},
+        windowColor{}
     {
+        windowTitle = string("Windows Game");
+
+        if (headless)
+        {
+            windowMode = WINDOWED;
+            Size(1280, 720);
+            return;
+        }
+
         XInitThreads();
 
         windowDisplay = XOpenDisplay(nullptr);
@@ -24,7 +38,6 @@ namespace Luna
         windowHeight = windowScreen->height;
         windowCursor = XCreateFontCursor(windowDisplay, XC_left_ptr);
         windowColor.pixel = WhitePixel(windowDisplay, DefaultScreen(windowDisplay));
-        windowTitle = string("Windows Game");
         windowMode = FULLSCREEN;
         windowCenterX = windowWidth / 2;
         windowCenterY = windowHeight / 2;
@@ -32,6 +45,9 @@ namespace Luna
 
     Window::~Window() noexcept
     {
+        if (!windowDisplay)
+            return;
+
         XFreeColors(windowDisplay, DefaultColormap(windowDisplay, DefaultScreen(windowDisplay)), &windowColor.pixel, 1, 0);
         XFreeCursor(windowDisplay, windowCursor);
         XUnmapWindow(windowDisplay, windowHandle);
@@ -41,6 +57,10 @@ namespace Luna
 
     uint32 Window::GetColor(const char * color) noexcept
     {
+        // the offscreen target of a headless run still clears to the window color
+        if (!windowDisplay)
+            return color[0] == '#' ? uint32(strtoul(color + 1, nullptr, 16)) : 0;
+
         XColor hex{};
         XParseColor(windowDisplay, DefaultColormap(windowDisplay, 0), color, &hex);
         XAllocColor(windowDisplay, DefaultColormap(windowDisplay, 0), &hex);
@@ -55,8 +75,11 @@ namespace Luna
         windowCenterX = windowWidth / 2;
         windowCenterY = windowHeight / 2;
 
-        windowPosX = (windowScreen->width - windowWidth) / 2;
-        windowPosY = (windowScreen->height - windowHeight) / 2;
+        if (windowScreen)
+        {
+            windowPosX = (windowScreen->width - windowWidth) / 2;
+            windowPosY = (windowScreen->height - windowHeight) / 2;
+        }
     }
 
     static void SendEventToWM(Display * display, XWindow window, Atom type,
@@ -93,8 +116,41 @@ namespace Luna
         );
     }
 
+    void Window::Present(const uint32 * pixels, const uint32 width, const uint32 height) const noexcept
+    {
+        if (!windowDisplay)
+            return;
+
+        XImage * image = XCreateImage(
+            windowDisplay,
+            DefaultVisual(windowDisplay, DefaultScreen(windowDisplay)),
+            24,
+            ZPixmap,
+            0,
+            reinterpret_cast<char*>(const_cast<uint32*>(pixels)),
+            width,
+            height,
+            32,
+            0
+        );
+
+        if (!image)
+            return;
+
+        XPutImage(windowDisplay, windowHandle, DefaultGC(windowDisplay, DefaultScreen(windowDisplay)),
+            image, 0, 0, 0, 0, width, height);
+
+        // the pixels belong to the caller
+        image->data = nullptr;
+        XDestroyImage(image);
+        XFlush(windowDisplay);
+    }
+
     void Window::Close() noexcept
     {
+        if (!windowDisplay)
+            return;
+
         SendEventToWM(
             windowDisplay,
             windowHandle,
@@ -105,33 +161,45 @@ namespace Luna
         );
     }
 
-    static bool LoadPNG(const string_view filename, uint8 ** imageData, int32 & width, int32 & height)
+    void Window::Caption(const string_view text) const noexcept
     {
-        FILE *fp = fopen(filename.data(), "rb");
-        if (!fp)
-            return false;
+        if (!windowDisplay)
+            return;
 
-        png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-        if (!png)
-        {
-            fclose(fp);
-            return false;
-        }
+        static Atom _NET_WM_NAME = XInternAtom(windowDisplay, "_NET_WM_NAME", false);
+        static Atom UTF8_STRING = XInternAtom(windowDisplay, "UTF8_STRING", false);
 
-        png_infop info = png_create_info_struct(png);
-        if (!info)
-        {
-            png_destroy_read_struct(&png, nullptr, nullptr);
-            fclose(fp);
-            return false;
-        }
+        XChangeProperty(
+            windowDisplay,
+            windowHandle,
+            _NET_WM_NAME,
+            UTF8_STRING,
+            8,
+            PropModeReplace,
+            reinterpret_cast<const uint8*>(text.data()),
+            static_cast<int32>(text.size())
+        );
+
+        XChangeProperty(
+            windowDisplay,
+            windowHandle,
+            XA_WM_NAME,
+            XA_STRING,
+            8,
+            PropModeReplace,
+            reinterpret_cast<const uint8*>(text.data()),
+            static_cast<int32>(text.size())
+        );
+    }
 
+    // libpng reports errors with a longjmp to the last setjmp, which skips
+    // destructors: the functions that set one only hold trivial locals, and
+    // the pixels are allocated by LoadPNG between the two
+    static bool ReadPNGInfo(png_structp png, png_infop info, FILE * fp,
+        int32 & width, int32 & height, size_t & rowBytes, int32 & passes)
+    {
         if (setjmp(png_jmpbuf(png)))
-        {
-            png_destroy_read_struct(&png, &info, nullptr);
-            fclose(fp);
             return false;
-        }
 
         png_init_io(png, fp);
         png_read_info(png, info);
@@ -153,56 +221,111 @@ namespace Luna
         if (bitDepth == 16)
             png_set_strip_16(png);
 
+        // always 4 bytes per pixel, RGBA
+        if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+            png_set_gray_to_rgb(png);
+
+        if (!(colorType & PNG_COLOR_MASK_ALPHA))
+            png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+
         png_set_expand(png);
+        passes = png_set_interlace_handling(png);
         png_read_update_info(png, info);
 
-        *imageData = new uint8[png_get_rowbytes(png, info) * height];
-        png_bytep* rowPointers = new png_bytep[height];
-        for (size_t y = 0; y < height; ++y)
-            rowPointers[y] = *imageData + y * png_get_rowbytes(png, info);
+        rowBytes = png_get_rowbytes(png, info);
+        return true;
+    }
+
+    static bool ReadPNGRows(png_structp png, uint8 * pixels, const int32 height, const size_t rowBytes, const int32 passes)
+    {
+        if (setjmp(png_jmpbuf(png)))
+            return false;
+
+        for (int32 pass = 0; pass < passes; ++pass)
+            for (int32 y = 0; y < height; ++y)
+                png_read_row(png, pixels + y * rowBytes, nullptr);
+
+        return true;
+    }
+
+    static bool LoadPNG(const string_view filename, std::vector<uint8> & image, int32 & width, int32 & height)
+    {
+        FILE *fp = fopen(filename.data(), "rb");
+        if (!fp)
+            return false;
+
+        png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+        if (!png)
+        {
+            fclose(fp);
+            return false;
+        }
+
+        png_infop info = png_create_info_struct(png);
+        if (!info)
+        {
+            png_destroy_read_struct(&png, nullptr, nullptr);
+            fclose(fp);
+            return false;
+        }
+
+        size_t rowBytes{};
+        int32 passes{};
+        bool loaded = ReadPNGInfo(png, info, fp, width, height, rowBytes, passes);
+        if (loaded)
+        {
+            image.resize(rowBytes * height);
+            loaded = ReadPNGRows(png, image.data(), height, rowBytes, passes);
+        }
 
-        png_read_image(png, rowPointers);
         png_destroy_read_struct(&png, &info, nullptr);
-        delete[] rowPointers;
         fclose(fp);
 
-        return true;
+        return loaded;
     }
 
-    static void SetIcon(Display * display, XWindow window, const string_view filename)
+    bool DecodeIcon(const string_view filename, std::vector<unsigned long> & icon)
     {
+        std::vector<uint8> image;
         int32 width, height;
-        uint8 * dataImage;
-        LoadPNG(filename.data(), &dataImage, width, height);
-
-        int32 longCount = 2 + width * height;
+        if (!LoadPNG(filename, image, width, height))
+            return false;
 
-        uint64* icon = new uint64[longCount * sizeof(uint64)];
-        uint64* target = icon;
+        const size_t pixelCount = size_t(width) * size_t(height);
+        icon.resize(2 + pixelCount);
+        icon[0] = width;
+        icon[1] = height;
 
-        *target++ = width;
-        *target++ = height;
+        const uint8 * source = image.data();
+        unsigned long * target = icon.data() + 2;
 
-        for (size_t i = 0; i < width * height; ++i)
+        for (size_t i = 0; i < pixelCount; ++i, source += 4)
         {
-            *target++ =
-            ((dataImage[i * 4 + 2])) |
-            ((dataImage[i * 4 + 1]) << 8) |
-            ((dataImage[i * 4 + 0]) << 16) |
-            ((dataImage[i * 4 + 3]) << 24);
+            target[i] =
+                uint32(source[2]) |
+                uint32(source[1]) << 8 |
+                uint32(source[0]) << 16 |
+                uint32(source[3]) << 24;
         }
 
+        return true;
+    }
+
+    static void SetIcon(Display * display, XWindow window, const string_view filename)
+    {
+        std::vector<unsigned long> icon;
+        if (!DecodeIcon(filename, icon))
+            return;
+
         Atom _NET_WM_ICON = XInternAtom(display, "_NET_WM_ICON", false);
         X11ChangeProperty(
             display,
             window,
             _NET_WM_ICON,
             XA_CARDINAL,
-            reinterpret_cast<uint8*>(icon),
-            longCount
+            reinterpret_cast<uint8*>(icon.data()),
+            int32(icon.size())
         );
-
-        delete[] icon;
     }
 
     static void Fullscreen(Display *display, XWindow window)
@@ -0,0 +1,21 @@
+# shaders the graphics library draws with, compiled to SPIR-V arrays in
+# headers it includes, so the engine needs no shader files at run time
+find_program(GLSLANG_VALIDATOR glslangValidator HINTS $ENV{VULKAN_SDK}/bin $ENV{VULKAN_SDK}/Bin)
+if(NOT GLSLANG_VALIDATOR)
+    message(FATAL_ERROR "glslangValidator not found, install glslang-tools or the Vulkan SDK.")
+endif()
+
+set(SHADER_HEADER_DIR ${CMAKE_CURRENT_BINARY_DIR}/shaders)
+
+foreach(SHADER Sprite.vert Sprite.frag)
+    # Sprite.vert becomes the array Sprite_vert in Sprite.vert.h
+    string(REPLACE "." "_" SHADER_ARRAY ${SHADER})
+    set(SHADER_HEADER ${SHADER_HEADER_DIR}/${SHADER}.h)
+    add_custom_command(OUTPUT ${SHADER_HEADER}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${SHADER_HEADER_DIR}
+        COMMAND ${GLSLANG_VALIDATOR} -V --vn ${SHADER_ARRAY} -o ${SHADER_HEADER} ${VULKAN_SHARED_DIR}/shaders/${SHADER}
+        DEPENDS ${VULKAN_SHARED_DIR}/shaders/${SHADER}
+        COMMENT "Compiling GLSL to SPIR-V: ${SHADER}"
+        VERBATIM)
+    list(APPEND SOURCE_FILES ${SHADER_HEADER})
+endforeach()
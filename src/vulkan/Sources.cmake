@@ -0,0 +1,12 @@
+# sources of the graphics library, the same on every platform, the
+# platform CMakeLists only add the surface define and link options
+set(SOURCE_FILES ${VULKAN_SHARED_DIR}/src/Mesh.cpp
+    ${VULKAN_SHARED_DIR}/src/Texture.cpp
+    ${VULKAN_SHARED_DIR}/src/MemoryAllocator.cpp
+    ${VULKAN_SHARED_DIR}/src/DescriptorHeap.cpp
+    ${VULKAN_SHARED_DIR}/src/RenderGraph.cpp
+    ${VULKAN_SHARED_DIR}/src/SpriteRenderer.cpp
+    ${VULKAN_SHARED_DIR}/src/VkError.cpp
+    ${VULKAN_SHARED_DIR}/src/Logger.cpp
+    ${VULKAN_SHARED_DIR}/src/ValidationLayer.cpp
+    ${VULKAN_SHARED_DIR}/src/Graphics.cpp)
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace Luna
+{
+    enum HeapBindings : uint32
+    {
+        HEAP_TEXTURES,                      // combined image samplers
+        HEAP_BUFFERS,                       // storage buffers
+        HEAP_BINDINGS
+    };
+
+    struct HeapIndex
+    {
+        uint32 binding;
+        uint32 index;
+        uint64 frame;                       // frame from which the index may be reused
+    };
+
+    // One descriptor set with an array per binding, written once per resource and
+    // bound once per command buffer. Shaders index the arrays with values passed
+    // in push constants, so draws never allocate or bind descriptor sets.
+    class DLL DescriptorHeap
+    {
+    private:
+        VkDevice                    device;
+        VkDescriptorSetLayout       layout;
+        VkDescriptorPool            pool;
+        VkDescriptorSet             set;
+        uint32                      capacity[HEAP_BINDINGS];
+        uint32                      count[HEAP_BINDINGS];       // indices handed out so far
+        std::vector<uint32>         freeIndices[HEAP_BINDINGS];
+        std::vector<HeapIndex>      removed;
+
+        uint32 NextIndex(const uint32 binding);
+
+    public:
+        explicit DescriptorHeap() noexcept;
+        ~DescriptorHeap() noexcept;
+
+        // without descriptor indexing the layout is empty and nothing can be added
+        void Initialize(VkPhysicalDevice physicalDevice, VkDevice device, const bool supported);
+
+        uint32 AddTexture(VkImageView view, VkSampler sampler,
+            const VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        uint32 AddBuffer(VkBuffer buffer,
+            const VkDeviceSize offset = 0,
+            const VkDeviceSize range = VK_WHOLE_SIZE);
+
+        // the index is reused once frame is reached, after the GPU stopped reading it
+        void Remove(const uint32 binding, const uint32 index, const uint64 frame);
+        void Recycle(const uint64 frame);
+
+        VkDescriptorSetLayout Layout() const noexcept;
+        VkDescriptorSet Set() const noexcept;
+        uint32 Capacity(const uint32 binding) const noexcept;
+    };
+
+    inline VkDescriptorSetLayout DescriptorHeap::Layout() const noexcept
+    { return layout; }
+
+    inline VkDescriptorSet DescriptorHeap::Set() const noexcept
+    { return set; }
+
+    inline uint32 DescriptorHeap::Capacity(const uint32 binding) const noexcept
+    { return capacity[binding]; }
+}
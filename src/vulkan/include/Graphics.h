@@ -0,0 +1,400 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Window.h"
+#include "Logger.h"
+#include "ValidationLayer.h"
+#include "Mesh.h"
+#include "MeshProcessing.h"
+#include "Texture.h"
+#include "TextureProcessing.h"
+#include "MemoryAllocator.h"
+#include "DescriptorHeap.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <vector>
+
+namespace Luna
+{
+    struct SwapchainBuffer
+    {
+        VkImage image;
+        VkImageView view;
+        VkFramebuffer framebuffer;
+        VkSemaphore renderFinished;
+        VkFence fence;                  // fence of the last frame that rendered to the image
+    };
+
+    // swapchain replaced by a resize, kept until the frames recorded before it are done
+    struct RetiredSwapchain
+    {
+        VkSwapchainKHR swapchain;
+        SwapchainBuffer * buffers;
+        uint32 count;
+        uint64 frame;                   // first frame recorded on the new swapchain
+    };
+
+    // pipeline replaced by a hot reload
+    struct RetiredPipeline
+    {
+        VkPipeline pipeline;
+        uint64 frame;                   // first frame that no longer waits on it
+    };
+
+    // staged copy to a texture, in the layout the image is in before the copy
+    struct ImageUpload
+    {
+        VkImage image;
+        uint32 levelCount;
+        VkImageLayout layout;
+    };
+
+    constexpr uint32 MAX_GPU_SCOPES = 64;
+    constexpr uint32 MAX_PUSH_CONSTANTS = 128;    // bytes every device supports
+
+    // piece of the frame's uniform ring, written by the CPU until the frame is presented
+    struct UniformAllocation
+    {
+        uint8 * data;
+        uint32 offset;                  // dynamic offset for BindResources
+    };
+
+    class RenderGraph;
+
+    // secondary command buffers of one recording thread, reused when its pool is reset
+    struct CommandRecorder
+    {
+        VkCommandPool commandPool;
+        std::vector<VkCommandBuffer> commandBuffers;
+        uint32 used;
+    };
+
+    // resources owned by one of the frames the CPU records while the GPU renders the others
+    struct FrameResources
+    {
+        VkCommandPool commandPool;
+        VkCommandBuffer commandBuffer;
+        VkCommandBuffer uploadCommandBuffer;
+        VkSemaphore imageAvailable;
+        VkFence fence;
+        VkDeviceSize stagingEnd;        // staging ring position released when the fence signals
+        VkQueryPool queryPool;          // frame begin and end, then a pair per GPU scope
+        uint32 queryCount;              // written this frame, read back when the fence signals
+        uint64 profileFrame;
+        uint32 scopeCount;
+        uint32 scopes[MAX_GPU_SCOPES];  // profiler entry of each scope
+        std::vector<CommandRecorder> recorders;     // one per ThreadPool::ThreadIndex
+    };
+
+    class DLL Graphics
+    {
+    private:
+        // config
+        uint32                       backBufferCount;
+        uint32                       frameCount;
+        bool                         vSync;
+        VkClearColorValue            bgColor;
+
+        // pipeline
+        VkInstance                   instance;
+        VkPhysicalDevice             physicalDevice;
+        VkDevice                     device;
+        uint32                       queueFamilyIndex;
+
+        VkSurfaceKHR                 surface;
+        VkSwapchainKHR               swapchain;
+        SwapchainBuffer            * buffers;
+        uint32                       backBufferIndex;
+        VkSurfaceFormatKHR           surfaceFormat;
+        VkPresentModeKHR             presentMode;
+        VkExtent2D                   requestedExtent;
+        bool                         lowLatency;
+        bool                         swapchainDirty;
+        uint64                       frameNumber;
+        std::vector<RetiredSwapchain> retiredSwapchains;
+        std::vector<RetiredPipeline> retiredPipelines;
+
+        VkCommandPool                commandPool;
+        VkCommandBuffer              copyCommandBuffer;
+
+        FrameResources             * frames;
+        uint32                       frameIndex;
+
+        VkRenderPass                 renderPass;
+        VkRenderPass                 renderPassLoad;    // compatible pass that keeps the contents
+        bool                         renderGraphSupport;
+        std::vector<VkCommandBuffer> secondaries;
+
+        // pipelines
+        VkPipelineCache              pipelineCache;
+        string                       pipelineCachePath;
+
+        // staging ring, offsets only grow and wrap around stagingSize
+        VkDeviceSize                 stagingSize;
+        VkBuffer                     stagingBuffer;
+        Allocation                   stagingAllocation;
+        uint8                      * stagingData;
+        VkDeviceSize                 stagingHead;
+        VkDeviceSize                 stagingTail;
+        VkFence                      copyFence;
+        std::vector<VkBuffer>        uploadTargets;
+        std::vector<VkBufferCopy>    uploadRegions;
+        std::vector<ImageUpload>     imageUploads;
+        std::vector<VkBufferImageCopy> imageRegions;
+
+        // bindless resources at set 0 and the uniform ring at set 1 of pipelineLayout
+        DescriptorHeap             * descriptorHeap;
+        bool                         bindlessSupport;
+        VkPipelineLayout             pipelineLayout;
+        VkDeviceSize                 uniformSize;       // per frame
+        VkDeviceSize                 uniformRange;      // visible from each dynamic offset
+        VkDeviceSize                 uniformAlignment;
+        VkDeviceSize                 uniformHead;
+        VkBuffer                     uniformBuffer;
+        Allocation                   uniformAllocation;
+        VkDescriptorSetLayout        uniformLayout;
+        VkDescriptorPool             uniformPool;
+        VkDescriptorSet              uniformSet;
+
+        // GPU timestamps
+        Profiler                   * profiler;
+        uint32                       timestampBits;
+        float                        timestampPeriod;   // nanoseconds per tick
+        std::vector<uint64>          timestamps;
+
+        // synchronization
+        VkQueue                      queue;
+
+        void LogHardwareInfo() const;
+        void CreateSurface(const Window * const window);
+
+        bool CreateSwapchain();
+        void DestroySwapchain(const RetiredSwapchain & retired);
+        void ReleaseSwapchains();
+        void ReleasePipelines();
+        void BeginRenderPass(VkRenderPass pass, const VkSubpassContents contents);
+
+        VkDeviceSize Reserve(const VkDeviceSize size);
+        void RecordUploads(VkCommandBuffer commandBuffer);
+        void FlushUploads();
+
+        void CreateTexture(Texture* texture, const VkFormat format,
+            const uint32 width, const uint32 height, const uint32 levelCount);
+        void StageRows(Texture* texture, const uint32 level, const uint8* rows, const VkDeviceSize rowSize,
+            const uint32 firstRow, const uint32 rowCount, const uint32 blockSize, const bool created);
+
+        void ReadTimestamps(FrameResources & frame);
+
+        void LoadPipelineCache();
+        void SavePipelineCache() const;
+
+        ValidationLayer * validationLayer;
+        MemoryAllocator * allocator;
+
+    public:
+        static Logger logger;
+
+        VkViewport                   viewport;
+        VkRect2D                     scissorRect;
+
+        explicit Graphics() noexcept;
+        ~Graphics() noexcept;
+
+        // both take effect on the next frame, recreating the swapchain
+        void VSync(const bool state) noexcept;
+        void LowLatency(const bool state) noexcept;
+
+        // for surfaces that take their size from the swapchain, as on Wayland
+        void Resize(const uint32 width, const uint32 height) noexcept;
+
+        void FramesInFlight(const uint32 count) noexcept;
+        void StagingSize(const VkDeviceSize size) noexcept;
+        void UniformSize(const VkDeviceSize size) noexcept;
+        void PipelineCachePath(const string_view path);
+        void Initialize(const Window * const window);
+
+        // false while the window has no area to render to, skip drawing and Present then
+        bool Clear();
+        void Present();
+
+        // GPU times reach the profiler reports when the frame fence signals,
+        // FramesInFlight frames later, call after Initialize
+        void Profile(Profiler * profiler) noexcept;
+        uint32 BeginScope(const char * name);
+        void EndScope(const uint32 scope);
+
+        // records count items in chunks of grain on the thread pool, each chunk into a
+        // secondary command buffer that continues the frame's render pass; the chunks
+        // execute in order and record must be safe to call from several threads
+        void Record(ThreadPool * threadPool,
+            const uint32 count,
+            const uint32 grain,
+            const std::function<void(VkCommandBuffer commandBuffer, uint32 begin, uint32 end)> & record);
+
+        // shaders reach textures and buffers through the heap with indices that stay
+        // valid until removed, a removed index is reused once no frame in flight reads it
+        uint32 AddTexture(VkImageView view, VkSampler sampler);
+        uint32 AddBuffer(VkBuffer buffer, const VkDeviceSize offset = 0, const VkDeviceSize range = VK_WHOLE_SIZE);
+        void RemoveTexture(const uint32 index);
+        void RemoveBuffer(const uint32 index);
+
+        // linear allocation from the frame's slice of the uniform ring, released by Clear
+        UniformAllocation Uniform(const VkDeviceSize size);
+
+        // binds the heap and the uniform ring at uniformOffset, once per command buffer or
+        // when the offset changes; draws only push their indices with vkCmdPushConstants
+        void BindResources(VkCommandBuffer commandBuffer,
+            const uint32 uniformOffset,
+            const VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
+
+        // runs the graph's passes between Clear and Present, outside the frame's render pass
+        void Execute(RenderGraph & graph);
+        
+        void Allocate(const VkDeviceSize size,
+            const VkBufferUsageFlags usageFlags,
+            const VkMemoryPropertyFlags properties,
+            VkBuffer* buffer,
+            Allocation* allocation);
+
+        void Allocate(const VkImageCreateInfo& imageInfo,
+            const VkMemoryPropertyFlags properties,
+            VkImage* image,
+            Allocation* allocation);
+
+        void Free(VkBuffer buffer, Allocation& allocation);
+        void Free(VkImage image, Allocation& allocation);
+
+        // writes to host visible memory, which stays mapped
+        void Copy(const void* data,
+            const VkDeviceSize size,
+            const Allocation& allocation);
+
+        // the data is copied to the staging ring and reaches the buffer with the next frame
+        void Upload(VkBuffer destination,
+            const void* data,
+            const VkDeviceSize size,
+            const VkDeviceSize offset = 0);
+
+        void Upload(Mesh* mesh,
+            const void* vertices,
+            const uint32 vertexCount,
+            const uint32 vertexSize);
+
+        // a mesh file from ReadMesh, vertices and indices are copied as they are
+        void Upload(Mesh* mesh, const MeshView& view);
+
+        // a texture file from ReadTexture, whose format the device must support;
+        // the levels are copied as they are, the texture is sampled from the next frame
+        bool Supports(const TextureFormat format, const bool srgb) const;
+        void Upload(Texture* texture, const TextureView& view);
+
+        // an RGBA8 texture of one level, then rows rewritten in place; pixels is the
+        // whole image, the way Font::Dirty reports its atlas
+        void Upload(Texture* texture, const void* pixels, const uint32 width, const uint32 height);
+        void Update(Texture* texture, const void* pixels, const uint32 firstRow, const uint32 rowCount);
+                
+        // relative paths start at the executable directory, the SPIR-V is
+        // read through a memory mapping instead of being copied
+        VkShaderModule CreateShaderModule(const string_view path) const;
+
+        // safe to call from worker threads, use ThreadPool::Submit for a future
+        VkPipeline CreatePipeline(const VkGraphicsPipelineCreateInfo& pipelineInfo) const;
+
+        // destroys the pipeline once the frames already recorded with it are done
+        void Retire(VkPipeline pipeline);
+
+        VkPhysicalDevice PhysicalDevice() const noexcept;
+        VkDevice Device() const noexcept;
+        MemoryAllocator * Allocator() const noexcept;
+        VkCommandBuffer CommandBuffer() const noexcept;
+        uint32 FramesInFlight() const noexcept;
+        uint32 FrameIndex() const noexcept;
+        uint64 FrameNumber() const noexcept;
+        VkRenderPass RenderPass() const noexcept;
+        VkPipelineCache PipelineCache() const noexcept;
+        VkPipelineLayout PipelineLayout() const noexcept;
+        DescriptorHeap * Heap() const noexcept;
+        VkPresentModeKHR PresentMode() const noexcept;
+        bool RenderGraphSupport() const noexcept;
+    };
+
+    // times the commands recorded in the enclosing block, on the GPU and the CPU
+    class GpuScope
+    {
+    private:
+        Graphics * graphics;
+        uint32 scope;
+
+    public:
+        GpuScope(Graphics * graphics, const char * name)
+            : graphics{ graphics }, scope{ graphics->BeginScope(name) } {}
+        ~GpuScope()
+        { graphics->EndScope(scope); }
+
+        GpuScope(const GpuScope &) = delete;
+        GpuScope & operator=(const GpuScope &) = delete;
+    };
+
+    inline void Graphics::VSync(const bool state) noexcept
+    { vSync = state; swapchainDirty = true; }
+
+    inline void Graphics::LowLatency(const bool state) noexcept
+    { lowLatency = state; swapchainDirty = true; }
+
+    inline void Graphics::Resize(const uint32 width, const uint32 height) noexcept
+    { requestedExtent = { width, height }; swapchainDirty = true; }
+
+    inline void Graphics::FramesInFlight(const uint32 count) noexcept
+    { frameCount = count > 0 ? count : 1; }
+
+    inline void Graphics::StagingSize(const VkDeviceSize size) noexcept
+    { stagingSize = size; }
+
+    inline void Graphics::UniformSize(const VkDeviceSize size) noexcept
+    { uniformSize = size; }
+
+    inline void Graphics::PipelineCachePath(const string_view path)
+    { pipelineCachePath = path; }
+
+    inline VkPhysicalDevice Graphics::PhysicalDevice() const noexcept
+    { return physicalDevice; }
+
+    inline VkDevice Graphics::Device() const noexcept
+    { return device; }
+
+    inline MemoryAllocator * Graphics::Allocator() const noexcept
+    { return allocator; }
+
+    inline VkCommandBuffer Graphics::CommandBuffer() const noexcept
+    { return frames[frameIndex].commandBuffer; }
+
+    inline uint32 Graphics::FramesInFlight() const noexcept
+    { return frameCount; }
+
+    inline uint32 Graphics::FrameIndex() const noexcept
+    { return frameIndex; }
+
+    inline uint64 Graphics::FrameNumber() const noexcept
+    { return frameNumber; }
+
+    inline VkRenderPass Graphics::RenderPass() const noexcept
+    { return renderPass; }
+
+    inline VkPipelineCache Graphics::PipelineCache() const noexcept
+    { return pipelineCache; }
+
+    inline VkPipelineLayout Graphics::PipelineLayout() const noexcept
+    { return pipelineLayout; }
+
+    inline DescriptorHeap * Graphics::Heap() const noexcept
+    { return descriptorHeap; }
+
+    inline VkPresentModeKHR Graphics::PresentMode() const noexcept
+    { return presentMode; }
+
+    inline bool Graphics::RenderGraphSupport() const noexcept
+    { return renderGraphSupport; }
+};
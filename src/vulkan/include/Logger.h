@@ -2,8 +2,13 @@
 
 #include "Types.h"
 #include "Export.h"
-#include "WinInclude.h"
-#include <windows.h>
+
+#ifdef _WIN32
+    #include "WinInclude.h"
+    #include <windows.h>
+#else
+    #include <cstdio>
+#endif
 
 namespace Luna
 {
@@ -20,6 +25,7 @@ namespace Luna
     class DLL Logger
     {
     private:
+    #ifdef _WIN32
         HANDLE outputHandle;
         HANDLE errorHandle;
 
@@ -29,12 +35,22 @@ namespace Luna
         void ApplyLevelColor(HANDLE handle, const LogLevel level) noexcept;
         void ResetColors() noexcept;
         void ResetColor(HANDLE handle) noexcept;
+    #else
+        bool colorOutput;
+        bool colorError;
+
+        void WriteToConsole(FILE * stream, const bool color, const LogLevel level, const string_view message) noexcept;
+    #endif
 
     public:
         Logger() noexcept;
+    #ifdef _WIN32
         ~Logger() noexcept;
+    #endif
 
         void OutputDebug(const LogLevel level, const string_view message) noexcept;
+    #ifdef _WIN32
         void OutputDebug(const LogLevel level, const wstring_view message) noexcept;
+    #endif
     };
-}
\ No newline at end of file
+}
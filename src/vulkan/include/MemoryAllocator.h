@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include <vulkan/vulkan_core.h>
+#include <unordered_map>
+#include <vector>
+
+namespace Luna
+{
+    // one vkAllocateMemory, split with a buddy allocator or given whole to a single resource
+    struct MemoryBlock
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize size;
+        VkDeviceSize used;
+        uint8 * mapped;
+        uint32 typeIndex;
+        uint32 levels;                              // 0 for dedicated blocks
+        bool linear;                                // buffers and linear images, when kept apart from optimal images
+        std::vector<uint8> state;                   // per node of the buddy tree
+        std::vector<std::vector<uint32>> freeLists; // per level, may hold stale nodes
+        std::unordered_map<uint32, void*> movable;  // nodes Defragment is allowed to move
+    };
+
+    struct Allocation
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        uint8 * mapped;                             // null unless the memory is host visible
+        MemoryBlock * block;
+        uint32 node;
+    };
+
+    // called for every allocation Defragment moves, the owner copies the
+    // contents and binds its resource to the new range before returning
+    using MoveCallback = void (*)(const Allocation & from, const Allocation & to, void * userData);
+
+    class DLL MemoryAllocator
+    {
+    private:
+        VkPhysicalDevice                    physicalDevice;
+        VkDevice                            device;
+        VkPhysicalDeviceMemoryProperties    memoryProperties;
+        VkDeviceSize                        blockSize;
+        VkDeviceSize                        granularity;
+        bool                                budget;
+        std::vector<MemoryBlock*>           blocks;
+
+        VkDeviceSize Headroom(const uint32 typeIndex) const;
+        uint32 FindMemoryType(const uint32 typeFilter, const VkMemoryPropertyFlags properties, const VkDeviceSize size) const;
+
+        MemoryBlock * CreateBlock(const uint32 typeIndex, const VkDeviceSize size, const bool linear, const void * next);
+        void DestroyBlock(MemoryBlock * block);
+
+        bool AllocateNode(MemoryBlock * block, const VkDeviceSize size, uint32 * node);
+        void FreeNode(MemoryBlock * block, uint32 node);
+
+    public:
+        explicit MemoryAllocator() noexcept;
+        ~MemoryAllocator() noexcept;
+
+        void BlockSize(const VkDeviceSize size) noexcept;
+        void Initialize(VkPhysicalDevice physicalDevice, VkDevice device, const bool memoryBudget);
+
+        // resources larger than half a block, or given dedicated info, get memory of their own
+        Allocation Allocate(const VkMemoryRequirements & requirements,
+            const VkMemoryPropertyFlags properties,
+            const bool linear,
+            const VkMemoryDedicatedAllocateInfo * dedicated = nullptr,
+            void * userData = nullptr);
+
+        void Free(Allocation & allocation);
+
+        // empties sparse blocks by moving allocations made with userData into
+        // fuller blocks of the same memory type, returns the number of moves
+        uint32 Defragment(MoveCallback move, const uint32 maxMoves = 64);
+
+        VkDeviceSize BlockSize() const noexcept;
+        uint32 BlockCount() const noexcept;
+        VkDeviceSize Used() const noexcept;
+    };
+
+    inline void MemoryAllocator::BlockSize(const VkDeviceSize size) noexcept
+    { blockSize = size; }
+
+    inline VkDeviceSize MemoryAllocator::BlockSize() const noexcept
+    { return blockSize; }
+
+    inline uint32 MemoryAllocator::BlockCount() const noexcept
+    { return static_cast<uint32>(blocks.size()); }
+}
@@ -1,28 +1,29 @@
 #pragma once
 
 #include "Types.h"
+#include "MemoryAllocator.h"
 #include <vulkan/vulkan_core.h>
 
 namespace Luna
 {
-    struct StagingBuffer
-    {
-        VkBuffer buffer;
-        VkDeviceMemory memory;
-    };
-    
     struct Mesh
     {
         string id;
-        StagingBuffer vertexUploadBuffer;
-
         uint32 vertexBufferSize;
         VkBuffer vertexBuffer;
-        VkDeviceMemory vertexBufferMemory;
+        Allocation vertexBufferMemory;
+        MemoryAllocator * allocator;
 	    VkDevice device;
 
 		int32 vertexCount;
 
+        // empty for meshes drawn without indices
+        uint32 indexBufferSize;
+        VkBuffer indexBuffer;
+        Allocation indexBufferMemory;
+        uint32 indexCount;
+        VkIndexType indexType;
+
         Mesh(const string_view name) noexcept;
         ~Mesh() noexcept;
     };
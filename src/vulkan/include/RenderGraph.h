@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Graphics.h"
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <vector>
+
+namespace Luna
+{
+    using RenderResource = uint32;
+
+    enum RenderAccess
+    {
+        COLOR_ATTACHMENT,
+        DEPTH_ATTACHMENT,
+        DEPTH_READ,
+        SAMPLED,
+        STORAGE_READ,
+        STORAGE_WRITE,
+        TRANSFER_SRC,
+        TRANSFER_DST
+    };
+
+    // image the graph creates and may alias in memory with images whose passes do not overlap
+    struct RenderTarget
+    {
+        VkFormat format;
+        uint32 width;                       // 0 follows the swapchain
+        uint32 height;
+    };
+
+    struct RenderUse
+    {
+        RenderResource resource;
+        RenderAccess access;
+        bool write;
+        bool clear;                         // the pass overwrites the whole image
+        VkClearValue clearValue;
+    };
+
+    struct RenderNode
+    {
+        const char * name;
+        std::function<void(VkCommandBuffer)> execute;
+        std::vector<RenderUse> uses;
+        bool sideEffect;                    // kept even when nothing reads what it writes
+    };
+
+    struct RenderImage
+    {
+        const char * name;
+        RenderTarget target;
+        bool imported;
+        VkImageUsageFlags usage;
+        VkImage image;
+        VkImageView view;
+        VkExtent2D extent;
+        VkDeviceSize offset;                // in the transient memory
+        VkMemoryRequirements requirements;
+        uint32 first;                       // first and last pass that uses it
+        uint32 last;
+    };
+
+    // layout change and dependency recorded before a pass, or after the last one
+    struct RenderBarrier
+    {
+        RenderResource resource;
+        VkPipelineStageFlags2 srcStage;
+        VkAccessFlags2 srcAccess;
+        VkPipelineStageFlags2 dstStage;
+        VkAccessFlags2 dstAccess;
+        VkImageLayout oldLayout;
+        VkImageLayout newLayout;
+    };
+
+    struct RetiredTargets
+    {
+        std::vector<VkImage> images;
+        std::vector<VkImageView> views;
+        Allocation memory;
+        uint64 frame;
+    };
+
+    // Frame graph for the Vulkan backend. Passes declare what they read and write,
+    // passes that contribute nothing to the back buffer or a side effect are culled,
+    // barriers are derived from the declared accesses and batched per pass, and
+    // render targets share memory when their lifetimes do not overlap. The graph is
+    // built once and executed every frame with Graphics::Execute, it compiles again
+    // when passes change or the swapchain is resized.
+    class DLL RenderGraph
+    {
+    private:
+        Graphics                    * graphics;
+        std::vector<RenderNode>       nodes;
+        std::vector<RenderImage>      images;
+        std::vector<uint32>           order;          // passes left after culling
+        std::vector<std::vector<RenderBarrier>> barriers;   // one list per pass in order, the last after all passes
+        std::vector<RetiredTargets>   retired;
+        Allocation                    memory;
+        VkExtent2D                    extent;         // of the swapchain when compiled
+        uint64                        frame;          // last frame executed
+        bool                          compiled;
+
+        void Cull();
+        void Allocate();
+        void Synchronize();
+        void Retire();
+        void Release(const bool all);
+
+        void Barriers(VkCommandBuffer commandBuffer, const std::vector<RenderBarrier> & list) const;
+        bool BeginRendering(VkCommandBuffer commandBuffer, const RenderNode & node) const;
+
+    public:
+        explicit RenderGraph(Graphics * graphics) noexcept;
+        ~RenderGraph() noexcept;
+
+        RenderGraph(const RenderGraph &) = delete;
+        RenderGraph & operator=(const RenderGraph &) = delete;
+
+        // the swapchain image of the frame, in the state Graphics::Clear leaves it
+        RenderResource BackBuffer() const noexcept;
+        RenderResource Create(const char * name, const RenderTarget & target);
+
+        // passes execute in the order they are added, colour and depth attachments are
+        // bound with dynamic rendering before execute is called
+        uint32 AddPass(const char * name, const std::function<void(VkCommandBuffer)> & execute);
+        void Read(const uint32 pass, const RenderResource resource, const RenderAccess access);
+        void Write(const uint32 pass, const RenderResource resource, const RenderAccess access);
+        void Clear(const uint32 pass, const RenderResource resource, const VkClearValue & value);
+        void SideEffect(const uint32 pass) noexcept;
+
+        // drops all passes and render targets, the memory is released once the GPU is done with it
+        void Reset();
+
+        void Compile();
+        void Execute(VkCommandBuffer commandBuffer, const SwapchainBuffer & backBuffer, const uint64 frameNumber);
+
+        VkImage Image(const RenderResource resource) const noexcept;
+        VkImageView View(const RenderResource resource) const noexcept;
+        uint32 PassCount() const noexcept;
+        uint32 BarrierCount() const noexcept;
+        VkDeviceSize MemorySize() const noexcept;
+    };
+
+    inline RenderResource RenderGraph::BackBuffer() const noexcept
+    { return 0; }
+
+    inline void RenderGraph::SideEffect(const uint32 pass) noexcept
+    { nodes[pass].sideEffect = true; }
+
+    inline VkImage RenderGraph::Image(const RenderResource resource) const noexcept
+    { return images[resource].image; }
+
+    inline VkImageView RenderGraph::View(const RenderResource resource) const noexcept
+    { return images[resource].view; }
+
+    inline uint32 RenderGraph::PassCount() const noexcept
+    { return static_cast<uint32>(order.size()); }
+
+    inline VkDeviceSize RenderGraph::MemorySize() const noexcept
+    { return memory.size; }
+}
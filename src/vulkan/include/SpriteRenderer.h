@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Types.h"
+#include "Export.h"
+#include "Graphics.h"
+#include "Font.h"
+#include "SpriteBatch.h"
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace Luna
+{
+    // Draws the runs of a SpriteBatch with one instanced draw each, a strip of four
+    // vertices per sprite, in the frame's render pass after the scene. The batch
+    // writes its instances straight into a host visible buffer that stays mapped,
+    // one slice per frame in flight, so the CPU never touches what the GPU reads.
+    // SpriteRun::texture is an index in the descriptor heap.
+    class DLL SpriteRenderer
+    {
+    private:
+        // font atlas replaced by a taller one, kept until no frame in flight samples it
+        struct RetiredTexture
+        {
+            Texture * texture;
+            uint64 frame;
+        };
+
+        Graphics                  * graphics;
+        VkPipeline                  pipeline;
+        VkSampler                   sampler;
+        VkBuffer                    instanceBuffer;
+        Allocation                  instanceAllocation;
+        uint32                      capacity;           // instances per frame
+        uint32                      used;               // instances of the frame drawn so far
+        uint64                      frame;              // frame the count belongs to
+
+        Texture                   * atlas;
+        uint32                      atlasIndex;
+        std::vector<RetiredTexture> retired;
+
+        SpriteInstance * Slice();
+
+    public:
+        explicit SpriteRenderer() noexcept;
+        ~SpriteRenderer() noexcept;
+
+        SpriteRenderer(const SpriteRenderer &) = delete;
+        SpriteRenderer & operator=(const SpriteRenderer &) = delete;
+
+        // false without a descriptor heap, through which sprites reach their
+        // textures; Draw records nothing then
+        bool Initialize(Graphics * graphics, const uint32 capacity = 65536);
+
+        // the next End of the batch writes into the rest of the frame's slice;
+        // call it between Clear and End, then Draw before mapping another batch
+        void Map(SpriteBatch & batch);
+
+        // records the runs of the batch's last End, a batch that was not mapped
+        // this frame has its instances copied into the slice first
+        void Draw(const SpriteBatch & batch);
+
+        // the font's atlas as a texture in the heap, created on first use and then
+        // updated with the rows Font::Dirty reports; a taller atlas gets a new index
+        uint32 Atlas(Font & font);
+    };
+}
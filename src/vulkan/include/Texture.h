@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Types.h"
+#include "MemoryAllocator.h"
+#include <vulkan/vulkan_core.h>
+
+namespace Luna
+{
+    // sampled image with its mip chain, filled by Graphics::Upload
+    struct Texture
+    {
+        string id;
+        VkImage image;
+        Allocation imageMemory;
+        VkImageView view;
+        VkFormat format;
+        uint32 width;
+        uint32 height;
+        uint32 levelCount;
+        MemoryAllocator * allocator;
+        VkDevice device;
+
+        Texture(const string_view name) noexcept;
+        ~Texture() noexcept;
+    };
+}
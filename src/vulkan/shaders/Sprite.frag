@@ -0,0 +1,20 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// the textures of the descriptor heap, indexed with the run's texture
+layout (set = 0, binding = 0) uniform sampler2D textures[];
+
+layout (push_constant) uniform Constants
+{
+    vec2 scale;
+    uint textureIndex;
+} constants;
+
+layout (location = 0) in vec2 v_TexCoord;
+layout (location = 1) in vec4 v_Color;
+layout (location = 0) out vec4 fragColor;
+
+void main()
+{
+    fragColor = texture(textures[constants.textureIndex], v_TexCoord) * v_Color;
+}
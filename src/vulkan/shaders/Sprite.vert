@@ -0,0 +1,33 @@
+#version 450
+
+// one SpriteInstance per instance, drawn as a strip of four vertices
+layout (location = 0) in vec2 Position;
+layout (location = 1) in vec2 Size;
+layout (location = 2) in vec4 TexCoords;
+layout (location = 3) in uint Color;
+layout (location = 4) in float Rotation;
+
+layout (push_constant) uniform Constants
+{
+    vec2 scale;                 // pixels to clip space
+    uint textureIndex;
+} constants;
+
+layout (location = 0) out vec2 v_TexCoord;
+layout (location = 1) out vec4 v_Color;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+    vec2 offset = (corner - 0.5) * Size;
+
+    float c = cos(Rotation);
+    float s = sin(Rotation);
+    vec2 pixel = Position + vec2(offset.x * c - offset.y * s, offset.x * s + offset.y * c);
+
+    gl_Position = vec4(pixel * constants.scale - 1.0, 0.0, 1.0);
+    v_TexCoord = mix(TexCoords.xy, TexCoords.zw, corner);
+
+    // 0xAARRGGBB, the bytes are blue, green, red and alpha in memory
+    v_Color = unpackUnorm4x8(Color).zyxw;
+}
@@ -0,0 +1,191 @@
+#include "DescriptorHeap.h"
+#include "VkError.h"
+#include <algorithm>
+
+namespace Luna
+{
+    constexpr uint32 MAX_HEAP_TEXTURES = 16384;
+    constexpr uint32 MAX_HEAP_BUFFERS = 4096;
+
+    DescriptorHeap::DescriptorHeap() noexcept
+        : device{nullptr},
+        layout{nullptr},
+        pool{nullptr},
+        set{nullptr},
+        capacity{},
+        count{}
+    {
+    }
+
+    DescriptorHeap::~DescriptorHeap() noexcept
+    {
+        // the set goes with the pool
+        if (device)
+        {
+            vkDestroyDescriptorPool(device, pool, nullptr);
+            vkDestroyDescriptorSetLayout(device, layout, nullptr);
+        }
+    }
+
+    void DescriptorHeap::Initialize(VkPhysicalDevice physicalDevice, VkDevice device, const bool supported)
+    {
+        this->device = device;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+
+        if (!supported)
+        {
+            VkThrowIfFailed(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layout));
+            return;
+        }
+
+        VkPhysicalDeviceVulkan12Properties properties12{};
+        properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &properties12;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+        capacity[HEAP_TEXTURES] = std::min({ MAX_HEAP_TEXTURES,
+            properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            properties12.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+        capacity[HEAP_BUFFERS] = std::min(MAX_HEAP_BUFFERS,
+            properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers);
+
+        // ---------------------------------------------------
+        // Layout
+        // ---------------------------------------------------
+
+        VkDescriptorSetLayoutBinding bindings[HEAP_BINDINGS]{};
+        bindings[HEAP_TEXTURES].binding = HEAP_TEXTURES;
+        bindings[HEAP_TEXTURES].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[HEAP_TEXTURES].descriptorCount = capacity[HEAP_TEXTURES];
+        bindings[HEAP_TEXTURES].stageFlags = VK_SHADER_STAGE_ALL;
+
+        bindings[HEAP_BUFFERS].binding = HEAP_BUFFERS;
+        bindings[HEAP_BUFFERS].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[HEAP_BUFFERS].descriptorCount = capacity[HEAP_BUFFERS];
+        bindings[HEAP_BUFFERS].stageFlags = VK_SHADER_STAGE_ALL;
+
+        // slots are written while earlier frames that do not read them are still pending
+        const VkDescriptorBindingFlags flags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+            | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+            | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+        const VkDescriptorBindingFlags bindingFlags[HEAP_BINDINGS] { flags, flags };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+        flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        flagsInfo.bindingCount = HEAP_BINDINGS;
+        flagsInfo.pBindingFlags = bindingFlags;
+
+        layoutInfo.pNext = &flagsInfo;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutInfo.bindingCount = HEAP_BINDINGS;
+        layoutInfo.pBindings = bindings;
+
+        VkThrowIfFailed(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layout));
+
+        // ---------------------------------------------------
+        // Pool and Set
+        // ---------------------------------------------------
+
+        const VkDescriptorPoolSize poolSizes[HEAP_BINDINGS]
+        {
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, capacity[HEAP_TEXTURES] },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, capacity[HEAP_BUFFERS] }
+        };
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = HEAP_BINDINGS;
+        poolInfo.pPoolSizes = poolSizes;
+
+        VkThrowIfFailed(vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool));
+
+        VkDescriptorSetAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = pool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &layout;
+
+        VkThrowIfFailed(vkAllocateDescriptorSets(device, &allocateInfo, &set));
+    }
+
+    uint32 DescriptorHeap::NextIndex(const uint32 binding)
+    {
+        VkThrowIfErrorMessage(VK_ERROR_FEATURE_NOT_PRESENT, !set, "descriptor indexing is not supported");
+
+        if (!freeIndices[binding].empty())
+        {
+            const uint32 index = freeIndices[binding].back();
+            freeIndices[binding].pop_back();
+            return index;
+        }
+
+        VkThrowIfError(VK_ERROR_OUT_OF_POOL_MEMORY, count[binding] == capacity[binding]);
+        return count[binding]++;
+    }
+
+    uint32 DescriptorHeap::AddTexture(VkImageView view, VkSampler sampler, const VkImageLayout imageLayout)
+    {
+        const uint32 index = NextIndex(HEAP_TEXTURES);
+
+        VkDescriptorImageInfo imageInfo{ sampler, view, imageLayout };
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = HEAP_TEXTURES;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    uint32 DescriptorHeap::AddBuffer(VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize range)
+    {
+        const uint32 index = NextIndex(HEAP_BUFFERS);
+
+        VkDescriptorBufferInfo bufferInfo{ buffer, offset, range };
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = HEAP_BUFFERS;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+        return index;
+    }
+
+    void DescriptorHeap::Remove(const uint32 binding, const uint32 index, const uint64 frame)
+    {
+        removed.push_back({ binding, index, frame });
+    }
+
+    void DescriptorHeap::Recycle(const uint64 frame)
+    {
+        auto reusable = [this, frame](const HeapIndex & entry)
+        {
+            if (entry.frame > frame)
+                return false;
+
+            freeIndices[entry.binding].push_back(entry.index);
+            return true;
+        };
+
+        removed.erase(std::remove_if(removed.begin(), removed.end(), reusable), removed.end());
+    }
+}
@@ -0,0 +1,2114 @@
+#include "Graphics.h"
+#include "RenderGraph.h"
+#include "VkError.h"
+#include "Utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <format>
+#include <vector>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+using std::format;
+using std::vector;
+
+namespace Luna
+{
+    Logger Graphics::logger;
+
+    // surface extension of the window library the engine was built with
+#if defined(VK_USE_PLATFORM_XLIB_KHR)
+    constexpr const char* PLATFORM_SURFACE_EXTENSION_NAME = VK_KHR_XLIB_SURFACE_EXTENSION_NAME;
+#elif defined(VK_USE_PLATFORM_XCB_KHR)
+    constexpr const char* PLATFORM_SURFACE_EXTENSION_NAME = VK_KHR_XCB_SURFACE_EXTENSION_NAME;
+#elif defined(VK_USE_PLATFORM_WAYLAND_KHR)
+    constexpr const char* PLATFORM_SURFACE_EXTENSION_NAME = VK_KHR_WAYLAND_SURFACE_EXTENSION_NAME;
+#elif defined(VK_USE_PLATFORM_WIN32_KHR)
+    constexpr const char* PLATFORM_SURFACE_EXTENSION_NAME = VK_KHR_WIN32_SURFACE_EXTENSION_NAME;
+#else
+    #error "Vulkan needs a VK_USE_PLATFORM_*_KHR define, on Linux build with BUILD_X11, BUILD_XCB or BUILD_WAYLAND."
+#endif
+
+    Graphics::Graphics() noexcept
+        : backBufferCount{},
+        frameCount{2},
+        vSync{false},
+        bgColor{},
+        instance{nullptr},
+        physicalDevice{nullptr},
+        device{nullptr},
+        queueFamilyIndex{},
+        surface{nullptr},
+        swapchain{nullptr},
+        buffers{nullptr},
+        backBufferIndex{},
+        surfaceFormat{},
+        presentMode{VK_PRESENT_MODE_FIFO_KHR},
+        requestedExtent{},
+        lowLatency{false},
+        swapchainDirty{false},
+        frameNumber{},
+        commandPool{nullptr},
+        copyCommandBuffer{nullptr},
+        frames{nullptr},
+        frameIndex{},
+        renderPass{nullptr},
+        renderPassLoad{nullptr},
+        renderGraphSupport{false},
+        pipelineCache{nullptr},
+        pipelineCachePath{"PipelineCache.bin"},
+        stagingSize{16 * 1024 * 1024},
+        stagingBuffer{nullptr},
+        stagingAllocation{},
+        stagingData{nullptr},
+        stagingHead{},
+        stagingTail{},
+        copyFence{nullptr},
+        bindlessSupport{false},
+        pipelineLayout{nullptr},
+        uniformSize{1024 * 1024},
+        uniformRange{},
+        uniformAlignment{1},
+        uniformHead{},
+        uniformBuffer{nullptr},
+        uniformAllocation{},
+        uniformLayout{nullptr},
+        uniformPool{nullptr},
+        uniformSet{nullptr},
+        profiler{nullptr},
+        timestampBits{},
+        timestampPeriod{1.0f},
+        queue{nullptr},
+        viewport{},
+        scissorRect{}
+    {
+        validationLayer = new ValidationLayer();
+        allocator = new MemoryAllocator();
+        descriptorHeap = new DescriptorHeap();
+    }
+
+    Graphics::~Graphics() noexcept
+    {
+        if (device)
+        {
+            vkDeviceWaitIdle(device);
+
+            for (uint32 i = 0; i < frameCount && frames; ++i)
+            {
+                vkDestroySemaphore(device, frames[i].imageAvailable, nullptr);
+                vkDestroyFence(device, frames[i].fence, nullptr);
+                vkDestroyQueryPool(device, frames[i].queryPool, nullptr);
+                vkDestroyCommandPool(device, frames[i].commandPool, nullptr);
+
+                for (const CommandRecorder & recorder : frames[i].recorders)
+                    vkDestroyCommandPool(device, recorder.commandPool, nullptr);
+            }
+            delete[] frames;
+
+            Free(stagingBuffer, stagingAllocation);
+            vkDestroyFence(device, copyFence, nullptr);
+
+            vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+            vkDestroyDescriptorPool(device, uniformPool, nullptr);
+            vkDestroyDescriptorSetLayout(device, uniformLayout, nullptr);
+            Free(uniformBuffer, uniformAllocation);
+            delete descriptorHeap;
+
+            for (const RetiredPipeline & retired : retiredPipelines)
+                vkDestroyPipeline(device, retired.pipeline, nullptr);
+
+            SavePipelineCache();
+            vkDestroyPipelineCache(device, pipelineCache, nullptr);
+
+            vkDestroyRenderPass(device, renderPass, nullptr);
+            vkDestroyRenderPass(device, renderPassLoad, nullptr);
+
+            vkFreeCommandBuffers(device, commandPool, 1, &copyCommandBuffer);
+            vkDestroyCommandPool(device, commandPool, nullptr);
+
+            for (const RetiredSwapchain & retired : retiredSwapchains)
+                DestroySwapchain(retired);
+
+            DestroySwapchain({ swapchain, buffers, backBufferCount, frameNumber });
+            delete allocator;
+            vkDestroyDevice(device, nullptr);
+        }
+        else
+        {
+            delete descriptorHeap;
+            delete allocator;
+        }
+
+        if (instance)
+        {
+            vkDestroySurfaceKHR(instance, surface, nullptr);
+
+            delete validationLayer;
+
+            vkDestroyInstance(instance, nullptr);
+        }
+        else
+        {
+            delete validationLayer;
+        }
+    }
+
+    static bool CheckExtensionSupported(
+        const vector<VkExtensionProperties>& extensions,
+        const string_view requestExtension)
+    {
+        return std::ranges::find_if(extensions,
+            [requestExtension](auto& extension) {
+                return strcmp(extension.extensionName, requestExtension.data()) == 0;
+            }) != extensions.end();
+    }
+
+    static std::filesystem::path ExecutablePath(const string_view path)
+    {
+        const std::filesystem::path file { path };
+        if (file.is_absolute())
+            return file;
+
+    #ifdef _WIN32
+        char exePath[MAX_PATH];
+        GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+
+        return std::filesystem::path(exePath).parent_path() / file;
+    #else
+        return std::filesystem::read_symlink("/proc/self/exe").parent_path() / file;
+    #endif
+    }
+
+    // read only view of a whole file, empty when it can not be opened
+    struct MappedFile
+    {
+        void * data = nullptr;
+        size_t size = 0;
+
+        explicit MappedFile(const std::filesystem::path & path) noexcept
+        {
+        #ifdef _WIN32
+            HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+            if (file == INVALID_HANDLE_VALUE)
+                return;
+
+            LARGE_INTEGER fileSize;
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+            {
+                HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping)
+                {
+                    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    if (data)
+                        size = size_t(fileSize.QuadPart);
+
+                    CloseHandle(mapping);
+                }
+            }
+
+            CloseHandle(file);
+        #else
+            const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return;
+
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void * view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (view != MAP_FAILED)
+                {
+                    data = view;
+                    size = size_t(info.st_size);
+                }
+            }
+
+            close(fd);
+        #endif
+        }
+
+        ~MappedFile() noexcept
+        {
+            if (!data)
+                return;
+
+        #ifdef _WIN32
+            UnmapViewOfFile(data);
+        #else
+            munmap(data, size);
+        #endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+    };
+
+    static bool CheckLayerSupported(const string_view requestLayer)
+    {
+        uint32 layerCount{};
+        vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+
+        vector<VkLayerProperties> layers(layerCount);
+        vkEnumerateInstanceLayerProperties(&layerCount, layers.data());
+
+        return std::ranges::find_if(layers,
+            [requestLayer](auto& layer) {
+                return strcmp(layer.layerName, requestLayer.data()) == 0;
+            }) != layers.end();
+    }
+
+    static void CheckSupportMemoryBudget(
+        VkPhysicalDevice gpu,
+        const vector<VkExtensionProperties>& instanceExtensions)
+    {
+        uint32 deviceExtensionCount{};
+        vkEnumerateDeviceExtensionProperties(gpu, nullptr, &deviceExtensionCount, nullptr);
+
+        vector<VkExtensionProperties> deviceExtensions(deviceExtensionCount);
+        vkEnumerateDeviceExtensionProperties(gpu, nullptr, &deviceExtensionCount, deviceExtensions.data());
+
+        const bool supportMemoryBudget =
+            CheckExtensionSupported(instanceExtensions, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) &&
+            CheckExtensionSupported(deviceExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+        if (supportMemoryBudget)
+        {
+            VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudgetProperties{};
+            memoryBudgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+            memoryBudgetProperties.pNext = nullptr;
+
+            VkPhysicalDeviceMemoryProperties2 deviceMemoryProperties{};
+            deviceMemoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+            deviceMemoryProperties.pNext = &memoryBudgetProperties;
+            vkGetPhysicalDeviceMemoryProperties2(gpu, &deviceMemoryProperties);
+
+            VkDeviceSize memoryTotalUsage{};
+            VkDeviceSize memoryTotalBudget{};
+            VkDeviceSize memoryTotalsize{};
+            for (size_t i = 0; i < deviceMemoryProperties.memoryProperties.memoryHeapCount; ++i)
+            {
+                memoryTotalUsage += memoryBudgetProperties.heapUsage[i];
+                memoryTotalBudget += memoryBudgetProperties.heapBudget[i];
+                memoryTotalsize += deviceMemoryProperties.memoryProperties.memoryHeaps[i].size;
+            }
+
+            constexpr const uint32 BytesinMegaByte = 1048576U; // 1'048'576
+
+            Graphics::logger.OutputDebug(LOG_LEVEL_INFO,
+                format("---> Video memory (size total): {}MB\n",
+                    memoryTotalsize / BytesinMegaByte)
+            );
+
+            Graphics::logger.OutputDebug(LOG_LEVEL_INFO,
+                format("---> Video memory (budget total): {}MB\n",
+                    memoryTotalBudget / BytesinMegaByte)
+            );
+
+            Graphics::logger.OutputDebug(LOG_LEVEL_INFO,
+                format("---> Video memory (usage total): {}MB\n",
+                    memoryTotalUsage / BytesinMegaByte)
+            );
+        }
+    }
+
+    static VkFormat TextureFormatOf(const TextureFormat format, const bool srgb)
+    {
+        switch (format)
+        {
+        case TEXTURE_BC1: return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case TEXTURE_BC3: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        case TEXTURE_BC7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        case TEXTURE_ETC2: return srgb ? VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+        default: return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        }
+    }
+
+    // copies that write rows of the same level
+    static bool Overlaps(const VkBufferImageCopy& a, const VkBufferImageCopy& b)
+    {
+        return a.imageSubresource.mipLevel == b.imageSubresource.mipLevel
+            && a.imageOffset.y < b.imageOffset.y + static_cast<int32>(b.imageExtent.height)
+            && b.imageOffset.y < a.imageOffset.y + static_cast<int32>(a.imageExtent.height);
+    }
+
+    void Graphics::LogHardwareInfo() const
+    {
+        // --------------------------------------
+        // Instance Layers
+        // --------------------------------------
+
+        uint32 layerCount{};
+        VkThrowIfFailed(vkEnumerateInstanceLayerProperties(&layerCount, nullptr))
+
+        vector<VkLayerProperties> instanceLayers(layerCount);
+        VkThrowIfFailed(vkEnumerateInstanceLayerProperties(&layerCount, instanceLayers.data()))
+
+        logger.OutputDebug(LOG_LEVEL_INFO, format("---> {} Instance Layer:\n", layerCount));
+        for (const auto& layer : instanceLayers)
+            logger.OutputDebug(LOG_LEVEL_INFO, format("\t{}\n", layer.layerName));
+
+        // --------------------------------------
+        // Instance Extensions
+        // --------------------------------------
+
+        uint32 extensionCount{};
+        VkThrowIfFailed(vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr))
+
+        vector<VkExtensionProperties> instanceExtensions(extensionCount);
+        VkThrowIfFailed(vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, instanceExtensions.data()))
+
+        logger.OutputDebug(LOG_LEVEL_INFO, format("---> {} Instance Extensions:\n", extensionCount));
+        for (const auto& extension : instanceExtensions)
+            logger.OutputDebug(LOG_LEVEL_INFO, format("\t{}\n", extension.extensionName));
+
+        // --------------------------------------
+        // Video adapter (GPUs)
+        // --------------------------------------
+
+        uint32 gpuCount{};
+        vkEnumeratePhysicalDevices(instance, &gpuCount, nullptr);
+
+        vector<VkPhysicalDevice> gpus(gpuCount);
+        vkEnumeratePhysicalDevices(instance, &gpuCount, gpus.data());
+
+        for (size_t i = 0; i < gpuCount; ++i)
+        {
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(gpus[i], &deviceProperties);
+            logger.OutputDebug(LOG_LEVEL_INFO,
+                format("---> Video adapter (GPU) {}: {}\n", i + 1, deviceProperties.deviceName)
+            );
+
+            CheckSupportMemoryBudget(gpus[i], instanceExtensions);
+
+            switch (deviceProperties.deviceType)
+            {
+            case VK_PHYSICAL_DEVICE_TYPE_OTHER:
+                logger.OutputDebug(LOG_LEVEL_INFO, "---> Other\n");
+                break;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+                logger.OutputDebug(LOG_LEVEL_INFO, "---> Integrated GPU\n");
+                break;
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+                logger.OutputDebug(LOG_LEVEL_INFO, "---> Discrete GPU\n");
+                break;
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+                logger.OutputDebug(LOG_LEVEL_INFO, "---> Virtual GPU\n");
+                break;
+            case VK_PHYSICAL_DEVICE_TYPE_CPU:
+                logger.OutputDebug(LOG_LEVEL_INFO, "---> CPU\n");
+                break;
+            default:
+                logger.OutputDebug(LOG_LEVEL_INFO, "---> Unknown device type\n");
+                break;
+            }
+
+            logger.OutputDebug(LOG_LEVEL_INFO,
+                format("---> Feature Level: {}.{}.{}\n",
+                    VK_API_VERSION_MAJOR(deviceProperties.apiVersion),
+                    VK_API_VERSION_MINOR(deviceProperties.apiVersion),
+                    VK_API_VERSION_PATCH(deviceProperties.apiVersion))
+            );
+        }
+
+        // --------------------------------------
+        // Device Extensions
+        // --------------------------------------
+
+        uint32 deviceExtensionCount{};
+        VkThrowIfFailed(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &deviceExtensionCount, nullptr));
+
+        vector<VkExtensionProperties> deviceExtensions(deviceExtensionCount);
+        VkThrowIfFailed(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &deviceExtensionCount, deviceExtensions.data()))
+
+        logger.OutputDebug(LOG_LEVEL_INFO, format("---> {} Device Extensions:\n", deviceExtensionCount));
+        for (const auto& extension : deviceExtensions)
+            logger.OutputDebug(LOG_LEVEL_INFO, format("\t{}\n", extension.extensionName));
+
+    #ifdef _WIN32
+        // -----------------------------------------
+        // Video Output (monitor)
+        // -----------------------------------------
+
+        DWORD deviceNum{};
+        DISPLAY_DEVICE displayDevice{};
+        displayDevice.cb = sizeof(DISPLAY_DEVICE);
+        while (EnumDisplayDevices(nullptr, deviceNum, &displayDevice, 0))
+        {
+            if (displayDevice.StateFlags & DISPLAY_DEVICE_ACTIVE)
+                logger.OutputDebug(LOG_LEVEL_INFO, format("---> Monitor: {}\n", displayDevice.DeviceName));
+            deviceNum++;
+            displayDevice = {};
+            displayDevice.cb = sizeof(DISPLAY_DEVICE);
+        }
+
+        // ------------------------------------------
+        // Video mode (resolution)
+        // ------------------------------------------
+
+        uint32 dpi { GetDpiForSystem() };
+        int32 screenWidth { GetSystemMetricsForDpi(SM_CXSCREEN, dpi) };
+        int32 screenHeight { GetSystemMetricsForDpi(SM_CYSCREEN, dpi) };
+
+        DEVMODE devMode{};
+        devMode.dmSize = sizeof(DEVMODE);
+        EnumDisplaySettings(nullptr, ENUM_CURRENT_SETTINGS, &devMode);
+        uint32 refreshRate = devMode.dmDisplayFrequency;
+
+        logger.OutputDebug(LOG_LEVEL_INFO,
+            format("---> Resolution: {}x{} {}Hz\n",
+                screenWidth, screenHeight, refreshRate)
+        );
+    #endif
+    }
+
+    void Graphics::CreateSurface(const Window * const window)
+    {
+        // the swapchain of a headless surface is presented nowhere, frames are
+        // still rendered, acquired and presented like on screen
+        if (window->Headless())
+        {
+            const auto createHeadlessSurface = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+                vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+
+            VkHeadlessSurfaceCreateInfoEXT surfaceCreateInfo{};
+            surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+            VkThrowIfFailed(createHeadlessSurface(instance, &surfaceCreateInfo, nullptr, &surface));
+            return;
+        }
+
+    #if defined(VK_USE_PLATFORM_XLIB_KHR)
+        VkXlibSurfaceCreateInfoKHR surfaceCreateInfo{};
+        surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR;
+        surfaceCreateInfo.dpy = window->XDisplay();
+        surfaceCreateInfo.window = window->Id();
+        VkThrowIfFailed(vkCreateXlibSurfaceKHR(instance, &surfaceCreateInfo, nullptr, &surface));
+    #elif defined(VK_USE_PLATFORM_XCB_KHR)
+        VkXcbSurfaceCreateInfoKHR surfaceCreateInfo{};
+        surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR;
+        surfaceCreateInfo.connection = window->Connection();
+        surfaceCreateInfo.window = window->Id();
+        VkThrowIfFailed(vkCreateXcbSurfaceKHR(instance, &surfaceCreateInfo, nullptr, &surface));
+    #elif defined(VK_USE_PLATFORM_WAYLAND_KHR)
+        VkWaylandSurfaceCreateInfoKHR surfaceCreateInfo{};
+        surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR;
+        surfaceCreateInfo.display = window->Display();
+        surfaceCreateInfo.surface = window->Surface();
+        VkThrowIfFailed(vkCreateWaylandSurfaceKHR(instance, &surfaceCreateInfo, nullptr, &surface));
+    #elif defined(VK_USE_PLATFORM_WIN32_KHR)
+        VkWin32SurfaceCreateInfoKHR surfaceCreateInfo{};
+        surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+        surfaceCreateInfo.hinstance = window->AppId();
+        surfaceCreateInfo.hwnd = window->Id();
+        VkThrowIfFailed(vkCreateWin32SurfaceKHR(instance, &surfaceCreateInfo, nullptr, &surface));
+    #endif
+    }
+
+    void Graphics::Initialize(const Window * const window)
+    {
+        // ---------------------------------------------------
+        // Instance
+        // ---------------------------------------------------
+
+        constexpr const char* instanceLayers[]
+        {
+            "VK_LAYER_KHRONOS_validation",
+        };
+
+        vector<const char*> instanceExtensions
+        {
+            VK_KHR_SURFACE_EXTENSION_NAME,
+            window->Headless() ? VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME : PLATFORM_SURFACE_EXTENSION_NAME,
+        #ifdef _DEBUG
+            VK_EXT_DEBUG_UTILS_EXTENSION_NAME
+        #endif
+        };
+
+        // Title() returns a copy, it has to outlive vkCreateInstance
+        const string title = window->Title();
+
+        VkApplicationInfo applicationInfo{};
+        applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        applicationInfo.pNext = nullptr;
+        applicationInfo.pApplicationName = title.c_str();
+        applicationInfo.applicationVersion = VK_API_VERSION_1_0;
+        applicationInfo.pEngineName = "Luna3D";
+        applicationInfo.engineVersion = VK_API_VERSION_1_0;
+        applicationInfo.apiVersion = VK_API_VERSION_1_3;
+
+        VkInstanceCreateInfo instanceInfo{};
+        instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instanceInfo.pNext = nullptr;
+        instanceInfo.flags = 0;
+        instanceInfo.pApplicationInfo = &applicationInfo;
+        instanceInfo.enabledExtensionCount = static_cast<uint32>(instanceExtensions.size());
+        instanceInfo.ppEnabledExtensionNames = instanceExtensions.data();
+        instanceInfo.enabledLayerCount = 0;
+        instanceInfo.ppEnabledLayerNames = nullptr;
+
+    #ifdef _DEBUG
+        // CI machines usually run without the Vulkan SDK layers
+        if (CheckLayerSupported(instanceLayers[0]))
+        {
+            instanceInfo.enabledLayerCount = Countof(instanceLayers);
+            instanceInfo.ppEnabledLayerNames = instanceLayers;
+        }
+        else
+        {
+            logger.OutputDebug(LOG_LEVEL_WARN, format("{} not found\n", instanceLayers[0]));
+        }
+    #endif
+
+        VkThrowIfFailed(vkCreateInstance(&instanceInfo, nullptr, &instance));
+
+    #ifdef _DEBUG
+        validationLayer->Initialize(instance, &logger);
+    #endif
+
+        // ---------------------------------------------------
+        // Surface
+        // ---------------------------------------------------
+
+        CreateSurface(window);
+
+        // ---------------------------------------------------
+        // Physical Device and Queue Family
+        // ---------------------------------------------------
+
+        uint32 gpuCount{};
+        VkThrowIfFailed(vkEnumeratePhysicalDevices(instance, &gpuCount, nullptr));
+        VkThrowIfError(VK_ERROR_INITIALIZATION_FAILED, gpuCount == 0)
+
+        vector<VkPhysicalDevice> gpus(gpuCount);
+        VkThrowIfFailed(vkEnumeratePhysicalDevices(instance, &gpuCount, gpus.data()));
+
+        // the first adapter with a queue that draws and presents to the window,
+        // software adapters like lavapipe are used only when nothing else is found
+        bool found = false;
+        bool software = false;
+        for (size_t i = 0; i < gpuCount && (!found || software); ++i)
+        {
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(gpus[i], &deviceProperties);
+            const bool cpu = deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+
+            if (found && cpu)
+                continue;
+
+            uint32 queueFamilyCount{};
+            vkGetPhysicalDeviceQueueFamilyProperties(gpus[i], &queueFamilyCount, nullptr);
+
+            vector<VkQueueFamilyProperties> queueProperties(queueFamilyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(gpus[i], &queueFamilyCount, queueProperties.data());
+
+            for (uint32 j = 0; j < queueFamilyCount; ++j)
+            {
+                VkBool32 presentSupport = false;
+                vkGetPhysicalDeviceSurfaceSupportKHR(gpus[i], j, surface, &presentSupport);
+
+                if ((queueProperties[j].queueFlags & VK_QUEUE_GRAPHICS_BIT) && presentSupport)
+                {
+                    physicalDevice = gpus[i];
+                    queueFamilyIndex = j;
+                    timestampBits = queueProperties[j].timestampValidBits;
+                    found = true;
+                    software = cpu;
+                    break;
+                }
+            }
+        }
+
+        VkThrowIfError(VK_ERROR_FEATURE_NOT_PRESENT, !found)
+
+    #ifdef _DEBUG
+        LogHardwareInfo();
+    #endif
+
+        float queuePriorities { 1.0f };
+        VkDeviceQueueCreateInfo queueInfo{};
+        queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueInfo.pNext = nullptr;
+        queueInfo.queueCount = 1;
+        queueInfo.pQueuePriorities = &queuePriorities;
+        queueInfo.queueFamilyIndex = queueFamilyIndex;
+
+        // ---------------------------------------------------
+        // Logical Device
+        // ---------------------------------------------------
+
+        uint32 extensionCount{};
+        VkThrowIfFailed(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr));
+
+        vector<VkExtensionProperties> supportedExtensions(extensionCount);
+        VkThrowIfFailed(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, supportedExtensions.data()));
+
+        // the memory allocator keeps new blocks inside the heap budgets when it can read them
+        const bool memoryBudget = CheckExtensionSupported(supportedExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+        vector<const char*> deviceExtensions { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+        if (memoryBudget)
+            deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+        // the render graph records its barriers with synchronization2 and its passes with
+        // dynamic rendering, the descriptor heap needs descriptor indexing
+        VkPhysicalDeviceVulkan12Features supported12{};
+        supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        VkPhysicalDeviceVulkan13Features supported13{};
+        supported13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+        VkPhysicalDeviceFeatures2 supportedFeatures{};
+        supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures.pNext = &supported12;
+
+        VkPhysicalDeviceProperties physicalProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &physicalProperties);
+        if (physicalProperties.apiVersion >= VK_API_VERSION_1_3)
+            supported12.pNext = &supported13;
+        if (physicalProperties.apiVersion >= VK_API_VERSION_1_2)
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures);
+
+        renderGraphSupport = supported13.dynamicRendering && supported13.synchronization2;
+
+        bindlessSupport = supported12.runtimeDescriptorArray
+            && supported12.descriptorBindingPartiallyBound
+            && supported12.descriptorBindingSampledImageUpdateAfterBind
+            && supported12.descriptorBindingStorageBufferUpdateAfterBind
+            && supported12.descriptorBindingUpdateUnusedWhilePending
+            && supported12.shaderSampledImageArrayNonUniformIndexing;
+
+        VkPhysicalDeviceVulkan13Features features13{};
+        features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        features13.dynamicRendering = VK_TRUE;
+        features13.synchronization2 = VK_TRUE;
+
+        VkPhysicalDeviceVulkan12Features features12{};
+        features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        features12.runtimeDescriptorArray = VK_TRUE;
+        features12.descriptorBindingPartiallyBound = VK_TRUE;
+        features12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        features12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        features12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
+        void * enabledFeatures = nullptr;
+        if (renderGraphSupport)
+        {
+            features13.pNext = enabledFeatures;
+            enabledFeatures = &features13;
+        }
+        if (bindlessSupport)
+        {
+            features12.pNext = enabledFeatures;
+            enabledFeatures = &features12;
+        }
+
+        VkDeviceCreateInfo deviceInfo{};
+        deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceInfo.pNext = enabledFeatures;
+        deviceInfo.queueCreateInfoCount = 1;
+        deviceInfo.pQueueCreateInfos = &queueInfo;
+        deviceInfo.enabledExtensionCount = static_cast<uint32>(deviceExtensions.size());
+        deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        deviceInfo.enabledLayerCount = 0;
+        deviceInfo.ppEnabledLayerNames = nullptr;
+        deviceInfo.pEnabledFeatures = nullptr;
+
+        VkThrowIfFailed(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device));
+
+        allocator->Initialize(physicalDevice, device, memoryBudget);
+
+        LoadPipelineCache();
+
+        // ---------------------------------------------------
+        // Surface Format
+        // ---------------------------------------------------
+
+        uint32 surfaceFormatCount{};
+        vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &surfaceFormatCount, nullptr);
+
+        vector<VkSurfaceFormatKHR> surfaceFormats(surfaceFormatCount);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &surfaceFormatCount, surfaceFormats.data());
+
+        surfaceFormat = surfaceFormats[0];
+        for (size_t i = 0; i < surfaceFormatCount; ++i)
+        {
+            if (surfaceFormats[i].format == VK_FORMAT_B8G8R8A8_UNORM &&
+                surfaceFormats[i].colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+            {
+                surfaceFormat = surfaceFormats[i];
+                break;
+            }
+        }
+
+        // ---------------------------------------------------
+        // Command Buffers and Command Pool
+        // ---------------------------------------------------
+
+        VkCommandPoolCreateInfo cmdPoolCreateInfo{};
+        cmdPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        cmdPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        cmdPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+
+        VkThrowIfFailed(vkCreateCommandPool(device, &cmdPoolCreateInfo, nullptr, &commandPool));
+
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+        commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        commandBufferAllocateInfo.commandPool = commandPool;
+        commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        commandBufferAllocateInfo.commandBufferCount = 1;
+
+        VkThrowIfFailed(vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &copyCommandBuffer));
+
+        // ---------------------------------------------------
+        // Renderpass
+        // ---------------------------------------------------
+
+        VkAttachmentDescription attachmentDescription{};
+        attachmentDescription.format = surfaceFormat.format;
+        attachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
+        attachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachmentDescription.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkAttachmentReference colorAttachmentReference{};
+        colorAttachmentReference.attachment = 0;
+        colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subPassDescription{};
+        subPassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subPassDescription.colorAttachmentCount = 1;
+        subPassDescription.pColorAttachments = &colorAttachmentReference;
+
+        VkSubpassDependency subpassDependencies[2]{};
+        subpassDependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        subpassDependencies[0].dstSubpass = 0;
+        subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        subpassDependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        subpassDependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        subpassDependencies[0].dependencyFlags = 0;
+
+        // the final layout transition has to finish before the barriers
+        // of a render graph executed after the pass
+        subpassDependencies[1].srcSubpass = 0;
+        subpassDependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        subpassDependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        subpassDependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        subpassDependencies[1].dstAccessMask = 0;
+        subpassDependencies[1].dependencyFlags = 0;
+
+        VkRenderPassCreateInfo renderPassCreateInfo{};
+        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassCreateInfo.attachmentCount = 1;
+        renderPassCreateInfo.pAttachments = &attachmentDescription;
+        renderPassCreateInfo.subpassCount = 1;
+        renderPassCreateInfo.pSubpasses = &subPassDescription;
+        renderPassCreateInfo.dependencyCount = 2;
+        renderPassCreateInfo.pDependencies = subpassDependencies;
+
+        VkThrowIfFailed(vkCreateRenderPass(device, &renderPassCreateInfo, nullptr, &renderPass));
+
+        // keeps what was drawn before it, used by Record; only the load op and the
+        // initial layout may differ or the framebuffers would not be compatible with it
+        attachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkThrowIfFailed(vkCreateRenderPass(device, &renderPassCreateInfo, nullptr, &renderPassLoad));
+
+        // ---------------------------------------------------
+        // Fence, Semaphores and Queue
+        // ---------------------------------------------------
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        // each frame records into its own pool, so resetting it never waits on the GPU
+        frames = new FrameResources[frameCount] {};
+        for (uint32 i = 0; i < frameCount; ++i)
+        {
+            VkCommandPoolCreateInfo framePoolCreateInfo{};
+            framePoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            framePoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            framePoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+
+            VkThrowIfFailed(vkCreateCommandPool(device, &framePoolCreateInfo, nullptr, &frames[i].commandPool));
+
+            VkCommandBufferAllocateInfo frameAllocateInfo{};
+            frameAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            frameAllocateInfo.commandPool = frames[i].commandPool;
+            frameAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            frameAllocateInfo.commandBufferCount = 2;
+
+            VkCommandBuffer frameCommandBuffers[2];
+            VkThrowIfFailed(vkAllocateCommandBuffers(device, &frameAllocateInfo, frameCommandBuffers));
+            frames[i].commandBuffer = frameCommandBuffers[0];
+            frames[i].uploadCommandBuffer = frameCommandBuffers[1];
+
+            VkThrowIfFailed(vkCreateFence(device, &fenceInfo, nullptr, &frames[i].fence));
+            VkThrowIfFailed(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &frames[i].imageAvailable));
+        }
+
+        vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+
+        // ---------------------------------------------------
+        // Timestamp Queries
+        // ---------------------------------------------------
+
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        timestampPeriod = deviceProperties.limits.timestampPeriod;
+
+        // queues without timestamp support leave the pools null and profile the CPU only
+        if (timestampBits > 0)
+        {
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = 2 + 2 * MAX_GPU_SCOPES;
+
+            for (uint32 i = 0; i < frameCount; ++i)
+                VkThrowIfFailed(vkCreateQueryPool(device, &queryPoolInfo, nullptr, &frames[i].queryPool));
+
+            timestamps.resize(queryPoolInfo.queryCount);
+        }
+
+        // ---------------------------------------------------
+        // Staging Ring
+        // ---------------------------------------------------
+
+        Allocate(
+            stagingSize,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            &stagingBuffer,
+            &stagingAllocation
+        );
+
+        stagingData = stagingAllocation.mapped;
+
+        // only waited on when the ring fills up with uploads no frame has submitted yet
+        VkFenceCreateInfo copyFenceInfo{};
+        copyFenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        VkThrowIfFailed(vkCreateFence(device, &copyFenceInfo, nullptr, &copyFence));
+
+        // ---------------------------------------------------
+        // Descriptor Heap and Uniform Ring
+        // ---------------------------------------------------
+
+        descriptorHeap->Initialize(physicalDevice, device, bindlessSupport);
+
+        VkPhysicalDeviceProperties uniformProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &uniformProperties);
+        uniformAlignment = uniformProperties.limits.minUniformBufferOffsetAlignment;
+        uniformRange = std::min<VkDeviceSize>(65536, uniformProperties.limits.maxUniformBufferRange);
+        uniformSize = (uniformSize + uniformAlignment - 1) / uniformAlignment * uniformAlignment;
+
+        // one slice per frame in flight, the range past the last slice keeps every binding inside the buffer
+        Allocate(
+            frameCount * uniformSize + uniformRange,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            &uniformBuffer,
+            &uniformAllocation
+        );
+
+        VkDescriptorSetLayoutBinding uniformBinding{};
+        uniformBinding.binding = 0;
+        uniformBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        uniformBinding.descriptorCount = 1;
+        uniformBinding.stageFlags = VK_SHADER_STAGE_ALL;
+
+        VkDescriptorSetLayoutCreateInfo uniformLayoutInfo{};
+        uniformLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        uniformLayoutInfo.bindingCount = 1;
+        uniformLayoutInfo.pBindings = &uniformBinding;
+
+        VkThrowIfFailed(vkCreateDescriptorSetLayout(device, &uniformLayoutInfo, nullptr, &uniformLayout));
+
+        const VkDescriptorPoolSize uniformPoolSize { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 };
+
+        VkDescriptorPoolCreateInfo uniformPoolInfo{};
+        uniformPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        uniformPoolInfo.maxSets = 1;
+        uniformPoolInfo.poolSizeCount = 1;
+        uniformPoolInfo.pPoolSizes = &uniformPoolSize;
+
+        VkThrowIfFailed(vkCreateDescriptorPool(device, &uniformPoolInfo, nullptr, &uniformPool));
+
+        VkDescriptorSetAllocateInfo uniformSetInfo{};
+        uniformSetInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        uniformSetInfo.descriptorPool = uniformPool;
+        uniformSetInfo.descriptorSetCount = 1;
+        uniformSetInfo.pSetLayouts = &uniformLayout;
+
+        VkThrowIfFailed(vkAllocateDescriptorSets(device, &uniformSetInfo, &uniformSet));
+
+        VkDescriptorBufferInfo uniformBufferInfo{ uniformBuffer, 0, uniformRange };
+
+        VkWriteDescriptorSet uniformWrite{};
+        uniformWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        uniformWrite.dstSet = uniformSet;
+        uniformWrite.dstBinding = 0;
+        uniformWrite.descriptorCount = 1;
+        uniformWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        uniformWrite.pBufferInfo = &uniformBufferInfo;
+
+        vkUpdateDescriptorSets(device, 1, &uniformWrite, 0, nullptr);
+
+        const VkDescriptorSetLayout setLayouts[] { descriptorHeap->Layout(), uniformLayout };
+        const VkPushConstantRange pushConstants { VK_SHADER_STAGE_ALL, 0, MAX_PUSH_CONSTANTS };
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = Countof(setLayouts);
+        pipelineLayoutInfo.pSetLayouts = setLayouts;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstants;
+
+        VkThrowIfFailed(vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout));
+
+        // ---------------------------------------------------
+        // Swapchain
+        // ---------------------------------------------------
+
+        requestedExtent = { uint32(window->Width()), uint32(window->Height()) };
+        VkThrowIfError(VK_ERROR_INITIALIZATION_FAILED, !CreateSwapchain())
+
+        // ---------------------------------------------------
+        // Backbuffer Background Color
+        // ---------------------------------------------------
+
+        // the window color as a 0xRRGGBB pixel
+    #if defined(VK_USE_PLATFORM_WIN32_KHR)
+        const COLORREF colorRef = window->Color();
+        const uint32 color = (uint32(GetRValue(colorRef)) << 16) | (uint32(GetGValue(colorRef)) << 8) | GetBValue(colorRef);
+    #elif defined(VK_USE_PLATFORM_XLIB_KHR)
+        const uint32 color = static_cast<uint32>(window->Color().pixel);
+    #else
+        const uint32 color = static_cast<uint32>(window->Color());
+    #endif
+
+        bgColor.float32[0] = ((color >> 16) & 0xff) / 255.0f;
+        bgColor.float32[1] = ((color >> 8) & 0xff) / 255.0f;
+        bgColor.float32[2] = (color & 0xff) / 255.0f;
+        bgColor.float32[3] = 1.0f;
+    }
+
+    bool Graphics::CreateSwapchain()
+    {
+        VkSurfaceCapabilitiesKHR surfaceCapabilities{};
+        VkThrowIfFailed(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &surfaceCapabilities));
+
+        // X11 and Win32 report the window size, Wayland lets the swapchain decide it
+        VkExtent2D extent = surfaceCapabilities.currentExtent;
+        if (extent.width == UINT32_MAX)
+        {
+            extent.width = std::clamp(requestedExtent.width,
+                surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width);
+            extent.height = std::clamp(requestedExtent.height,
+                surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height);
+        }
+
+        // nothing to render to until the window gets an area again
+        if (extent.width == 0 || extent.height == 0)
+            return false;
+
+        uint32 presentModeCount{};
+        vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, nullptr);
+
+        vector<VkPresentModeKHR> presentModes(presentModeCount);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, presentModes.data());
+
+        auto presentModeSupported = [&presentModes](const VkPresentModeKHR mode) {
+            return std::ranges::find(presentModes, mode) != presentModes.end();
+        };
+
+        // FIFO is the only mode every driver has, Wayland compositors usually lack IMMEDIATE.
+        // Without vSync MAILBOX replaces the queued image instead of tearing; with vSync and
+        // low latency FIFO_RELAXED shows a late frame at once instead of a refresh later
+        presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        if (!vSync)
+        {
+            if (presentModeSupported(VK_PRESENT_MODE_MAILBOX_KHR))
+                presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            else if (presentModeSupported(VK_PRESENT_MODE_IMMEDIATE_KHR))
+                presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            else if (presentModeSupported(VK_PRESENT_MODE_FIFO_RELAXED_KHR))
+                presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        }
+        else if (lowLatency && presentModeSupported(VK_PRESENT_MODE_FIFO_RELAXED_KHR))
+        {
+            presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        }
+
+        VkSurfaceTransformFlagBitsKHR preTransform{};
+        if (surfaceCapabilities.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
+            preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+        else
+            preTransform = surfaceCapabilities.currentTransform;
+
+        // every image past the minimum is one more frame the presentation engine can queue
+        uint32 imageCount = surfaceCapabilities.minImageCount + (lowLatency ? 0 : 1);
+        if (surfaceCapabilities.maxImageCount != 0 && imageCount > surfaceCapabilities.maxImageCount)
+            imageCount = surfaceCapabilities.maxImageCount;
+
+        VkCompositeAlphaFlagBitsKHR compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        if (!(surfaceCapabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR))
+            compositeAlpha = VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR;
+
+        const VkSwapchainKHR oldSwapchain = swapchain;
+
+        VkSwapchainCreateInfoKHR swapChainCreateInfo{};
+        swapChainCreateInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+        swapChainCreateInfo.pNext = nullptr;
+        swapChainCreateInfo.surface = surface;
+        swapChainCreateInfo.minImageCount = imageCount;
+        swapChainCreateInfo.imageFormat = surfaceFormat.format;
+        swapChainCreateInfo.imageColorSpace = surfaceFormat.colorSpace;
+        swapChainCreateInfo.imageExtent = extent;
+        swapChainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        swapChainCreateInfo.preTransform = preTransform;
+        swapChainCreateInfo.imageArrayLayers = 1;
+        swapChainCreateInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        swapChainCreateInfo.presentMode = presentMode;
+        swapChainCreateInfo.clipped = true;
+        swapChainCreateInfo.compositeAlpha = compositeAlpha;
+        swapChainCreateInfo.queueFamilyIndexCount = 1;
+        swapChainCreateInfo.pQueueFamilyIndices = &queueFamilyIndex;
+        swapChainCreateInfo.oldSwapchain = oldSwapchain;
+
+        VkThrowIfFailed(vkCreateSwapchainKHR(device, &swapChainCreateInfo, nullptr, &swapchain));
+
+        // frames in flight may still render to the old images, so they are
+        // destroyed later instead of waiting for the device to go idle
+        if (oldSwapchain)
+            retiredSwapchains.push_back({ oldSwapchain, buffers, backBufferCount, frameNumber });
+
+        // VkImage
+        VkThrowIfFailed(vkGetSwapchainImagesKHR(device, swapchain, &backBufferCount, nullptr));
+
+        vector<VkImage> swapchainImages(backBufferCount);
+        VkThrowIfFailed(vkGetSwapchainImagesKHR(device, swapchain, &backBufferCount, swapchainImages.data()));
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        buffers = new SwapchainBuffer[backBufferCount] {};
+        for (uint32 i = 0; i < backBufferCount; ++i)
+        {
+            buffers[i].image = swapchainImages[i];
+
+            // VkImageView
+            VkImageViewCreateInfo colorImageView{};
+            colorImageView.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            colorImageView.pNext = nullptr;
+            colorImageView.flags = 0;
+            colorImageView.image = buffers[i].image;
+            colorImageView.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            colorImageView.format = surfaceFormat.format;
+            colorImageView.components.r = VK_COMPONENT_SWIZZLE_R;
+            colorImageView.components.g = VK_COMPONENT_SWIZZLE_G;
+            colorImageView.components.b = VK_COMPONENT_SWIZZLE_B;
+            colorImageView.components.a = VK_COMPONENT_SWIZZLE_A;
+            colorImageView.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            colorImageView.subresourceRange.baseMipLevel = 0;
+            colorImageView.subresourceRange.levelCount = 1;
+            colorImageView.subresourceRange.baseArrayLayer = 0;
+            colorImageView.subresourceRange.layerCount = 1;
+
+            VkThrowIfFailed(vkCreateImageView(device, &colorImageView, nullptr, &buffers[i].view));
+
+            // VkFramebuffer
+            VkFramebufferCreateInfo framebufferCreateInfo{};
+            framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferCreateInfo.renderPass = renderPass;
+            framebufferCreateInfo.attachmentCount = 1;
+            framebufferCreateInfo.pAttachments = &buffers[i].view;
+            framebufferCreateInfo.width = extent.width;
+            framebufferCreateInfo.height = extent.height;
+            framebufferCreateInfo.layers = 1;
+
+            VkThrowIfFailed(vkCreateFramebuffer(device, &framebufferCreateInfo, nullptr, &buffers[i].framebuffer));
+
+            // a render finished semaphore per image, present may still be waiting
+            // on it when the same frame slot comes around again
+            VkThrowIfFailed(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &buffers[i].renderFinished));
+        }
+
+        viewport.x = 0;
+        viewport.y = 0;
+        viewport.width = static_cast<float>(extent.width);
+        viewport.height = static_cast<float>(extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        scissorRect = { 0, 0, extent.width, extent.height };
+
+        swapchainDirty = false;
+        return true;
+    }
+
+    void Graphics::DestroySwapchain(const RetiredSwapchain & retired)
+    {
+        for (uint32 i = 0; i < retired.count && retired.buffers; ++i)
+        {
+            vkDestroySemaphore(device, retired.buffers[i].renderFinished, nullptr);
+            vkDestroyFramebuffer(device, retired.buffers[i].framebuffer, nullptr);
+            vkDestroyImageView(device, retired.buffers[i].view, nullptr);
+        }
+        delete[] retired.buffers;
+
+        vkDestroySwapchainKHR(device, retired.swapchain, nullptr);
+    }
+
+    void Graphics::ReleaseSwapchains()
+    {
+        // once a frame slot's fence signals, every frame up to frameNumber - frameCount is done
+        while (!retiredSwapchains.empty() && retiredSwapchains.front().frame + frameCount <= frameNumber + 1)
+        {
+            DestroySwapchain(retiredSwapchains.front());
+            retiredSwapchains.erase(retiredSwapchains.begin());
+        }
+    }
+
+    void Graphics::ReleasePipelines()
+    {
+        auto done = [this](const RetiredPipeline & retired)
+        {
+            if (retired.frame > frameNumber)
+                return false;
+
+            vkDestroyPipeline(device, retired.pipeline, nullptr);
+            return true;
+        };
+
+        retiredPipelines.erase(std::remove_if(retiredPipelines.begin(), retiredPipelines.end(), done), retiredPipelines.end());
+    }
+
+    bool Graphics::Clear()
+    {
+        FrameResources & frame = frames[frameIndex];
+
+        // only waits when the GPU is frameCount frames behind
+        VkThrowIfFailed(vkWaitForFences(device, 1, &frame.fence, true, UINT64_MAX));
+        stagingTail = std::max(stagingTail, frame.stagingEnd);
+        ReadTimestamps(frame);
+        ReleaseSwapchains();
+        ReleasePipelines();
+        descriptorHeap->Recycle(frameNumber);
+        uniformHead = 0;
+
+        // low latency keeps at most one frame queued on the GPU
+        if (lowLatency && frameCount > 1)
+        {
+            FrameResources & previous = frames[(frameIndex + frameCount - 1) % frameCount];
+            VkThrowIfFailed(vkWaitForFences(device, 1, &previous.fence, true, UINT64_MAX));
+        }
+
+        if (swapchainDirty && !CreateSwapchain())
+            return false;
+
+        VkResult result = vkAcquireNextImageKHR(
+            device,
+            swapchain,
+            UINT64_MAX,
+            frame.imageAvailable,
+            nullptr,
+            &backBufferIndex
+        );
+
+        // the semaphore is left unsignaled, so the acquire can be retried on the new swapchain
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            swapchainDirty = true;
+            if (!CreateSwapchain())
+                return false;
+
+            result = vkAcquireNextImageKHR(
+                device,
+                swapchain,
+                UINT64_MAX,
+                frame.imageAvailable,
+                nullptr,
+                &backBufferIndex
+            );
+        }
+
+        // a suboptimal image still presents, the swapchain is replaced before the next frame
+        if (result == VK_SUBOPTIMAL_KHR)
+            swapchainDirty = true;
+        else
+            VkThrowIfFailed(result);
+
+        // the image can still be in use by another frame when the swapchain
+        // hands images out of order or has fewer images than frames in flight
+        SwapchainBuffer & backBuffer = buffers[backBufferIndex];
+        if (backBuffer.fence && backBuffer.fence != frame.fence)
+            VkThrowIfFailed(vkWaitForFences(device, 1, &backBuffer.fence, true, UINT64_MAX));
+        backBuffer.fence = frame.fence;
+
+        VkThrowIfFailed(vkResetFences(device, 1, &frame.fence));
+        VkThrowIfFailed(vkResetCommandPool(device, frame.commandPool, 0));
+
+        for (CommandRecorder & recorder : frame.recorders)
+        {
+            VkThrowIfFailed(vkResetCommandPool(device, recorder.commandPool, 0));
+            recorder.used = 0;
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkThrowIfFailed(vkBeginCommandBuffer(frame.commandBuffer, &beginInfo));
+
+        // queries are reset outside the render pass, before the first timestamp
+        frame.scopeCount = 0;
+        if (profiler && frame.queryPool)
+        {
+            vkCmdResetQueryPool(frame.commandBuffer, frame.queryPool, 0, 2 + 2 * MAX_GPU_SCOPES);
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, 0);
+            frame.profileFrame = profiler->Frame();
+            frame.queryCount = 2;
+        }
+
+        vkCmdSetViewport(frame.commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(frame.commandBuffer, 0, 1, &scissorRect);
+
+        BeginRenderPass(renderPass, VK_SUBPASS_CONTENTS_INLINE);
+        return true;
+    }
+
+    void Graphics::BeginRenderPass(VkRenderPass pass, const VkSubpassContents contents)
+    {
+        VkClearValue clearValue{};
+        clearValue.color = bgColor;
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = pass;
+        renderPassInfo.framebuffer = buffers[backBufferIndex].framebuffer;
+        renderPassInfo.renderArea = scissorRect;
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearValue;
+        vkCmdBeginRenderPass(frames[frameIndex].commandBuffer, &renderPassInfo, contents);
+    }
+
+    void Graphics::Record(ThreadPool * threadPool, const uint32 count, const uint32 grain,
+        const std::function<void(VkCommandBuffer, uint32, uint32)> & record)
+    {
+        if (count == 0)
+            return;
+
+        FrameResources & frame = frames[frameIndex];
+        const uint32 step = std::max(1U, grain);
+        const uint32 chunks = (count + step - 1) / step;
+
+        // command pools are externally synchronized, so every thread that can
+        // run a chunk records from a pool of its own, indexed by ThreadIndex
+        const uint32 threads = threadPool->Size() + 1;
+        while (frame.recorders.size() < threads)
+        {
+            VkCommandPoolCreateInfo poolCreateInfo{};
+            poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+
+            CommandRecorder recorder{};
+            VkThrowIfFailed(vkCreateCommandPool(device, &poolCreateInfo, nullptr, &recorder.commandPool));
+            frame.recorders.push_back(std::move(recorder));
+        }
+
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = renderPassLoad;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = buffers[backBufferIndex].framebuffer;
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        secondaries.resize(chunks);
+
+        // workers must not throw, the first failure is rethrown below
+        std::atomic<int32> failure{ VK_SUCCESS };
+
+        threadPool->ParallelFor(count, step, [&](const uint32 begin, const uint32 end)
+        {
+            CommandRecorder & recorder = frame.recorders[ThreadPool::ThreadIndex()];
+            VkResult result = VK_SUCCESS;
+
+            if (recorder.used == recorder.commandBuffers.size())
+            {
+                VkCommandBufferAllocateInfo allocateInfo{};
+                allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                allocateInfo.commandPool = recorder.commandPool;
+                allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+                allocateInfo.commandBufferCount = 1;
+
+                VkCommandBuffer commandBuffer{};
+                result = vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer);
+                if (result == VK_SUCCESS)
+                    recorder.commandBuffers.push_back(commandBuffer);
+            }
+
+            if (result == VK_SUCCESS)
+            {
+                VkCommandBuffer commandBuffer = recorder.commandBuffers[recorder.used++];
+                result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+                if (result == VK_SUCCESS)
+                {
+                    // dynamic state is not inherited from the primary command buffer
+                    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+                    vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+                    record(commandBuffer, begin, end);
+                    result = vkEndCommandBuffer(commandBuffer);
+                }
+
+                secondaries[begin / step] = commandBuffer;
+            }
+
+            if (result != VK_SUCCESS)
+            {
+                int32 expected = VK_SUCCESS;
+                failure.compare_exchange_strong(expected, result);
+            }
+        });
+
+        VkThrowIfFailed(static_cast<VkResult>(failure.load()));
+
+        // secondaries need a render pass instance begun for them alone, the load
+        // pass keeps what was recorded inline before and after the chunks
+        VkCommandBuffer commandBuffer = frame.commandBuffer;
+        vkCmdEndRenderPass(commandBuffer);
+        BeginRenderPass(renderPassLoad, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        vkCmdExecuteCommands(commandBuffer, chunks, secondaries.data());
+        vkCmdEndRenderPass(commandBuffer);
+        BeginRenderPass(renderPassLoad, VK_SUBPASS_CONTENTS_INLINE);
+
+        // executing secondaries leaves the dynamic state of the primary undefined
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+    }
+
+    uint32 Graphics::AddTexture(VkImageView view, VkSampler sampler)
+    {
+        return descriptorHeap->AddTexture(view, sampler);
+    }
+
+    uint32 Graphics::AddBuffer(VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize range)
+    {
+        return descriptorHeap->AddBuffer(buffer, offset, range);
+    }
+
+    void Graphics::RemoveTexture(const uint32 index)
+    {
+        descriptorHeap->Remove(HEAP_TEXTURES, index, frameNumber + frameCount);
+    }
+
+    void Graphics::RemoveBuffer(const uint32 index)
+    {
+        descriptorHeap->Remove(HEAP_BUFFERS, index, frameNumber + frameCount);
+    }
+
+    UniformAllocation Graphics::Uniform(const VkDeviceSize size)
+    {
+        const VkDeviceSize offset = (uniformHead + uniformAlignment - 1) / uniformAlignment * uniformAlignment;
+
+        VkThrowIfErrorMessage(VK_ERROR_OUT_OF_DEVICE_MEMORY, size > uniformRange || offset + size > uniformSize,
+            "the frame's uniform ring is full, raise it with Graphics::UniformSize");
+
+        uniformHead = offset + size;
+
+        const VkDeviceSize start = frameIndex * uniformSize + offset;
+        return { uniformAllocation.mapped + start, static_cast<uint32>(start) };
+    }
+
+    void Graphics::BindResources(VkCommandBuffer commandBuffer, const uint32 uniformOffset, const VkPipelineBindPoint bindPoint) const
+    {
+        const VkDescriptorSet sets[] { descriptorHeap->Set(), uniformSet };
+
+        // without descriptor indexing the heap set is empty and left unbound
+        const uint32 first = sets[0] ? 0 : 1;
+        vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, first, Countof(sets) - first, sets + first, 1, &uniformOffset);
+    }
+
+    void Graphics::Execute(RenderGraph & graph)
+    {
+        // the graph places its own barriers and passes, the frame's render pass
+        // is closed around it and continued with the load pass afterwards
+        VkCommandBuffer commandBuffer = frames[frameIndex].commandBuffer;
+        vkCmdEndRenderPass(commandBuffer);
+        graph.Execute(commandBuffer, buffers[backBufferIndex], frameNumber);
+        BeginRenderPass(renderPassLoad, VK_SUBPASS_CONTENTS_INLINE);
+
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+    }
+
+    void Graphics::Present()
+    {
+        FrameResources & frame = frames[frameIndex];
+        VkSemaphore renderFinished = buffers[backBufferIndex].renderFinished;
+
+        vkCmdEndRenderPass(frame.commandBuffer);
+
+        if (frame.queryCount)
+        {
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.queryPool, 1);
+            frame.queryCount = 2 + 2 * frame.scopeCount;
+        }
+
+        VkThrowIfFailed(vkEndCommandBuffer(frame.commandBuffer));
+
+        // uploads queued since the last frame go in the same submission, ahead of the draws
+        VkCommandBuffer commandBuffers[2];
+        uint32 commandBufferCount = 0;
+
+        if (!uploadTargets.empty() || !imageUploads.empty())
+        {
+            RecordUploads(frame.uploadCommandBuffer);
+            commandBuffers[commandBufferCount++] = frame.uploadCommandBuffer;
+        }
+        commandBuffers[commandBufferCount++] = frame.commandBuffer;
+        frame.stagingEnd = stagingHead;
+
+        const VkPipelineStageFlags waitStages[]
+        { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &frame.imageAvailable;
+        submitInfo.pWaitDstStageMask = waitStages;
+        submitInfo.commandBufferCount = commandBufferCount;
+        submitInfo.pCommandBuffers = commandBuffers;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &renderFinished;
+
+        VkThrowIfFailed(vkQueueSubmit(queue, 1, &submitInfo, frame.fence));
+
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &renderFinished;
+        presentInfo.swapchainCount = 1;
+        presentInfo.pSwapchains = &swapchain;
+        presentInfo.pImageIndices = &backBufferIndex;
+
+        const VkResult result = vkQueuePresentKHR(queue, &presentInfo);
+
+        frameIndex = (frameIndex + 1) % frameCount;
+        ++frameNumber;
+
+        // the frame was submitted either way, the swapchain is replaced before the next one
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+            swapchainDirty = true;
+        else
+            VkThrowIfFailed(result);
+    }
+
+    void Graphics::Profile(Profiler * profiler) noexcept
+    {
+        if (this->profiler)
+            this->profiler->GpuResolved(false);
+
+        this->profiler = profiler;
+
+        // reports wait for the GPU only when there are queries to read it from
+        if (profiler && frames && frames[0].queryPool)
+            profiler->GpuResolved(true);
+    }
+
+    uint32 Graphics::BeginScope(const char * name)
+    {
+        FrameResources & frame = frames[frameIndex];
+
+        if (!profiler || frame.scopeCount == MAX_GPU_SCOPES)
+            return MAX_GPU_SCOPES;
+
+        const uint32 scope = frame.scopeCount++;
+        frame.scopes[scope] = profiler->Begin(name);
+
+        if (frame.queryCount)
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, 2 + 2 * scope);
+
+        return scope;
+    }
+
+    void Graphics::EndScope(const uint32 scope)
+    {
+        FrameResources & frame = frames[frameIndex];
+
+        if (!profiler || scope >= frame.scopeCount)
+            return;
+
+        if (frame.queryCount)
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.queryPool, 3 + 2 * scope);
+
+        profiler->End(frame.scopes[scope]);
+    }
+
+    void Graphics::ReadTimestamps(FrameResources & frame)
+    {
+        const uint32 queryCount = frame.queryCount;
+        frame.queryCount = 0;
+
+        if (!profiler || queryCount == 0)
+            return;
+
+        // the frame fence has signaled, so the results are read without waiting,
+        // a scope left open keeps its query unavailable and the frame is dropped
+        const VkResult result = vkGetQueryPoolResults(
+            device,
+            frame.queryPool,
+            0,
+            queryCount,
+            queryCount * sizeof(uint64),
+            timestamps.data(),
+            sizeof(uint64),
+            VK_QUERY_RESULT_64_BIT
+        );
+
+        if (result == VK_NOT_READY)
+            return;
+
+        VkThrowIfFailed(result);
+
+        const uint64 mask = timestampBits < 64 ? (uint64(1) << timestampBits) - 1 : ~uint64(0);
+        const double milliseconds = timestampPeriod * 1e-6;
+
+        auto elapsed = [&](const uint32 query) {
+            return double((timestamps[query + 1] - timestamps[query]) & mask) * milliseconds;
+        };
+
+        for (uint32 i = 0; i < frame.scopeCount; ++i)
+            profiler->Gpu(frame.profileFrame, frame.scopes[i], elapsed(2 + 2 * i));
+
+        profiler->Resolve(frame.profileFrame, elapsed(0));
+    }
+
+    void Graphics::Allocate(const VkDeviceSize size,
+        const VkBufferUsageFlags usageFlags,
+        const VkMemoryPropertyFlags properties,
+        VkBuffer* buffer,
+        Allocation* allocation)
+    {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usageFlags;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkThrowIfFailed(vkCreateBuffer(device, &bufferInfo, nullptr, buffer));
+
+        VkMemoryRequirements memRequirements{};
+        vkGetBufferMemoryRequirements(device, *buffer, &memRequirements);
+
+        *allocation = allocator->Allocate(memRequirements, properties, true);
+
+        VkThrowIfFailed(vkBindBufferMemory(device, *buffer, allocation->memory, allocation->offset));
+    }
+
+    void Graphics::Allocate(const VkImageCreateInfo& imageInfo,
+        const VkMemoryPropertyFlags properties,
+        VkImage* image,
+        Allocation* allocation)
+    {
+        VkThrowIfFailed(vkCreateImage(device, &imageInfo, nullptr, image));
+
+        VkMemoryDedicatedRequirements dedicatedRequirements{};
+        dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+
+        VkMemoryRequirements2 memRequirements{};
+        memRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+        memRequirements.pNext = &dedicatedRequirements;
+
+        VkImageMemoryRequirementsInfo2 requirementsInfo{};
+        requirementsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+        requirementsInfo.image = *image;
+
+        vkGetImageMemoryRequirements2(device, &requirementsInfo, &memRequirements);
+
+        // render targets are usually better off with memory of their own
+        VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+        dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+        dedicatedInfo.image = *image;
+
+        const bool dedicated = dedicatedRequirements.prefersDedicatedAllocation
+            || dedicatedRequirements.requiresDedicatedAllocation;
+
+        *allocation = allocator->Allocate(
+            memRequirements.memoryRequirements,
+            properties,
+            imageInfo.tiling == VK_IMAGE_TILING_LINEAR,
+            dedicated ? &dedicatedInfo : nullptr);
+
+        VkThrowIfFailed(vkBindImageMemory(device, *image, allocation->memory, allocation->offset));
+    }
+
+    void Graphics::Free(VkBuffer buffer, Allocation& allocation)
+    {
+        vkDestroyBuffer(device, buffer, nullptr);
+        allocator->Free(allocation);
+    }
+
+    void Graphics::Free(VkImage image, Allocation& allocation)
+    {
+        vkDestroyImage(device, image, nullptr);
+        allocator->Free(allocation);
+    }
+
+    void Graphics::Copy(const void* data, const VkDeviceSize size, const Allocation& allocation)
+    {
+        memcpy(allocation.mapped, data, size);
+    }
+
+    void Graphics::LoadPipelineCache()
+    {
+        const std::filesystem::path path = ExecutablePath(pipelineCachePath);
+        const MappedFile file(path);
+
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+        // drivers may crash on data written by another device or driver version
+        VkPipelineCacheHeaderVersionOne header{};
+        if (file.size >= sizeof(header))
+            memcpy(&header, file.data, sizeof(header));
+
+        const bool valid = file.size >= sizeof(header)
+            && header.headerSize >= sizeof(header)
+            && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header.vendorID == deviceProperties.vendorID
+            && header.deviceID == deviceProperties.deviceID
+            && memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+        if (file.data && !valid)
+            logger.OutputDebug(LOG_LEVEL_WARN, format("---> Pipeline cache {} is stale, starting empty\n", path.string()));
+
+        VkPipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheInfo.initialDataSize = valid ? file.size : 0;
+        cacheInfo.pInitialData = valid ? file.data : nullptr;
+
+        VkThrowIfFailed(vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache));
+    }
+
+    void Graphics::SavePipelineCache() const
+    {
+        size_t size{};
+        if (!pipelineCache || vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+            return;
+
+        vector<char> data(size);
+        if (vkGetPipelineCacheData(device, pipelineCache, &size, data.data()) != VK_SUCCESS)
+            return;
+
+        // written aside and renamed, an interrupted write never leaves half a cache behind
+        const std::filesystem::path path = ExecutablePath(pipelineCachePath);
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), std::streamsize(size));
+        file.close();
+
+        std::error_code error;
+        if (file)
+            std::filesystem::rename(temporary, path, error);
+        else
+            std::filesystem::remove(temporary, error);
+    }
+
+    VkShaderModule Graphics::CreateShaderModule(const string_view path) const
+    {
+        const std::filesystem::path shaderPath = ExecutablePath(path);
+        const MappedFile file(shaderPath);
+
+        if (!file.data)
+            VkThrowIfFailure(VK_ERROR_INITIALIZATION_FAILED, "Shader not found or empty: " + shaderPath.string());
+
+        // mappings are page aligned, as pCode requires
+        VkShaderModuleCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = file.size;
+        createInfo.pCode = static_cast<const uint32*>(file.data);
+
+        VkShaderModule shaderModule;
+        VkThrowIfFailed(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule));
+
+        return shaderModule;
+    }
+
+    VkPipeline Graphics::CreatePipeline(const VkGraphicsPipelineCreateInfo& pipelineInfo) const
+    {
+        // the cache is internally synchronized, concurrent creation is fine
+        VkPipeline pipeline;
+        VkThrowIfFailed(vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline));
+
+        return pipeline;
+    }
+
+    void Graphics::Retire(VkPipeline pipeline)
+    {
+        if (pipeline)
+            retiredPipelines.push_back({ pipeline, frameNumber + frameCount });
+    }
+
+    VkDeviceSize Graphics::Reserve(const VkDeviceSize size)
+    {
+        // aligned regions that never wrap around the end of the buffer
+        VkDeviceSize start = (stagingHead + 15) & ~VkDeviceSize(15);
+        if (start % stagingSize + size > stagingSize)
+            start += stagingSize - start % stagingSize;
+
+        // release the regions of frames still in flight, oldest first
+        for (uint32 i = 0; i < frameCount && start + size - stagingTail > stagingSize; ++i)
+        {
+            FrameResources & frame = frames[(frameIndex + i) % frameCount];
+            if (frame.stagingEnd > stagingTail)
+            {
+                VkThrowIfFailed(vkWaitForFences(device, 1, &frame.fence, true, UINT64_MAX));
+                stagingTail = frame.stagingEnd;
+            }
+        }
+
+        // the rest of the ring holds uploads no frame has submitted yet
+        if (start + size - stagingTail > stagingSize)
+        {
+            FlushUploads();
+            stagingTail = stagingHead + (stagingSize - stagingHead % stagingSize) % stagingSize;
+            start = stagingTail;
+        }
+
+        stagingHead = start + size;
+        return start % stagingSize;
+    }
+
+    void Graphics::RecordUploads(VkCommandBuffer commandBuffer)
+    {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkThrowIfFailed(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+        // the uploads of each texture are gathered, in the order they were staged, so
+        // it enters the transfer layout once per submission: from undefined when it
+        // was created for this one and from the sampled layout otherwise
+        vector<uint32> imageOrder(imageUploads.size());
+        for (uint32 i = 0; i < imageOrder.size(); ++i)
+            imageOrder[i] = i;
+
+        std::stable_sort(imageOrder.begin(), imageOrder.end(), [this](const uint32 a, const uint32 b)
+            { return imageUploads[a].image < imageUploads[b].image; });
+
+        vector<VkImageMemoryBarrier> imageBarriers;
+        for (size_t i = 0; i < imageOrder.size(); ++i)
+        {
+            const ImageUpload & upload = imageUploads[imageOrder[i]];
+            if (i > 0 && upload.image == imageUploads[imageOrder[i - 1]].image)
+            {
+                if (upload.layout == VK_IMAGE_LAYOUT_UNDEFINED)
+                    imageBarriers.back().oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                continue;
+            }
+
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = upload.layout;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = upload.image;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, upload.levelCount, 0, 1 };
+            imageBarriers.push_back(barrier);
+        }
+
+        // frames still in flight may be reading the buffers about to be written
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 0, nullptr, 0, nullptr,
+            static_cast<uint32>(imageBarriers.size()), imageBarriers.data());
+
+        // consecutive uploads to the same buffer become a single copy
+        const size_t count = uploadTargets.size();
+        for (size_t first = 0, last = 1; first < count; first = last++)
+        {
+            while (last < count && uploadTargets[last] == uploadTargets[first]
+                && uploadRegions[last].dstOffset >= uploadRegions[last - 1].dstOffset + uploadRegions[last - 1].size)
+                ++last;
+
+            vkCmdCopyBuffer(commandBuffer, stagingBuffer, uploadTargets[first],
+                static_cast<uint32>(last - first), &uploadRegions[first]);
+        }
+
+        // one copy per texture, split where a region writes rows an earlier region
+        // of the copy also writes, so the later update lands after the first
+        vector<VkBufferImageCopy> regions;
+        for (size_t first = 0, last = 1, group = 0; first < imageOrder.size(); first = last++, ++group)
+        {
+            const VkImage image = imageUploads[imageOrder[first]].image;
+            while (last < imageOrder.size() && imageUploads[imageOrder[last]].image == image)
+                ++last;
+
+            regions.clear();
+            for (size_t i = first; i < last; ++i)
+            {
+                const VkBufferImageCopy & region = imageRegions[imageOrder[i]];
+                if (std::any_of(regions.begin(), regions.end(),
+                    [&region](const VkBufferImageCopy & other) { return Overlaps(region, other); }))
+                {
+                    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32>(regions.size()), regions.data());
+                    regions.clear();
+
+                    VkImageMemoryBarrier barrier = imageBarriers[group];
+                    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+                    vkCmdPipelineBarrier(commandBuffer,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        0, 0, nullptr, 0, nullptr, 1, &barrier);
+                }
+
+                regions.push_back(region);
+            }
+
+            vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32>(regions.size()), regions.data());
+        }
+
+        for (VkImageMemoryBarrier & imageBarrier : imageBarriers)
+        {
+            imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT
+            | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0, 1, &barrier, 0, nullptr,
+            static_cast<uint32>(imageBarriers.size()), imageBarriers.data());
+
+        VkThrowIfFailed(vkEndCommandBuffer(commandBuffer));
+
+        uploadTargets.clear();
+        uploadRegions.clear();
+        imageUploads.clear();
+        imageRegions.clear();
+    }
+
+    void Graphics::FlushUploads()
+    {
+        if (uploadTargets.empty() && imageUploads.empty())
+            return;
+
+        RecordUploads(copyCommandBuffer);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &copyCommandBuffer;
+
+        VkThrowIfFailed(vkQueueSubmit(queue, 1, &submitInfo, copyFence));
+        VkThrowIfFailed(vkWaitForFences(device, 1, &copyFence, true, UINT64_MAX));
+        VkThrowIfFailed(vkResetFences(device, 1, &copyFence));
+    }
+
+    void Graphics::Upload(VkBuffer destination, const void* data, const VkDeviceSize size, const VkDeviceSize offset)
+    {
+        const uint8* source = static_cast<const uint8*>(data);
+
+        // uploads larger than the ring are split
+        for (VkDeviceSize done = 0; done < size;)
+        {
+            const VkDeviceSize chunk = std::min(size - done, stagingSize);
+            const VkDeviceSize position = Reserve(chunk);
+            memcpy(stagingData + position, source + done, chunk);
+
+            uploadTargets.push_back(destination);
+            uploadRegions.push_back({ position, offset + done, chunk });
+            done += chunk;
+        }
+    }
+
+    void Graphics::Upload(Mesh* mesh, const void* vertices, const uint32 vertexCount, const uint32 vertexSize)
+    {
+        mesh->device = device;
+        mesh->allocator = allocator;
+        mesh->vertexCount = static_cast<int32>(vertexCount);
+        mesh->vertexBufferSize = vertexCount * vertexSize;
+
+        Allocate(
+            mesh->vertexBufferSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            &mesh->vertexBuffer,
+            &mesh->vertexBufferMemory
+        );
+
+        Upload(mesh->vertexBuffer, vertices, mesh->vertexBufferSize);
+    }
+
+    void Graphics::Upload(Mesh* mesh, const MeshView& view)
+    {
+        Upload(mesh, view.vertices, view.header->vertexCount, view.header->vertexStride);
+
+        mesh->indexCount = view.header->indexCount;
+        mesh->indexType = view.header->indexSize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        mesh->indexBufferSize = view.header->indexCount * view.header->indexSize;
+
+        if (mesh->indexBufferSize == 0)
+            return;
+
+        Allocate(
+            mesh->indexBufferSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            &mesh->indexBuffer,
+            &mesh->indexBufferMemory
+        );
+
+        Upload(mesh->indexBuffer, view.indices, mesh->indexBufferSize);
+    }
+
+    bool Graphics::Supports(const TextureFormat format, const bool srgb) const
+    {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, TextureFormatOf(format, srgb), &properties);
+        return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    }
+
+    void Graphics::CreateTexture(Texture* texture, const VkFormat format, const uint32 width, const uint32 height, const uint32 levelCount)
+    {
+        texture->device = device;
+        texture->allocator = allocator;
+        texture->format = format;
+        texture->width = width;
+        texture->height = height;
+        texture->levelCount = levelCount;
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = format;
+        imageInfo.extent = { width, height, 1 };
+        imageInfo.mipLevels = levelCount;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        Allocate(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &texture->image, &texture->imageMemory);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = texture->image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = format;
+        viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount, 0, 1 };
+
+        VkThrowIfFailed(vkCreateImageView(device, &viewInfo, nullptr, &texture->view));
+    }
+
+    void Graphics::StageRows(Texture* texture, const uint32 level, const uint8* rows, const VkDeviceSize rowSize,
+        const uint32 firstRow, const uint32 rowCount, const uint32 blockSize, const bool created)
+    {
+        const uint32 width = std::max(1U, texture->width >> level);
+        const uint32 height = std::max(1U, texture->height >> level);
+
+        // rows are never split, a single one has to fit in the ring
+        VkThrowIfErrorMessage(VK_ERROR_OUT_OF_DEVICE_MEMORY, rowSize > stagingSize,
+            format("a texture row of {} bytes is larger than the {} bytes staging ring, raise it with Graphics::StagingSize",
+                rowSize, stagingSize));
+
+        // more rows than the ring holds are split in as many copies as needed
+        const uint32 rowsPerChunk = static_cast<uint32>(stagingSize / rowSize);
+
+        for (uint32 done = 0; done < rowCount; done += rowsPerChunk)
+        {
+            const uint32 count = std::min(rowsPerChunk, rowCount - done);
+            const uint32 row = firstRow + done;
+            const VkDeviceSize position = Reserve(count * rowSize);
+            memcpy(stagingData + position, rows + done * rowSize, count * rowSize);
+
+            VkBufferImageCopy region{};
+            region.bufferOffset = position;
+            region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+            region.imageOffset = { 0, static_cast<int32>(row * blockSize), 0 };
+            region.imageExtent = { width, std::min(count * blockSize, height - row * blockSize), 1 };
+
+            // only the first copy into a new image may discard its contents
+            const bool undefined = created && level == 0 && done == 0;
+            imageUploads.push_back({ texture->image, texture->levelCount,
+                undefined ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+            imageRegions.push_back(region);
+        }
+    }
+
+    void Graphics::Upload(Texture* texture, const TextureView& view)
+    {
+        const TextureHeader& header = *view.header;
+        const TextureFormat format = static_cast<TextureFormat>(header.format);
+
+        CreateTexture(texture, TextureFormatOf(format, header.srgb != 0), header.width, header.height, header.levelCount);
+
+        // compressed levels are copied in rows of 4x4 blocks
+        const uint32 blockSize = format == TEXTURE_RGBA8 ? 1 : 4;
+
+        for (uint32 level = 0; level < header.levelCount; ++level)
+        {
+            const uint32 height = std::max(1U, header.height >> level);
+            const uint32 rows = (height + blockSize - 1) / blockSize;
+
+            StageRows(texture, level, view.data + view.levels[level].offset, view.levels[level].size / rows,
+                0, rows, blockSize, true);
+        }
+    }
+
+    void Graphics::Upload(Texture* texture, const void* pixels, const uint32 width, const uint32 height)
+    {
+        CreateTexture(texture, VK_FORMAT_R8G8B8A8_UNORM, width, height, 1);
+        StageRows(texture, 0, static_cast<const uint8*>(pixels), width * 4, 0, height, 1, true);
+    }
+
+    void Graphics::Update(Texture* texture, const void* pixels, const uint32 firstRow, const uint32 rowCount)
+    {
+        const VkDeviceSize rowSize = texture->width * 4;
+        StageRows(texture, 0, static_cast<const uint8*>(pixels) + firstRow * rowSize, rowSize, firstRow, rowCount, 1, false);
+    }
+}
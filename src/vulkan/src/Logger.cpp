@@ -2,13 +2,18 @@
 #include <format>
 using std::format;
 
-#if !defined(__GNUC__)
-    #include <ConsoleApi2.h>
-    #include <ConsoleApi.h>
+#ifdef _WIN32
+    #if !defined(__GNUC__)
+        #include <ConsoleApi2.h>
+        #include <ConsoleApi.h>
+    #endif
+#else
+    #include <unistd.h>
 #endif
 
 namespace Luna
 {
+#ifdef _WIN32
     enum ForegroundColor : WORD
     {
         COLOR_BLUE   = FOREGROUND_BLUE,
@@ -18,7 +23,7 @@ namespace Luna
         COLOR_WHITE  = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE,
         COLOR_GRAY   = FOREGROUND_INTENSITY
     };
-    
+
     Logger::Logger() noexcept
     {
         AllocConsole();
@@ -38,7 +43,7 @@ namespace Luna
         {
             COLOR_BG_DARK_RED = BACKGROUND_RED
         };
-        
+
         const constexpr WORD LOG_LEVEL_COLORS[]
         {
             COLOR_BG_DARK_RED,
@@ -80,6 +85,37 @@ namespace Luna
         OutputDebugStringW(owned.c_str());
         WriteConsoleW(handle, message.data(), static_cast<DWORD>(message.size()), nullptr, nullptr);
     }
+#else
+    Logger::Logger() noexcept
+    {
+        // escape sequences only when the stream is a terminal
+        colorOutput = isatty(fileno(stdout));
+        colorError = isatty(fileno(stderr));
+    }
+
+    void Logger::WriteToConsole(FILE * stream, const bool color, const LogLevel level, const string_view message) noexcept
+    {
+        constexpr const char* LOG_LEVEL_COLORS[]
+        {
+            "\033[41m",
+            "\033[1;31m",
+            "\033[33m",
+            "\033[1;32m",
+            "\033[34m",
+            "\033[90m"
+        };
+
+        if (color)
+            fputs(LOG_LEVEL_COLORS[level], stream);
+
+        fwrite(message.data(), 1, message.size(), stream);
+
+        if (color)
+            fputs("\033[0m", stream);
+
+        fflush(stream);
+    }
+#endif
 
     void Logger::OutputDebug(const LogLevel level, const string_view message) noexcept
     {
@@ -96,11 +132,19 @@ namespace Luna
         const bool isError = (level < LOG_LEVEL_WARN);
         const string output = format("{}{}", LOG_LEVEL_PREFIX[level], message);
 
+    #ifdef _WIN32
         WriteToConsole((isError ? errorHandle : outputHandle), level, output);
 
         ResetColors();
+    #else
+        if (isError)
+            WriteToConsole(stderr, colorError, level, output);
+        else
+            WriteToConsole(stdout, colorOutput, level, output);
+    #endif
     }
 
+#ifdef _WIN32
     void Logger::OutputDebug(const LogLevel level, const wstring_view message) noexcept
     {
         constexpr const wchar_t* LOG_LEVEL_PREFIX[]
@@ -120,4 +164,5 @@ namespace Luna
 
         ResetColors();
     }
+#endif
 }
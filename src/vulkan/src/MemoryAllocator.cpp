@@ -0,0 +1,371 @@
+#include "MemoryAllocator.h"
+#include "VkError.h"
+#include <algorithm>
+#include <bit>
+
+namespace Luna
+{
+    // smallest range handed out, also the alignment every node starts with
+    constexpr VkDeviceSize MIN_NODE_SIZE = 1024;
+    constexpr uint32 NO_NODE = UINT32_MAX;
+
+    enum NodeState : uint8 { NODE_UNUSED, NODE_FREE, NODE_SPLIT, NODE_USED };
+
+    static uint32 NodeLevel(const uint32 node) noexcept
+    { return static_cast<uint32>(std::bit_width(node + 1u)) - 1; }
+
+    // free lists are not cleaned when buddies merge, stale nodes are skipped here
+    static uint32 PopFree(MemoryBlock * block, const uint32 level)
+    {
+        std::vector<uint32> & freeList = block->freeLists[level];
+
+        while (!freeList.empty())
+        {
+            const uint32 node = freeList.back();
+            freeList.pop_back();
+
+            if (block->state[node] == NODE_FREE)
+                return node;
+        }
+
+        return NO_NODE;
+    }
+
+    MemoryAllocator::MemoryAllocator() noexcept
+        : physicalDevice{nullptr},
+        device{nullptr},
+        memoryProperties{},
+        blockSize{64 * 1024 * 1024},
+        granularity{1},
+        budget{false}
+    {
+    }
+
+    MemoryAllocator::~MemoryAllocator() noexcept
+    {
+        // anything still allocated goes with the blocks
+        for (MemoryBlock * block : blocks)
+        {
+            vkFreeMemory(device, block->memory, nullptr);
+            delete block;
+        }
+    }
+
+    void MemoryAllocator::Initialize(VkPhysicalDevice physicalDevice, VkDevice device, const bool memoryBudget)
+    {
+        this->physicalDevice = physicalDevice;
+        this->device = device;
+        budget = memoryBudget;
+
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+        granularity = deviceProperties.limits.bufferImageGranularity;
+
+        // buddy trees need a power of two, and small heaps should not be taken by a single block
+        VkDeviceSize smallestHeap = blockSize * 8;
+        for (uint32 i = 0; i < memoryProperties.memoryHeapCount; ++i)
+            smallestHeap = std::min(smallestHeap, memoryProperties.memoryHeaps[i].size);
+
+        blockSize = std::bit_floor(std::max(std::min(blockSize, smallestHeap / 8), MIN_NODE_SIZE));
+    }
+
+    VkDeviceSize MemoryAllocator::Headroom(const uint32 typeIndex) const
+    {
+        if (!budget)
+            return UINT64_MAX;
+
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &properties);
+
+        const uint32 heap = memoryProperties.memoryTypes[typeIndex].heapIndex;
+        const VkDeviceSize usage = budgetProperties.heapUsage[heap];
+        const VkDeviceSize limit = budgetProperties.heapBudget[heap];
+
+        return usage < limit ? limit - usage : 0;
+    }
+
+    uint32 MemoryAllocator::FindMemoryType(const uint32 typeFilter,
+        const VkMemoryPropertyFlags properties,
+        const VkDeviceSize size) const
+    {
+        // the first type whose heap still has room, or the first type at all
+        // and let the driver decide when every heap is over budget
+        uint32 fallback = NO_NODE;
+
+        for (uint32 i = 0; i < memoryProperties.memoryTypeCount; ++i)
+        {
+            if (!(typeFilter & (1u << i)) || (memoryProperties.memoryTypes[i].propertyFlags & properties) != properties)
+                continue;
+
+            if (fallback == NO_NODE)
+                fallback = i;
+
+            if (Headroom(i) >= size)
+                return i;
+        }
+
+        VkThrowIfError(VK_ERROR_OUT_OF_DEVICE_MEMORY, fallback == NO_NODE)
+        return fallback;
+    }
+
+    MemoryBlock * MemoryAllocator::CreateBlock(const uint32 typeIndex,
+        const VkDeviceSize size,
+        const bool linear,
+        const void * next)
+    {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.pNext = next;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = typeIndex;
+
+        VkDeviceMemory memory;
+        VkThrowIfFailed(vkAllocateMemory(device, &allocInfo, nullptr, &memory));
+
+        MemoryBlock * block = new MemoryBlock{ memory, size, 0, nullptr, typeIndex, 0, linear };
+
+        // host visible blocks stay mapped for their whole life
+        if (memoryProperties.memoryTypes[typeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            void * mapped;
+            VkThrowIfFailed(vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped));
+            block->mapped = static_cast<uint8*>(mapped);
+        }
+
+        blocks.push_back(block);
+        return block;
+    }
+
+    void MemoryAllocator::DestroyBlock(MemoryBlock * block)
+    {
+        vkFreeMemory(device, block->memory, nullptr);
+        std::erase(blocks, block);
+        delete block;
+    }
+
+    bool MemoryAllocator::AllocateNode(MemoryBlock * block, const VkDeviceSize size, uint32 * node)
+    {
+        if (size > block->size)
+            return false;
+
+        const uint32 level = static_cast<uint32>(std::countr_zero(block->size / size));
+
+        // the nearest level with a free node, walking up towards the root
+        int32 current = int32(level);
+        uint32 found = NO_NODE;
+
+        while (current >= 0 && (found = PopFree(block, uint32(current))) == NO_NODE)
+            --current;
+
+        if (found == NO_NODE)
+            return false;
+
+        // split it down to the requested size, freeing the right halves
+        for (uint32 l = uint32(current); l < level; ++l)
+        {
+            block->state[found] = NODE_SPLIT;
+            block->state[2 * found + 2] = NODE_FREE;
+            block->freeLists[l + 1].push_back(2 * found + 2);
+            found = 2 * found + 1;
+        }
+
+        block->state[found] = NODE_USED;
+        block->used += size;
+        *node = found;
+        return true;
+    }
+
+    void MemoryAllocator::FreeNode(MemoryBlock * block, uint32 node)
+    {
+        uint32 level = NodeLevel(node);
+        block->used -= block->size >> level;
+        block->movable.erase(node);
+
+        // merge with the buddy for as long as it is free too
+        while (node > 0)
+        {
+            const uint32 buddy = (node & 1) ? node + 1 : node - 1;
+            if (block->state[buddy] != NODE_FREE)
+                break;
+
+            block->state[buddy] = NODE_UNUSED;
+            block->state[node] = NODE_UNUSED;
+            node = (node - 1) / 2;
+            --level;
+        }
+
+        block->state[node] = NODE_FREE;
+        block->freeLists[level].push_back(node);
+    }
+
+    Allocation MemoryAllocator::Allocate(const VkMemoryRequirements & requirements,
+        const VkMemoryPropertyFlags properties,
+        const bool linear,
+        const VkMemoryDedicatedAllocateInfo * dedicated,
+        void * userData)
+    {
+        // nodes are aligned to their size, so linear and optimal resources
+        // only need separate blocks when the granularity is above the node size
+        const bool kind = granularity > MIN_NODE_SIZE && linear;
+
+        if (dedicated || requirements.size > blockSize / 2)
+        {
+            const uint32 typeIndex = FindMemoryType(requirements.memoryTypeBits, properties, requirements.size);
+            MemoryBlock * block = CreateBlock(typeIndex, requirements.size, kind, dedicated);
+            block->used = requirements.size;
+
+            return { block->memory, 0, requirements.size, block->mapped, block, 0 };
+        }
+
+        const VkDeviceSize size = std::max(MIN_NODE_SIZE, std::bit_ceil(std::max(requirements.size, requirements.alignment)));
+
+        MemoryBlock * block = nullptr;
+        uint32 node = NO_NODE;
+
+        for (MemoryBlock * candidate : blocks)
+        {
+            const VkMemoryPropertyFlags flags = memoryProperties.memoryTypes[candidate->typeIndex].propertyFlags;
+
+            if (candidate->levels && candidate->linear == kind
+                && (requirements.memoryTypeBits & (1u << candidate->typeIndex))
+                && (flags & properties) == properties
+                && AllocateNode(candidate, size, &node))
+            {
+                block = candidate;
+                break;
+            }
+        }
+
+        if (!block)
+        {
+            // a smaller block when the heap is close to its budget
+            const uint32 typeIndex = FindMemoryType(requirements.memoryTypeBits, properties, size);
+            const VkDeviceSize headroom = Headroom(typeIndex);
+
+            VkDeviceSize newSize = blockSize;
+            while (newSize > size && newSize > headroom)
+                newSize /= 2;
+
+            block = CreateBlock(typeIndex, newSize, kind, nullptr);
+            block->levels = static_cast<uint32>(std::countr_zero(newSize / MIN_NODE_SIZE)) + 1;
+            block->state.assign((size_t(1) << block->levels) - 1, NODE_UNUSED);
+            block->freeLists.resize(block->levels);
+            block->state[0] = NODE_FREE;
+            block->freeLists[0].push_back(0);
+
+            AllocateNode(block, size, &node);
+        }
+
+        if (userData)
+            block->movable[node] = userData;
+
+        const VkDeviceSize offset = (block->size >> NodeLevel(node)) * (node + 1 - (1u << NodeLevel(node)));
+        return { block->memory, offset, requirements.size, block->mapped ? block->mapped + offset : nullptr, block, node };
+    }
+
+    void MemoryAllocator::Free(Allocation & allocation)
+    {
+        MemoryBlock * block = allocation.block;
+        const uint32 node = allocation.node;
+        allocation = {};
+
+        if (!block)
+            return;
+
+        if (!block->levels)
+        {
+            DestroyBlock(block);
+            return;
+        }
+
+        FreeNode(block, node);
+
+        // one empty block per memory type is kept around for the next allocation
+        if (block->used == 0)
+        {
+            for (MemoryBlock * other : blocks)
+            {
+                if (other != block && other->levels && other->used == 0 && other->typeIndex == block->typeIndex)
+                {
+                    DestroyBlock(block);
+                    break;
+                }
+            }
+        }
+    }
+
+    uint32 MemoryAllocator::Defragment(MoveCallback move, const uint32 maxMoves)
+    {
+        // sub-allocated blocks under half full, emptiest first
+        std::vector<MemoryBlock*> sparse;
+        for (MemoryBlock * block : blocks)
+        {
+            if (block->levels && block->used && block->used < block->size / 2 && !block->movable.empty())
+                sparse.push_back(block);
+        }
+
+        std::ranges::sort(sparse, {}, &MemoryBlock::used);
+
+        uint32 moves = 0;
+
+        for (MemoryBlock * source : sparse)
+        {
+            // copied, moving a node erases it from the map
+            const std::vector<std::pair<uint32, void*>> owners(source->movable.begin(), source->movable.end());
+
+            for (const auto & [node, userData] : owners)
+            {
+                if (moves == maxMoves)
+                    return moves;
+
+                const VkDeviceSize size = source->size >> NodeLevel(node);
+
+                for (MemoryBlock * target : blocks)
+                {
+                    uint32 targetNode;
+
+                    if (target == source || !target->levels || target->used < source->used
+                        || target->typeIndex != source->typeIndex || target->linear != source->linear
+                        || !AllocateNode(target, size, &targetNode))
+                        continue;
+
+                    target->movable[targetNode] = userData;
+
+                    const VkDeviceSize fromOffset = size * (node + 1 - (1u << NodeLevel(node)));
+                    const VkDeviceSize toOffset = size * (targetNode + 1 - (1u << NodeLevel(targetNode)));
+
+                    const Allocation from { source->memory, fromOffset, size,
+                        source->mapped ? source->mapped + fromOffset : nullptr, source, node };
+                    const Allocation to { target->memory, toOffset, size,
+                        target->mapped ? target->mapped + toOffset : nullptr, target, targetNode };
+
+                    move(from, to, userData);
+                    FreeNode(source, node);
+                    ++moves;
+                    break;
+                }
+            }
+
+            if (source->used == 0)
+                DestroyBlock(source);
+        }
+
+        return moves;
+    }
+
+    VkDeviceSize MemoryAllocator::Used() const noexcept
+    {
+        VkDeviceSize used = 0;
+        for (const MemoryBlock * block : blocks)
+            used += block->used;
+
+        return used;
+    }
+}
@@ -0,0 +1,37 @@
+#include "Mesh.h"
+
+namespace Luna
+{
+    Mesh::Mesh(const string_view name) noexcept
+        : id{name},
+        vertexBufferSize{},
+        vertexBuffer{nullptr},
+        vertexBufferMemory{},
+        allocator{nullptr},
+        device{nullptr},
+        vertexCount{},
+        indexBufferSize{},
+        indexBuffer{nullptr},
+        indexBufferMemory{},
+        indexCount{},
+        indexType{VK_INDEX_TYPE_UINT16}
+    {
+    }
+    
+    Mesh::~Mesh() noexcept
+    {
+        if (device)
+        {
+            if (vertexBuffer)
+                vkDestroyBuffer(device, vertexBuffer, nullptr);
+            
+            allocator->Free(vertexBufferMemory);
+
+            if (indexBuffer)
+            {
+                vkDestroyBuffer(device, indexBuffer, nullptr);
+                allocator->Free(indexBufferMemory);
+            }
+        }
+    }
+}
@@ -0,0 +1,623 @@
+#include "RenderGraph.h"
+#include "VkError.h"
+#include <algorithm>
+
+namespace Luna
+{
+    constexpr uint32 NO_PASS = ~0U;
+
+    struct AccessInfo
+    {
+        VkPipelineStageFlags2 stage;
+        VkAccessFlags2 access;
+        VkImageLayout layout;
+        VkImageUsageFlags usage;
+    };
+
+    static AccessInfo Info(const RenderAccess access)
+    {
+        constexpr VkPipelineStageFlags2 shaders = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        constexpr VkPipelineStageFlags2 tests = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+        switch (access)
+        {
+        case COLOR_ATTACHMENT:
+            return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+        case DEPTH_ATTACHMENT:
+            return { tests,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+        case DEPTH_READ:
+            return { tests, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+        case SAMPLED:
+            return { shaders, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT };
+        case STORAGE_READ:
+            return { shaders, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT };
+        case STORAGE_WRITE:
+            return { shaders, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT };
+        case TRANSFER_SRC:
+            return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
+        default:
+            return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+        }
+    }
+
+    static bool IsDepth(const VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static VkImageAspectFlags Aspect(const VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return IsDepth(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+        }
+    }
+
+    static VkDeviceSize AlignUp(const VkDeviceSize value, const VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // ---------------------------------------------------
+
+    RenderGraph::RenderGraph(Graphics * graphics) noexcept
+        : graphics{ graphics },
+        memory{},
+        extent{},
+        frame{ 0 },
+        compiled{ false }
+    {
+        images.push_back({ "BackBuffer", {}, true });
+    }
+
+    RenderGraph::~RenderGraph() noexcept
+    {
+        if (graphics->Device())
+        {
+            vkDeviceWaitIdle(graphics->Device());
+            Retire();
+            Release(true);
+        }
+    }
+
+    RenderResource RenderGraph::Create(const char * name, const RenderTarget & target)
+    {
+        images.push_back({ name, target, false });
+        compiled = false;
+        return static_cast<RenderResource>(images.size() - 1);
+    }
+
+    uint32 RenderGraph::AddPass(const char * name, const std::function<void(VkCommandBuffer)> & execute)
+    {
+        nodes.push_back({ name, execute, {}, false });
+        compiled = false;
+        return static_cast<uint32>(nodes.size() - 1);
+    }
+
+    void RenderGraph::Read(const uint32 pass, const RenderResource resource, const RenderAccess access)
+    {
+        nodes[pass].uses.push_back({ resource, access, false, false, {} });
+        compiled = false;
+    }
+
+    void RenderGraph::Write(const uint32 pass, const RenderResource resource, const RenderAccess access)
+    {
+        nodes[pass].uses.push_back({ resource, access, true, false, {} });
+        compiled = false;
+    }
+
+    void RenderGraph::Clear(const uint32 pass, const RenderResource resource, const VkClearValue & value)
+    {
+        const RenderAccess access = IsDepth(images[resource].target.format) ? DEPTH_ATTACHMENT : COLOR_ATTACHMENT;
+        nodes[pass].uses.push_back({ resource, access, true, true, value });
+        compiled = false;
+    }
+
+    void RenderGraph::Reset()
+    {
+        Retire();
+        nodes.clear();
+        images.resize(1);
+        order.clear();
+        barriers.clear();
+        compiled = false;
+    }
+
+    uint32 RenderGraph::BarrierCount() const noexcept
+    {
+        uint32 count = 0;
+        for (const auto & list : barriers)
+            count += static_cast<uint32>(list.size());
+
+        return count;
+    }
+
+    // ---------------------------------------------------
+    // Compilation
+    // ---------------------------------------------------
+
+    void RenderGraph::Compile()
+    {
+        VkThrowIfErrorMessage(VK_ERROR_FEATURE_NOT_PRESENT, !graphics->RenderGraphSupport(),
+            "the render graph needs dynamic rendering and synchronization2");
+
+        Retire();
+        extent = graphics->scissorRect.extent;
+
+        Cull();
+        Allocate();
+        Synchronize();
+        compiled = true;
+    }
+
+    void RenderGraph::Cull()
+    {
+        const int32 count = static_cast<int32>(nodes.size());
+        std::vector<bool> live(count);
+
+        for (int32 i = 0; i < count; ++i)
+        {
+            live[i] = nodes[i].sideEffect;
+            for (const RenderUse & use : nodes[i].uses)
+                live[i] = live[i] || (use.write && use.resource == BackBuffer());
+        }
+
+        // a live pass needs the earlier writers of everything it reads, and of what
+        // it writes without clearing, back to the last pass that cleared the image
+        for (int32 i = count - 1; i >= 0; --i)
+        {
+            if (!live[i])
+                continue;
+
+            for (const RenderUse & use : nodes[i].uses)
+            {
+                if (use.clear)
+                    continue;
+
+                bool cleared = false;
+                for (int32 j = i - 1; j >= 0 && !cleared; --j)
+                {
+                    for (const RenderUse & earlier : nodes[j].uses)
+                    {
+                        if (earlier.resource == use.resource && earlier.write)
+                        {
+                            live[j] = true;
+                            cleared = cleared || earlier.clear;
+                        }
+                    }
+                }
+            }
+        }
+
+        order.clear();
+        for (int32 i = 0; i < count; ++i)
+        {
+            if (live[i])
+                order.push_back(uint32(i));
+        }
+    }
+
+    void RenderGraph::Allocate()
+    {
+        VkDevice device = graphics->Device();
+
+        for (RenderImage & image : images)
+        {
+            image.usage = 0;
+            image.first = NO_PASS;
+            image.last = NO_PASS;
+        }
+
+        for (uint32 k = 0; k < order.size(); ++k)
+        {
+            for (const RenderUse & use : nodes[order[k]].uses)
+            {
+                RenderImage & image = images[use.resource];
+                image.usage |= Info(use.access).usage;
+                image.first = std::min(image.first, k);
+                image.last = image.last == NO_PASS ? k : std::max(image.last, k);
+            }
+        }
+
+        // render targets no live pass touches are not created
+        std::vector<uint32> transients;
+        for (uint32 i = 1; i < images.size(); ++i)
+        {
+            RenderImage & image = images[i];
+            if (image.first == NO_PASS)
+                continue;
+
+            image.extent.width = image.target.width ? image.target.width : extent.width;
+            image.extent.height = image.target.height ? image.target.height : extent.height;
+
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = image.target.format;
+            imageInfo.extent = { image.extent.width, image.extent.height, 1 };
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = image.usage;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            VkThrowIfFailed(vkCreateImage(device, &imageInfo, nullptr, &image.image));
+            vkGetImageMemoryRequirements(device, image.image, &image.requirements);
+            transients.push_back(i);
+        }
+
+        if (transients.empty())
+            return;
+
+        // largest first, each at the lowest offset that does not overlap the
+        // memory of a placed image whose passes overlap its own
+        std::sort(transients.begin(), transients.end(), [this](const uint32 a, const uint32 b)
+        {
+            return images[a].requirements.size > images[b].requirements.size;
+        });
+
+        VkMemoryRequirements requirements{ 0, 1, ~0U };
+        std::vector<uint32> placed;
+
+        for (const uint32 i : transients)
+        {
+            RenderImage & image = images[i];
+            const VkDeviceSize alignment = image.requirements.alignment;
+
+            std::vector<VkDeviceSize> candidates{ 0 };
+            for (const uint32 j : placed)
+                candidates.push_back(AlignUp(images[j].offset + images[j].requirements.size, alignment));
+
+            std::sort(candidates.begin(), candidates.end());
+
+            for (const VkDeviceSize offset : candidates)
+            {
+                bool fits = true;
+                for (const uint32 j : placed)
+                {
+                    const RenderImage & other = images[j];
+                    const bool together = image.first <= other.last && other.first <= image.last;
+                    const bool overlap = offset < other.offset + other.requirements.size
+                        && other.offset < offset + image.requirements.size;
+
+                    fits = fits && !(together && overlap);
+                }
+
+                if (fits)
+                {
+                    image.offset = offset;
+                    break;
+                }
+            }
+
+            placed.push_back(i);
+            requirements.size = std::max(requirements.size, image.offset + image.requirements.size);
+            requirements.alignment = std::max(requirements.alignment, alignment);
+            requirements.memoryTypeBits &= image.requirements.memoryTypeBits;
+        }
+
+        VkThrowIfErrorMessage(VK_ERROR_FEATURE_NOT_PRESENT, requirements.memoryTypeBits == 0,
+            "the render targets have no memory type in common");
+
+        memory = graphics->Allocator()->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false);
+
+        for (const uint32 i : transients)
+        {
+            RenderImage & image = images[i];
+            VkThrowIfFailed(vkBindImageMemory(device, image.image, memory.memory, memory.offset + image.offset));
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = image.image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = image.target.format;
+            viewInfo.subresourceRange = { Aspect(image.target.format), 0, 1, 0, 1 };
+
+            VkThrowIfFailed(vkCreateImageView(device, &viewInfo, nullptr, &image.view));
+        }
+    }
+
+    void RenderGraph::Synchronize()
+    {
+        struct State
+        {
+            VkImageLayout layout;
+            VkPipelineStageFlags2 writeStage;
+            VkAccessFlags2 writeAccess;
+            VkPipelineStageFlags2 readStage;        // reads since the last write
+            VkPipelineStageFlags2 visibleStage;     // stages and accesses that already see the last write
+            VkAccessFlags2 visibleAccess;
+        };
+
+        std::vector<State> states(images.size(), State{ VK_IMAGE_LAYOUT_UNDEFINED });
+
+        // Clear leaves the back buffer after a render pass that wrote it
+        states[0] = { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+
+        barriers.assign(order.size() + 1, {});
+
+        for (uint32 k = 0; k < order.size(); ++k)
+        {
+            const RenderNode & node = nodes[order[k]];
+
+            // a resource used more than once by a pass gets one barrier
+            std::vector<RenderResource> seen;
+            for (const RenderUse & use : node.uses)
+            {
+                if (std::find(seen.begin(), seen.end(), use.resource) != seen.end())
+                    continue;
+                seen.push_back(use.resource);
+
+                AccessInfo dst{};
+                bool write = false;
+                for (const RenderUse & other : node.uses)
+                {
+                    if (other.resource != use.resource)
+                        continue;
+
+                    const AccessInfo info = Info(other.access);
+                    dst.stage |= info.stage;
+                    dst.access |= info.access;
+                    dst.layout = (other.write || !dst.layout) ? info.layout : dst.layout;
+                    write = write || other.write;
+                }
+
+                const RenderImage & image = images[use.resource];
+                State & state = states[use.resource];
+                RenderBarrier barrier{ use.resource, 0, 0, dst.stage, dst.access, state.layout, dst.layout };
+
+                if (!image.imported && image.first == k)
+                {
+                    // contents are discarded, but the memory may still be in use
+                    // by earlier images it aliases
+                    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                    for (uint32 j = 1; j < images.size(); ++j)
+                    {
+                        const RenderImage & other = images[j];
+                        if (j == use.resource || other.first == NO_PASS || other.last >= k
+                            || other.offset >= image.offset + image.requirements.size
+                            || image.offset >= other.offset + other.requirements.size)
+                            continue;
+
+                        barrier.srcStage |= states[j].writeStage | states[j].readStage;
+                        barrier.srcAccess |= states[j].writeAccess;
+                    }
+                    barriers[k].push_back(barrier);
+                }
+                else if (write || state.layout != dst.layout)
+                {
+                    barrier.srcStage = state.writeStage | state.readStage;
+                    barrier.srcAccess = state.writeAccess;
+                    barriers[k].push_back(barrier);
+                }
+                else if ((dst.stage & ~state.visibleStage) || (dst.access & ~state.visibleAccess))
+                {
+                    // read after write, only waits on the write
+                    barrier.srcStage = state.writeStage;
+                    barrier.srcAccess = state.writeAccess;
+                    barriers[k].push_back(barrier);
+                }
+
+                if (write)
+                {
+                    state = { dst.layout, dst.stage, dst.access, 0, 0, 0 };
+                }
+                else
+                {
+                    // later reads wait on the layout change instead of the write before it
+                    if (state.layout != dst.layout)
+                        state = { dst.layout, dst.stage, 0, 0, 0, 0 };
+
+                    state.layout = dst.layout;
+                    state.readStage |= dst.stage;
+                    state.visibleStage |= dst.stage;
+                    state.visibleAccess |= dst.access;
+                }
+            }
+        }
+
+        // back to the layout Present and the load render pass expect
+        const State & backBuffer = states[0];
+        if (backBuffer.layout != VK_IMAGE_LAYOUT_PRESENT_SRC_KHR || backBuffer.readStage)
+        {
+            barriers.back().push_back({ BackBuffer(),
+                backBuffer.writeStage | backBuffer.readStage, backBuffer.writeAccess,
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                backBuffer.layout, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR });
+        }
+    }
+
+    // ---------------------------------------------------
+    // Execution
+    // ---------------------------------------------------
+
+    void RenderGraph::Execute(VkCommandBuffer commandBuffer, const SwapchainBuffer & backBuffer, const uint64 frameNumber)
+    {
+        frame = frameNumber;
+        Release(false);
+
+        const VkExtent2D size = graphics->scissorRect.extent;
+        if (!compiled || size.width != extent.width || size.height != extent.height)
+            Compile();
+
+        images[0].image = backBuffer.image;
+        images[0].view = backBuffer.view;
+        images[0].extent = extent;
+
+        for (uint32 k = 0; k < order.size(); ++k)
+        {
+            const RenderNode & node = nodes[order[k]];
+            Barriers(commandBuffer, barriers[k]);
+
+            if (BeginRendering(commandBuffer, node))
+            {
+                node.execute(commandBuffer);
+                vkCmdEndRendering(commandBuffer);
+            }
+            else
+            {
+                node.execute(commandBuffer);
+            }
+        }
+
+        Barriers(commandBuffer, barriers.back());
+    }
+
+    void RenderGraph::Barriers(VkCommandBuffer commandBuffer, const std::vector<RenderBarrier> & list) const
+    {
+        if (list.empty())
+            return;
+
+        std::vector<VkImageMemoryBarrier2> imageBarriers(list.size());
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            const RenderBarrier & barrier = list[i];
+            const RenderImage & image = images[barrier.resource];
+
+            VkImageMemoryBarrier2 & imageBarrier = imageBarriers[i];
+            imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            imageBarrier.srcStageMask = barrier.srcStage;
+            imageBarrier.srcAccessMask = barrier.srcAccess;
+            imageBarrier.dstStageMask = barrier.dstStage;
+            imageBarrier.dstAccessMask = barrier.dstAccess;
+            imageBarrier.oldLayout = barrier.oldLayout;
+            imageBarrier.newLayout = barrier.newLayout;
+            imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.image = image.image;
+            imageBarrier.subresourceRange = { image.imported ? VkImageAspectFlags(VK_IMAGE_ASPECT_COLOR_BIT) : Aspect(image.target.format), 0, 1, 0, 1 };
+        }
+
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32>(imageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    }
+
+    bool RenderGraph::BeginRendering(VkCommandBuffer commandBuffer, const RenderNode & node) const
+    {
+        std::vector<VkRenderingAttachmentInfo> colorAttachments;
+        VkRenderingAttachmentInfo depthAttachment{};
+        VkExtent2D area{};
+
+        for (const RenderUse & use : node.uses)
+        {
+            if (use.access != COLOR_ATTACHMENT && use.access != DEPTH_ATTACHMENT && use.access != DEPTH_READ)
+                continue;
+
+            const RenderImage & image = images[use.resource];
+            area = image.extent;
+
+            VkRenderingAttachmentInfo attachment{};
+            attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            attachment.imageView = image.view;
+            attachment.imageLayout = Info(use.access).layout;
+            attachment.loadOp = use.clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+            attachment.storeOp = use.access == DEPTH_READ ? VK_ATTACHMENT_STORE_OP_NONE : VK_ATTACHMENT_STORE_OP_STORE;
+            attachment.clearValue = use.clearValue;
+
+            if (use.access == COLOR_ATTACHMENT)
+                colorAttachments.push_back(attachment);
+            else
+                depthAttachment = attachment;
+        }
+
+        if (colorAttachments.empty() && !depthAttachment.imageView)
+            return false;
+
+        VkRenderingInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderingInfo.renderArea = { { 0, 0 }, area };
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = static_cast<uint32>(colorAttachments.size());
+        renderingInfo.pColorAttachments = colorAttachments.data();
+        renderingInfo.pDepthAttachment = depthAttachment.imageView ? &depthAttachment : nullptr;
+
+        vkCmdBeginRendering(commandBuffer, &renderingInfo);
+
+        // the frame viewport covers the swapchain, render targets may be smaller
+        const VkViewport viewport{ 0.0f, 0.0f, float(area.width), float(area.height), 0.0f, 1.0f };
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &renderingInfo.renderArea);
+        return true;
+    }
+
+    // ---------------------------------------------------
+    // Transient memory
+    // ---------------------------------------------------
+
+    void RenderGraph::Retire()
+    {
+        RetiredTargets targets{ {}, {}, memory, frame + 1 };
+
+        for (uint32 i = 1; i < images.size(); ++i)
+        {
+            if (images[i].image)
+                targets.images.push_back(images[i].image);
+            if (images[i].view)
+                targets.views.push_back(images[i].view);
+
+            images[i].image = nullptr;
+            images[i].view = nullptr;
+        }
+
+        memory = {};
+        if (targets.memory.memory || !targets.images.empty())
+            retired.push_back(std::move(targets));
+    }
+
+    void RenderGraph::Release(const bool all)
+    {
+        VkDevice device = graphics->Device();
+        const uint64 frameCount = graphics->FramesInFlight();
+
+        auto done = [&](RetiredTargets & targets)
+        {
+            if (!all && targets.frame + frameCount > frame + 1)
+                return false;
+
+            for (VkImageView view : targets.views)
+                vkDestroyImageView(device, view, nullptr);
+            for (VkImage image : targets.images)
+                vkDestroyImage(device, image, nullptr);
+            if (targets.memory.memory)
+                graphics->Allocator()->Free(targets.memory);
+
+            return true;
+        };
+
+        retired.erase(std::remove_if(retired.begin(), retired.end(), done), retired.end());
+    }
+}
@@ -0,0 +1,307 @@
+#include "SpriteRenderer.h"
+#include "VkError.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "Sprite.vert.h"
+#include "Sprite.frag.h"
+
+namespace Luna
+{
+    struct SpriteConstants
+    {
+        float scale[2];
+        uint32 texture;
+    };
+
+    SpriteRenderer::SpriteRenderer() noexcept
+        : graphics{nullptr},
+        pipeline{nullptr},
+        sampler{nullptr},
+        instanceBuffer{nullptr},
+        instanceAllocation{},
+        capacity{},
+        used{},
+        frame{},
+        atlas{nullptr},
+        atlasIndex{}
+    {
+    }
+
+    SpriteRenderer::~SpriteRenderer() noexcept
+    {
+        if (!graphics)
+            return;
+
+        vkDeviceWaitIdle(graphics->Device());
+
+        for (const RetiredTexture & old : retired)
+            delete old.texture;
+        delete atlas;
+
+        if (instanceBuffer)
+            graphics->Free(instanceBuffer, instanceAllocation);
+
+        vkDestroySampler(graphics->Device(), sampler, nullptr);
+        vkDestroyPipeline(graphics->Device(), pipeline, nullptr);
+    }
+
+    static VkShaderModule CreateModule(VkDevice device, const uint32 * code, const size_t size)
+    {
+        VkShaderModuleCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = size;
+        createInfo.pCode = code;
+
+        VkShaderModule shaderModule;
+        VkThrowIfFailed(vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule));
+
+        return shaderModule;
+    }
+
+    bool SpriteRenderer::Initialize(Graphics * graphics, const uint32 capacity)
+    {
+        this->graphics = graphics;
+        this->capacity = capacity;
+
+        if (!graphics->Heap()->Set())
+            return false;
+
+        VkDevice device = graphics->Device();
+
+        // ---------------------------------------------------
+        // Instance Ring and Sampler
+        // ---------------------------------------------------
+
+        graphics->Allocate(
+            VkDeviceSize(capacity) * graphics->FramesInFlight() * sizeof(SpriteInstance),
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            &instanceBuffer,
+            &instanceAllocation
+        );
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+        VkThrowIfFailed(vkCreateSampler(device, &samplerInfo, nullptr, &sampler));
+
+        // ---------------------------------------------------
+        // Pipeline
+        // ---------------------------------------------------
+
+        VkShaderModule vertexShaderModule = CreateModule(device, Sprite_vert, sizeof(Sprite_vert));
+        VkShaderModule fragmentShaderModule = CreateModule(device, Sprite_frag, sizeof(Sprite_frag));
+
+        VkPipelineShaderStageCreateInfo shaderStages[2]{};
+        shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        shaderStages[0].module = vertexShaderModule;
+        shaderStages[0].pName = "main";
+
+        shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        shaderStages[1].module = fragmentShaderModule;
+        shaderStages[1].pName = "main";
+
+        // the four corners come from the vertex index, every attribute is per instance
+        VkVertexInputBindingDescription instanceBinding{};
+        instanceBinding.binding = 0;
+        instanceBinding.stride = sizeof(SpriteInstance);
+        instanceBinding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        const VkVertexInputAttributeDescription attributes[]
+        {
+            { 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteInstance, position) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(SpriteInstance, size) },
+            { 2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(SpriteInstance, uv) },
+            { 3, 0, VK_FORMAT_R32_UINT, offsetof(SpriteInstance, color) },
+            { 4, 0, VK_FORMAT_R32_SFLOAT, offsetof(SpriteInstance, rotation) }
+        };
+
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &instanceBinding;
+        vertexInputInfo.vertexAttributeDescriptionCount = Countof(attributes);
+        vertexInputInfo.pVertexAttributeDescriptions = attributes;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssemblyInfo{};
+        inputAssemblyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+
+        // the swapchain size changes with the window, the frame sets both
+        VkPipelineViewportStateCreateInfo viewportInfo{};
+        viewportInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportInfo.viewportCount = 1;
+        viewportInfo.scissorCount = 1;
+
+        const VkDynamicState dynamicStates[] { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+        VkPipelineDynamicStateCreateInfo dynamicInfo{};
+        dynamicInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicInfo.dynamicStateCount = Countof(dynamicStates);
+        dynamicInfo.pDynamicStates = dynamicStates;
+
+        // rotated sprites may face either way
+        VkPipelineRasterizationStateCreateInfo rasterizationInfo{};
+        rasterizationInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizationInfo.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizationInfo.cullMode = VK_CULL_MODE_NONE;
+        rasterizationInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
+        rasterizationInfo.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisampleInfo{};
+        multisampleInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampleInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        // straight alpha, as the Canvas blends
+        VkPipelineColorBlendAttachmentState blendAttachment{};
+        blendAttachment.blendEnable = true;
+        blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT
+            | VK_COLOR_COMPONENT_G_BIT
+            | VK_COLOR_COMPONENT_B_BIT
+            | VK_COLOR_COMPONENT_A_BIT;
+
+        VkPipelineColorBlendStateCreateInfo blendInfo{};
+        blendInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        blendInfo.attachmentCount = 1;
+        blendInfo.pAttachments = &blendAttachment;
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = Countof(shaderStages);
+        pipelineInfo.pStages = shaderStages;
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssemblyInfo;
+        pipelineInfo.pViewportState = &viewportInfo;
+        pipelineInfo.pRasterizationState = &rasterizationInfo;
+        pipelineInfo.pMultisampleState = &multisampleInfo;
+        pipelineInfo.pColorBlendState = &blendInfo;
+        pipelineInfo.pDynamicState = &dynamicInfo;
+        pipelineInfo.layout = graphics->PipelineLayout();
+        pipelineInfo.renderPass = graphics->RenderPass();
+        pipelineInfo.subpass = 0;
+
+        pipeline = graphics->CreatePipeline(pipelineInfo);
+
+        vkDestroyShaderModule(device, vertexShaderModule, nullptr);
+        vkDestroyShaderModule(device, fragmentShaderModule, nullptr);
+
+        return true;
+    }
+
+    SpriteInstance * SpriteRenderer::Slice()
+    {
+        // the frame's fence was waited by Clear, its slice is free again
+        if (frame != graphics->FrameNumber())
+        {
+            frame = graphics->FrameNumber();
+            used = 0;
+        }
+
+        return reinterpret_cast<SpriteInstance*>(instanceAllocation.mapped) + size_t(graphics->FrameIndex()) * capacity;
+    }
+
+    void SpriteRenderer::Map(SpriteBatch & batch)
+    {
+        if (!pipeline)
+            return;
+
+        batch.Map(Slice() + used, capacity - used);
+    }
+
+    void SpriteRenderer::Draw(const SpriteBatch & batch)
+    {
+        if (!pipeline || batch.InstanceCount() == 0)
+            return;
+
+        SpriteInstance * slice = Slice();
+        const SpriteInstance * instances = batch.Instances();
+        uint32 count = batch.InstanceCount();
+        uint32 offset;
+
+        if (instances >= slice + used && instances + count <= slice + capacity)
+        {
+            offset = static_cast<uint32>(instances - slice);
+        }
+        else
+        {
+            // the runs past the end of a full slice are dropped
+            count = std::min(count, capacity - used);
+            memcpy(slice + used, instances, count * sizeof(SpriteInstance));
+            offset = used;
+        }
+
+        used = offset + count;
+
+        VkCommandBuffer commandBuffer = graphics->CommandBuffer();
+        const VkDeviceSize bufferOffset = 0;
+        const uint32 first = graphics->FrameIndex() * capacity + offset;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        graphics->BindResources(commandBuffer, 0);
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &instanceBuffer, &bufferOffset);
+
+        SpriteConstants constants{};
+        constants.scale[0] = 2.0f / graphics->viewport.width;
+        constants.scale[1] = 2.0f / graphics->viewport.height;
+
+        const SpriteRun * runs = batch.Runs();
+        for (uint32 i = 0; i < batch.RunCount() && runs[i].first < count; ++i)
+        {
+            constants.texture = runs[i].texture;
+            vkCmdPushConstants(commandBuffer, graphics->PipelineLayout(), VK_SHADER_STAGE_ALL,
+                0, sizeof(constants), &constants);
+
+            vkCmdDraw(commandBuffer, 4, std::min(runs[i].count, count - runs[i].first), 0, first + runs[i].first);
+        }
+    }
+
+    uint32 SpriteRenderer::Atlas(Font & font)
+    {
+        while (!retired.empty() && retired.front().frame <= graphics->FrameNumber())
+        {
+            delete retired.front().texture;
+            retired.erase(retired.begin());
+        }
+
+        uint32 firstRow, rowCount;
+        if (!pipeline || !font.Dirty(firstRow, rowCount))
+            return atlasIndex;
+
+        if (atlas && atlas->height == font.AtlasHeight())
+        {
+            graphics->Update(atlas, font.Atlas(), firstRow, rowCount);
+            return atlasIndex;
+        }
+
+        // sprites built with the old index this frame still sample the old texture
+        if (atlas)
+        {
+            graphics->RemoveTexture(atlasIndex);
+            retired.push_back({ atlas, graphics->FrameNumber() + graphics->FramesInFlight() });
+        }
+
+        atlas = new Texture("Font Atlas");
+        graphics->Upload(atlas, font.Atlas(), font.AtlasWidth(), font.AtlasHeight());
+        atlasIndex = graphics->AddTexture(atlas->view, sampler);
+
+        return atlasIndex;
+    }
+}
@@ -0,0 +1,32 @@
+#include "Texture.h"
+
+namespace Luna
+{
+    Texture::Texture(const string_view name) noexcept
+        : id{name},
+        image{nullptr},
+        imageMemory{},
+        view{nullptr},
+        format{VK_FORMAT_UNDEFINED},
+        width{},
+        height{},
+        levelCount{},
+        allocator{nullptr},
+        device{nullptr}
+    {
+    }
+
+    Texture::~Texture() noexcept
+    {
+        if (device)
+        {
+            if (view)
+                vkDestroyImageView(device, view, nullptr);
+
+            if (image)
+                vkDestroyImage(device, image, nullptr);
+
+            allocator->Free(imageMemory);
+        }
+    }
+}
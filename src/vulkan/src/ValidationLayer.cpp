@@ -33,6 +33,10 @@ namespace Luna
 
     ValidationLayer::~ValidationLayer() noexcept
     {
+        // only debug builds create the messenger
+        if (!debugUtils)
+            return;
+
         logger->OutputDebug(LOG_LEVEL_DEBUG, "Destroying Vulkan debugger\n");
         DestroyDebugUtilsMessengerEXT(instance, debugUtils, nullptr);
     }
@@ -87,7 +91,7 @@ namespace Luna
             logger->OutputDebug(LOG_LEVEL_TRACE, format("{}\n", pCallbackData->pMessage));
             break;
         }
-        Sleep(1500);
+
         return VK_FALSE;
     }
 }
\ No newline at end of file
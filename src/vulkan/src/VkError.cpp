@@ -13,12 +13,12 @@ namespace Luna
         const string_view file,
         const int32 line,
         const string_view message) noexcept
-        : result{res}, funcName{func}, lineNum{line}, message{message}
+        : result{res}, lineNum{line}, message{message}, funcName{func}
     {
-        auto pos = file.find_last_of('\\');
+        // __FILE__ holds backslashes on Windows and slashes elsewhere
+        auto pos = file.find_last_of("/\\");
 
-        if (pos != string::npos)
-            fileName = file.substr(pos + 1);
+        fileName = (pos != string::npos) ? file.substr(pos + 1) : file;
     }
 
     constexpr const char* VkResultStr(const VkResult err) noexcept
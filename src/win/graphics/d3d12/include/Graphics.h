@@ -8,12 +8,25 @@
 #include "Export.h"
 #include "Window.h"
 #include "Types.h"
+#include "Profiler.h"
 #include <d3dcompiler.h>
 
 namespace Luna
 {
     enum AllocationType { GPU, UPLOAD };
 
+    constexpr uint32 MAX_GPU_SCOPES = 64;
+    constexpr uint32 TIMESTAMP_QUERIES = 2 + 2 * MAX_GPU_SCOPES;
+
+    // timestamps of one back buffer: frame begin and end, then a pair per GPU scope
+    struct TimestampFrame
+    {
+        uint64 profileFrame;
+        uint32 queryCount;              // resolved this frame, read back when the slot comes around
+        uint32 scopeCount;
+        uint32 scopes[MAX_GPU_SCOPES];  // profiler entry of each scope
+    };
+
     class DLL Graphics
     {
     private:
@@ -45,10 +58,18 @@ namespace Luna
         // sincronization
         ID3D12Fence                * fence;
         uint64                       currentFence;
+
+        // GPU timestamps
+        Profiler                   * profiler;
+        ID3D12QueryHeap            * queryHeap;
+        ID3D12Resource             * queryReadback;
+        uint64                       timestampFrequency;
+        TimestampFrame             * timestampFrames;
         
         DebugLayer * debugLayer;
 
         bool WaitCommandQueue() noexcept;
+        void ReadTimestamps(TimestampFrame & timing, const uint32 slot) noexcept;
         
         void LogHardwareInfo() noexcept;
         void RefreshRate() noexcept;
@@ -64,6 +85,12 @@ namespace Luna
         void Clear(ID3D12PipelineState * pso) noexcept;
         void Present() noexcept;
 
+        // GPU times reach the profiler reports when the back buffer
+        // comes around again, call after Initialize
+        void Profile(Profiler * profiler) noexcept;
+        uint32 BeginScope(const char * name);
+        void EndScope(const uint32 scope);
+
         void ResetCommands() noexcept;
         void SubmitCommands() noexcept;
 
@@ -89,6 +116,23 @@ namespace Luna
         uint32 Quality() const noexcept;
     };
 
+    // times the commands recorded in the enclosing block, on the GPU and the CPU
+    class GpuScope
+    {
+    private:
+        Graphics * graphics;
+        uint32 scope;
+
+    public:
+        GpuScope(Graphics * graphics, const char * name)
+            : graphics{ graphics }, scope{ graphics->BeginScope(name) } {}
+        ~GpuScope()
+        { graphics->EndScope(scope); }
+
+        GpuScope(const GpuScope &) = delete;
+        GpuScope & operator=(const GpuScope &) = delete;
+    };
+
     inline void Graphics::VSync(const bool state) noexcept
     { vSync = state; }
 
@@ -28,7 +28,12 @@ namespace Luna
         scissorRect{},
         featureLevel{D3D_FEATURE_LEVEL_11_0},
         fence{nullptr},
-        currentFence{}
+        currentFence{},
+        profiler{nullptr},
+        queryHeap{nullptr},
+        queryReadback{nullptr},
+        timestampFrequency{},
+        timestampFrames{nullptr}
     {
         renderTargets = new ID3D12Resource*[backBufferCount] {nullptr};
         debugLayer = new DebugLayer(logger);
@@ -53,6 +58,10 @@ namespace Luna
             swapChain->Release();
         }
 
+        SafeRelease(queryReadback);
+        SafeRelease(queryHeap);
+        delete[] timestampFrames;
+
         SafeRelease(fence);
         SafeRelease(renderTargetHeap);
     	SafeRelease(commandList);
@@ -230,6 +239,44 @@ namespace Luna
 
     	ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
 
+        // ---------------------------------------------------
+        // Timestamp Queries
+        // ---------------------------------------------------
+
+        timestampFrames = new TimestampFrame[backBufferCount] {};
+
+        // queues without timestamp support leave the heap null and profile the CPU only
+        if (SUCCEEDED(commandQueue->GetTimestampFrequency(&timestampFrequency)))
+        {
+            D3D12_QUERY_HEAP_DESC queryHeapDesc{};
+            queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+            queryHeapDesc.Count = backBufferCount * TIMESTAMP_QUERIES;
+            ThrowIfFailed(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&queryHeap)));
+
+            D3D12_HEAP_PROPERTIES readbackProp{};
+            readbackProp.Type = D3D12_HEAP_TYPE_READBACK;
+            readbackProp.CreationNodeMask = 1;
+            readbackProp.VisibleNodeMask = 1;
+
+            D3D12_RESOURCE_DESC readbackDesc{};
+            readbackDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            readbackDesc.Width = uint64(queryHeapDesc.Count) * sizeof(uint64);
+            readbackDesc.Height = 1;
+            readbackDesc.DepthOrArraySize = 1;
+            readbackDesc.MipLevels = 1;
+            readbackDesc.Format = DXGI_FORMAT_UNKNOWN;
+            readbackDesc.SampleDesc.Count = 1;
+            readbackDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            ThrowIfFailed(device->CreateCommittedResource(
+                &readbackProp,
+                D3D12_HEAP_FLAG_NONE,
+                &readbackDesc,
+                D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr,
+                IID_PPV_ARGS(&queryReadback)));
+        }
+
         // ---------------------------------------------------
         // Swap Chain
         // ---------------------------------------------------
@@ -317,6 +364,17 @@ namespace Luna
         commandListAlloc->Reset();
         commandList->Reset(commandListAlloc, pso);
 
+        TimestampFrame & timing = timestampFrames[backBufferIndex];
+        ReadTimestamps(timing, backBufferIndex);
+
+        timing.scopeCount = 0;
+        if (profiler && queryHeap)
+        {
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, backBufferIndex * TIMESTAMP_QUERIES);
+            timing.profileFrame = profiler->Frame();
+            timing.queryCount = 2;
+        }
+
         D3D12_RESOURCE_BARRIER barrier{};
         barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
         barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
@@ -380,12 +438,92 @@ namespace Luna
         barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
         commandList->ResourceBarrier(1, &barrier);
 
+        TimestampFrame & timing = timestampFrames[backBufferIndex];
+        if (timing.queryCount)
+        {
+            const uint32 base = backBufferIndex * TIMESTAMP_QUERIES;
+            timing.queryCount = 2 + 2 * timing.scopeCount;
+
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, base + 1);
+            commandList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP,
+                base, timing.queryCount, queryReadback, uint64(base) * sizeof(uint64));
+        }
+
         SubmitCommands();
 
         swapChain->Present(vSync, 0);
         backBufferIndex = (backBufferIndex + 1) % backBufferCount;
     }
 
+    void Graphics::Profile(Profiler * profiler) noexcept
+    {
+        if (this->profiler)
+            this->profiler->GpuResolved(false);
+
+        this->profiler = profiler;
+
+        // reports wait for the GPU only when there are queries to read it from
+        if (profiler && queryHeap)
+            profiler->GpuResolved(true);
+    }
+
+    uint32 Graphics::BeginScope(const char * name)
+    {
+        TimestampFrame & timing = timestampFrames[backBufferIndex];
+
+        if (!profiler || timing.scopeCount == MAX_GPU_SCOPES)
+            return MAX_GPU_SCOPES;
+
+        const uint32 scope = timing.scopeCount++;
+        timing.scopes[scope] = profiler->Begin(name);
+
+        if (timing.queryCount)
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, backBufferIndex * TIMESTAMP_QUERIES + 2 + 2 * scope);
+
+        return scope;
+    }
+
+    void Graphics::EndScope(const uint32 scope)
+    {
+        TimestampFrame & timing = timestampFrames[backBufferIndex];
+
+        if (!profiler || scope >= timing.scopeCount)
+            return;
+
+        if (timing.queryCount)
+            commandList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, backBufferIndex * TIMESTAMP_QUERIES + 3 + 2 * scope);
+
+        profiler->End(timing.scopes[scope]);
+    }
+
+    void Graphics::ReadTimestamps(TimestampFrame & timing, const uint32 slot) noexcept
+    {
+        const uint32 queryCount = timing.queryCount;
+        timing.queryCount = 0;
+
+        if (!profiler || queryCount == 0)
+            return;
+
+        // Present waited for the queue, the resolved values are already in the readback buffer
+        const uint64 base = uint64(slot) * TIMESTAMP_QUERIES;
+        D3D12_RANGE readRange{ SIZE_T(base * sizeof(uint64)), SIZE_T((base + queryCount) * sizeof(uint64)) };
+
+        uint64 * data = nullptr;
+        if (FAILED(queryReadback->Map(0, &readRange, reinterpret_cast<void**>(&data))))
+            return;
+
+        const uint64 * ticks = data + base;
+        const double milliseconds = 1000.0 / double(timestampFrequency);
+
+        for (uint32 i = 0; i < timing.scopeCount; ++i)
+            profiler->Gpu(timing.profileFrame, timing.scopes[i], double(ticks[3 + 2 * i] - ticks[2 + 2 * i]) * milliseconds);
+
+        profiler->Resolve(timing.profileFrame, double(ticks[1] - ticks[0]) * milliseconds);
+
+        D3D12_RANGE writeRange{ 0, 0 };
+        queryReadback->Unmap(0, &writeRange);
+    }
+
     void Graphics::Allocate(const uint32 type,
         const uint32 sizeInBytes,
         ID3D12Resource** resource) const
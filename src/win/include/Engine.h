@@ -1,10 +1,21 @@
 #pragma once
 
 #include "Graphics.h"
+#ifdef LUNA_VULKAN
+#include "SpriteRenderer.h"
+#endif
 #include "Window.h"
 #include "Input.h"
 #include "Timer.h"
 #include "Game.h"
+#include "Scheduler.h"
+#include "Visibility.h"
+#include "Profiler.h"
+#include "Streamer.h"
+#include "FileWatcher.h"
+#include "Overlay.h"
+#include "Headless.h"
+#include "Latency.h"
 #include "Export.h"
 
 namespace Luna
@@ -14,24 +25,50 @@ namespace Luna
     private:
         static Timer timer;
         static bool paused;
+        static bool headless;
+        static HeadlessConfig config;
 
+        void Allocate() noexcept;
         double FrameTime() noexcept;
+        void Frame();
         int32 Loop();
+        int32 HeadlessLoop();
 
     public:
         static Graphics* graphics;
+    #ifdef LUNA_VULKAN
+        static SpriteRenderer * sprites;
+    #endif
         static Window * window;
         static Input * input;
         static Game * game;
         static double frameTime;
+        static ThreadPool * threadPool;
+        static World * world;
+        static Scheduler * scheduler;
+        static Visibility * visibility;
+        static Profiler * profiler;
+        static Streamer * streamer;
+        static FileWatcher * watcher;
+        static Overlay * overlay;
+        static LatencyProbe * latency;
 
         explicit Engine() noexcept;
+
+        // a hidden window: Start runs the game for the configured frames without
+        // messages, then writes the PerfSummary and returns 0 if it was written
+        explicit Engine(const HeadlessConfig & config) noexcept;
         ~Engine() noexcept;
 
         int32 Start(Game * const game);
-        
+
+        // injects tagged key presses with SendInput until the samples are measured,
+        // then closes the window and writes the report; the window needs the focus
+        void MeasureLatency(const LatencyConfig & config);
+
         static void Pause() noexcept;
         static void Resume() noexcept;
+        static bool Headless() noexcept;
 
         static LRESULT CALLBACK EngineProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
     };
@@ -41,4 +78,7 @@ namespace Luna
 
     inline void Engine::Resume() noexcept
     { paused = false; timer.Start(); }
+
+    inline bool Engine::Headless() noexcept
+    { return headless; }
 }
\ No newline at end of file
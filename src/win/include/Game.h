@@ -1,8 +1,17 @@
 #pragma once
 
 #include "Graphics.h"
+#ifdef LUNA_VULKAN
+#include "SpriteRenderer.h"
+#endif
 #include "Window.h"
 #include "Input.h"
+#include "Scheduler.h"
+#include "Visibility.h"
+#include "Profiler.h"
+#include "Streamer.h"
+#include "FileWatcher.h"
+#include "Overlay.h"
 #include "Export.h"
 
 namespace Luna
@@ -11,9 +20,20 @@ namespace Luna
     {
     protected:
         static Graphics *& graphics;
+    #ifdef LUNA_VULKAN
+        static SpriteRenderer *& sprites;
+    #endif
         static Window*   & window;
         static Input*    & input;
         static double    & frameTime;
+        static ThreadPool* & threadPool;
+        static World*    & world;
+        static Scheduler*& scheduler;
+        static Visibility*& visibility;
+        static Profiler*& profiler;
+        static Streamer*& streamer;
+        static FileWatcher*& watcher;
+        static Overlay*& overlay;
         
     public:
         explicit Game() noexcept;
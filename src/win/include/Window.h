@@ -26,12 +26,14 @@ namespace Luna
         int32		windowPosY;
         int32		windowCenterX;
         int32		windowCenterY;
+        bool		windowHeadless;
 
         static void (*inFocus)();
         static void (*lostFocus)();
         
     public:
-        explicit Window() noexcept;
+        // a headless window is never shown, it only gives the renderer a target
+        explicit Window(const bool headless = false) noexcept;
 
         HWND Id() const noexcept;
         HINSTANCE AppId() const noexcept;
@@ -43,6 +45,7 @@ namespace Luna
         string Title() const noexcept;
         COLORREF Color() const noexcept;
         float AspectRatio() const noexcept;
+        bool Headless() const noexcept;
 
         void Icon(const uint32 icon) noexcept;
         void Cursor(const uint32 cursor) noexcept;
@@ -91,6 +94,9 @@ namespace Luna
     inline float Window::AspectRatio() const noexcept
     { return windowWidth / float(windowHeight); }
 
+    inline bool Window::Headless() const noexcept
+    { return windowHeadless; }
+
     inline void Window::Icon(const uint32 icon) noexcept
     { windowIcon = LoadIcon(GetModuleHandle(nullptr), MAKEINTRESOURCE(icon)); }
 
@@ -9,24 +9,70 @@ using std::format;
 namespace Luna 
 {
     Graphics* Engine::graphics  = nullptr;
+#ifdef LUNA_VULKAN
+    SpriteRenderer* Engine::sprites = nullptr;
+#endif
     Window*   Engine::window = nullptr;
     Input*    Engine::input = nullptr;
     Game*     Engine::game = nullptr;
+    ThreadPool* Engine::threadPool = nullptr;
+    World*    Engine::world = nullptr;
+    Scheduler* Engine::scheduler = nullptr;
+    Visibility* Engine::visibility = nullptr;
+    Profiler* Engine::profiler = nullptr;
+    Streamer* Engine::streamer = nullptr;
+    FileWatcher* Engine::watcher = nullptr;
+    Overlay* Engine::overlay = nullptr;
+    LatencyProbe* Engine::latency = nullptr;
     double    Engine::frameTime = {};
     bool      Engine::paused    = false;
+    bool      Engine::headless  = false;
+    HeadlessConfig Engine::config;
     Timer     Engine::timer;
 
     Engine::Engine() noexcept
     {
-        window = new Window();
+        Allocate();
+    }
+
+    Engine::Engine(const HeadlessConfig & config) noexcept
+    {
+        headless = true;
+        this->config = config;
+        Allocate();
+    }
+
+    void Engine::Allocate() noexcept
+    {
+        window = new Window(headless);
+        threadPool = new ThreadPool();
+        world = new World();
+        scheduler = new Scheduler(world, threadPool);
+        visibility = new Visibility();
+        profiler = new Profiler();
+        streamer = new Streamer(threadPool);
+        watcher = new FileWatcher();
+        overlay = new Overlay();
         graphics = new Graphics();
     }
 
     Engine::~Engine() noexcept
     {
+        delete latency;
+        delete overlay;
+        delete watcher;
+        delete streamer;
         delete game;
+        delete profiler;
+        delete visibility;
+        delete scheduler;
+        delete world;
+        delete threadPool;
         delete input;
         delete window;
+    #ifdef LUNA_VULKAN
+        delete sprites;
+    #endif
         delete graphics;
     }
 
@@ -39,18 +85,31 @@ namespace Luna
         input = new Input();
 
         graphics->Initialize(window);
+    #if defined(LUNA_D3D12) || defined(LUNA_VULKAN)
+        graphics->Profile(profiler);
+    #endif
+    #ifdef LUNA_VULKAN
+        sprites = new SpriteRenderer();
+        sprites->Initialize(graphics);
+    #endif
 
         SetWindowLongPtr(window->Id(), GWLP_WNDPROC, reinterpret_cast<LONG_PTR>(EngineProc));
 
         timeBeginPeriod(1);
 
-        int exitCode = Loop();
+        int exitCode = headless ? HeadlessLoop() : Loop();
 
         timeEndPeriod(1);
 
         return exitCode;
     }
 
+    void Engine::MeasureLatency(const LatencyConfig & config)
+    {
+        delete latency;
+        latency = new LatencyProbe(config);
+    }
+
     double Engine::FrameTime() noexcept
     {
     #ifdef _DEBUG
@@ -80,42 +139,158 @@ namespace Luna
         return frameTime;
     }
 
+    void Engine::Frame()
+    {
+        profiler->BeginFrame();
+        frameTime = headless ? config.frameTime : FrameTime();
+        overlay->Frame(frameTime * 1000.0);
+        {
+            ProfileScope scope(profiler, "Streaming");
+            watcher->Update();
+            streamer->Deliver();
+        }
+        if (overlay->Visible())
+        {
+            // the game may add rows with overlay->Text until Draw
+            ProfileScope scope(profiler, "Overlay");
+            overlay->Begin();
+            overlay->Graph();
+        #ifdef LUNA_VULKAN
+            overlay->Stats(profiler->Report(), graphics->Allocator()->Used());
+        #else
+            overlay->Stats(profiler->Report());
+        #endif
+        }
+        {
+            ProfileScope scope(profiler, "Update");
+            if (latency)
+                latency->Stage(LATENCY_UPDATE);
+            game->Update();
+        }
+        {
+            ProfileScope scope(profiler, "Systems");
+            scheduler->Update(frameTime);
+        }
+        {
+            ProfileScope scope(profiler, "Culling");
+            visibility->Cull(threadPool);
+        }
+        {
+            ProfileScope scope(profiler, "Draw");
+            if (overlay->Visible())
+                overlay->End();
+            if (latency)
+                latency->Stage(LATENCY_DRAW);
+
+            // the game presents at the end of its Draw
+            game->Draw();
+            if (latency)
+                latency->Stage(LATENCY_PRESENT);
+        }
+        overlay->Presented();
+        profiler->EndFrame();
+    }
+
+    // ---------------------------------------------------
+    // Latency probe: F20 presses sent through SendInput, timed
+    // until the Present at the end of the frame that reads them
+    // ---------------------------------------------------
+
+    static void InjectProbe(const Window * window, LatencyProbe * latency)
+    {
+        // SendInput goes to the foreground window, which may refuse to change
+        if (GetForegroundWindow() != window->Id())
+        {
+            SetForegroundWindow(window->Id());
+            return;
+        }
+
+        INPUT inputs[2]{};
+        inputs[0].type = INPUT_KEYBOARD;
+        inputs[0].ki.wVk = VK_F20;
+        inputs[1] = inputs[0];
+        inputs[1].ki.dwFlags = KEYEVENTF_KEYUP;
+
+        latency->Sent();
+        SendInput(2, inputs, sizeof(INPUT));
+    }
+
     int32 Engine::Loop()
     {
         MSG msg{};
 
         game->Init();
 
+        bool closing = false;
+
         do
         {
             if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
             {
+                overlay->Event((msg.message >= WM_KEYFIRST && msg.message <= WM_KEYLAST)
+                    || (msg.message >= WM_MOUSEFIRST && msg.message <= WM_MOUSELAST));
+
                 TranslateMessage(&msg);
                 DispatchMessage(&msg);
+
+                if (latency && msg.message == WM_KEYDOWN && msg.wParam == VK_F20)
+                    latency->Received();
             }
             else
             {
+                if (latency && latency->Due())
+                    InjectProbe(window, latency);
+
                 if (input->KeyPress(VK_PAUSE))
                     (paused) ? Resume() : Pause();
 
                 if (!paused)
                 {
-                    frameTime = FrameTime();
-                    game->Update();
-                    game->Draw();
+                    Frame();
                 }
                 else
                 {
                     game->OnPause();
                 }
+
+                if (latency && latency->Done() && !closing)
+                {
+                    window->Close();
+                    closing = true;
+                }
             }
         } while (msg.message != WM_QUIT);
 
         game->Finalize();    
 
+        if (latency)
+            latency->Write("win32");
+
         return int32(msg.wParam);
     }
 
+    int32 Engine::HeadlessLoop()
+    {
+        PerfSummary summary;
+        double simulated = 0.0;
+        game->Init();
+        timer.Start();
+
+        for (uint32 frames = 0;
+            (config.frames == 0 || frames < config.frames) &&
+            (config.duration <= 0.0 || simulated < config.duration);
+            ++frames)
+        {
+            Frame();
+            simulated += config.frameTime;
+            summary.Frame(timer.Reset() * 1000.0, profiler->Report());
+        }
+
+        game->Finalize();
+
+        return summary.Write(config.summary) ? 0 : 1;
+    }
+
     LRESULT CALLBACK Engine::EngineProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
     {
         if (msg == WM_PAINT)
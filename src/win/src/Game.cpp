@@ -4,9 +4,20 @@
 namespace Luna
 {
     Graphics* & Game::graphics  = Engine::graphics;
+#ifdef LUNA_VULKAN
+    SpriteRenderer* & Game::sprites = Engine::sprites;
+#endif
     Window*   & Game::window    = Engine::window;
     Input*    & Game::input     = Engine::input;
     double    & Game::frameTime = Engine::frameTime;
+    ThreadPool* & Game::threadPool = Engine::threadPool;
+    World*    & Game::world     = Engine::world;
+    Scheduler*& Game::scheduler = Engine::scheduler;
+    Visibility*& Game::visibility = Engine::visibility;
+    Profiler*& Game::profiler = Engine::profiler;
+    Streamer*& Game::streamer = Engine::streamer;
+    FileWatcher*& Game::watcher = Engine::watcher;
+    Overlay*& Game::overlay = Engine::overlay;
     
     Game::Game() noexcept
     {
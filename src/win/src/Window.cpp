@@ -6,7 +6,7 @@ namespace Luna
     void (*Window::inFocus)() = nullptr;
     void (*Window::lostFocus)() = nullptr;
 
-    Window::Window() noexcept : windowHandle{}, windowPosX{}, windowPosY{}
+    Window::Window(const bool headless) noexcept : windowHandle{}, windowPosX{}, windowPosY{}, windowHeadless{ headless }
     {
         hInstance = GetModuleHandle(nullptr);
         windowWidth = GetSystemMetrics(SM_CXSCREEN);
@@ -19,6 +19,12 @@ namespace Luna
         windowMode = FULLSCREEN;
         windowCenterX = windowWidth / 2;
         windowCenterY = windowHeight / 2;
+
+        if (headless)
+        {
+            Mode(WINDOWED);
+            Size(1280, 720);
+        }
     }
 
     void Window::Mode(const uint32 mode) noexcept
@@ -29,6 +35,9 @@ namespace Luna
             windowStyle = WS_OVERLAPPED | WS_SYSMENU | WS_VISIBLE; 
         else
             windowStyle = WS_EX_TOPMOST | WS_POPUP | WS_VISIBLE; 
+
+        if (windowHeadless)
+            windowStyle &= ~WS_VISIBLE;
     }
 
     void Window::Size(const uint32 width, const uint32 height) noexcept
@@ -0,0 +1,47 @@
+// luna_mesh <input.obj | input.gltf | input.glb> <output.lmesh>
+// Imports a mesh, optimizes it for the vertex cache, overdraw and vertex
+// fetch, and writes it quantized in the format ReadMesh maps into buffers.
+
+#include "MeshProcessing.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace Luna;
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: luna_mesh <input.obj | input.gltf | input.glb> <output.lmesh>\n");
+        return 1;
+    }
+
+    MeshData mesh;
+    if (!ImportMesh(argv[1], mesh) || mesh.vertices.empty())
+    {
+        fprintf(stderr, "luna_mesh: could not import %s\n", argv[1]);
+        return 1;
+    }
+
+    // the imported triangle list, indexed without reordering, is the baseline
+    Deduplicate(mesh);
+    const CacheStats before = AnalyzeVertexCache(mesh.indices, uint32(mesh.vertices.size()));
+
+    ProcessMesh(mesh);
+    const CacheStats after = AnalyzeVertexCache(mesh.indices, uint32(mesh.vertices.size()));
+
+    const std::vector<uint8> packed = PackMesh(mesh);
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(packed.data()), std::streamsize(packed.size()));
+
+    if (!output)
+    {
+        fprintf(stderr, "luna_mesh: could not write %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("%zu vertices, %zu triangles\n", mesh.vertices.size(), mesh.indices.size() / 3);
+    printf("ACMR %.3f -> %.3f, ATVR %.3f -> %.3f (cache of %u)\n", before.acmr, after.acmr, before.atvr, after.atvr, MESH_CACHE_SIZE);
+    printf("%zu -> %zu bytes per vertex, %zu bytes written\n", sizeof(MeshVertex), sizeof(PackedVertex), packed.size());
+    return 0;
+}
@@ -0,0 +1,54 @@
+// luna_pack <directory> <output> [--lz4 | --zstd]
+// Packs every file under directory into one AssetPack. With a codec, entries
+// are stored compressed when that saves at least an eighth of their size.
+
+#include "AssetPack.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace Luna;
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: luna_pack <directory> <output> [--lz4 | --zstd]\n");
+        return 1;
+    }
+
+    PackCompression codec = PACK_NONE;
+    if (argc > 3 && strcmp(argv[3], "--lz4") == 0)
+        codec = PACK_LZ4;
+    else if (argc > 3 && strcmp(argv[3], "--zstd") == 0)
+        codec = PACK_ZSTD;
+
+    if (!AssetPack::Supports(codec))
+    {
+        fprintf(stderr, "luna_pack: the core library was built without %s\n", argv[3]);
+        return 1;
+    }
+
+    if (!AssetPack::Build(argv[1], argv[2], codec))
+    {
+        fprintf(stderr, "luna_pack: could not pack %s into %s\n", argv[1], argv[2]);
+        return 1;
+    }
+
+    AssetPack pack;
+    if (!pack.Open(argv[2]))
+    {
+        fprintf(stderr, "luna_pack: %s does not read back\n", argv[2]);
+        return 1;
+    }
+
+    uint64 rawSize = 0;
+    uint64 storedSize = 0;
+    for (const PackEntry & entry : pack.Entries())
+    {
+        rawSize += entry.rawSize;
+        storedSize += entry.size;
+    }
+
+    printf("%zu files, %llu bytes stored as %llu\n", pack.Entries().size(), rawSize, storedSize);
+    return 0;
+}
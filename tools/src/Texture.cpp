@@ -0,0 +1,97 @@
+// luna_texture <input.png> <output.ltex> [--bc1 | --bc3 | --bc7 | --etc2 | --rgba] [--linear] [--box]
+// Builds the mip chain of an image and block compresses every level into the
+// format ReadTexture hands to the GPU without transcoding. Colors are taken as
+// sRGB unless --linear is given, for normal maps and other data textures.
+
+#include "TextureProcessing.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <png.h>
+
+using namespace Luna;
+
+static bool LoadPng(const char * path, ImageData & image)
+{
+    png_image png{};
+    png.version = PNG_IMAGE_VERSION;
+
+    if (!png_image_begin_read_from_file(&png, path))
+        return false;
+
+    png.format = PNG_FORMAT_RGBA;
+    image.width = png.width;
+    image.height = png.height;
+    image.pixels.resize(PNG_IMAGE_SIZE(png));
+
+    return png_image_finish_read(&png, nullptr, image.pixels.data(), 0, nullptr) != 0;
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: luna_texture <input.png> <output.ltex> [--bc1 | --bc3 | --bc7 | --etc2 | --rgba] [--linear] [--box]\n");
+        return 1;
+    }
+
+    TextureFormat format = TEXTURE_BC7;
+    MipFilter filter = MIP_KAISER;
+    bool srgb = true;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--bc1") == 0)
+            format = TEXTURE_BC1;
+        else if (strcmp(argv[i], "--bc3") == 0)
+            format = TEXTURE_BC3;
+        else if (strcmp(argv[i], "--bc7") == 0)
+            format = TEXTURE_BC7;
+        else if (strcmp(argv[i], "--etc2") == 0)
+            format = TEXTURE_ETC2;
+        else if (strcmp(argv[i], "--rgba") == 0)
+            format = TEXTURE_RGBA8;
+        else if (strcmp(argv[i], "--linear") == 0)
+            srgb = false;
+        else if (strcmp(argv[i], "--box") == 0)
+            filter = MIP_BOX;
+        else
+        {
+            fprintf(stderr, "luna_texture: unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    ImageData image;
+    if (!LoadPng(argv[1], image))
+    {
+        fprintf(stderr, "luna_texture: could not read %s\n", argv[1]);
+        return 1;
+    }
+
+    ThreadPool pool;
+    const auto start = std::chrono::steady_clock::now();
+
+    const std::vector<ImageData> levels = GenerateMips(image, srgb, filter, &pool);
+    const std::vector<uint8> packed = PackTexture(levels, format, srgb, &pool);
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(packed.data()), std::streamsize(packed.size()));
+
+    if (packed.empty() || !output)
+    {
+        fprintf(stderr, "luna_texture: could not write %s\n", argv[2]);
+        return 1;
+    }
+
+    uint64 uncompressed = 0;
+    for (const ImageData & level : levels)
+        uncompressed += level.pixels.size();
+
+    printf("%ux%u, %zu levels in %.0f ms with %u pool workers\n", image.width, image.height, levels.size(), seconds * 1000.0, pool.Size());
+    printf("%llu bytes as RGBA8 -> %zu bytes written (%.1fx)\n", (unsigned long long)uncompressed, packed.size(), double(uncompressed) / double(packed.size()));
+    return 0;
+}